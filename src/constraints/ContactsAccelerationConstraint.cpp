@@ -2,7 +2,7 @@
 
 namespace wbc{
 
-    void ContactsAccelerationConstraint::update(RobotModelPtr robot_model) {
+    void ContactsAccelerationConstraint::update(const RobotModelPtr& robot_model) {
         
         const ActiveContacts& contacts = robot_model->getActiveContacts();
 
@@ -21,7 +21,7 @@ public:
 
     virtual ~ContactsAccelerationConstraint() = default;
 
-    virtual void update(RobotModelPtr robot_model) override;
+    virtual void update(const RobotModelPtr& robot_model) override;
 
 private:
 
@@ -2,7 +2,7 @@
 
 namespace wbc {
 
-void ContactsFrictionPointConstraint::update(RobotModelPtr robot_model){
+void ContactsFrictionPointConstraint::update(const RobotModelPtr& robot_model){
 
     const bool use_torques = false;
 
@@ -2,7 +2,7 @@
 
 namespace wbc {
 
-void ContactsFrictionSurfaceConstraint::update(RobotModelPtr robot_model){
+void ContactsFrictionSurfaceConstraint::update(const RobotModelPtr& robot_model){
 
     const auto& contacts = robot_model->getActiveContacts();
 
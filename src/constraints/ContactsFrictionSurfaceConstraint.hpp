@@ -12,7 +12,7 @@ public:
 
     virtual ~ContactsFrictionSurfaceConstraint() = default;
 
-    virtual void update(RobotModelPtr robot_model) override;
+    virtual void update(const RobotModelPtr& robot_model) override;
 
 private:
     bool reduced; // if torques are removed from the qp formulation or not
@@ -2,7 +2,7 @@
 
 namespace wbc{
 
-    void ContactsVelocityConstraint::update(RobotModelPtr robot_model) {
+    void ContactsVelocityConstraint::update(const RobotModelPtr& robot_model) {
         
         const ActiveContacts& contacts = robot_model->getActiveContacts();
 
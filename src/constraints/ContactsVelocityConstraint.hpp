@@ -21,7 +21,7 @@ public:
 
     virtual ~ContactsVelocityConstraint() = default;
 
-    virtual void update(RobotModelPtr robot_model) override;
+    virtual void update(const RobotModelPtr& robot_model) override;
 
 };
 typedef std::shared_ptr<ContactsVelocityConstraint> ContactsVelocityConstraintPtr;
@@ -2,7 +2,7 @@
 
 namespace wbc{
 
-    void EffortLimitsAccelerationConstraint::update(RobotModelPtr robot_model) {
+    void EffortLimitsAccelerationConstraint::update(const RobotModelPtr& robot_model) {
         
         const auto& contacts = robot_model->getActiveContacts();
 
@@ -33,8 +33,8 @@ namespace wbc{
 
         for(uint i = 0; i < robot_model->noOfActuatedJoints(); i++){
             const std::string& name = robot_model->actuatedJointNames()[i];
-            lb_vec(i) = robot_model->jointLimits()[name].min.effort - b(i);
-            ub_vec(i) = robot_model->jointLimits()[name].max.effort - b(i);
+            lb_vec(i) = robot_model->jointLimits()[name].min.effort + margin - b(i);
+            ub_vec(i) = robot_model->jointLimits()[name].max.effort - margin - b(i);
         }
     }
 
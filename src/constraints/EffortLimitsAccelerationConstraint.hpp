@@ -19,14 +19,20 @@ namespace wbc{
 class EffortLimitsAccelerationConstraint : public Constraint {
 public:
 
-    /** @brief Default constructor */
-    EffortLimitsAccelerationConstraint() 
-        : Constraint(Constraint::inequality) { }
+    /**
+     * @brief Default constructor
+     * @param margin Safety margin. The effort range is reduced by this value on both sides
+     */
+    EffortLimitsAccelerationConstraint(double margin = 0)
+        : Constraint(Constraint::inequality), margin(margin) { }
 
     virtual ~EffortLimitsAccelerationConstraint() = default;
 
-    virtual void update(RobotModelPtr robot_model) override;
+    virtual void update(const RobotModelPtr& robot_model) override;
 
+protected:
+    /** Safety margin for the effort limits*/
+    double margin;
 };
 typedef std::shared_ptr<EffortLimitsAccelerationConstraint> EffortLimitsAccelerationConstraintPtr;
 
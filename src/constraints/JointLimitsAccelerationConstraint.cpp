@@ -2,15 +2,16 @@
 
 namespace wbc{
 
-    JointLimitsAccelerationConstraint::JointLimitsAccelerationConstraint(double dt, bool reduced) 
+    JointLimitsAccelerationConstraint::JointLimitsAccelerationConstraint(double dt, bool reduced, double margin) 
     :   Constraint(Constraint::bounds),
         dt(dt),
-        reduced(reduced)
+        reduced(reduced),
+        margin(margin)
     {
 
     }
 
-    void JointLimitsAccelerationConstraint::update(RobotModelPtr robot_model) {
+    void JointLimitsAccelerationConstraint::update(const RobotModelPtr& robot_model) {
         
         uint nj = robot_model->noOfJoints();
         uint na = robot_model->noOfActuatedJoints();
@@ -58,8 +59,8 @@ namespace wbc{
             // enforce joint position limit
             if(check_positions)
             {
-                lb_vec(idx) = std::max(lb_vec(idx), 2*(range.min.position - pos - dt*vel) / (dt*dt));
-                ub_vec(idx) = std::min(ub_vec(idx), 2*(range.max.position - pos - dt*vel) / (dt*dt));
+                lb_vec(idx) = std::max(lb_vec(idx), 2*(range.min.position + margin - pos - dt*vel) / (dt*dt));
+                ub_vec(idx) = std::min(ub_vec(idx), 2*(range.max.position - margin - pos - dt*vel) / (dt*dt));
             }
         }
 
@@ -18,13 +18,18 @@ public:
 
     /** @brief Default constructor */
     explicit JointLimitsAccelerationConstraint(bool reduced=false) 
-        : Constraint(Constraint::bounds), reduced(reduced) { }
+        : Constraint(Constraint::bounds), reduced(reduced), margin(0) { }
     
-    explicit JointLimitsAccelerationConstraint(double dt, bool reduced=false);
+    /**
+     * @param dt Control time step
+     * @param reduced If torques are removed from the qp formulation or not
+     * @param margin Safety margin. The joint position range is reduced by this value on both sides
+     */
+    explicit JointLimitsAccelerationConstraint(double dt, bool reduced=false, double margin=0);
 
     virtual ~JointLimitsAccelerationConstraint() = default;
 
-    virtual void update(RobotModelPtr robot_model) override;
+    virtual void update(const RobotModelPtr& robot_model) override;
 
 protected:
 
@@ -33,6 +38,9 @@ protected:
 
     bool reduced;
 
+    /** Safety margin for the joint position limits*/
+    double margin;
+
 };
 typedef std::shared_ptr<JointLimitsAccelerationConstraint> JointLimitsAccelerationConstraintPtr;
 
@@ -2,14 +2,15 @@
 
 namespace wbc{
 
-    JointLimitsVelocityConstraint::JointLimitsVelocityConstraint(double dt) :
+    JointLimitsVelocityConstraint::JointLimitsVelocityConstraint(double dt, double margin) :
         Constraint(Constraint::bounds), 
-        dt(dt)
+        dt(dt),
+        margin(margin)
     {
 
     }
 
-    void JointLimitsVelocityConstraint::update(RobotModelPtr robot_model) {
+    void JointLimitsVelocityConstraint::update(const RobotModelPtr& robot_model) {
 
         uint nj = robot_model->noOfJoints();
 
@@ -27,8 +28,8 @@ namespace wbc{
             const base::JointLimitRange &range = robot_model->jointLimits().getElementByName(n);
 
             // enforce joint velocity and position limits
-            lb_vec(idx) = std::max(static_cast<double>(range.min.speed), (range.min.position - state[n].position) / dt);
-            ub_vec(idx) = std::min(static_cast<double>(range.max.speed), (range.max.position - state[n].position) / dt);
+            lb_vec(idx) = std::max(static_cast<double>(range.min.speed), (range.min.position + margin - state[n].position) / dt);
+            ub_vec(idx) = std::min(static_cast<double>(range.max.speed), (range.max.position - margin - state[n].position) / dt);
             lb_vec(idx) = std::min(lb_vec(idx), 0.0); // Why is this required?
             ub_vec(idx) = std::max(ub_vec(idx), 0.0);
         }
@@ -17,19 +17,26 @@ class JointLimitsVelocityConstraint : public Constraint {
 public:
 
     /** @brief Default constructor */
-    JointLimitsVelocityConstraint() : Constraint(Constraint::bounds) { }
+    JointLimitsVelocityConstraint() : Constraint(Constraint::bounds), margin(0) { }
 
-    JointLimitsVelocityConstraint(double dt);
+    /**
+     * @param dt Control time step
+     * @param margin Safety margin. The joint position range is reduced by this value on both sides
+     */
+    JointLimitsVelocityConstraint(double dt, double margin = 0);
 
     virtual ~JointLimitsVelocityConstraint() = default;
 
-    virtual void update(RobotModelPtr robot_model) override;
+    virtual void update(const RobotModelPtr& robot_model) override;
 
 protected:
 
     /** Control timestep: used to integrate and differentiate velocities */
     double dt;
 
+    /** Safety margin for the joint position limits*/
+    double margin;
+
 };
 typedef std::shared_ptr<JointLimitsVelocityConstraint> JointLimitsVelocityConstraintPtr;
 
@@ -2,7 +2,7 @@
 
 namespace wbc{
 
-    void RigidbodyDynamicsConstraint::update(RobotModelPtr robot_model) {
+    void RigidbodyDynamicsConstraint::update(const RobotModelPtr& robot_model) {
         
         const ActiveContacts& contacts = robot_model->getActiveContacts();
 
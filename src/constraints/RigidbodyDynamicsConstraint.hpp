@@ -22,7 +22,7 @@ public:
 
     virtual ~RigidbodyDynamicsConstraint() = default;
 
-    virtual void update(RobotModelPtr robot_model) override;
+    virtual void update(const RobotModelPtr& robot_model) override;
 
 protected:
 
@@ -28,7 +28,7 @@ public:
     virtual ~Constraint() = default;
 
     /** @brief Update constraint matrix and vectors, depending on the type. Abstract method. */
-    virtual void update(RobotModelPtr robot_model) = 0;
+    virtual void update(const RobotModelPtr& robot_model) = 0;
 
     /** @brief Return the type of this constraint */
     Type type(); 
@@ -0,0 +1,55 @@
+#ifndef CONSTRAINT_CONFIG_HPP
+#define CONSTRAINT_CONFIG_HPP
+
+#include <string>
+#include <stdexcept>
+
+namespace wbc{
+
+/**
+ * Constraint type. Which types are available depends on the scene:
+ *  - dynamics_constraint: Rigid body dynamics (acceleration based scenes with torques)
+ *  - contacts_constraint: Rigid contacts, i.e., zero acceleration/velocity of all active contact points
+ *  - joint_limits_constraint: Joint position, velocity (and acceleration/effort) limits as bounds
+ *  - effort_limits_constraint: Joint effort limits as linear inequality constraints (reduced TSID scene, where the torques are not optimization variables)
+ *  - friction_point_constraint: Linearized friction cones for point contacts
+ *  - friction_surface_constraint: Linearized friction cones for surface contacts (including the center of pressure and yaw torque)
+ */
+enum ConstraintType{dynamics_constraint = 0,
+                    contacts_constraint = 1,
+                    joint_limits_constraint = 2,
+                    effort_limits_constraint = 3,
+                    friction_point_constraint = 4,
+                    friction_surface_constraint = 5};
+
+/**
+ * @brief Defines a hard constraint of a WBC scene. The constraints are added to the optimization problem in the order in which they are given to Scene::configure().
+ */
+class ConstraintConfig{
+public:
+    ConstraintConfig() :
+        type(joint_limits_constraint),
+        margin(0){
+    }
+    ConstraintConfig(const ConstraintType type, const double margin = 0) :
+        type(type),
+        margin(margin){
+    }
+    void validate() const{
+        if(type < dynamics_constraint || type > friction_surface_constraint)
+            throw std::invalid_argument("Invalid constraint config. Invalid constraint type: " + std::to_string(type));
+        if(margin < 0)
+            throw std::invalid_argument("Invalid constraint config. Margin must be >= 0, but is " + std::to_string(margin));
+    }
+
+    /** Constraint type, see ConstraintType*/
+    ConstraintType type;
+
+    /** Safety margin, only used for limit constraints. Joint limits: The position range is reduced by the margin on both sides (in rad or m).
+     *  Effort limits: The effort range is reduced by the margin on both sides (in Nm or N)*/
+    double margin;
+};
+
+}
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef FIXED_SIZE_TASK_COST_HPP
+#define FIXED_SIZE_TASK_COST_HPP
+
+#include "Task.hpp"
+#include "QuadraticProgram.hpp"
+#include <base-logging/Logging.hpp>
+
+namespace wbc{
+
+/**
+ * @brief Weighted least-squares cost of a set of tasks, i.e. \f$\sum_i \|\mathbf{A}_{w,i}\mathbf{x} - \mathbf{y}_{w,i}\|_2\f$, for a robot with a compile-time number of joints NV.
+ * All intermediate matrices (weighted task matrices, Hessian and gradient) are fixed size or fixed maximum size Eigen types, so that no heap memory is used and
+ * Eigen can unroll the involved products. Used by StaticScene.
+ */
+template<int NV>
+class FixedSizeTaskCost{
+public:
+    /** Maximum number of task variables, i.e. 6 for Cartesian tasks or NV for joint space tasks*/
+    static constexpr int MAX_TASK_VARIABLES = NV > 6 ? NV : 6;
+
+    typedef Eigen::Matrix<double,NV,NV> Hessian;
+    typedef Eigen::Matrix<double,NV,1> Gradient;
+    typedef Eigen::Matrix<double,Eigen::Dynamic,NV,Eigen::ColMajor,MAX_TASK_VARIABLES,NV> TaskMatrix;
+    typedef Eigen::Matrix<double,Eigen::Dynamic,1,Eigen::ColMajor,MAX_TASK_VARIABLES,1> TaskVector;
+
+    /** Hessian of the task cost function (NV x NV)*/
+    Hessian H;
+    /** Gradient of the task cost function (NV x 1)*/
+    Gradient g;
+
+    /**
+     * @brief Update all given tasks and accumulate Hessian and gradient. Task and reference weighting is the same as in the dynamically sized scenes, i.e.
+     * rows are scaled with weights_root * activation * (!timeout) and columns with the joint weights. Aw and y_ref_root of each task will be updated accordingly.
+     * Inactive tasks (see Task::checkInactive()) are skipped.
+     */
+    void update(const std::vector<TaskPtr>& tasks, const RobotModelPtr& robot_model, const JointWeights& joint_weights){
+
+        reset(robot_model, joint_weights);
+        for(const TaskPtr& task : tasks){
+
+            task->checkTimeout();
+            if(task->checkInactive())
+                continue;
+            task->update(robot_model);
+            add(*task);
+        }
+    }
+
+    /**
+     * @brief Set Hessian and gradient to zero and store the joint weights. Call this before adding tasks with add()
+     */
+    void reset(const RobotModelPtr& robot_model, const JointWeights& joint_weights){
+
+        if(robot_model->noOfJoints() != NV){
+            LOG_ERROR("FixedSizeTaskCost has been instantiated for %i joints, but robot model has %i joints", NV, robot_model->noOfJoints());
+            throw std::runtime_error("Invalid robot model size");
+        }
+
+        for(int i = 0; i < NV; i++)
+            Wq(i) = joint_weights[i];
+
+        H.setZero();
+        g.setZero();
+    }
+
+    /**
+     * @brief Weight the given task and add it to Hessian and gradient. The task has to be updated and active.
+     */
+    void add(Task& task){
+
+        const int nv = task.A.rows();
+        if(nv > MAX_TASK_VARIABLES){
+            LOG_ERROR("Task %s has %i task variables, but FixedSizeTaskCost supports at most %i", task.config.name.c_str(), nv, MAX_TASK_VARIABLES);
+            throw std::runtime_error("Invalid task size");
+        }
+
+        w = task.weights_root * (task.activation * (!task.timeout));
+        Aw.noalias() = w.asDiagonal() * Eigen::Map<const Eigen::Matrix<double,Eigen::Dynamic,NV>>(task.A.data(), nv, NV) * Wq.asDiagonal();
+        task.y_ref_root.array() *= task.weights_root.array() * task.activation;
+        y = task.y_ref_root;
+        task.Aw = Aw;
+
+        H.noalias() += Aw.transpose() * Aw;
+        g.noalias() -= Aw.transpose() * y;
+    }
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+protected:
+    Gradient Wq;
+    TaskMatrix Aw;
+    TaskVector w, y;
+};
+
+}
+
+#endif
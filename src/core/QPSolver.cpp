@@ -1,4 +1,6 @@
 #include "QPSolver.hpp"
+#include "QuadraticProgram.hpp"
+#include <stdexcept>
 
 namespace wbc{
 
@@ -8,5 +10,67 @@ QPSolver::QPSolver() : configured(false){
 QPSolver::~QPSolver(){
 }
 
+void QPSolver::setParameter(const std::string &name, const std::string &value){
+    throw std::invalid_argument("QPSolver::setParameter: Solver has no parameter with name '" + name + "'");
+}
+
+void QPSolver::applyConfig(const QPSolverConfig &config){
+    for(const auto &p : config.parameters)
+        setParameter(p.first, p.second);
+}
+
+bool QPSolver::predictWarmStart(const HierarchicalQP &hierarchical_qp){
+    warm_start.clear();
+    if(!warm_start_predictor || hierarchical_qp.size() != 1)
+        return false;
+    if(!warm_start_predictor->predict(hierarchical_qp, warm_start)){
+        warm_start.clear();
+        return false;
+    }
+    const QuadraticProgram &qp = hierarchical_qp[0];
+    warm_start.validate(qp);
+    if(warm_start.hasPrimal() && !warm_start.hasActiveSet(qp) && (qp.nin > 0 || qp.bounded))
+        estimateActiveSet(qp, warm_start.x, 1e-6, warm_start.active_constraints, warm_start.active_bounds);
+    return warm_start.hasPrimal() || warm_start.hasDual(qp) || warm_start.hasActiveSet(qp);
+}
+
+void QPSolver::updateWarmStartPredictor(const HierarchicalQP &hierarchical_qp, const base::VectorXd &solver_output){
+    if(!warm_start_predictor || hierarchical_qp.size() != 1)
+        return;
+    WarmStart solution;
+    solution.x = solver_output;
+    if(!getActiveSet(solution.active_constraints, solution.active_bounds))
+        estimateActiveSet(hierarchical_qp[0], solver_output, 1e-6, solution.active_constraints, solution.active_bounds);
+    warm_start_predictor->update(hierarchical_qp, solution);
+}
+
+void QPSolver::estimateActiveSet(const QuadraticProgram &qp, const base::VectorXd &x, const double tolerance, Eigen::VectorXi &constraints, Eigen::VectorXi &bounds){
+    constraints.setZero(qp.nin);
+    if(qp.nin > 0){
+        base::VectorXd Cx = qp.C * x;
+        constraints = (Cx.array() <= qp.lower_y.array() + tolerance).select(ACTIVE_SET_LOWER, constraints);
+        constraints = (Cx.array() >= qp.upper_y.array() - tolerance).select(ACTIVE_SET_UPPER, constraints);
+    }
+    bounds.setZero(qp.bounded ? qp.nq : 0);
+    if(qp.bounded){
+        bounds = (x.array() <= qp.lower_x.array() + tolerance).select(ACTIVE_SET_LOWER, bounds);
+        bounds = (x.array() >= qp.upper_x.array() - tolerance).select(ACTIVE_SET_UPPER, bounds);
+    }
+}
+
+bool QPSolver::isFeasible(const QuadraticProgram &qp, const base::VectorXd &x, const double tolerance){
+    // Row-wise, so that no temporaries are allocated and the check stops at the first violated constraint
+    for(int i = 0; i < qp.nin; i++){
+        const double c = qp.C.row(i).dot(x);
+        if(c < qp.lower_y[i] - tolerance || c > qp.upper_y[i] + tolerance)
+            return false;
+    }
+    if(qp.bounded){
+        if((x.array() < qp.lower_x.array() - tolerance).any() || (x.array() > qp.upper_x.array() + tolerance).any())
+            return false;
+    }
+    return true;
+}
+
 QPSolverFactory::QPSolverMap* QPSolverFactory::qp_solver_map = 0;
 }
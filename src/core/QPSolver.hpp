@@ -6,14 +6,34 @@
 #include <memory>
 #include <map>
 #include "QPSolverConfig.hpp"
+#include "WarmStartPredictor.hpp"
 
 namespace wbc{
 
 class HierarchicalQP;
+class QuadraticProgram;
+
+/** Status of an inequality constraint or bound in the active set of a QP solution*/
+enum ActiveSetStatus{ACTIVE_SET_LOWER = -1,     /** Constraint is active at its lower bound*/
+                     ACTIVE_SET_INACTIVE = 0,   /** Constraint is not active*/
+                     ACTIVE_SET_UPPER = 1};     /** Constraint is active at its upper bound*/
 
 class QPSolver{
 protected:
     bool configured;
+    WarmStartPredictorPtr warm_start_predictor;
+    WarmStart warm_start;
+
+    /**
+     * @brief predictWarmStart To be called by solvers that support warm starts at the beginning of solve(). Queries the warm start predictor (if any) and stores the
+     * validated prediction in the member warm_start. If only a primal guess is predicted, the active set is estimated from it.
+     * @return True if a prediction is available
+     */
+    bool predictWarmStart(const HierarchicalQP &hierarchical_qp);
+
+    /** @brief updateWarmStartPredictor To be called by solvers that support warm starts after a successful solve(). Passes the solution and the active set to the predictor (if any)*/
+    void updateWarmStartPredictor(const HierarchicalQP &hierarchical_qp, const base::VectorXd &solver_output);
+
 public:
     QPSolver();
     virtual ~QPSolver();
@@ -24,8 +44,65 @@ public:
      */
     virtual void solve(const HierarchicalQP& hierarchical_qp, base::VectorXd &solver_output) = 0;
 
-    /** @brief reset Enforces reconfiguration at next call to solve() */
-    void reset(){configured=false;}
+    /** @brief reset Enforces reconfiguration at next call to solve(), e.g. after the problem size has changed, and resets the warm start predictor (if any), so that
+     *  the next solve is a cold start. Solver front-ends that wrap a backend solver have to override this and reset their backend as well */
+    virtual void reset(){
+        configured = false;
+        if(warm_start_predictor)
+            warm_start_predictor->reset();
+    }
+
+    /**
+     * @brief getActiveSet Return the active set of the last solution. Only available for single priority QPs and solvers that support it.
+     * @param constraints Status (see ActiveSetStatus) of each inequality constraint (nin x 1), equality constraints are not included
+     * @param bounds Status (see ActiveSetStatus) of each variable bound (nq x 1)
+     * @return False if the solver does not report its active set
+     */
+    virtual bool getActiveSet(Eigen::VectorXi &constraints, Eigen::VectorXi &bounds) {return false;}
+
+    /**
+     * @brief setParameter Set a solver specific parameter by name, e.g., from a QPSolverConfig. See the documentation of the respective solver for valid names and values.
+     * Throws std::invalid_argument if the solver does not have a parameter with the given name or if the value is invalid. Parameters that affect the
+     * initialization of the solver backend should be set before the first call to solve().
+     * @param name Name of the parameter
+     * @param value Value of the parameter as string
+     */
+    virtual void setParameter(const std::string &name, const std::string &value);
+
+    /** @brief applyConfig Set all parameters of the given solver config (see setParameter())*/
+    void applyConfig(const QPSolverConfig &config);
+
+    /**
+     * @brief setWarmStartPredictor Set a predictor that supplies the initial primal/dual guess and the predicted active set before each call to solve().
+     * Only used if the solver supports warm starts (see supportsWarmStart()). Pass an empty pointer to use the default warm start of the solver again.
+     */
+    void setWarmStartPredictor(WarmStartPredictorPtr predictor){warm_start_predictor = predictor;}
+
+    /** @brief getWarmStartPredictor Return the warm start predictor, empty pointer if none is set*/
+    WarmStartPredictorPtr getWarmStartPredictor(){return warm_start_predictor;}
+
+    /** @brief supportsWarmStart True if the solver uses the prediction of the warm start predictor (see setWarmStartPredictor())*/
+    virtual bool supportsWarmStart(){return false;}
+
+    /**
+     * @brief estimateActiveSet Estimate the active set of a single priority QP from its primal solution, e.g. for solvers that do not report their active set.
+     * An inequality constraint or bound is considered active if it is fulfilled with equality up to the given tolerance.
+     * @param qp The quadratic program
+     * @param x Primal solution of the QP
+     * @param tolerance Max. distance to the lower/upper bound of an active constraint
+     * @param constraints Status (see ActiveSetStatus) of each inequality constraint (nin x 1)
+     * @param bounds Status (see ActiveSetStatus) of each variable bound (nq x 1, or 0 x 1 if the QP is not bounded)
+     */
+    static void estimateActiveSet(const QuadraticProgram &qp, const base::VectorXd &x, const double tolerance, Eigen::VectorXi &constraints, Eigen::VectorXi &bounds);
+
+    /**
+     * @brief isFeasible Check if the given point fulfills all inequality constraints and bounds of a single priority QP. Equality constraints are not checked.
+     * @param qp The quadratic program
+     * @param x Point to check (nq x 1)
+     * @param tolerance Allowed violation of the lower/upper bounds
+     * @return True if no inequality constraint and no bound is violated by more than the tolerance
+     */
+    static bool isFeasible(const QuadraticProgram &qp, const base::VectorXd &x, const double tolerance);
 };
 
 typedef std::shared_ptr<QPSolver> QPSolverPtr;
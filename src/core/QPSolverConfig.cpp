@@ -0,0 +1,57 @@
+#include "QPSolverConfig.hpp"
+#include <fstream>
+#include <base-logging/Logging.hpp>
+
+namespace wbc{
+
+static std::string trim(const std::string &s){
+    const std::string whitespace = " \t\r";
+    size_t first = s.find_first_not_of(whitespace);
+    if(first == std::string::npos)
+        return "";
+    return s.substr(first, s.find_last_not_of(whitespace) - first + 1);
+}
+
+void QPSolverConfig::load(const std::string &filename){
+    std::ifstream fs(filename.c_str());
+    if(!fs.is_open()){
+        LOG_ERROR("Unable to open solver config file %s", filename.c_str());
+        throw std::runtime_error("Invalid solver config file");
+    }
+    type = "";
+    parameters.clear();
+    std::string line;
+    int line_no = 0;
+    while(std::getline(fs, line)){
+        line_no++;
+        line = trim(line);
+        if(line.empty() || line[0] == '#')
+            continue;
+        size_t sep = line.find(':');
+        std::string key = trim(line.substr(0, sep));
+        if(sep == std::string::npos || key.empty()){
+            LOG_ERROR("Invalid line %i in solver config file %s: '%s'. Expected 'key: value'", line_no, filename.c_str(), line.c_str());
+            throw std::runtime_error("Invalid solver config file");
+        }
+        std::string value = trim(line.substr(sep+1));
+        if(key == "type")
+            type = value;
+        else
+            parameters[key] = value;
+    }
+    file = filename;
+    validate();
+}
+
+void QPSolverConfig::save(const std::string &filename) const{
+    std::ofstream fs(filename.c_str());
+    if(!fs.is_open()){
+        LOG_ERROR("Unable to write solver config file %s", filename.c_str());
+        throw std::runtime_error("Invalid solver config file");
+    }
+    fs << "type: " << type << std::endl;
+    for(const auto &p : parameters)
+        fs << p.first << ": " << p.second << std::endl;
+}
+
+}
@@ -2,6 +2,8 @@
 #define QP_SOLVER_CONFIG_HPP
 
 #include <string>
+#include <map>
+#include <stdexcept>
 
 namespace wbc {
 
@@ -18,8 +20,19 @@ public:
         if(type.empty())
             throw std::runtime_error("Invalid solver config. Type must not be empty!");
     }
+    /**
+     * @brief load Load type and parameters from a solver config file, e.g., as generated by the solver tuner (wbc_solver_tuner). The file contains one "key: value"
+     * pair per line, the key "type" is the solver type, all other keys are solver parameters (see QPSolver::setParameter()). Lines starting with '#' are ignored.
+     * Sets the member file to the given file name. Throws if the file cannot be read or contains invalid lines.
+     */
+    void load(const std::string &filename);
+    /** @brief save Write type and parameters to the given file, in the format described in load()*/
+    void save(const std::string &filename) const;
+
     std::string type;
     std::string file;
+    /** Solver specific parameters, which are passed to QPSolver::setParameter(), see the documentation of the respective solver for valid names and values*/
+    std::map<std::string, std::string> parameters;
 };
 
 }
@@ -39,6 +39,24 @@ void QuadraticProgram::resize(const uint _nq, const uint _neq, const uint _nin,
     Wy.setOnes(neq+nin);
 }
 
+void QuadraticProgram::resizeEqualityOnly(const uint _nq, const uint _neq){
+    neq = _neq;
+    nin = 0;
+    nq = _nq;
+    bounded = false;
+
+    H.resize(0,0);
+    g.resize(0);
+    A.resize(neq, nq);
+    b.resize(neq);
+    C.resize(0, nq);
+    lower_y.resize(0);
+    upper_y.resize(0);
+    lower_x.resize(0);
+    upper_x.resize(0);
+    Wy.resize(neq);
+}
+
 void QuadraticProgram::check() const {
     if(bounded) {
         if(lower_x.size() != nq)
@@ -70,6 +88,8 @@ void QuadraticProgram::check() const {
             "but has size " +  std::to_string(A.rows()) + "x" + std::to_string(A.cols())<<std::endl;
     if(b.size() != neq)
             std::cout<<"Equality constraint vector b should have size " + std::to_string(neq) + "but has size " + std::to_string(b.size())<<std::endl;
+    if(isEqualityOnly())
+        return;
     if(H.rows() != nq || H.cols() != nq)
         std::cout<<"Hessian matrix H should have size " + std::to_string(nq) + "x" + std::to_string(nq) +
             "but has size " +  std::to_string(H.rows()) + "x" + std::to_string(H.cols())<<std::endl;
@@ -103,4 +123,14 @@ void QuadraticProgram::print() const {
     std::cout << Wy.transpose() << std::endl;
 }
 
+bool QuadraticProgram::isUnconstrained(const double inf) const{
+    if(!A.isZero(0) || !b.isZero(0))
+        return false;
+    if(nin > 0 && ((lower_y.array() > -inf).any() || (upper_y.array() < inf).any()))
+        return false;
+    if(bounded && ((lower_x.array() > -inf).any() || (upper_x.array() < inf).any()))
+        return false;
+    return true;
+}
+
 }
@@ -43,12 +43,24 @@ struct QuadraticProgram{
     /** Initialize all variables with NaN */
     void resize(uint nq, uint neq, uint nin, bool bounds);
 
+    /** Slim representation of an equality-only priority, as used by the hierarchical least squares solver: Resize only A, b and Wy. All other
+     *  matrices and vectors are empty. The cost function is implicitly given by the (weighted) minimum norm solution. A and b are not initialized and reallocation
+     *  only takes place if the size changes.*/
+    void resizeEqualityOnly(uint nq, uint neq);
+
+    /** Return true if this QP has the slim, equality-only representation, see resizeEqualityOnly()*/
+    bool isEqualityOnly() const {return nin == 0 && !bounded && H.size() == 0 && g.size() == 0;}
+
     /** Check if matrix and vectors dims match with nq, neq, nin. Throw exception if not **/
     void check() const;
 
     /** Print content to console*/
     void print() const;
 
+    /** Return true if the QP has no active constraints, i.e. all equality constraints are zero rows (A = 0, b = 0) and all inequality constraints
+     *  and bounds are inert (lower <= -inf, upper >= inf). Such a QP can be solved directly with a Cholesky decomposition of H*/
+    bool isUnconstrained(const double inf = 1e10) const;
+
 };
 
 /**
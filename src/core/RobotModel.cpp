@@ -13,7 +13,8 @@ std::vector<std::string> operator+(std::vector<std::string> a, std::vector<std::
 }
 
 RobotModel::RobotModel() :
-    gravity(base::Vector3d(0,0,-9.81)){
+    gravity(base::Vector3d(0,0,-9.81)),
+    inertia_factorization_valid(false){
 }
 
 void RobotModel::clear(){
@@ -32,6 +33,61 @@ void RobotModel::clear(){
     space_jac_map.clear();
     body_jac_map.clear();
     jac_dot_map.clear();
+    spatial_acc_bias_dq_map.clear();
+    inertia_factorization_valid = false;
+}
+
+const base::MatrixXd &RobotModel::spatialAccelerationBiasDerivative(const std::string &root_frame, const std::string &tip_frame){
+    throw std::runtime_error("Not implemented: spatialAccelerationBiasDerivative has not been implemented for this robot model");
+}
+
+void RobotModel::inverseDynamicsDerivatives(base::MatrixXd &dtau_dq, base::MatrixXd &dtau_dqd){
+    throw std::runtime_error("Not implemented: inverseDynamicsDerivatives has not been implemented for this robot model");
+}
+
+void RobotModel::forwardDynamicsDerivatives(const base::VectorXd &tau, base::MatrixXd &dqdd_dq, base::MatrixXd &dqdd_dqd, base::MatrixXd &dqdd_dtau){
+    throw std::runtime_error("Not implemented: forwardDynamicsDerivatives has not been implemented for this robot model");
+}
+
+void RobotModel::factorizeJointSpaceInertiaMatrix(){
+    inertia_llt.compute(jointSpaceInertiaMatrix());
+    if(inertia_llt.info() != Eigen::Success){
+        LOG_ERROR("RobotModel: Failed to factorize the joint space inertia matrix. Is the matrix positive definite?");
+        throw std::runtime_error("Invalid joint space inertia matrix");
+    }
+    inertia_factorization_valid = true;
+}
+
+void RobotModel::solveFactorizedInertia(Eigen::Ref<base::MatrixXd> B){
+    inertia_llt.solveInPlace(B);
+}
+
+void RobotModel::checkInertiaFactorization(){
+    if(joint_state.time.isNull()){
+        LOG_ERROR("RobotModel: You have to call update() with appropriately timestamped joint data at least once before requesting dynamic information!");
+        throw std::runtime_error("Invalid call to solveJointSpaceInertia()");
+    }
+    if(!inertia_factorization_valid)
+        factorizeJointSpaceInertiaMatrix();
+}
+
+void RobotModel::solveJointSpaceInertia(Eigen::Ref<base::MatrixXd> B){
+    if(B.rows() != (int)noOfJoints()){
+        LOG_ERROR("RobotModel: Number of rows of the right hand side is %i, but should be %i", (int)B.rows(), (int)noOfJoints());
+        throw std::invalid_argument("Invalid call to solveJointSpaceInertia()");
+    }
+    checkInertiaFactorization();
+    solveFactorizedInertia(B);
+}
+
+void RobotModel::inertiaInverseJacobianTranspose(const base::MatrixXd &J, base::MatrixXd &Minv_Jt){
+    Minv_Jt = J.transpose();
+    solveJointSpaceInertia(Minv_Jt);
+}
+
+void RobotModel::operationalSpaceInertiaInverse(const base::MatrixXd &J, base::MatrixXd &J_Minv_Jt){
+    inertiaInverseJacobianTranspose(J, Minv_Jt);
+    J_Minv_Jt.noalias() = J * Minv_Jt;
 }
 
 void RobotModel::setActiveContacts(const ActiveContacts &contacts){
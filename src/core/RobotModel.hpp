@@ -11,6 +11,7 @@
 #include <base/commands/Joints.hpp>
 #include "RobotModelConfig.hpp"
 #include <urdf_world/world.h>
+#include <Eigen/Cholesky>
 
 namespace wbc{
 
@@ -52,9 +53,23 @@ protected:
     JacobianMap space_jac_map;
     JacobianMap body_jac_map;
     JacobianMap jac_dot_map;
+    JacobianMap spatial_acc_bias_dq_map;
 
     // Helper
     base::samples::Joints joint_state_out;
+    base::MatrixXd Minv_Jt;
+
+    /** Dense factorization of the joint space inertia matrix (default implementation)*/
+    Eigen::LLT<base::MatrixXd> inertia_llt;
+    /** True if the factorization of the joint space inertia matrix belongs to the current robot state. Every robot model has to reset this flag in update()*/
+    bool inertia_factorization_valid;
+
+    /** @brief Solve M*X = B in place (B <- M^-1*B) using the current factorization of the joint space inertia matrix. Default implementation uses the dense
+      * Cholesky decomposition computed in factorizeJointSpaceInertiaMatrix(). Robot models that override factorizeJointSpaceInertiaMatrix() have to override this method as well*/
+    virtual void solveFactorizedInertia(Eigen::Ref<base::MatrixXd> B);
+
+    /** Factorize the joint space inertia matrix if the robot state has changed since the last factorization (see inertia_factorization_valid)*/
+    void checkInertiaFactorization();
 
 public:
     RobotModel();
@@ -129,6 +144,50 @@ public:
     /** @brief Compute and return the bias force vector, which is nj x 1, where nj is the number of joints of the system*/
     virtual const base::VectorXd &biasForces() = 0;
 
+    /** @brief Returns the partial derivative of the spatial acceleration bias (see spatialAccelerationBias()) w.r.t. the joint positions, i.e. \f$\partial(\dot{\mathbf{J}}\dot{\mathbf{q}})/\partial\mathbf{q}\f$.
+      * The first three rows correspond to the linear, the last three rows to the angular part. For floating base robots the derivative is taken w.r.t. the tangent space of the configuration.
+      * The default implementation throws, robot models that support it have to override this method.
+      * @param root_frame Root frame of the chain. Has to be a valid link in the robot model.
+      * @param tip_frame Tip frame of the chain. Has to be a valid link in the robot model.
+      * @return A 6xN matrix, where N is the number of robot joints
+      */
+    virtual const base::MatrixXd &spatialAccelerationBiasDerivative(const std::string &root_frame, const std::string &tip_frame);
+
+    /** @brief Compute the partial derivatives of the inverse dynamics \f$\tau = ID(\mathbf{q},\dot{\mathbf{q}},\ddot{\mathbf{q}})\f$ at the current robot state (including joint accelerations) w.r.t. the joint positions and velocities.
+      * The derivative w.r.t. the joint accelerations is the joint space inertia matrix. For floating base robots the derivative w.r.t. q is taken w.r.t. the tangent space of the configuration.
+      * The default implementation throws, robot models that support it have to override this method.
+      * @param dtau_dq Output: nj x nj matrix, where nj is the number of joints of the system
+      * @param dtau_dqd Output: nj x nj matrix, where nj is the number of joints of the system
+      */
+    virtual void inverseDynamicsDerivatives(base::MatrixXd &dtau_dq, base::MatrixXd &dtau_dqd);
+
+    /** @brief Compute the partial derivatives of the forward dynamics \f$\ddot{\mathbf{q}} = FD(\mathbf{q},\dot{\mathbf{q}},\tau)\f$ at the current joint positions and velocities and the given joint torques.
+      * For floating base robots the derivative w.r.t. q is taken w.r.t. the tangent space of the configuration.
+      * The default implementation throws, robot models that support it have to override this method.
+      * @param tau Joint torques, nj x 1. For floating base robots, the first 6 entries are the generalized forces acting on the floating base.
+      * @param dqdd_dq Output: nj x nj matrix, where nj is the number of joints of the system
+      * @param dqdd_dqd Output: nj x nj matrix, where nj is the number of joints of the system
+      * @param dqdd_dtau Output: nj x nj matrix, where nj is the number of joints of the system. This is the inverse of the joint space inertia matrix.
+      */
+    virtual void forwardDynamicsDerivatives(const base::VectorXd &tau, base::MatrixXd &dqdd_dq, base::MatrixXd &dqdd_dqd, base::MatrixXd &dqdd_dtau);
+
+    /** @brief Factorize the joint space inertia matrix M at the current robot state. The factorization is used by solveJointSpaceInertia(), inertiaInverseJacobianTranspose()
+      * and operationalSpaceInertiaInverse(), so that M^-1 is never computed explicitly. These methods factorize automatically if the time stamp of the robot state has changed
+      * since the last factorization. Call this method explicitly only if the robot state changes without a new time stamp.
+      * The default implementation computes a dense Cholesky decomposition of jointSpaceInertiaMatrix(), i.e., O(nj^3). Robot models may override it with a factorization that
+      * exploits the sparsity of M induced by the branches of the kinematic tree (see RobotModelPinocchio).
+      */
+    virtual void factorizeJointSpaceInertiaMatrix();
+
+    /** @brief Solve M*X = B in place, i.e., B <- M^-1*B, where M is the joint space inertia matrix. B is nj x k (or a vector of size nj)*/
+    void solveJointSpaceInertia(Eigen::Ref<base::MatrixXd> B);
+
+    /** @brief Compute M^-1*J^T for the given Jacobian J (m x nj), where M is the joint space inertia matrix. Result is nj x m*/
+    void inertiaInverseJacobianTranspose(const base::MatrixXd &J, base::MatrixXd &Minv_Jt);
+
+    /** @brief Compute J*M^-1*J^T for the given Jacobian J (m x nj), i.e., the inverse of the operational space inertia matrix of the task J. Result is m x m*/
+    void operationalSpaceInertiaInverse(const base::MatrixXd &J, base::MatrixXd &J_Minv_Jt);
+
     /** @brief Return all joint names*/
     const std::vector<std::string>& jointNames(){return joint_names;}
 
@@ -197,6 +256,9 @@ public:
     /** @brief Is floating base robot?*/
     bool hasFloatingBase(){return has_floating_base;}
 
+    /** @brief True if update() has been called at least once with a valid joint state*/
+    bool hasJointState(){return !joint_state.time.isNull();}
+
     /** @brief Load URDF model from either file or string*/
     urdf::ModelInterfaceSharedPtr loadRobotURDF(const std::string& file_or_string);
 
@@ -34,6 +34,24 @@ public:
     }
 };
 
+/**
+ * @brief Loop closure of a closed kinematic chain (parallel mechanism). The spanning tree of the mechanism is described in the URDF, the loop closure
+ * constrains the two given frames (valid links in the URDF) to coincide.
+ */
+class LoopClosure{
+public:
+    LoopClosure() : full_pose(false){
+
+    }
+    LoopClosure(const std::string& frame_a, const std::string& frame_b, const bool full_pose = false) :
+        frame_a(frame_a), frame_b(frame_b), full_pose(full_pose){
+
+    }
+    std::string frame_a; /** First frame of the loop closure*/
+    std::string frame_b; /** Second frame of the loop closure*/
+    bool full_pose;      /** If true, position and orientation of both frames are constrained (6D), otherwise only the position (3D, e.g. spherical joints)*/
+};
+
 /**
  * @brief Robot Model configuration class
  */
@@ -59,13 +77,15 @@ public:
             throw std::runtime_error("Invalid Robot model config. File path or string must not be empty!");
         if(type == "hyrodyn" && submechanism_file.empty())
             throw std::runtime_error("Invalid Robot model config. If you choose 'hyrodyn' as type, submechanism_file must not be empty!");
+        if(type == "pinocchio_hybrid" && submechanism_file.empty())
+            throw std::runtime_error("Invalid Robot model config. If you choose 'pinocchio_hybrid' as type, submechanism_file must not be empty!");
         if(floating_base && contact_points.empty())
             throw std::runtime_error("Invalid Robot model config. If floating_base is set to true, contact_points must not be empty!");
     }
 
     /** Absolute path to URDF file describing the robot model or URDF string.*/
     std::string file_or_string;
-    /** Only Hyrodyn models: Absolute path to submechanism file, which describes the kinematic structure including parallel mechanisms.*/
+    /** Only Hyrodyn and pinocchio_hybrid models: Absolute path to submechanism file, which describes the kinematic structure including parallel mechanisms.*/
     std::string submechanism_file;
     /** Model type. Must be the exact name of one of the registered robot model plugins. See src/robot_models for all available plugins. Default is pinocchio*/
     std::string type;
@@ -77,6 +97,12 @@ public:
     ActiveContacts contact_points;
 
     std::vector<std::string> joint_blacklist;
+    /** Optional: Joints that are locked at the given position (rad or m). Locked joints are set to fixed, like the joints in joint_blacklist, but at the given position instead of zero.
+      * They are removed from the model, i.e., they do not appear in the joint names, Jacobians, mass-inertia matrix, etc. Their mass is attached to the parent link.
+      * Supported by the pinocchio and rbdl models.*/
+    base::NamedVector<double> locked_joints;
+    /** Only pinocchio_hybrid models: Loop closures of the spanning tree given in file_or_string. The independent and active joints are read from submechanism_file.*/
+    std::vector<LoopClosure> loop_closures;
 };
 
 }
@@ -2,13 +2,17 @@
 #include <base-logging/Logging.hpp>
 #include "../tasks/JointTask.hpp"
 #include "../tasks/CartesianTask.hpp"
+#include "../tools/URDFTools.hpp"
+#include <algorithm>
 
 namespace wbc{
 
 Scene::Scene(RobotModelPtr robot_model, QPSolverPtr solver, const double dt) :
     robot_model(robot_model),
     solver(solver),
-    configured(false){
+    configured(false),
+    dt(dt),
+    auto_model_reduction(false){
 }
 
 Scene::~Scene(){
@@ -22,13 +26,21 @@ void Scene::clearTasks(){
         tasks[i].clear();
     }
     tasks.clear();
+    tasks_require_locked_joints.clear();
     tasks_status.clear();
     configured = false;
 }
 
-bool Scene::configure(const std::vector<TaskConfig> &config){
+ConstraintPtr Scene::createConstraint(const ConstraintConfig &config){
+    LOG_ERROR("Constraint type %i is not supported by this scene", config.type);
+    throw std::invalid_argument("Invalid constraint config");
+}
+
+bool Scene::configure(const std::vector<TaskConfig> &config, const std::vector<ConstraintConfig> &_constraint_config){
 
-    solver->reset();
+    // Scenes that do not set up a QP (e.g. OperationalSpaceScene) may be created without solver
+    if(solver)
+        solver->reset();
     clearTasks();
     if(config.empty()){
         LOG_ERROR("Empty WBC Task configuration");
@@ -40,25 +52,53 @@ bool Scene::configure(const std::vector<TaskConfig> &config){
     std::vector< std::vector<TaskConfig> > sorted_config;
     sortTaskConfig(config, sorted_config);
 
+    //// Lock the joints that are not required by any active task. This changes the number of robot joints, so it has to be done before creating the tasks
+    ///
+    if(auto_model_reduction || !locked_joints.empty()){
+        if(!reduceRobotModel(config))
+            return false;
+    }
+
     //// Create tasks. Store the number of task variables per priority
     ///
     tasks.resize(sorted_config.size());
+    tasks_require_locked_joints.resize(sorted_config.size());
     for(size_t i = 0; i < sorted_config.size(); i++){
 
         tasks[i].resize(sorted_config[i].size());
-        for(size_t j = 0; j < sorted_config[i].size(); j++)
+        tasks_require_locked_joints[i].resize(sorted_config[i].size());
+        for(size_t j = 0; j < sorted_config[i].size(); j++){
             tasks[i][j] = createTask(sorted_config[i][j]);
+            // The locked joints only change in configure(), so this does not have to be evaluated in every cycle
+            tasks_require_locked_joints[i][j] = requiresLockedJoints(sorted_config[i][j]);
+        }
     }
     n_task_variables_per_prio = getNTaskVariablesPerPrio(config);
 
     for(size_t i = 0; i < tasks.size(); i++){
         for(size_t j = 0; j < tasks[i].size(); j++){
-            TaskPtr task = tasks[i][j];
+            const TaskPtr& task = tasks[i][j];
             tasks_status.names.push_back(task->config.name);
             tasks_status.elements.push_back(TaskStatus());
         }
     }
 
+    //// Create constraints. Use the default constraints of the scene if no constraint configuration is given
+    ///
+    constraint_config = _constraint_config.empty() ? default_constraint_config : _constraint_config;
+    constraints.clear();
+    constraints.resize(1);
+    for(const ConstraintConfig& c : constraint_config){
+        try{
+            c.validate();
+            constraints[0].push_back(createConstraint(c));
+        }
+        catch(std::invalid_argument e){
+            LOG_ERROR("Failed to create constraint of type %i: %s", c.type, e.what());
+            return false;
+        }
+    }
+
     hqp.resize(tasks.size());
     configured = true;
 
@@ -120,7 +160,156 @@ void Scene::setTaskWeights(const std::string& constraint_name, const base::Vecto
 }
 
 void Scene::setTaskActivation(const std::string& constraint_name, const double activation){
-    getTask(constraint_name)->setActivation(activation);
+    TaskPtr task = getTask(constraint_name);
+    const bool was_active = task->activation > 0;
+    task->setActivation(activation);
+    if(auto_model_reduction && !was_active && activation > 0 && requiresLockedJoints(task->config))
+        reconfigure();
+}
+
+std::vector<std::string> Scene::requiredJoints(const TaskConfig &config){
+    if(config.type == jnt)
+        return config.joint_names;
+    else if(config.type == cart){
+        // Virtual links, e.g. the world frame of floating base robots, are not part of the URDF. Use the URDF root instead
+        const std::string root = robot_urdf->getLink(config.root) ? config.root : robot_urdf->getRoot()->name;
+        const std::string tip = robot_urdf->getLink(config.tip) ? config.tip : robot_urdf->getRoot()->name;
+        return URDFTools::jointNamesOnChain(robot_urdf, root, tip);
+    }
+    else
+        return URDFTools::jointNamesFromURDF(robot_urdf);
+}
+
+bool Scene::requiresLockedJoints(const TaskConfig &config){
+    if(locked_joints.empty())
+        return false;
+    for(const std::string& name : requiredJoints(config)){
+        if(std::find(locked_joints.begin(), locked_joints.end(), name) != locked_joints.end())
+            return true;
+    }
+    return false;
+}
+
+bool Scene::reduceRobotModel(const std::vector<TaskConfig> &config){
+
+    RobotModelConfig model_config = robot_model->getRobotModelConfig();
+    robot_urdf = robot_model->loadRobotURDF(model_config.file_or_string);
+    if(!robot_urdf){
+        LOG_ERROR("Automatic model reduction: Unable to parse urdf model");
+        return false;
+    }
+
+    // Candidates: All joints of the robot model except the floating base, including the joints that are currently locked by the scene
+    std::vector<std::string> candidates = robot_model->actuatedJointNames() + locked_joints;
+    std::vector<std::string> required;
+    if(auto_model_reduction){
+        for(const TaskConfig& cfg : config){
+            if(cfg.activation > 0)
+                required = required + requiredJoints(cfg);
+        }
+        for(const std::string& contact : robot_model->getActiveContacts().names)
+            required = required + URDFTools::jointNamesOnChain(robot_urdf, robot_urdf->getRoot()->name, contact);
+    }
+    else
+        required = candidates;
+
+    std::vector<std::string> new_locked_joints;
+    for(const std::string& name : candidates){
+        if(std::find(required.begin(), required.end(), name) == required.end())
+            new_locked_joints.push_back(name);
+    }
+    std::sort(new_locked_joints.begin(), new_locked_joints.end());
+    if(new_locked_joints == locked_joints)
+        return true;
+
+    // The current robot state is used to lock the joints and to restore the state after reconfiguring the robot model
+    const bool has_state = robot_model->hasJointState();
+    base::samples::Joints joint_state;
+    base::samples::RigidBodyStateSE3 floating_base_state = robot_model->floatingBaseState();
+    if(has_state)
+        joint_state = robot_model->jointState(robot_model->jointNames());
+
+    // Joints that have been locked by the user remain locked. Joints that remain locked by the scene keep their position.
+    // Joints that are unlocked start at the position where they have been locked
+    base::NamedVector<double> locks;
+    for(size_t i = 0; i < model_config.locked_joints.size(); i++){
+        const std::string& name = model_config.locked_joints.names[i];
+        const double position = model_config.locked_joints.elements[i];
+        const bool locked_by_scene = std::find(locked_joints.begin(), locked_joints.end(), name) != locked_joints.end();
+        const bool remains_locked = std::find(new_locked_joints.begin(), new_locked_joints.end(), name) != new_locked_joints.end();
+        if(!locked_by_scene || remains_locked){
+            locks.names.push_back(name);
+            locks.elements.push_back(position);
+        }
+        else if(has_state){
+            base::JointState state;
+            state.position = position;
+            state.speed = state.acceleration = 0;
+            joint_state.names.push_back(name);
+            joint_state.elements.push_back(state);
+        }
+    }
+
+    // Newly locked joints are locked at their current position
+    for(const std::string& name : new_locked_joints){
+        if(std::find(locked_joints.begin(), locked_joints.end(), name) != locked_joints.end())
+            continue;
+        if(!has_state){
+            LOG_ERROR("Automatic model reduction: Joint %s has to be locked at its current position, but the robot model has not been updated yet", name.c_str());
+            return false;
+        }
+        locks.names.push_back(name);
+        locks.elements.push_back(joint_state[name].position);
+    }
+
+    model_config.locked_joints = locks;
+    if(!robot_model->configure(model_config)){
+        LOG_ERROR("Automatic model reduction: Failed to reconfigure robot model");
+        return false;
+    }
+    for(const std::string& name : new_locked_joints){
+        if(robot_model->hasJoint(name)){
+            LOG_ERROR("Automatic model reduction: Joint %s has been locked, but it is still in the robot model. Does the robot model type %s support locked joints?",
+                      name.c_str(), model_config.type.c_str());
+            return false;
+        }
+    }
+    locked_joints = new_locked_joints;
+    if(has_state)
+        robot_model->update(joint_state, floating_base_state);
+
+    LOG_INFO("Automatic model reduction: %i joints locked, robot model has %i joints", (int)locked_joints.size(), robot_model->noOfJoints());
+    return true;
+}
+
+void Scene::reconfigure(){
+
+    // configure() creates new tasks, so their runtime state has to be copied
+    std::vector<TaskPtr> old_tasks;
+    for(const auto& prio : tasks)
+        old_tasks.insert(old_tasks.end(), prio.begin(), prio.end());
+    JointWeights old_joint_weights = joint_weights;
+
+    std::vector<TaskConfig> config = wbc_config;
+    for(TaskConfig& cfg : config)
+        cfg.activation = getTask(cfg.name)->activation;
+    if(!configure(config, constraint_config))
+        throw std::runtime_error("Failed to reconfigure scene");
+
+    for(const TaskPtr& old_task : old_tasks){
+        TaskPtr task = getTask(old_task->config.name);
+        task->y_ref = old_task->y_ref;
+        task->time = old_task->time;
+        task->weights = old_task->weights;
+        task->activation = old_task->activation;
+        task->timeout = old_task->timeout;
+    }
+    for(size_t i = 0; i < old_joint_weights.size(); i++){
+        if(robot_model->hasJoint(old_joint_weights.names[i]))
+            joint_weights[old_joint_weights.names[i]] = old_joint_weights[i];
+    }
+    for(auto n : actuated_joint_weights.names)
+        actuated_joint_weights[n] = joint_weights[n];
 }
 
 TaskPtr Scene::getTask(const std::string& name){
@@ -7,6 +7,7 @@
 #include "RobotModel.hpp"
 #include "QPSolver.hpp"
 #include "SceneConfig.hpp"
+#include "ConstraintConfig.hpp"
 
 namespace wbc{
 
@@ -26,27 +27,91 @@ protected:
     base::commands::Joints solver_output_joints;
     JointWeights joint_weights, actuated_joint_weights;
     std::vector<TaskConfig> wbc_config;
+    std::vector<ConstraintConfig> constraint_config, default_constraint_config;
     base::VectorXd solver_output;
+    base::samples::Wrenches contact_wrenches;
+    double dt;
+    bool auto_model_reduction;
+    std::vector<std::string> locked_joints;
+    /** True for each task (same indexing as tasks) that requires joints locked by the automatic model reduction. Computed in configure()*/
+    std::vector< std::vector<bool> > tasks_require_locked_joints;
+    urdf::ModelInterfaceSharedPtr robot_urdf;
 
     /**
      * brief Create a task and add it to the WBC scene
      */
     virtual TaskPtr createTask(const TaskConfig &config) = 0;
 
+    /**
+     * @brief Create a constraint. The default implementation throws, i.e., the scene does not support constraints.
+     */
+    virtual ConstraintPtr createConstraint(const ConstraintConfig &config);
+
     /**
      * @brief Delete all tasks and free memory
      */
     void clearTasks();
 
+    /**
+     * @brief Return the joints that are required by the given task, i.e., the joints of a joint task, the joints on the kinematic chain of a Cartesian task
+     * and all joints for a CoM task
+     */
+    std::vector<std::string> requiredJoints(const TaskConfig &config);
+
+    /**
+     * @brief Return true if the given task requires any of the joints that have been locked by the automatic model reduction
+     */
+    bool requiresLockedJoints(const TaskConfig &config);
+
+    /**
+     * @brief Lock all joints of the robot model that are not required by any active task (activation > 0) or any contact point at their current position.
+     * If automatic model reduction is disabled, unlock all joints that have been locked by the scene. Reconfigure the robot model only if the set of locked joints changes.
+     */
+    bool reduceRobotModel(const std::vector<TaskConfig> &config);
+
+    /**
+     * @brief Reconfigure the scene with the current task activations, e.g. after a task that requires locked joints has been activated. The task references,
+     * weights and activations as well as the joint weights are kept. Not real-time safe: The URDF is parsed again, the robot model is reconfigured, all tasks
+     * and constraints are re-created and the solver has to set up its problem again at the next call to solve().
+     */
+    void reconfigure();
+
 public:
     Scene(RobotModelPtr robot_model, QPSolverPtr solver, const double dt);
     ~Scene();
 
     /**
-     * @brief Configure the WBC scene. Create tasks and sort them by priority
+     * @brief Configure the WBC scene. Create tasks and sort them by priority. Create the constraints.
      * @param config configuration. Size has to be > 0. All tasks have to be valid. See TaskConfig.hpp for more details.
+     * @param _constraint_config Constraints of the scene, in the order in which they will be added to the optimization problem.
+     * If empty, the default constraints of the scene will be used. See ConstraintConfig.hpp for more details.
      */
-    virtual bool configure(const std::vector<TaskConfig> &config);
+    virtual bool configure(const std::vector<TaskConfig> &config, const std::vector<ConstraintConfig> &_constraint_config = std::vector<ConstraintConfig>());
+
+    /**
+     * @brief Enable/disable automatic model reduction. If enabled, configure() locks all joints of the robot model that are not referenced by any active task
+     * (activation > 0) or contact point at their current position (see RobotModelConfig::locked_joints), so that the number of joints and thus the size of the optimization problem shrinks.
+     * The robot model has to be updated with a valid joint state before calling configure(). If a task that requires locked joints is activated via setTaskActivation(),
+     * the joints are unlocked and the scene is reconfigured, which is not real-time safe (see reconfigure()). To avoid this in the control loop, configure the scene with
+     * all tasks that may be activated at runtime having activation > 0 and deactivate them afterwards. Locked joints are not part of the solver output, their position
+     * has to be held by the caller. Default is false.
+     */
+    void setAutoModelReduction(const bool enable){auto_model_reduction = enable;}
+
+    /**
+     * @brief Return true if automatic model reduction is enabled
+     */
+    bool getAutoModelReduction() const { return auto_model_reduction; }
+
+    /**
+     * @brief Return the joints that have been locked by the automatic model reduction
+     */
+    const std::vector<std::string>& getLockedJoints() const { return locked_joints; }
+
+    /**
+     * @brief Return the current constraint configuration
+     */
+    const std::vector<ConstraintConfig>& getConstraintConfig() const { return constraint_config; }
 
     /**
      * @brief Update the wbc scene and return the (updated) optimization problem
@@ -81,7 +146,8 @@ public:
      */
     void setTaskWeights(const std::string& task_name, const base::VectorXd &weights);
     /**
-     * @brief Set Task activation for a  task
+     * @brief Set Task activation for a  task. If automatic model reduction is enabled and the task requires locked joints, the joints are unlocked
+     * and the scene is reconfigured (see setAutoModelReduction()). In this case the call is not real-time safe, see reconfigure().
      * @param task_name Name of the task
      * @param activation Activation value. Has to be in interval [0.0Scene,1.0]
      */
@@ -136,6 +202,11 @@ public:
      */
     const base::VectorXd& getSolverOutputRaw() const { return solver_output; }
 
+    /**
+     * @brief Get the contact wrenches estimated in the last call of solve(). Empty for scenes that do not compute contact wrenches
+     */
+    virtual const base::samples::Wrenches& getContactWrenches(){return contact_wrenches;}
+
     /**
      * @brief set Joint weights by given name
      */
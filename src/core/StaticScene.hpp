@@ -0,0 +1,202 @@
+#ifndef STATIC_SCENE_HPP
+#define STATIC_SCENE_HPP
+
+#include "FixedSizeTaskCost.hpp"
+#include "Constraint.hpp"
+#include "QPSolver.hpp"
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+namespace wbc{
+
+/** List of task types of a StaticScene, e.g. TaskList<CartesianVelocityTask, JointVelocityTask>*/
+template<typename... T> struct TaskList{};
+
+/** List of constraint types of a StaticScene, e.g. ConstraintList<ContactsVelocityConstraint, JointLimitsVelocityConstraint>*/
+template<typename... C> struct ConstraintList{};
+
+template<int NV, int NQ, typename Tasks, typename Constraints> class StaticScene;
+
+/**
+ * @brief Scene whose tasks and constraints are fixed at compile time. Meant for fixed production configurations, where the flexibility of the Scene
+ * class is not required. In contrast to Scene:
+ *   - Tasks and constraints are stored by value in a std::tuple, not as shared pointers in std::vectors.
+ *   - The update() methods of the tasks and constraints are called without virtual dispatch (qualified calls on the concrete types).
+ *   - The task cost is accumulated using fixed size Eigen types (see FixedSizeTaskCost), so the block sizes of all products are known at compile time.
+ *
+ * The scene sets up a single priority QP with NQ variables. The first NV variables (number of robot joints, including floating base) are the joint space
+ * variables that the tasks refer to, e.g. joint velocities or accelerations. Additional variables (NQ > NV), e.g. joint torques and contact wrenches, are only
+ * affected by the constraints. The constraints are added to the QP in the order of the ConstraintList. Example, same as VelocitySceneQP for a 7 dof arm:
+ * \code
+ *     typedef StaticScene<7, 7, TaskList<CartesianVelocityTask>, ConstraintList<JointLimitsVelocityConstraint>> MyScene;
+ *     MyScene scene(robot_model, solver, std::make_tuple(CartesianVelocityTask(cfg, 7)), std::make_tuple(JointLimitsVelocityConstraint(dt)));
+ *     scene.getTask<0>().setReference(ref);
+ *     scene.solve(scene.update());
+ * \endcode
+ * The scene is not registered in the SceneFactory. The dynamic Scene API remains available for all other use cases.
+ */
+template<int NV, int NQ, typename... Tasks, typename... Constraints>
+class StaticScene<NV, NQ, TaskList<Tasks...>, ConstraintList<Constraints...>>{
+    static_assert(NQ >= NV, "Number of QP variables has to be greater or equal to the number of joints");
+    static_assert(sizeof...(Tasks) > 0, "StaticScene requires at least one task");
+
+public:
+    typedef std::tuple<Tasks...> TaskTuple;
+    typedef std::tuple<Constraints...> ConstraintTuple;
+
+    /**
+     * @param robot_model Robot model. Number of joints has to be NV
+     * @param solver QP solver
+     * @param tasks Tasks of the scene
+     * @param constraints Constraints of the scene
+     */
+    StaticScene(RobotModelPtr robot_model, QPSolverPtr solver, const TaskTuple& tasks, const ConstraintTuple& constraints = ConstraintTuple()) :
+        robot_model(robot_model),
+        solver(solver),
+        tasks(tasks),
+        constraints(constraints),
+        hessian_regularizer(1e-8){
+
+        if(robot_model->noOfJoints() != NV){
+            LOG_ERROR("StaticScene has been instantiated for %i joints, but robot model has %i joints", NV, robot_model->noOfJoints());
+            throw std::invalid_argument("Invalid robot model size");
+        }
+        joint_weights.resize(NV);
+        joint_weights.names = robot_model->jointNames();
+        std::fill(joint_weights.elements.begin(), joint_weights.elements.end(), 1);
+        hqp.resize(1);
+        hqp[0].resize(NQ, 0, 0, false);
+        solver_output.setZero(NQ);
+    }
+
+    /** Return the I-th task*/
+    template<size_t I> typename std::tuple_element<I, TaskTuple>::type& getTask(){return std::get<I>(tasks);}
+
+    /** Return the I-th constraint*/
+    template<size_t I> typename std::tuple_element<I, ConstraintTuple>::type& getConstraint(){return std::get<I>(constraints);}
+
+    /**
+     * @brief Update all constraints and tasks and set up the QP
+     * @return Hierarchical quadratic program with a single priority (solver input)
+     */
+    const HierarchicalQP& update(){
+
+        ///////// Constraints
+
+        uint neq = 0, nin = 0;
+        bool bounded = false;
+        forEach(constraints, [&](auto& constraint){
+            typedef typename std::decay<decltype(constraint)>::type C;
+            constraint.C::update(robot_model);
+            if(constraint.type() == Constraint::equality)
+                neq += constraint.size();
+            else if(constraint.type() == Constraint::inequality)
+                nin += constraint.size();
+            else
+                bounded = true;
+        });
+
+        // Reallocate only if the number of constraints changes, e.g. due to contact switches
+        QuadraticProgram& qp = hqp[0];
+        if(qp.neq != (int)neq || qp.nin != (int)nin || qp.bounded != bounded)
+            qp.resize(NQ, neq, nin, bounded);
+
+        neq = nin = 0;
+        forEach(constraints, [&](auto& constraint){
+            const uint n = constraint.size();
+            if(constraint.type() == Constraint::equality){
+                qp.A.middleRows(neq, n) = constraint.A();
+                qp.b.segment(neq, n) = constraint.b();
+                neq += n;
+            }
+            else if(constraint.type() == Constraint::inequality){
+                qp.C.middleRows(nin, n) = constraint.A();
+                qp.lower_y.segment(nin, n) = constraint.lb();
+                qp.upper_y.segment(nin, n) = constraint.ub();
+                nin += n;
+            }
+            else{
+                qp.lower_x = constraint.lb();
+                qp.upper_x = constraint.ub();
+            }
+        });
+
+        ///////// Tasks
+
+        task_cost.reset(robot_model, joint_weights);
+        forEach(tasks, [&](auto& task){
+            typedef typename std::decay<decltype(task)>::type T;
+            task.checkTimeout();
+            if(task.checkInactive())
+                return;
+            task.T::update(robot_model);
+            task_cost.add(task);
+        });
+
+        qp.H.setZero();
+        qp.g.setZero();
+        qp.H.template topLeftCorner<NV,NV>() = task_cost.H;
+        qp.H.template topLeftCorner<NV,NV>().diagonal().array() += hessian_regularizer;
+        qp.H.diagonal().template tail<NQ-NV>().array() += hessian_regularizer;
+        qp.g.template head<NV>() = task_cost.g;
+
+        hqp.Wq = base::VectorXd::Map(joint_weights.elements.data(), NV);
+        hqp.time = base::Time::now();
+        return hqp;
+    }
+
+    /**
+     * @brief Solve the given optimization problem
+     * @return Raw solver output (NQ x 1). The first NV entries are the joint space variables, in the order of the joints in the robot model
+     */
+    const base::VectorXd& solve(const HierarchicalQP& hqp){
+        solver->solve(hqp, solver_output);
+        return solver_output;
+    }
+
+    /** Set the joint weights by name. Default is 1 for all joints*/
+    void setJointWeights(const JointWeights& weights){
+        for(uint i = 0; i < weights.size(); i++)
+            joint_weights[weights.names[i]] = weights[i];
+    }
+
+    /** Return the joint weights*/
+    const JointWeights& getJointWeights() const {return joint_weights;}
+
+    /** Set the regularization term that is added to the diagonal of the Hessian. Default is 1e-8*/
+    void setHessianRegularizer(const double reg){hessian_regularizer = reg;}
+
+    /** Return the current QP*/
+    const HierarchicalQP& getHierarchicalQP() const {return hqp;}
+
+    /** Return the raw solver output of the last call to solve()*/
+    const base::VectorXd& getSolverOutputRaw() const {return solver_output;}
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+protected:
+    template<typename Tuple, typename F, size_t... I>
+    static void forEach(Tuple& tuple, F&& f, std::index_sequence<I...>){
+        int expand[] = {0, (f(std::get<I>(tuple)), 0)...};
+        (void)expand;
+    }
+    template<typename Tuple, typename F>
+    static void forEach(Tuple& tuple, F&& f){
+        forEach(tuple, std::forward<F>(f), std::make_index_sequence<std::tuple_size<Tuple>::value>());
+    }
+
+    RobotModelPtr robot_model;
+    QPSolverPtr solver;
+    TaskTuple tasks;
+    ConstraintTuple constraints;
+    FixedSizeTaskCost<NV> task_cost;
+    JointWeights joint_weights;
+    HierarchicalQP hqp;
+    base::VectorXd solver_output;
+    double hessian_regularizer;
+};
+
+} // namespace wbc
+
+#endif
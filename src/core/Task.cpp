@@ -4,12 +4,14 @@
 
 namespace wbc{
 
-Task::Task(){
+Task::Task() :
+    rows_pruned(false){
 
 }
 
 Task::Task(const TaskConfig& _config, uint n_robot_joints) :
-    config(_config){
+    config(_config),
+    rows_pruned(false){
 
     unsigned int no_variables = config.nVariables();
 
@@ -20,6 +22,7 @@ Task::Task(const TaskConfig& _config, uint n_robot_joints) :
 
     A.resize(no_variables, n_robot_joints);
     Aw.resize(no_variables, n_robot_joints);
+    active_rows.reserve(no_variables);
     reset();
 }
 
@@ -42,6 +45,7 @@ void Task::reset(){
     }
     // Reset timeout and time. Like this, tasks can get activated only after they received a reference value
     timeout = 1;
+    inactive = false;
     time.microseconds = 0;
 }
 
@@ -51,6 +55,45 @@ void Task::checkTimeout(){
         timeout = (int)(base::Time::now() - time).toSeconds() > config.timeout;
 }
 
+bool Task::checkInactive(){
+
+    // If the activation value is zero, also set reference to zero. Activation is usually used to switch between different
+    // task phases and we don't want to store the "old" reference value, in case we switch on the task again
+    if(activation == 0){
+       y_ref.setZero();
+       y_ref_root.setZero();
+    }
+
+    bool was_inactive = inactive;
+    inactive = activation == 0 || timeout;
+    if(inactive && !was_inactive)
+        Aw.setZero();
+    return inactive;
+}
+
+uint Task::updateActiveRows(){
+    active_rows.clear();
+    for(uint i = 0; i < weights_root.size(); i++)
+        if(weights_root(i) != 0)
+            active_rows.push_back(i);
+    return active_rows.size();
+}
+
+uint Task::pruneRows(){
+    uint n_rows = updateActiveRows();
+    // Common case: No row has zero weight, so Aw and y_ref_root can be used directly
+    rows_pruned = (int)n_rows < Aw.rows();
+    if(!rows_pruned)
+        return n_rows;
+    Aw_pruned.resize(n_rows, Aw.cols());
+    y_ref_pruned.resize(n_rows);
+    for(uint i = 0; i < n_rows; i++){
+        Aw_pruned.row(i) = Aw.row(active_rows[i]);
+        y_ref_pruned(i) = y_ref_root(active_rows[i]);
+    }
+    return n_rows;
+}
+
 void Task::setWeights(const base::VectorXd& weights){
     if(config.nVariables() != weights.size()){
         LOG_ERROR("Task %s: Size of weight vector should be %i but is %i", config.name.c_str(), config.nVariables(), weights.size())
@@ -31,7 +31,7 @@ public:
     /**
      * @brief Update Task matrices and vectors
      */
-    virtual void update(RobotModelPtr robot_model) = 0;
+    virtual void update(const RobotModelPtr& robot_model) = 0;
 
     /**
      * @brief Check if the task is in timeout and set the timeout flag accordingly. A task is in timeout if
@@ -40,6 +40,34 @@ public:
      */
     void checkTimeout();
 
+    /**
+     * @brief Check if the task is inactive and set the inactive flag accordingly. A task is inactive if its activation is zero or if it is in timeout (call checkTimeout() before).
+     * Inactive tasks do not contribute to the optimization problem, so the scenes skip updating them, i.e., A and y_ref_root will not be updated and Aw will be zero.
+     * If the activation is zero, the reference values are also set to zero.
+     * @return True if the task is inactive
+     */
+    bool checkInactive();
+
+    /**
+     * @brief Collect the indices of all task variables with non-zero weight in root coordinates (weights_root) in active_rows.
+     * Rows with zero weight do not contribute to the optimization problem and can be pruned by the scenes.
+     * @return Number of active rows
+     */
+    uint updateActiveRows();
+
+    /**
+     * @brief Update active_rows (see updateActiveRows()) and copy the corresponding rows of Aw and y_ref_root to Aw_pruned and y_ref_pruned.
+     * If all rows are active, nothing is copied. Call this after Aw and y_ref_root have been computed and use activeAw() and activeYRef() afterwards.
+     * @return Number of active rows
+     */
+    uint pruneRows();
+
+    /** Weighted task matrix containing only the active rows after pruneRows(): Aw_pruned if rows have been pruned, otherwise Aw*/
+    const base::MatrixXd& activeAw() const {return rows_pruned ? Aw_pruned : Aw;}
+
+    /** Weighted reference in root coordinates containing only the active rows after pruneRows(): y_ref_pruned if rows have been pruned, otherwise y_ref_root*/
+    const base::VectorXd& activeYRef() const {return rows_pruned ? y_ref_pruned : y_ref_root;}
+
     /**
      * @brief Set task weights.
      * @param weights Weight vector. Size has to be same as number of task variables and all entries have to be >= 0
@@ -82,11 +110,26 @@ public:
      *  config.timeout time, this value will be set to zero*/
     int timeout;
 
+    /** True if the task has been skipped in the last update of the scene, since its activation is zero or it is in timeout. See checkInactive()*/
+    bool inactive;
+
     /** Task matrix */
     base::MatrixXd A;
 
     /** Weighted task matrix */
     base::MatrixXd Aw;
+
+    /** Indices of the task variables with non-zero weight in root coordinates. See updateActiveRows()*/
+    std::vector<uint> active_rows;
+
+    /** Weighted task matrix, containing only the active rows. See pruneRows()*/
+    base::MatrixXd Aw_pruned;
+
+    /** Weighted reference in root coordinates, containing only the active rows. See pruneRows()*/
+    base::VectorXd y_ref_pruned;
+
+    /** True if rows have been pruned in the last call of pruneRows(), i.e., Aw_pruned and y_ref_pruned are valid*/
+    bool rows_pruned;
 };
 
 
@@ -0,0 +1,68 @@
+#include "WarmStartPredictor.hpp"
+#include "QuadraticProgram.hpp"
+
+namespace wbc{
+
+void WarmStart::clear(){
+    x.resize(0);
+    y_eq.resize(0);
+    y_in.resize(0);
+    y_bounds.resize(0);
+    active_constraints.resize(0);
+    active_bounds.resize(0);
+}
+
+void WarmStart::validate(const QuadraticProgram &qp){
+    if(x.size() != qp.nq)
+        x.resize(0);
+    if(y_eq.size() != qp.neq)
+        y_eq.resize(0);
+    if(y_in.size() != qp.nin)
+        y_in.resize(0);
+    if(y_bounds.size() != qp.nq)
+        y_bounds.resize(0);
+    const int n_bounds = qp.bounded ? qp.nq : 0;
+    if(active_constraints.size() != qp.nin)
+        active_constraints.resize(0);
+    if(active_bounds.size() != n_bounds)
+        active_bounds.resize(0);
+    if(active_constraints.size() > 0 && active_bounds.size() == 0)
+        active_bounds.setZero(n_bounds);
+    else if(active_bounds.size() > 0 && active_constraints.size() == 0)
+        active_constraints.setZero(qp.nin);
+}
+
+bool WarmStart::hasDual(const QuadraticProgram &qp) const{
+    if(qp.neq == 0 && qp.nin == 0 && !qp.bounded)
+        return false;
+    return y_eq.size() == qp.neq && y_in.size() == qp.nin && (!qp.bounded || y_bounds.size() == qp.nq);
+}
+
+bool WarmStart::hasActiveSet(const QuadraticProgram &qp) const{
+    if(qp.nin == 0 && !qp.bounded)
+        return false;
+    return active_constraints.size() == qp.nin && active_bounds.size() == (qp.bounded ? qp.nq : 0);
+}
+
+ExtrapolationPredictor::ExtrapolationPredictor() :
+    n_solutions(0){
+}
+
+bool ExtrapolationPredictor::predict(const HierarchicalQP &hierarchical_qp, WarmStart &warm_start){
+    if(n_solutions == 0 || hierarchical_qp.size() != 1 || last.x.size() != hierarchical_qp[0].nq)
+        return false;
+    warm_start.x = last.x;
+    if(n_solutions > 1 && x_prev.size() == last.x.size())
+        warm_start.x += last.x - x_prev;
+    warm_start.active_constraints = last.active_constraints;
+    warm_start.active_bounds = last.active_bounds;
+    return true;
+}
+
+void ExtrapolationPredictor::update(const HierarchicalQP &hierarchical_qp, const WarmStart &solution){
+    x_prev = last.x;
+    last = solution;
+    n_solutions++;
+}
+
+}
@@ -0,0 +1,94 @@
+#ifndef WBC_CORE_WARM_START_PREDICTOR_HPP
+#define WBC_CORE_WARM_START_PREDICTOR_HPP
+
+#include <base/Eigen.hpp>
+#include <memory>
+
+namespace wbc{
+
+class HierarchicalQP;
+class QuadraticProgram;
+
+/**
+ * @brief Initial guess for the solution of a single priority QP, as provided by a WarmStartPredictor. All entries are optional, i.e., have size zero if not
+ * available. The multipliers follow the convention \f$\mathbf{Hx} + \mathbf{g} + \mathbf{A}^T\mathbf{y}_{eq} + \mathbf{C}^T\mathbf{y}_{in} + \mathbf{y}_{bounds} = 0\f$, i.e.,
+ * the multiplier of an inequality constraint or bound is >= 0 if it is active at its upper bound and <= 0 if it is active at its lower bound. The active set
+ * is given as ActiveSetStatus per constraint/bound (see QPSolver::getActiveSet()).
+ */
+struct WarmStart{
+    base::VectorXd x;                     /** Primal solution (nq x 1)*/
+    base::VectorXd y_eq;                  /** Multipliers of the equality constraints (neq x 1)*/
+    base::VectorXd y_in;                  /** Multipliers of the inequality constraints (nin x 1)*/
+    base::VectorXd y_bounds;              /** Multipliers of the bounds (nq x 1)*/
+    Eigen::VectorXi active_constraints;   /** Status of the inequality constraints (nin x 1)*/
+    Eigen::VectorXi active_bounds;        /** Status of the bounds (nq x 1)*/
+
+    /** Remove all entries*/
+    void clear();
+
+    /** Remove all entries whose size does not match the given QP. If only one part of the active set (constraints or bounds) is given, the other part is set to inactive*/
+    void validate(const QuadraticProgram &qp);
+
+    /** True if the primal guess is available*/
+    bool hasPrimal() const {return x.size() > 0;}
+
+    /** True if the QP has constraints or bounds and the multipliers of all of them are available*/
+    bool hasDual(const QuadraticProgram &qp) const;
+
+    /** True if the QP has inequality constraints or bounds and the predicted active set matches the QP dimensions*/
+    bool hasActiveSet(const QuadraticProgram &qp) const;
+};
+
+/**
+ * @brief Interface for user-provided predictors of the QP solution, e.g., a regression model, a lookup table keyed on the gait phase or an extrapolation of
+ * the previous solutions. Solvers that support warm starts (see QPSolver::supportsWarmStart()) query the predictor before each solve() and use the prediction
+ * as initial guess instead of their default warm start. After each successful solve, the predictor receives the solution. See QPSolver::setWarmStartPredictor().
+ */
+class WarmStartPredictor{
+public:
+    virtual ~WarmStartPredictor(){}
+
+    /**
+     * @brief predict Predict the solution of the given QP
+     * @param hierarchical_qp The QP that is about to be solved
+     * @param warm_start Prediction. Entries that are not predicted should be left empty
+     * @return False if no prediction is available. In this case the solver uses its default warm start
+     */
+    virtual bool predict(const HierarchicalQP &hierarchical_qp, WarmStart &warm_start) = 0;
+
+    /**
+     * @brief update Receive the solution of the last solve. The default implementation does nothing.
+     * @param hierarchical_qp The solved QP
+     * @param solution Primal solution and active set. Multipliers are not filled
+     */
+    virtual void update(const HierarchicalQP &hierarchical_qp, const WarmStart &solution){}
+
+    /** @brief reset Forget all previous solutions. Called by QPSolver::reset(), e.g. after reconfiguration of the scene. The default implementation does nothing*/
+    virtual void reset(){}
+};
+
+typedef std::shared_ptr<WarmStartPredictor> WarmStartPredictorPtr;
+
+/**
+ * @brief Predicts the primal solution by linear extrapolation of the last two solutions and the active set of the last solution. This reproduces the default
+ * warm start of active-set solvers and can be used as baseline, or to warm start a solver from the solution of a different solver instance.
+ */
+class ExtrapolationPredictor : public WarmStartPredictor{
+public:
+    ExtrapolationPredictor();
+
+    virtual bool predict(const HierarchicalQP &hierarchical_qp, WarmStart &warm_start);
+    virtual void update(const HierarchicalQP &hierarchical_qp, const WarmStart &solution);
+
+    /** Forget all previous solutions*/
+    virtual void reset(){n_solutions = 0;}
+
+protected:
+    WarmStart last;
+    base::VectorXd x_prev;
+    uint n_solutions;
+};
+
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include <core/RobotModel.hpp>
 #include <core/QPSolver.hpp>
 #include <core/Scene.hpp>
+#include <core/QuadraticProgram.hpp>
 
 using namespace std;
 using namespace wbc;
@@ -112,3 +113,71 @@ BOOST_AUTO_TEST_CASE(scene_factory){
     BOOST_CHECK_NO_THROW(scene = SceneFactory::createInstance("velocity", robot_model, solver, 1e-3));
     BOOST_CHECK(scene != 0);
 }
+
+BOOST_AUTO_TEST_CASE(quadratic_program_equality_only){
+
+    QuadraticProgram qp;
+    qp.resizeEqualityOnly(7, 6);
+    BOOST_CHECK(qp.isEqualityOnly());
+    BOOST_CHECK(qp.A.rows() == 6 && qp.A.cols() == 7);
+    BOOST_CHECK(qp.b.size() == 6);
+    BOOST_CHECK(qp.Wy.size() == 6);
+    BOOST_CHECK(qp.H.size() == 0);
+    BOOST_CHECK(qp.g.size() == 0);
+    BOOST_CHECK(qp.C.rows() == 0);
+    BOOST_CHECK(qp.lower_x.size() == 0 && qp.upper_x.size() == 0);
+
+    qp.resize(7, 6, 0, false);
+    BOOST_CHECK(!qp.isEqualityOnly());
+}
+
+BOOST_AUTO_TEST_CASE(qp_solver_config_file){
+
+    QPSolverConfig config("osqp", "");
+    config.parameters["rho"] = "0.1";
+    config.parameters["polish"] = "1";
+    BOOST_CHECK_NO_THROW(config.save("solver_config.yml"));
+
+    QPSolverConfig loaded;
+    BOOST_CHECK_NO_THROW(loaded.load("solver_config.yml"));
+    BOOST_CHECK(loaded.type == "osqp");
+    BOOST_CHECK(loaded.file == "solver_config.yml");
+    BOOST_CHECK(loaded.parameters == config.parameters);
+
+    BOOST_CHECK_THROW(loaded.load("non_existing_file.yml"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(warm_start_predictor){
+
+    QuadraticProgram qp;
+    qp.resize(3, 1, 2, true);
+    HierarchicalQP hqp;
+    hqp << qp;
+
+    // Entries with wrong size are removed, missing parts of the active set are inactive
+    WarmStart warm_start;
+    warm_start.x.setOnes(3);
+    warm_start.y_eq.setOnes(2);
+    warm_start.active_bounds.setConstant(3, ACTIVE_SET_UPPER);
+    warm_start.validate(qp);
+    BOOST_CHECK(warm_start.hasPrimal());
+    BOOST_CHECK(warm_start.y_eq.size() == 0);
+    BOOST_CHECK(!warm_start.hasDual(qp));
+    BOOST_CHECK(warm_start.hasActiveSet(qp));
+    BOOST_CHECK(warm_start.active_constraints.size() == 2 && warm_start.active_constraints.isZero());
+
+    // Linear extrapolation of the last two solutions
+    ExtrapolationPredictor predictor;
+    BOOST_CHECK(!predictor.predict(hqp, warm_start));
+    WarmStart solution;
+    solution.x = base::Vector3d(1,2,3);
+    predictor.update(hqp, solution);
+    solution.x = base::Vector3d(2,3,4);
+    solution.active_bounds.setConstant(3, ACTIVE_SET_LOWER);
+    predictor.update(hqp, solution);
+    BOOST_CHECK(predictor.predict(hqp, warm_start));
+    BOOST_CHECK(warm_start.x == base::Vector3d(3,4,5));
+    BOOST_CHECK(warm_start.active_bounds == solution.active_bounds);
+    predictor.reset();
+    BOOST_CHECK(!predictor.predict(hqp, warm_start));
+}
@@ -0,0 +1,276 @@
+#include "DatasetGenerator.hpp"
+#include <base-logging/Logging.hpp>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <limits>
+#include <set>
+
+namespace wbc{
+
+UniformDatasetSampler::UniformDatasetSampler(const double velocity_scale, const double reference_scale) :
+    velocity_scale(velocity_scale),
+    reference_scale(reference_scale){
+}
+
+void UniformDatasetSampler::sampleState(std::mt19937 &rng, RobotModelPtr robot_model, base::samples::Joints &joint_state,
+                                        base::samples::RigidBodyStateSE3 &floating_base_state){
+    std::uniform_real_distribution<double> uniform(0, 1);
+    for(uint i = 0; i < joint_state.size(); i++){
+        const base::JointLimitRange &range = robot_model->jointLimits().getElementByName(joint_state.names[i]);
+        double min = range.min.position, max = range.max.position;
+        if(!std::isfinite(min) || !std::isfinite(max)){
+            min = -M_PI;
+            max = M_PI;
+        }
+        joint_state[i].position = min + (max - min) * uniform(rng);
+        const double max_speed = std::isfinite(range.max.speed) ? range.max.speed : 0;
+        joint_state[i].speed = velocity_scale * max_speed * (2*uniform(rng) - 1);
+        joint_state[i].acceleration = 0;
+    }
+}
+
+void UniformDatasetSampler::sampleReferences(std::mt19937 &rng, Scene &scene){
+    std::uniform_real_distribution<double> uniform(-reference_scale, reference_scale);
+    for(const TaskConfig &cfg : scene.getWbcConfig()){
+        if(cfg.type == jnt){
+            base::samples::Joints ref;
+            ref.names = cfg.joint_names;
+            ref.elements.resize(cfg.joint_names.size());
+            for(uint i = 0; i < ref.size(); i++){
+                ref[i].speed = uniform(rng);
+                ref[i].acceleration = uniform(rng);
+            }
+            scene.setReference(cfg.name, ref);
+        }
+        else{
+            base::samples::RigidBodyStateSE3 ref;
+            for(uint i = 0; i < 3; i++){
+                ref.twist.linear[i] = uniform(rng);
+                ref.twist.angular[i] = uniform(rng);
+                ref.acceleration.linear[i] = uniform(rng);
+                ref.acceleration.angular[i] = uniform(rng);
+            }
+            scene.setReference(cfg.name, ref);
+        }
+    }
+}
+
+DatasetGenerator::DatasetGenerator(SceneCreator create_scene, DatasetSamplerPtr sampler) :
+    create_scene(create_scene),
+    sampler(sampler),
+    n_threads(std::max(1u, std::thread::hardware_concurrency())),
+    rows_per_shard(10000),
+    seed(0),
+    n_failures(0),
+    samples_per_second(0){
+    if(!sampler)
+        throw std::invalid_argument("DatasetGenerator: Invalid sampler");
+}
+
+void DatasetGenerator::setNoThreads(const uint n){
+    if(n == 0)
+        throw std::invalid_argument("DatasetGenerator: Number of threads has to be > 0");
+    n_threads = n;
+}
+
+void DatasetGenerator::setRowsPerShard(const uint n){
+    if(n == 0)
+        throw std::invalid_argument("DatasetGenerator: Number of rows per shard has to be > 0");
+    rows_per_shard = n;
+}
+
+bool DatasetGenerator::processSample(const uint index, Scene &scene, std::vector<base::VectorXd> &row){
+
+    std::mt19937 rng(seed + index);
+    RobotModelPtr robot_model = scene.getRobotModel();
+    base::samples::Joints joint_state;
+    joint_state.names = robot_model->actuatedJointNames();
+    joint_state.elements.resize(joint_state.names.size());
+    base::samples::RigidBodyStateSE3 floating_base_state = robot_model->floatingBaseState();
+    sampler->sampleState(rng, robot_model, joint_state, floating_base_state);
+    joint_state.time = floating_base_state.time = base::Time::now();
+    if(robot_model->hasFloatingBase())
+        robot_model->update(joint_state, floating_base_state);
+    else
+        robot_model->update(joint_state);
+    sampler->sampleReferences(rng, scene);
+
+    // Solve each sample from cold start (incl. the warm start predictor of the solver, see QPSolver::reset()), so that the solution does not depend on the
+    // sample that has been processed before by the same thread. The reset is not part of the measured solve time
+    scene.getSolver()->reset();
+    const HierarchicalQP *hqp = 0;
+    double solve_time = 0;
+    try{
+        auto start = std::chrono::high_resolution_clock::now();
+        hqp = &scene.update();
+        scene.solve(*hqp);
+        solve_time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start).count()*1e-3;
+    }
+    catch(std::exception &e){
+        LOG_DEBUG("DatasetGenerator: Sample %i failed: %s", index, e.what());
+        return false;
+    }
+
+    const uint na = joint_state.size();
+    row.clear();
+    row.push_back(base::VectorXd::Constant(1, index));
+    row.push_back(base::VectorXd(na));
+    row.push_back(base::VectorXd(na));
+    for(uint i = 0; i < na; i++){
+        row[1][i] = joint_state[i].position;
+        row[2][i] = joint_state[i].speed;
+    }
+    if(robot_model->hasFloatingBase()){
+        base::VectorXd fb(13);
+        fb << floating_base_state.pose.position, floating_base_state.pose.orientation.coeffs(), floating_base_state.twist.linear, floating_base_state.twist.angular;
+        row.push_back(fb);
+    }
+
+    std::vector<TaskConfig> wbc_config = scene.getWbcConfig();
+    uint n_ref = 0;
+    for(const TaskConfig &cfg : wbc_config)
+        n_ref += scene.getTask(cfg.name)->y_ref.size();
+    base::VectorXd reference(n_ref);
+    n_ref = 0;
+    for(const TaskConfig &cfg : wbc_config){
+        const base::VectorXd &y_ref = scene.getTask(cfg.name)->y_ref;
+        reference.segment(n_ref, y_ref.size()) = y_ref;
+        n_ref += y_ref.size();
+    }
+    row.push_back(reference);
+
+    base::VectorXd qp_dims(3*hqp->size());
+    for(uint i = 0; i < hqp->size(); i++)
+        qp_dims.segment(3*i, 3) << (*hqp)[i].nq, (*hqp)[i].neq, (*hqp)[i].nin;
+    row.push_back(qp_dims);
+    row.push_back(scene.getSolverOutputRaw());
+
+    const uint nc = robot_model->getActiveContacts().size();
+    const base::samples::Wrenches &wrenches = scene.getContactWrenches();
+    base::VectorXd contact_wrenches = base::VectorXd::Constant(6*nc, std::numeric_limits<double>::quiet_NaN());
+    if(wrenches.size() == nc){
+        for(uint i = 0; i < nc; i++)
+            contact_wrenches.segment(6*i, 6) << wrenches[i].force, wrenches[i].torque;
+    }
+    row.push_back(contact_wrenches);
+    row.push_back(base::VectorXd::Constant(1, solve_time));
+    return true;
+}
+
+std::vector<DatasetColumn> DatasetGenerator::createColumns(Scene &scene, const std::vector<base::VectorXd> &row){
+
+    RobotModelPtr robot_model = scene.getRobotModel();
+    std::vector<DatasetColumn> columns;
+    columns.push_back(DatasetColumn("sample_index", 1));
+    columns.push_back(DatasetColumn("joint_position", robot_model->noOfActuatedJoints(), robot_model->actuatedJointNames()));
+    columns.push_back(DatasetColumn("joint_velocity", robot_model->noOfActuatedJoints(), robot_model->actuatedJointNames()));
+    if(robot_model->hasFloatingBase())
+        columns.push_back(DatasetColumn("floating_base", 13, {"x","y","z","qx","qy","qz","qw","vx","vy","vz","wx","wy","wz"}));
+
+    std::vector<std::string> labels;
+    for(const TaskConfig &cfg : scene.getWbcConfig()){
+        for(uint i = 0; i < scene.getTask(cfg.name)->y_ref.size(); i++)
+            labels.push_back(cfg.name + "/" + std::to_string(i));
+    }
+    columns.push_back(DatasetColumn("reference", labels.size(), labels));
+
+    labels.clear();
+    for(uint i = 0; i < row[columns.size()].size()/3; i++){
+        for(const char *n : {"nq", "neq", "nin"})
+            labels.push_back("prio_" + std::to_string(i) + "/" + n);
+    }
+    columns.push_back(DatasetColumn("qp_dims", labels.size(), labels));
+    columns.push_back(DatasetColumn("solution", row[columns.size()].size()));
+
+    labels.clear();
+    for(const std::string &name : robot_model->getActiveContacts().names){
+        for(const char *n : {"fx", "fy", "fz", "tx", "ty", "tz"})
+            labels.push_back(name + "/" + n);
+    }
+    columns.push_back(DatasetColumn("contact_wrenches", labels.size(), labels));
+    columns.push_back(DatasetColumn("solve_time", 1));
+    return columns;
+}
+
+uint DatasetGenerator::generate(const uint n_samples, const std::string &directory){
+
+    if(n_samples == 0)
+        throw std::invalid_argument("DatasetGenerator::generate: Number of samples has to be > 0");
+    n_failures = 0;
+
+    // Each thread needs its own scene, robot model and solver
+    std::vector<ScenePtr> scenes;
+    std::set<void*> robot_models, solvers;
+    for(uint i = 0; i < std::min(n_threads, n_samples); i++){
+        ScenePtr scene = create_scene();
+        if(!scene || !scene->getRobotModel() || !scene->getSolver())
+            throw std::runtime_error("DatasetGenerator::generate: Scene creator returned an invalid scene");
+        if(!robot_models.insert(scene->getRobotModel().get()).second || !solvers.insert(scene->getSolver().get()).second)
+            throw std::invalid_argument("DatasetGenerator::generate: The scenes of the worker threads must not share robot models or solvers");
+        scenes.push_back(scene);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // The first successful sample determines the schema of the dataset
+    std::vector<base::VectorXd> row;
+    uint first = 0;
+    while(first < n_samples && !processSample(first, *scenes[0], row)){
+        n_failures++;
+        first++;
+    }
+    if(first == n_samples)
+        throw std::runtime_error("DatasetGenerator::generate: All samples failed");
+
+    ShardWriter writer(directory, createColumns(*scenes[0], row), rows_per_shard);
+    writer.append(row);
+
+    std::atomic<uint> next_index(first+1);
+    std::atomic<bool> stop(false);
+    std::mutex error_mutex;
+    std::string error;
+    auto work = [&](Scene &scene){
+        std::vector<base::VectorXd> r;
+        while(!stop){
+            const uint index = next_index++;
+            if(index >= n_samples)
+                break;
+            try{
+                if(processSample(index, scene, r))
+                    writer.append(r);
+                else
+                    n_failures++;
+            }
+            catch(std::exception &e){
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if(error.empty())
+                    error = "Sample " + std::to_string(index) + ": " + e.what();
+                stop = true;
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for(uint i = 0; i < scenes.size(); i++)
+        threads.push_back(std::thread(work, std::ref(*scenes[i])));
+    for(std::thread &t : threads)
+        t.join();
+    if(!error.empty()){
+        LOG_ERROR("DatasetGenerator: %s", error.c_str());
+        throw std::runtime_error("DatasetGenerator::generate: " + error);
+    }
+
+    std::string task_names;
+    for(const TaskConfig &cfg : scenes[0]->getWbcConfig())
+        task_names += (task_names.empty() ? "" : ",") + cfg.name;
+    writer.setMetadata("tasks", task_names);
+    writer.setMetadata("seed", std::to_string(seed));
+    writer.setMetadata("n_samples", std::to_string(n_samples));
+    writer.setMetadata("n_failures", std::to_string(n_failures.load()));
+    writer.close();
+
+    samples_per_second = n_samples / std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    return writer.getNoRows();
+}
+
+}
@@ -0,0 +1,105 @@
+#ifndef WBC_DATASET_DATASET_GENERATOR_HPP
+#define WBC_DATASET_DATASET_GENERATOR_HPP
+
+#include "ShardWriter.hpp"
+#include "../core/Scene.hpp"
+#include <functional>
+#include <random>
+#include <atomic>
+
+namespace wbc{
+
+/**
+ * @brief Samples the robot state and the task references for the DatasetGenerator. sampleState() and sampleReferences() are called concurrently by
+ * the worker threads, each with its own scene and robot model, so implementations must not modify shared state. All randomness has to be drawn from the given
+ * random number generator, which is seeded per sample, so that a dataset can be reproduced independent of the number of threads.
+ */
+class DatasetSampler{
+public:
+    virtual ~DatasetSampler(){}
+
+    /** Sample the joint state (actuated joints, names are already set) and, for floating base robots, the floating base state*/
+    virtual void sampleState(std::mt19937 &rng, RobotModelPtr robot_model, base::samples::Joints &joint_state, base::samples::RigidBodyStateSE3 &floating_base_state) = 0;
+
+    /** Sample the references of the tasks of the given scene (see Scene::setReference()). Called after the robot model has been updated with the sampled state*/
+    virtual void sampleReferences(std::mt19937 &rng, Scene &scene) = 0;
+};
+typedef std::shared_ptr<DatasetSampler> DatasetSamplerPtr;
+
+/**
+ * @brief Default sampler: Joint positions are sampled uniformly within the position limits of the robot model (joints without finite limits in [-pi,pi]), joint velocities uniformly
+ * within velocity_scale times the velocity limits. The floating base state is kept at the state of the robot model at the time of sampling. The task references are sampled
+ * uniformly in [-reference_scale, reference_scale]: twist and spatial acceleration for Cartesian and CoM tasks, speed and acceleration for joint tasks. Poses and joint
+ * positions of the references are not modified.
+ */
+class UniformDatasetSampler : public DatasetSampler{
+public:
+    UniformDatasetSampler(const double velocity_scale = 0.5, const double reference_scale = 1.0);
+    virtual void sampleState(std::mt19937 &rng, RobotModelPtr robot_model, base::samples::Joints &joint_state, base::samples::RigidBodyStateSE3 &floating_base_state);
+    virtual void sampleReferences(std::mt19937 &rng, Scene &scene);
+protected:
+    double velocity_scale, reference_scale;
+};
+
+/**
+ * @brief Headless, multi-threaded dataset generation, e.g., for training learned policies that imitate the WBC: Drives a scene over sampled robot states and task references
+ * (see DatasetSampler) and streams the results into columnar shards (see ShardWriter), with the following fixed schema (one row per sample):
+ *   - sample_index: Index of the sample, the random number generator of each sample is seeded with seed + sample_index
+ *   - joint_position, joint_velocity: Sampled state of the actuated joints
+ *   - floating_base: Position, orientation (quaternion x,y,z,w) and twist (linear, angular) of the floating base. Only for floating base robots
+ *   - reference: Concatenated raw references (Task::y_ref) of all tasks in configuration order
+ *   - qp_dims: Number of variables, equality and inequality constraints of each priority level of the QP
+ *   - solution: Raw solver output (Scene::getSolverOutputRaw())
+ *   - contact_wrenches: Force and torque of each contact point (Scene::getContactWrenches()). NaN if the scene does not compute contact wrenches
+ *   - solve_time: Time for Scene::update() and Scene::solve() in microseconds
+ * Each worker thread owns one scene, created by the given SceneCreator, i.e., every scene must use its own robot model and solver instance. Each sample is solved from cold start
+ * (see QPSolver::reset()), so that the dataset, except for solve_time, does not depend on the number of threads. The schema is determined from the first sample. Samples for which the QP cannot be solved are skipped (see getNoFailures()). Writing is buffered and asynchronous, so that the throughput is bounded by the
+ * solve rate rather than by the I/O.
+ */
+class DatasetGenerator{
+public:
+    /** Has to return a configured scene. Called once per worker thread, in the calling thread*/
+    typedef std::function<ScenePtr()> SceneCreator;
+
+    DatasetGenerator(SceneCreator create_scene, DatasetSamplerPtr sampler = std::make_shared<UniformDatasetSampler>());
+
+    /** Number of worker threads. Default is std::thread::hardware_concurrency()*/
+    void setNoThreads(const uint n);
+    uint getNoThreads(){return n_threads;}
+
+    /** Number of rows per shard. Default is 10000*/
+    void setRowsPerShard(const uint n);
+    uint getRowsPerShard(){return rows_per_shard;}
+
+    /** Seed of the random number generators. Default is 0*/
+    void setSeed(const uint s){seed = s;}
+    uint getSeed(){return seed;}
+
+    /**
+     * @brief Generate n_samples samples and write them to the given directory. Throws if no scene can be created, if the first sample fails or if the QP size changes
+     * during generation (fixed schema). Returns the number of rows written, i.e., n_samples - getNoFailures().
+     */
+    uint generate(const uint n_samples, const std::string &directory);
+
+    /** Number of failed samples (solver errors) in the last call of generate()*/
+    uint getNoFailures(){return n_failures;}
+
+    /** Average number of samples per second in the last call of generate()*/
+    double getSamplesPerSecond(){return samples_per_second;}
+
+protected:
+    /** Sample, update and solve the given scene. Returns false if the solver failed*/
+    bool processSample(const uint index, Scene &scene, std::vector<base::VectorXd> &row);
+    /** Derive the columns of the dataset from the scene and the first row*/
+    std::vector<DatasetColumn> createColumns(Scene &scene, const std::vector<base::VectorXd> &row);
+
+    SceneCreator create_scene;
+    DatasetSamplerPtr sampler;
+    uint n_threads, rows_per_shard, seed;
+    std::atomic<uint> n_failures;
+    double samples_per_second;
+};
+
+}
+
+#endif
@@ -0,0 +1,240 @@
+#include "ShardWriter.hpp"
+#include <base-logging/Logging.hpp>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <sys/stat.h>
+
+namespace wbc{
+
+static std::string npyDescr(){
+    const uint16_t x = 1;
+    return *reinterpret_cast<const char*>(&x) == 1 ? "<f8" : ">f8";
+}
+
+static std::string jsonString(const std::string &str){
+    std::stringstream ss;
+    ss << "\"";
+    for(char c : str){
+        if(c == '"' || c == '\\')
+            ss << "\\" << c;
+        else if((unsigned char)c < 0x20)
+            ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec;
+        else
+            ss << c;
+    }
+    ss << "\"";
+    return ss.str();
+}
+
+ShardWriter::ShardWriter(const std::string &directory, const std::vector<DatasetColumn> &columns, const uint rows_per_shard, const uint max_pending_shards) :
+    directory(directory),
+    columns(columns),
+    rows_per_shard(rows_per_shard),
+    max_pending_shards(max_pending_shards),
+    n_rows(0),
+    closing(false),
+    closed(false){
+
+    if(columns.empty())
+        throw std::invalid_argument("ShardWriter: Dataset has no columns");
+    if(rows_per_shard == 0 || max_pending_shards == 0)
+        throw std::invalid_argument("ShardWriter: rows_per_shard and max_pending_shards have to be > 0");
+    for(const DatasetColumn &c : columns){
+        if(!c.labels.empty() && c.labels.size() != c.width)
+            throw std::invalid_argument("ShardWriter: Column " + c.name + " has " + std::to_string(c.labels.size()) + " labels, but width is " + std::to_string(c.width));
+    }
+    if(mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST){
+        LOG_ERROR("ShardWriter: Unable to create directory %s: %s", directory.c_str(), strerror(errno));
+        throw std::runtime_error("ShardWriter: Unable to create directory " + directory);
+    }
+
+    current.index = 0;
+    newShard();
+    writer_thread = std::thread(&ShardWriter::writeLoop, this);
+}
+
+ShardWriter::~ShardWriter(){
+    try{
+        close();
+    }
+    catch(std::exception &e){
+        LOG_ERROR("ShardWriter: %s", e.what());
+    }
+}
+
+void ShardWriter::newShard(){
+    current.n_rows = 0;
+    current.data.resize(columns.size());
+    for(uint i = 0; i < columns.size(); i++)
+        current.data[i].resize(rows_per_shard, columns[i].width);
+}
+
+void ShardWriter::enqueueShard(){
+    const uint next_index = current.index + 1;
+    pending.push_back(std::move(current));
+    current = Shard();
+    current.index = next_index;
+    cond_pending.notify_one();
+}
+
+void ShardWriter::append(const std::vector<base::VectorXd> &row){
+    if(row.size() != columns.size())
+        throw std::invalid_argument("ShardWriter::append: Row has " + std::to_string(row.size()) + " columns, but expected " + std::to_string(columns.size()));
+    for(uint i = 0; i < columns.size(); i++){
+        if(row[i].size() != columns[i].width)
+            throw std::invalid_argument("ShardWriter::append: Column " + columns[i].name + " has width " + std::to_string(row[i].size()) +
+                                        ", but expected " + std::to_string(columns[i].width));
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if(closing)
+        throw std::runtime_error("ShardWriter::append: Writer has been closed");
+    // Backpressure: Wait until the writer thread has caught up
+    cond_written.wait(lock, [this]{return pending.size() < max_pending_shards || !write_error.empty();});
+    if(!write_error.empty())
+        throw std::runtime_error("ShardWriter: " + write_error);
+
+    if(current.data.empty())
+        newShard();
+    for(uint i = 0; i < columns.size(); i++)
+        current.data[i].row(current.n_rows) = row[i].transpose();
+    current.n_rows++;
+    n_rows++;
+    if(current.n_rows == rows_per_shard)
+        enqueueShard();
+}
+
+void ShardWriter::setMetadata(const std::string &key, const std::string &value){
+    std::unique_lock<std::mutex> lock(mutex);
+    metadata[key] = value;
+}
+
+void ShardWriter::close(){
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if(closed)
+            return;
+        if(!closing && current.n_rows > 0)
+            enqueueShard();
+        closing = true;
+        cond_pending.notify_one();
+    }
+    if(writer_thread.joinable())
+        writer_thread.join();
+    closed = true;
+    if(!write_error.empty())
+        throw std::runtime_error("ShardWriter: " + write_error);
+    writeManifest();
+}
+
+uint ShardWriter::getNoRows(){
+    std::unique_lock<std::mutex> lock(mutex);
+    return n_rows;
+}
+
+uint ShardWriter::getNoShards(){
+    std::unique_lock<std::mutex> lock(mutex);
+    return written_shard_rows.size();
+}
+
+std::string ShardWriter::shardFilename(const std::string &column, const uint index){
+    std::stringstream ss;
+    ss << column << "_" << std::setw(5) << std::setfill('0') << index << ".npy";
+    return ss.str();
+}
+
+void ShardWriter::writeNpy(const std::string &filename, const RowMajorMatrix &data){
+    std::stringstream header;
+    header << "{'descr': '" << npyDescr() << "', 'fortran_order': False, 'shape': (" << data.rows() << ", " << data.cols() << "), }";
+    // Magic string (6 bytes), version (2 bytes) and header length (2 bytes) + header have to be aligned to 64 bytes, header is terminated by newline
+    std::string header_str = header.str();
+    header_str.append(63 - (10 + header_str.size()) % 64, ' ');
+    header_str.push_back('\n');
+    const uint16_t header_len = header_str.size();
+
+    std::ofstream stream(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if(!stream.is_open())
+        throw std::runtime_error("Unable to open file " + filename);
+    stream.write("\x93NUMPY\x01\x00", 8);
+    const unsigned char len[2] = {(unsigned char)(header_len & 0xff), (unsigned char)(header_len >> 8)};
+    stream.write(reinterpret_cast<const char*>(len), 2);
+    stream.write(header_str.data(), header_str.size());
+    stream.write(reinterpret_cast<const char*>(data.data()), data.size()*sizeof(double));
+    if(!stream)
+        throw std::runtime_error("Failed to write file " + filename);
+}
+
+void ShardWriter::writeLoop(){
+    while(true){
+        Shard shard;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond_pending.wait(lock, [this]{return !pending.empty() || closing;});
+            if(pending.empty())
+                return;
+            shard = std::move(pending.front());
+            pending.pop_front();
+        }
+        std::string error;
+        try{
+            for(uint i = 0; i < columns.size(); i++){
+                if(shard.data[i].rows() != shard.n_rows)
+                    shard.data[i].conservativeResize(shard.n_rows, Eigen::NoChange);
+                writeNpy(directory + "/" + shardFilename(columns[i].name, shard.index), shard.data[i]);
+            }
+        }
+        catch(std::exception &e){
+            error = e.what();
+            LOG_ERROR("ShardWriter: %s", error.c_str());
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        if(error.empty())
+            written_shard_rows.push_back(shard.n_rows);
+        else if(write_error.empty())
+            write_error = error;
+        cond_written.notify_all();
+    }
+}
+
+void ShardWriter::writeManifest(){
+    const std::string filename = directory + "/manifest.json";
+    std::ofstream stream(filename.c_str(), std::ios::trunc);
+    if(!stream.is_open()){
+        LOG_ERROR("ShardWriter: Unable to open file %s", filename.c_str());
+        throw std::runtime_error("ShardWriter: Unable to open file " + filename);
+    }
+    stream << "{" << std::endl;
+    stream << "  \"format\": \"npy\"," << std::endl;
+    stream << "  \"dtype\": " << jsonString(npyDescr()) << "," << std::endl;
+    stream << "  \"rows\": " << n_rows << "," << std::endl;
+    stream << "  \"rows_per_shard\": " << rows_per_shard << "," << std::endl;
+    stream << "  \"metadata\": {";
+    for(auto it = metadata.begin(); it != metadata.end(); it++)
+        stream << (it == metadata.begin() ? "" : ",") << std::endl << "    " << jsonString(it->first) << ": " << jsonString(it->second);
+    stream << (metadata.empty() ? "" : "\n  ") << "}," << std::endl;
+    stream << "  \"columns\": [";
+    for(uint i = 0; i < columns.size(); i++){
+        stream << (i == 0 ? "" : ",") << std::endl << "    {\"name\": " << jsonString(columns[i].name) << ", \"width\": " << columns[i].width << ", \"labels\": [";
+        for(uint j = 0; j < columns[i].labels.size(); j++)
+            stream << (j == 0 ? "" : ", ") << jsonString(columns[i].labels[j]);
+        stream << "]}";
+    }
+    stream << std::endl << "  ]," << std::endl;
+    stream << "  \"shards\": [";
+    for(uint k = 0; k < written_shard_rows.size(); k++){
+        stream << (k == 0 ? "" : ",") << std::endl << "    {\"index\": " << k << ", \"rows\": " << written_shard_rows[k] << ", \"files\": {";
+        for(uint i = 0; i < columns.size(); i++)
+            stream << (i == 0 ? "" : ", ") << jsonString(columns[i].name) << ": " << jsonString(shardFilename(columns[i].name, k));
+        stream << "}}";
+    }
+    stream << std::endl << "  ]" << std::endl << "}" << std::endl;
+    if(!stream)
+        throw std::runtime_error("ShardWriter: Failed to write file " + filename);
+}
+
+}
@@ -0,0 +1,98 @@
+#ifndef WBC_DATASET_SHARD_WRITER_HPP
+#define WBC_DATASET_SHARD_WRITER_HPP
+
+#include <base/Eigen.hpp>
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace wbc{
+
+/** Column of a dataset with fixed width, e.g., the joint positions of the robot. The labels (optional) name the entries of the column, e.g., the joint names*/
+struct DatasetColumn{
+    DatasetColumn(){}
+    DatasetColumn(const std::string &name, const uint width, const std::vector<std::string> &labels = std::vector<std::string>()) :
+        name(name), width(width), labels(labels){}
+    std::string name;
+    uint width;
+    std::vector<std::string> labels;
+};
+
+/**
+ * @brief Writes rows of a fixed-schema dataset into columnar shards. Each shard contains rows_per_shard rows (except the last one) and is stored as one
+ * NumPy (.npy, float64, shape n_rows x width) file per column, named <column>_<shard index>.npy, e.g., joint_position_00003.npy. On close(), a manifest
+ * (manifest.json) is written, which describes the columns, the shards and optional metadata (see setMetadata()), so that the dataset can be loaded e.g. with
+ * numpy.load() without knowing the schema in advance.
+ *
+ * Rows are buffered in memory. Full shards are written asynchronously by a background thread, so that the caller is blocked only while copying a row. The
+ * number of full shards waiting to be written is limited (max_pending_shards): If the I/O is slower than the producer, append() blocks until a shard has been written.
+ * append() is thread-safe, i.e., it can be called concurrently by multiple producers.
+ */
+class ShardWriter{
+public:
+    /**
+     * @brief Create the output directory (if it does not exist) and start the writer thread. Throws if the directory cannot be created, if there are no columns
+     * or if rows_per_shard or max_pending_shards is zero.
+     */
+    ShardWriter(const std::string &directory, const std::vector<DatasetColumn> &columns, const uint rows_per_shard = 10000, const uint max_pending_shards = 4);
+    ~ShardWriter();
+
+    /** Append a row. The row must contain one vector per column with the width of the column, otherwise this throws. Also rethrows errors of the writer thread*/
+    void append(const std::vector<base::VectorXd> &row);
+
+    /** Add a key/value pair to the metadata section of the manifest*/
+    void setMetadata(const std::string &key, const std::string &value);
+
+    /** Write the remaining rows, wait for the writer thread and write the manifest. Called automatically on destruction. Throws if writing failed*/
+    void close();
+
+    /** Number of rows appended so far*/
+    uint getNoRows();
+
+    /** Number of shards written to disk so far*/
+    uint getNoShards();
+
+    const std::vector<DatasetColumn>& getColumns(){return columns;}
+
+    /** Write a matrix as NumPy array (.npy, version 1.0, float64). Throws if the file cannot be written*/
+    static void writeNpy(const std::string &filename, const Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> &data);
+
+protected:
+    typedef Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> RowMajorMatrix;
+    struct Shard{
+        uint index, n_rows;
+        std::vector<RowMajorMatrix> data;
+    };
+
+    /** Allocate the buffer of the current shard*/
+    void newShard();
+    /** Move the current shard to the write queue. Has to be called with the mutex locked*/
+    void enqueueShard();
+    /** Main loop of the writer thread*/
+    void writeLoop();
+    void writeManifest();
+    std::string shardFilename(const std::string &column, const uint index);
+
+    std::string directory;
+    std::vector<DatasetColumn> columns;
+    uint rows_per_shard, max_pending_shards;
+    std::map<std::string,std::string> metadata;
+
+    Shard current;
+    std::deque<Shard> pending;
+    std::vector<uint> written_shard_rows;
+    uint n_rows;
+    bool closing, closed;
+    std::string write_error;
+    std::mutex mutex;
+    std::condition_variable cond_pending, cond_written;
+    std::thread writer_thread;
+};
+
+}
+
+#endif
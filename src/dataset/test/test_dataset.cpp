@@ -0,0 +1,225 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "dataset/ShardWriter.hpp"
+#include "dataset/DatasetGenerator.hpp"
+#include "robot_models/pinocchio/RobotModelPinocchio.hpp"
+#include "scenes/velocity_qp/VelocitySceneQP.hpp"
+#include "solvers/qpoases/QPOasesSolver.hpp"
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <iomanip>
+#include <thread>
+#include <algorithm>
+
+using namespace wbc;
+using namespace std;
+
+/** Read a 2D float64 array written by ShardWriter::writeNpy() and check the header*/
+base::MatrixXd readNpy(const string &filename){
+    ifstream stream(filename.c_str(), ios::binary);
+    BOOST_REQUIRE(stream.is_open());
+    char magic[8];
+    stream.read(magic, 8);
+    BOOST_CHECK(memcmp(magic, "\x93NUMPY\x01\x00", 8) == 0);
+    unsigned char len[2];
+    stream.read(reinterpret_cast<char*>(len), 2);
+    const uint header_len = len[0] + 256*len[1];
+    BOOST_CHECK((10 + header_len) % 64 == 0);
+    string header(header_len, ' ');
+    stream.read(&header[0], header_len);
+    BOOST_CHECK(header.back() == '\n');
+    BOOST_CHECK(header.find("'fortran_order': False") != string::npos);
+    size_t pos = header.find("'shape': (");
+    BOOST_REQUIRE(pos != string::npos);
+    uint rows, cols;
+    char sep;
+    stringstream(header.substr(pos+10)) >> rows >> sep >> cols;
+    Eigen::Matrix<double,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> data(rows, cols);
+    stream.read(reinterpret_cast<char*>(data.data()), data.size()*sizeof(double));
+    BOOST_CHECK(stream.good());
+    return data;
+}
+
+/** Read all shards of a column of a dataset written by DatasetGenerator, with rows sorted by sample index*/
+base::MatrixXd readColumn(const string &directory, const string &column, const uint n_shards){
+    base::MatrixXd data, index;
+    for(uint k = 0; k < n_shards; k++){
+        stringstream idx;
+        idx << setw(5) << setfill('0') << k;
+        base::MatrixXd d = readNpy(directory + "/" + column + "_" + idx.str() + ".npy");
+        base::MatrixXd i = readNpy(directory + "/sample_index_" + idx.str() + ".npy");
+        data.conservativeResize(data.rows() + d.rows(), d.cols());
+        data.bottomRows(d.rows()) = d;
+        index.conservativeResize(index.rows() + i.rows(), 1);
+        index.bottomRows(i.rows()) = i;
+    }
+    vector<uint> order(index.rows());
+    for(uint r = 0; r < order.size(); r++)
+        order[r] = r;
+    std::sort(order.begin(), order.end(), [&index](uint a, uint b){return index(a,0) < index(b,0);});
+    base::MatrixXd sorted(data.rows(), data.cols());
+    for(uint r = 0; r < order.size(); r++)
+        sorted.row(r) = data.row(order[r]);
+    return sorted;
+}
+
+string readFile(const string &filename){
+    ifstream stream(filename.c_str());
+    stringstream ss;
+    ss << stream.rdbuf();
+    return ss.str();
+}
+
+BOOST_AUTO_TEST_CASE(shard_writer){
+
+    /**
+     * Write rows from several threads into small shards and check if all rows can be read back, incl. the last, partially filled shard and the manifest
+     */
+
+    const string dir = "test_shard_writer";
+    const uint n_rows = 95, rows_per_shard = 10;
+    vector<DatasetColumn> columns = {DatasetColumn("index", 1), DatasetColumn("data", 3, {"a","b","c"})};
+    BOOST_CHECK_THROW(ShardWriter(dir, vector<DatasetColumn>()), std::invalid_argument);
+    BOOST_CHECK_THROW(ShardWriter(dir, {DatasetColumn("data", 3, {"a"})}), std::invalid_argument);
+
+    {
+        ShardWriter writer(dir, columns, rows_per_shard, 2);
+        BOOST_CHECK_THROW(writer.append({base::VectorXd::Zero(1), base::VectorXd::Zero(2)}), std::invalid_argument);
+        vector<std::thread> threads;
+        for(uint t = 0; t < 4; t++){
+            threads.push_back(std::thread([&writer,t,n_rows](){
+                for(uint i = t; i < n_rows; i += 4)
+                    writer.append({base::VectorXd::Constant(1,i), base::Vector3d(i, 2*i, 3*i)});
+            }));
+        }
+        for(auto &t : threads)
+            t.join();
+        writer.setMetadata("robot", "test");
+        writer.close();
+        BOOST_CHECK(writer.getNoRows() == n_rows);
+        BOOST_CHECK(writer.getNoShards() == 10);
+        BOOST_CHECK_THROW(writer.append({base::VectorXd::Zero(1), base::VectorXd::Zero(3)}), std::runtime_error);
+    }
+
+    vector<bool> found(n_rows, false);
+    for(uint k = 0; k < 10; k++){
+        stringstream idx;
+        idx << setw(5) << setfill('0') << k;
+        base::MatrixXd index = readNpy(dir + "/index_" + idx.str() + ".npy");
+        base::MatrixXd data = readNpy(dir + "/data_" + idx.str() + ".npy");
+        BOOST_CHECK(index.rows() == (k < 9 ? rows_per_shard : 5));
+        BOOST_CHECK(index.cols() == 1);
+        BOOST_CHECK(data.rows() == index.rows());
+        BOOST_CHECK(data.cols() == 3);
+        for(uint r = 0; r < index.rows(); r++){
+            uint i = index(r,0);
+            BOOST_CHECK(!found[i]);
+            found[i] = true;
+            BOOST_CHECK(data.row(r) == base::Vector3d(i, 2*i, 3*i).transpose());
+        }
+    }
+    BOOST_CHECK(std::find(found.begin(), found.end(), false) == found.end());
+
+    string manifest = readFile(dir + "/manifest.json");
+    BOOST_CHECK(manifest.find("\"rows\": 95") != string::npos);
+    BOOST_CHECK(manifest.find("{\"name\": \"data\", \"width\": 3, \"labels\": [\"a\", \"b\", \"c\"]}") != string::npos);
+    BOOST_CHECK(manifest.find("\"robot\": \"test\"") != string::npos);
+    BOOST_CHECK(manifest.find("\"data\": \"data_00009.npy\"") != string::npos);
+}
+
+ScenePtr makeScene(){
+    RobotModelPtr robot_model = make_shared<RobotModelPinocchio>();
+    RobotModelConfig config;
+    config.file_or_string = "../../../../models/kuka/urdf/kuka_iiwa.urdf";
+    BOOST_CHECK(robot_model->configure(config));
+
+    QPSolverPtr solver = std::make_shared<QPOASESSolver>();
+    qpOASES::Options options = dynamic_pointer_cast<QPOASESSolver>(solver)->getOptions();
+    options.printLevel = qpOASES::PL_NONE;
+    dynamic_pointer_cast<QPOASESSolver>(solver)->setOptions(options);
+    dynamic_pointer_cast<QPOASESSolver>(solver)->setMaxNoWSR(1000);
+    // The predictor keeps state between samples, which must not leak into the next sample of the same thread
+    solver->setWarmStartPredictor(std::make_shared<ExtrapolationPredictor>());
+
+    ScenePtr scene = make_shared<VelocitySceneQP>(robot_model, solver, 1e-3);
+    TaskConfig cart_task("cart_pos_ctrl", 0, "kuka_lbr_l_link_0", "kuka_lbr_l_tcp", "kuka_lbr_l_link_0", 1);
+    BOOST_CHECK(scene->configure({cart_task}));
+    return scene;
+}
+
+BOOST_AUTO_TEST_CASE(dataset_generator){
+
+    /**
+     * Generate a dataset with multiple threads and check the schema and the content: The solution has to match the solution of a scene that is driven sequentially with the
+     * same state and reference. Generating the dataset again with a different number of threads has to yield an identical dataset, except for the solve time.
+     */
+
+    const uint n_samples = 200;
+    DatasetGenerator generator(makeScene);
+    generator.setNoThreads(4);
+    generator.setRowsPerShard(64);
+    generator.setSeed(42);
+    const string dir = "test_dataset_generator";
+    uint n_rows = generator.generate(n_samples, dir);
+    BOOST_CHECK(n_rows + generator.getNoFailures() == n_samples);
+    BOOST_CHECK(generator.getSamplesPerSecond() > 0);
+
+    const uint n_shards = (n_rows+63)/64;
+    base::MatrixXd index = readColumn(dir, "sample_index", n_shards);
+    base::MatrixXd q = readColumn(dir, "joint_position", n_shards);
+    base::MatrixXd qd = readColumn(dir, "joint_velocity", n_shards);
+    base::MatrixXd reference = readColumn(dir, "reference", n_shards);
+    base::MatrixXd qp_dims = readColumn(dir, "qp_dims", n_shards);
+    base::MatrixXd solution = readColumn(dir, "solution", n_shards);
+    base::MatrixXd wrenches = readColumn(dir, "contact_wrenches", n_shards);
+    BOOST_CHECK(index.rows() == n_rows);
+    BOOST_CHECK(q.cols() == 7 && qd.cols() == 7);
+    BOOST_CHECK(reference.cols() == 6);
+    BOOST_CHECK(qp_dims.cols() == 3);
+    BOOST_CHECK(solution.cols() == 7);
+    BOOST_CHECK(wrenches.cols() == 0);
+    string manifest = readFile(dir + "/manifest.json");
+    BOOST_CHECK(manifest.find("\"tasks\": \"cart_pos_ctrl\"") != string::npos);
+    BOOST_CHECK(manifest.find("kuka_lbr_l_joint_1") != string::npos);
+
+    // Compare with sequential solution
+    ScenePtr scene = makeScene();
+    RobotModelPtr robot_model = scene->getRobotModel();
+    for(uint r = 0; r < index.rows(); r += 20){
+        base::samples::Joints joint_state;
+        joint_state.names = robot_model->actuatedJointNames();
+        joint_state.elements.resize(7);
+        for(uint i = 0; i < 7; i++){
+            joint_state[i].position = q(r,i);
+            joint_state[i].speed = qd(r,i);
+            joint_state[i].acceleration = 0;
+        }
+        joint_state.time = base::Time::now();
+        robot_model->update(joint_state);
+        base::samples::RigidBodyStateSE3 ref;
+        ref.twist.linear = reference.block(r,0,1,3).transpose();
+        ref.twist.angular = reference.block(r,3,1,3).transpose();
+        scene->setReference("cart_pos_ctrl", ref);
+        scene->getSolver()->reset();
+        scene->solve(scene->update());
+        BOOST_CHECK(qp_dims(r,0) == 7);
+        BOOST_CHECK((scene->getSolverOutputRaw() - solution.row(r).transpose()).norm() < 1e-9);
+    }
+
+    // Identical dataset (except for the solve time) with a single thread
+    generator.setNoThreads(1);
+    BOOST_CHECK(generator.generate(n_samples, "test_dataset_generator_single") == n_rows);
+    for(const char *column : {"sample_index", "joint_position", "joint_velocity", "reference", "qp_dims", "solution", "contact_wrenches"}){
+        base::MatrixXd single = readColumn("test_dataset_generator_single", column, n_shards);
+        BOOST_CHECK(single.rows() == n_rows);
+        BOOST_CHECK_MESSAGE(single == readColumn(dir, column, n_shards), string("Column ") + column + " differs");
+    }
+
+    // Scenes must not share robot models or solvers
+    ScenePtr shared_scene = makeScene();
+    DatasetGenerator invalid_generator([shared_scene](){return shared_scene;});
+    invalid_generator.setNoThreads(2);
+    BOOST_CHECK_THROW(invalid_generator.generate(10, "test_dataset_generator_invalid"), std::invalid_argument);
+}
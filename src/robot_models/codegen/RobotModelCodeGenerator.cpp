@@ -0,0 +1,1158 @@
+#include "RobotModelCodeGenerator.hpp"
+#include "../../tools/URDFTools.hpp"
+#include <base-logging/Logging.hpp>
+#include <urdf_parser/urdf_parser.h>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <regex>
+#include <algorithm>
+
+namespace wbc {
+
+namespace {
+
+std::string num(double value){
+    std::ostringstream os;
+    os << std::setprecision(17) << value;
+    std::string s = os.str();
+    if(s.find_first_of(".eEn") == std::string::npos)
+        s += ".0";
+    return s;
+}
+
+std::string vec3(const base::Vector3d& v){
+    return "Eigen::Vector3d(" + num(v(0)) + ", " + num(v(1)) + ", " + num(v(2)) + ")";
+}
+
+std::string mat3(const base::Matrix3d& m){
+    std::string s = "(Eigen::Matrix3d() << ";
+    for(int i = 0; i < 3; i++){
+        for(int j = 0; j < 3; j++){
+            s += num(m(i,j));
+            if(i != 2 || j != 2)
+                s += ", ";
+        }
+    }
+    return s + ").finished()";
+}
+
+base::Matrix3d skew(const base::Vector3d& v){
+    base::Matrix3d S;
+    S << 0, -v(2), v(1),
+         v(2), 0, -v(0),
+         -v(1), v(0), 0;
+    return S;
+}
+
+bool isIdentity(const base::Matrix3d& R){
+    return (R - base::Matrix3d::Identity()).norm() < 1e-12;
+}
+
+/** Return 0,1,2 if the given axis is the x-,y- or z-axis, -1 otherwise*/
+int unitAxis(const base::Vector3d& axis){
+    for(int i = 0; i < 3; i++)
+        if((axis - base::Vector3d::Unit(i)).norm() < 1e-12)
+            return i;
+    return -1;
+}
+
+/** Tangent vector index of the motion subspace of the given revolute/prismatic joint, if it is aligned with one of the coordinate axes, -1 otherwise*/
+int subspaceIndex(const RobotModelCodeGenerator::Joint& joint){
+    int i = unitAxis(joint.axis);
+    if(i < 0)
+        return -1;
+    return joint.type == RobotModelCodeGenerator::revolute ? i + 3 : i;
+}
+
+/** Code for 'target += S*value', where S is the motion subspace of a revolute or prismatic joint*/
+std::string addMotion(const RobotModelCodeGenerator::Joint& joint, const std::string& target, const std::string& value){
+    int i = subspaceIndex(joint);
+    if(i >= 0)
+        return target + "(" + std::to_string(i) + ") += " + value + ";";
+    std::string segment = joint.type == RobotModelCodeGenerator::revolute ? ".tail<3>()" : ".head<3>()";
+    return target + segment + " += " + vec3(joint.axis) + "*" + value + ";";
+}
+
+/** Code for 'S^T*force', where S is the motion subspace of a revolute or prismatic joint*/
+std::string projectForce(const RobotModelCodeGenerator::Joint& joint, const std::string& force){
+    int i = subspaceIndex(joint);
+    if(i >= 0)
+        return force + "(" + std::to_string(i) + ")";
+    std::string segment = joint.type == RobotModelCodeGenerator::revolute ? ".tail<3>()" : ".head<3>()";
+    return vec3(joint.axis) + ".dot(" + force + segment + ")";
+}
+
+/** Code for the joint axis of a revolute or prismatic joint in world coordinates*/
+std::string worldAxis(const RobotModelCodeGenerator::Joint& joint, int idx){
+    int i = unitAxis(joint.axis);
+    if(i >= 0)
+        return "oR[" + std::to_string(idx) + "].col(" + std::to_string(i) + ")";
+    return "oR[" + std::to_string(idx) + "]*" + vec3(joint.axis);
+}
+
+std::string replaceAll(std::string s, const std::string& from, const std::string& to){
+    size_t pos = 0;
+    while((pos = s.find(from, pos)) != std::string::npos){
+        s.replace(pos, from.length(), to);
+        pos += to.length();
+    }
+    return s;
+}
+
+const char* header_template = R"code(// This file has been generated by RobotModelCodeGenerator from @URDF@. Do not edit!
+#ifndef @GUARD@
+#define @GUARD@
+
+#include <core/RobotModel.hpp>
+#include <array>
+#include <unordered_map>
+
+namespace wbc{
+
+/**
+ * @brief Robot model of @ROBOT@, generated from URDF by RobotModelCodeGenerator. Forward kinematics, frame Jacobians, CRBA and RNEA are unrolled
+ * for the kinematic tree of the robot and stored in fixed size matrices. Joint order and frame conventions are the same as in RobotModelPinocchio.
+ * Floating base: @FLOATING_BASE@, Blacklisted joints: @BLACKLIST@
+ */
+class @CLASS@ : public RobotModel{
+public:
+    static constexpr int NQ = @NQ@;
+    static constexpr int NV = @NV@;
+    static constexpr int NJOINTS = @NJOINTS@;
+    static constexpr int NFRAMES = @NFRAMES@;
+
+    typedef Eigen::Matrix<double,6,1> Motion;
+    typedef Eigen::Matrix<double,6,1> Force;
+    typedef Eigen::Matrix<double,NQ,1> ConfigVector;
+    typedef Eigen::Matrix<double,NV,1> TangentVector;
+    typedef Eigen::Matrix<double,6,NV> FrameJacobian;
+    typedef Eigen::Matrix<double,3,NV> CoMJacobian;
+    typedef Eigen::Matrix<double,NV,NV> InertiaMatrix;
+
+protected:
+    static RobotModelRegistry<@CLASS@> reg;
+
+    ConfigVector q;
+    TangentVector qd, qdd, tau;
+    /** Joint placements in world (oR,op) and in parent joint coordinates (liR, lip)*/
+    std::array<Eigen::Matrix3d,NJOINTS> oR, liR;
+    std::array<Eigen::Vector3d,NJOINTS> op, lip;
+    /** Spatial velocity and acceleration of each joint in joint coordinates. a_bias is the acceleration for qdd = 0*/
+    std::array<Motion,NJOINTS> v, a, a_bias;
+    std::array<Force,NJOINTS> f;
+    /** Composite rigid body inertias (mass, first moment of mass, rotational inertia w.r.t. joint origin)*/
+    std::array<double,NJOINTS> mc;
+    std::array<Eigen::Vector3d,NJOINTS> hc;
+    std::array<Eigen::Matrix3d,NJOINTS> Ic;
+    FrameJacobian jac;
+    CoMJacobian jac_com;
+    InertiaMatrix M;
+    std::unordered_map<std::string,int> frame_ids;
+
+    /** Free all data*/
+    void clear();
+    /** Throw if update() has not been called yet*/
+    void checkJointState(const std::string& function);
+    /** Throw if the root frame is not the world frame*/
+    void checkRootFrame(const std::string& root_frame, const std::string& tip_frame);
+    /** Joint placements, velocities and accelerations. Called in update()*/
+    void forwardKinematics();
+    /** Recursive Newton-Euler algorithm with the given joint accelerations (gravity is added internally). Result is stored in tau*/
+    void rnea(const std::array<Motion,NJOINTS>& acc);
+    /** Composite rigid body algorithm. Result is stored in M*/
+    void crba();
+    /** CoM Jacobian. Result is stored in jac_com*/
+    void comJac();
+
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    @CLASS@();
+    ~@CLASS@();
+
+    /**
+     * @brief Configure the robot model. The URDF in cfg has to describe the same kinematic tree the model has been generated for.
+     * @param cfg Model configuration. See RobotModelConfig.hpp for details
+     * @return True in case of success, else false
+     */
+    virtual bool configure(const RobotModelConfig& cfg);
+
+    /**
+     * @brief Update the robot configuration
+     * @param joint_state The joint_state vector. Has to contain all robot joints that are configured in the model.
+     * @param poses Optional, only for floating base robots: update the floating base state of the robot model.
+     */
+    virtual void update(const base::samples::Joints& joint_state,
+                        const base::samples::RigidBodyStateSE3& floating_base_state = base::samples::RigidBodyStateSE3());
+
+    /** Return entire system state*/
+    virtual void systemState(base::VectorXd &q, base::VectorXd &qd, base::VectorXd &qdd);
+
+    /** Returns the pose, twist and spatial acceleration between the two given frames. All quantities are defined in root_frame coordinates*/
+    virtual const base::samples::RigidBodyStateSE3 &rigidBodyState(const std::string &root_frame, const std::string &tip_frame);
+
+    /** @brief Returns the Space Jacobian for the kinematic chain between root and the tip frame as full body Jacobian. See RobotModel.hpp for details*/
+    virtual const base::MatrixXd &spaceJacobian(const std::string &root_frame, const std::string &tip_frame);
+
+    /** @brief Returns the Body Jacobian for the kinematic chain between root and the tip frame as full body Jacobian. See RobotModel.hpp for details*/
+    virtual const base::MatrixXd &bodyJacobian(const std::string &root_frame, const std::string &tip_frame);
+
+    /** @brief Returns the CoM Jacobian for the entire robot. See RobotModel.hpp for details*/
+    virtual const base::MatrixXd &comJacobian();
+
+    /** @brief Returns the spatial acceleration bias, i.e. the term Jdot*qdot*/
+    virtual const base::Acceleration &spatialAccelerationBias(const std::string &root_frame, const std::string &tip_frame);
+
+    /** @brief Not implemented*/
+    virtual const base::MatrixXd &jacobianDot(const std::string &root_frame, const std::string &tip_frame);
+
+    /** @brief Compute and return the joint space mass-inertia matrix, which is nj x nj, where nj is the number of joints of the system*/
+    virtual const base::MatrixXd &jointSpaceInertiaMatrix();
+
+    /** @brief Compute and return the bias force vector, which is nj x 1, where nj is the number of joints of the system*/
+    virtual const base::VectorXd &biasForces();
+
+    /** @brief Compute and return center of mass expressed in base frame*/
+    virtual const base::samples::RigidBodyStateSE3& centerOfMass();
+
+    /** @brief Compute and return the inverse dynamics solution*/
+    virtual void computeInverseDynamics(base::commands::Joints &solver_output);
+
+    /** @brief Index of the given frame (link or joint name), to be used with the fixed size interface below. Throws if the frame does not exist*/
+    int frameId(const std::string& frame) const;
+
+    /** @brief Compute the Jacobian of the given frame. If local is true, the Jacobian is given in frame coordinates (body Jacobian),
+     *  otherwise in world coordinates with reference point in the frame origin (space Jacobian)*/
+    void frameJacobian(int frame_id, bool local, FrameJacobian& J) const;
+
+    /** @brief Compute and return the joint space mass-inertia matrix in fixed size*/
+    const InertiaMatrix& inertiaMatrix();
+
+    /** @brief Compute and return the CoM Jacobian in fixed size*/
+    const CoMJacobian& centerOfMassJacobian();
+};
+
+}
+
+#endif
+)code";
+
+const char* source_helpers = R"code(
+typedef Eigen::Matrix<double,6,1> Vector6d;
+
+inline Eigen::Matrix3d skew(const Eigen::Vector3d& v){
+    Eigen::Matrix3d S;
+    S << 0, -v(2), v(1),
+         v(2), 0, -v(0),
+         -v(1), v(0), 0;
+    return S;
+}
+
+/** Express motion m (parent coordinates) in child coordinates, where (R,p) is the placement of the child in the parent frame*/
+inline Vector6d actInvMotion(const Eigen::Matrix3d& R, const Eigen::Vector3d& p, const Vector6d& m){
+    Vector6d res;
+    res.head<3>() = R.transpose()*(m.head<3>() - p.cross(m.tail<3>()));
+    res.tail<3>() = R.transpose()*m.tail<3>();
+    return res;
+}
+
+/** Express force f (child coordinates) in parent coordinates, where (R,p) is the placement of the child in the parent frame*/
+inline Vector6d actForce(const Eigen::Matrix3d& R, const Eigen::Vector3d& p, const Vector6d& f){
+    Vector6d res;
+    res.head<3>() = R*f.head<3>();
+    res.tail<3>() = R*f.tail<3>() + p.cross(res.head<3>());
+    return res;
+}
+
+/** Spatial cross product v x m for motion vectors*/
+inline Vector6d crossMotion(const Vector6d& v, const Vector6d& m){
+    Vector6d res;
+    res.head<3>() = v.tail<3>().cross(m.head<3>()) + v.head<3>().cross(m.tail<3>());
+    res.tail<3>() = v.tail<3>().cross(m.tail<3>());
+    return res;
+}
+
+/** Spatial cross product v x* f for force vectors*/
+inline Vector6d crossForce(const Vector6d& v, const Vector6d& f){
+    Vector6d res;
+    res.head<3>() = v.tail<3>().cross(f.head<3>());
+    res.tail<3>() = v.tail<3>().cross(f.tail<3>()) + v.head<3>().cross(f.head<3>());
+    return res;
+}
+
+/** Product of the spatial inertia (m,h,I) and the motion vector v*/
+inline Vector6d inertiaTimes(double m, const Eigen::Vector3d& h, const Eigen::Matrix3d& I, const Vector6d& v){
+    Vector6d res;
+    res.head<3>() = m*v.head<3>() - h.cross(v.tail<3>());
+    res.tail<3>() = h.cross(v.head<3>()) + I*v.tail<3>();
+    return res;
+}
+
+/** 6x6 matrix of the spatial inertia (m,h,I)*/
+inline Eigen::Matrix<double,6,6> inertiaMatrix6(double m, const Eigen::Vector3d& h, const Eigen::Matrix3d& I){
+    Eigen::Matrix<double,6,6> res;
+    res.topLeftCorner<3,3>() = m*Eigen::Matrix3d::Identity();
+    res.topRightCorner<3,3>() = -skew(h);
+    res.bottomLeftCorner<3,3>() = skew(h);
+    res.bottomRightCorner<3,3>() = I;
+    return res;
+}
+
+/** Add the spatial inertia (m,h,I), given in child coordinates, to the spatial inertia (m_parent,h_parent,I_parent), given in parent coordinates*/
+inline void addInertia(const Eigen::Matrix3d& R, const Eigen::Vector3d& p, double m, const Eigen::Vector3d& h, const Eigen::Matrix3d& I,
+                       double& m_parent, Eigen::Vector3d& h_parent, Eigen::Matrix3d& I_parent){
+    const Eigen::Vector3d hr = R*h;
+    const Eigen::Matrix3d Sp = skew(p), Sh = skew(hr);
+    I_parent += R*I*R.transpose() - Sh*Sp - Sp*Sh - m*Sp*Sp;
+    h_parent += hr + m*p;
+    m_parent += m;
+}
+)code";
+
+const char* source_template = R"code(
+@CLASS@::@CLASS@(){
+    for(int i = 0; i < NFRAMES; i++)
+        frame_ids.insert(std::make_pair(std::string(frame_names[i]), i));
+    clear();
+}
+
+@CLASS@::~@CLASS@(){
+}
+
+void @CLASS@::clear(){
+
+    RobotModel::clear();
+    q.setZero();
+    if(FLOATING_BASE)
+        q[6] = 1;
+    qd.setZero();
+    qdd.setZero();
+    tau.setZero();
+    for(int i = 0; i < NJOINTS; i++){
+        oR[i].setIdentity();
+        liR[i].setIdentity();
+        op[i].setZero();
+        lip[i].setZero();
+        v[i].setZero();
+        a[i].setZero();
+        a_bias[i].setZero();
+        f[i].setZero();
+    }
+    jac.setZero();
+    jac_com.setZero();
+    M.setZero();
+}
+
+bool @CLASS@::configure(const RobotModelConfig& cfg){
+
+    clear();
+
+    // 1. Load Robot Model
+
+    robot_model_config = cfg;
+    if(cfg.floating_base != FLOATING_BASE){
+        LOG_ERROR("@CLASS@: Model has been generated with floating_base = %d, but configuration has floating_base = %d", FLOATING_BASE, cfg.floating_base);
+        return false;
+    }
+    robot_urdf = loadRobotURDF(cfg.file_or_string);
+    if(!robot_urdf){
+        LOG_ERROR("Unable to parse urdf model");
+        return false;
+    }
+    base_frame =  robot_urdf->getRoot()->name;
+    if(!URDFTools::applyJointBlacklist(robot_urdf, cfg.joint_blacklist))
+        return false;
+
+    // The URDF has to describe the same kinematic tree the model has been generated for
+    std::vector<std::string> urdf_joint_names = URDFTools::jointNamesFromURDF(robot_urdf);
+    std::vector<std::string> generated_joint_names(movable_joint_names.begin(), movable_joint_names.end());
+    if(urdf_joint_names != generated_joint_names){
+        LOG_ERROR("@CLASS@: Movable joints in URDF do not match the joints the model has been generated for. Did you change the URDF or the joint blacklist?");
+        return false;
+    }
+
+    has_floating_base = cfg.floating_base;
+    world_frame = base_frame;
+    if(has_floating_base){
+        joint_names_floating_base = URDFTools::addFloatingBaseToURDF(robot_urdf);
+        world_frame = robot_urdf->getRoot()->name;
+    }
+    actuated_joint_names = generated_joint_names;
+    joint_names = independent_joint_names = joint_names_floating_base + actuated_joint_names;
+
+    // 2. Verify consistency of URDF and config
+
+    // All contact point have to be a valid link in the robot URDF
+    for(auto c : cfg.contact_points.names){
+        if(!hasLink(c)){
+            LOG_ERROR("Contact point %s is not a valid link in the robot model", c.c_str());
+            return false;
+        }
+    }
+
+    // 3. Create data structures
+
+    joint_state.resize(joint_names.size());
+    joint_state.names = joint_names;
+
+    URDFTools::jointLimitsFromURDF(robot_urdf, joint_limits);
+
+    selection_matrix.resize(noOfActuatedJoints(),noOfJoints());
+    selection_matrix.setZero();
+    for(uint i = 0; i < actuated_joint_names.size(); i++)
+        selection_matrix(i, jointIndex(actuated_joint_names[i])) = 1.0;
+
+    active_contacts = cfg.contact_points;
+
+    return true;
+}
+
+void @CLASS@::update(const base::samples::Joints& joint_state_in,
+                     const base::samples::RigidBodyStateSE3& floating_base_state_in){
+    if(joint_state_in.elements.size() != joint_state_in.names.size()){
+        LOG_ERROR_S << "Size of names and size of elements in joint state do not match"<<std::endl;
+        throw std::runtime_error("Invalid joint state");
+    }
+
+    if(joint_state_in.time.isNull()){
+        LOG_ERROR_S << "Joint State does not have a valid timestamp. Or do we have 1970?"<<std::endl;
+        throw std::runtime_error("Invalid joint state");
+    }
+
+    // New robot state: The factorization of the joint space inertia matrix has to be recomputed on demand
+    inertia_factorization_valid = false;
+
+    const int start_idx = has_floating_base ? 6 : 0;
+    for(uint i = 0; i < actuated_joint_names.size(); i++){
+        const std::string& name = actuated_joint_names[i];
+        base::JointState state;
+        try{
+            state = joint_state_in[name];
+        }
+        catch(...){
+            LOG_ERROR_S << "Joint " << name << " is a non-fixed joint in the robot model, but it is not in the joint state vector."
+                        << "You should either set the joint to 'fixed' in your URDF file or provide a valid joint state for it" << std::endl;
+            throw std::runtime_error("Incomplete Joint State");
+        }
+        joint_state[name] = state;
+        q[i+(NQ-NV)+start_idx] = state.position;
+        qd[i+start_idx]        = state.speed;
+        qdd[i+start_idx]       = state.acceleration;
+    }
+    joint_state.time = joint_state_in.time;
+
+    if(has_floating_base){
+        if(!floating_base_state_in.hasValidPose() ||
+           !floating_base_state_in.hasValidTwist() ||
+           !floating_base_state_in.hasValidAcceleration()){
+           LOG_ERROR("Invalid status of floating base given! One (or all) of pose, twist or acceleration members is invalid (Either NaN or non-unit quaternion)");
+           throw std::runtime_error("Invalid floating base status");
+        }
+        if(floating_base_state_in.time.isNull()){
+            LOG_ERROR("Floating base state does not have a valid timestamp. Or do we have 1970?");
+            throw std::runtime_error("Invalid call to update()");
+        }
+
+        // The floating base twist/acceleration is expected in local coordinates. However, we
+        // want to give the linear part in world coordinates and the angular part in local coordinates
+        floating_base_state = floating_base_state_in;
+        base::Matrix3d fb_rot = floating_base_state.pose.orientation.toRotationMatrix();
+
+        base::Twist fb_twist = floating_base_state.twist;
+        fb_twist.linear = fb_rot.transpose() * floating_base_state.twist.linear;
+
+        base::Acceleration fb_acc = floating_base_state.acceleration;
+        fb_acc.linear = fb_rot.transpose() * floating_base_state.acceleration.linear;
+
+        base::Vector3d euler = fb_rot.eulerAngles(0, 1, 2);
+        for(int i = 0; i < 3; i++){
+            q[i]     = joint_state[joint_names_floating_base[i]].position       = floating_base_state.pose.position[i];
+            joint_state[joint_names_floating_base[i+3]].position = euler(i);
+            qd[i]    = joint_state[joint_names_floating_base[i]].speed          = fb_twist.linear[i];
+            qd[i+3]  = joint_state[joint_names_floating_base[i+3]].speed        = fb_twist.angular[i];
+            qdd[i]   = joint_state[joint_names_floating_base[i]].acceleration   = fb_acc.linear[i];
+            qdd[i+3] = joint_state[joint_names_floating_base[i+3]].acceleration = fb_acc.angular[i];
+        }
+        q[3] = floating_base_state.pose.orientation.x();
+        q[4] = floating_base_state.pose.orientation.y();
+        q[5] = floating_base_state.pose.orientation.z();
+        q[6] = floating_base_state.pose.orientation.w();
+
+        if(floating_base_state.time > joint_state.time)
+            joint_state.time = floating_base_state.time;
+    }
+
+    forwardKinematics();
+}
+
+void @CLASS@::systemState(base::VectorXd &_q, base::VectorXd &_qd, base::VectorXd &_qdd){
+    _q = q;
+    _qd = qd;
+    _qdd = qdd;
+}
+
+void @CLASS@::checkJointState(const std::string& function){
+    if(joint_state.time.isNull()){
+        LOG_ERROR("@CLASS@: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
+        throw std::runtime_error("Invalid call to " + function + "()");
+    }
+}
+
+void @CLASS@::checkRootFrame(const std::string& root_frame, const std::string& tip_frame){
+    if(root_frame != world_frame){
+        LOG_ERROR_S<<"Requested kinematics for chain "<<root_frame<<"->"<<tip_frame<<" but the robot model always requires the root frame to be the root of the full model"<<std::endl;
+        throw std::runtime_error("Invalid root frame");
+    }
+}
+
+int @CLASS@::frameId(const std::string& frame) const{
+    auto it = frame_ids.find(frame == "world" ? "universe" : frame);
+    if(it == frame_ids.end()){
+        LOG_ERROR_S<<"Requested frame "<<frame<<" but this frame does not exist in the robot model"<<std::endl;
+        throw std::runtime_error("Invalid tip frame");
+    }
+    return it->second;
+}
+
+const base::samples::RigidBodyStateSE3 &@CLASS@::rigidBodyState(const std::string &root_frame, const std::string &tip_frame){
+
+    checkJointState("rigidBodyState");
+    checkRootFrame(root_frame, tip_frame);
+
+    const int id = frameId(tip_frame);
+    const int j = frame_joint[id];
+    const Eigen::Vector3d& p = frame_p[id];
+    const Eigen::Vector3d vel = v[j].head<3>() + v[j].tail<3>().cross(p);
+
+    rbs.time = joint_state.time;
+    rbs.frame_id = root_frame;
+    rbs.pose.position = op[j] + oR[j]*p;
+    rbs.pose.orientation = base::Quaterniond(oR[j]*frame_R[id]);
+    // Twist and classical acceleration of the frame origin in world-aligned coordinates
+    rbs.twist.linear = oR[j]*vel;
+    rbs.twist.angular = oR[j]*v[j].tail<3>();
+    rbs.acceleration.linear = oR[j]*(a[j].head<3>() + a[j].tail<3>().cross(p) + v[j].tail<3>().cross(vel));
+    rbs.acceleration.angular = oR[j]*a[j].tail<3>();
+
+    return rbs;
+}
+
+const base::MatrixXd &@CLASS@::spaceJacobian(const std::string &root_frame, const std::string &tip_frame){
+
+    checkJointState("spaceJacobian");
+    checkRootFrame(root_frame, tip_frame);
+
+    frameJacobian(frameId(tip_frame), false, jac);
+    base::MatrixXd& J = space_jac_map[chainID(root_frame, tip_frame)];
+    J = jac;
+    return J;
+}
+
+const base::MatrixXd &@CLASS@::bodyJacobian(const std::string &root_frame, const std::string &tip_frame){
+
+    checkJointState("bodyJacobian");
+    checkRootFrame(root_frame, tip_frame);
+
+    frameJacobian(frameId(tip_frame), true, jac);
+    base::MatrixXd& J = body_jac_map[chainID(root_frame, tip_frame)];
+    J = jac;
+    return J;
+}
+
+const base::MatrixXd &@CLASS@::comJacobian(){
+
+    checkJointState("comJacobian");
+    comJac();
+    com_jac = jac_com;
+    return com_jac;
+}
+
+const @CLASS@::CoMJacobian& @CLASS@::centerOfMassJacobian(){
+
+    checkJointState("centerOfMassJacobian");
+    comJac();
+    return jac_com;
+}
+
+const base::Acceleration &@CLASS@::spatialAccelerationBias(const std::string &root_frame, const std::string &tip_frame){
+
+    checkJointState("spatialAccelerationBias");
+    checkRootFrame(root_frame, tip_frame);
+
+    const int id = frameId(tip_frame);
+    const int j = frame_joint[id];
+    const Eigen::Vector3d& p = frame_p[id];
+    const Eigen::Vector3d vel = v[j].head<3>() + v[j].tail<3>().cross(p);
+    spatial_acc_bias.linear = oR[j]*(a_bias[j].head<3>() + a_bias[j].tail<3>().cross(p) + v[j].tail<3>().cross(vel));
+    spatial_acc_bias.angular = oR[j]*a_bias[j].tail<3>();
+    return spatial_acc_bias;
+}
+
+const base::MatrixXd &@CLASS@::jacobianDot(const std::string &root_frame, const std::string &tip_frame){
+
+    throw std::runtime_error("Not implemented: jacobianDot has not been implemented for @CLASS@");
+}
+
+const base::MatrixXd &@CLASS@::jointSpaceInertiaMatrix(){
+
+    checkJointState("jointSpaceInertiaMatrix");
+    crba();
+    joint_space_inertia_mat = M;
+    return joint_space_inertia_mat;
+}
+
+const @CLASS@::InertiaMatrix& @CLASS@::inertiaMatrix(){
+
+    checkJointState("inertiaMatrix");
+    crba();
+    return M;
+}
+
+const base::VectorXd &@CLASS@::biasForces(){
+
+    checkJointState("biasForces");
+    rnea(a_bias);
+    bias_forces = tau;
+    return bias_forces;
+}
+
+void @CLASS@::computeInverseDynamics(base::commands::Joints &solver_output){
+
+    checkJointState("computeInverseDynamics");
+    rnea(a);
+
+    const int start_idx = has_floating_base ? 6 : 0;
+    for(uint i = 0; i < actuated_joint_names.size(); i++)
+        solver_output[actuated_joint_names[i]].effort = tau[i+start_idx];
+}
+)code";
+
+}
+
+RobotModelCodeGenerator::RobotModelCodeGenerator() : nq(0), nv(0){
+}
+
+RobotModelCodeGenerator::~RobotModelCodeGenerator(){
+}
+
+bool RobotModelCodeGenerator::configure(const RobotModelConfig& cfg, const std::string& _class_name, const std::string& _plugin_name){
+
+    joints.clear();
+    frames.clear();
+    nq = nv = 0;
+
+    if(!std::regex_match(_class_name, std::regex("[A-Za-z_][A-Za-z0-9_]*"))){
+        LOG_ERROR("RobotModelCodeGenerator: Class name '%s' is not a valid C++ identifier", _class_name.c_str());
+        return false;
+    }
+    if(_plugin_name.empty()){
+        LOG_ERROR("RobotModelCodeGenerator: Plugin name must not be empty");
+        return false;
+    }
+    class_name = _class_name;
+    plugin_name = _plugin_name;
+    robot_model_config = cfg;
+
+    std::ifstream fs(cfg.file_or_string.c_str());
+    if(fs)
+        robot_urdf = urdf::parseURDFFile(cfg.file_or_string);
+    else
+        robot_urdf = urdf::parseURDF(cfg.file_or_string);
+    if(!robot_urdf){
+        LOG_ERROR("RobotModelCodeGenerator: Unable to parse urdf model");
+        return false;
+    }
+    if(!URDFTools::applyJointBlacklist(robot_urdf, cfg.joint_blacklist))
+        return false;
+
+    Joint root;
+    root.name = "universe";
+    root.type = universe;
+    root.parent = -1;
+    root.R.setIdentity();
+    root.p.setZero();
+    root.axis.setZero();
+    root.idx_q = root.idx_v = root.nq = root.nv = 0;
+    root.mass = 0;
+    root.h.setZero();
+    root.I.setZero();
+    joints.push_back(root);
+    addFrame("universe", 0, base::Matrix3d::Identity(), base::Vector3d::Zero());
+
+    if(cfg.floating_base){
+        Joint fb = root;
+        fb.name = "root_joint";
+        fb.type = freeflyer;
+        fb.parent = 0;
+        fb.nq = 7;
+        fb.nv = 6;
+        joints.push_back(fb);
+        nq = 7;
+        nv = 6;
+        addFrame("root_joint", 1, base::Matrix3d::Identity(), base::Vector3d::Zero());
+    }
+
+    try{
+        addLink(robot_urdf->getRoot(), joints.size()-1, base::Matrix3d::Identity(), base::Vector3d::Zero());
+    }
+    catch(std::runtime_error e){
+        LOG_ERROR_S << "RobotModelCodeGenerator: " << e.what() << std::endl;
+        return false;
+    }
+
+    if(joints.size() < 2){
+        LOG_ERROR("RobotModelCodeGenerator: Robot model does not have any movable joints");
+        return false;
+    }
+    if(totalMass() <= 0){
+        LOG_ERROR("RobotModelCodeGenerator: Total mass of the robot model has to be > 0");
+        return false;
+    }
+
+    return true;
+}
+
+void RobotModelCodeGenerator::addFrame(const std::string& name, int joint_idx, const base::Matrix3d& R, const base::Vector3d& p){
+    // Same as in pinocchio: if names are ambiguous, the first frame wins
+    for(const auto& f : frames)
+        if(f.name == name)
+            return;
+    Frame frame;
+    frame.name = name;
+    frame.joint = joint_idx;
+    frame.R = R;
+    frame.p = p;
+    frames.push_back(frame);
+}
+
+void RobotModelCodeGenerator::addLink(urdf::LinkConstSharedPtr link, int joint_idx, const base::Matrix3d& R, const base::Vector3d& p){
+
+    addFrame(link->name, joint_idx, R, p);
+
+    // Append the link inertia to the body of the supporting joint
+    if(link->inertial){
+        const urdf::Inertial& inertial = *link->inertial;
+        const urdf::Pose& origin = inertial.origin;
+        base::Matrix3d R_inertial = R * base::Quaterniond(origin.rotation.w, origin.rotation.x, origin.rotation.y, origin.rotation.z).toRotationMatrix();
+        base::Vector3d com = p + R * base::Vector3d(origin.position.x, origin.position.y, origin.position.z);
+        base::Matrix3d I_com;
+        I_com << inertial.ixx, inertial.ixy, inertial.ixz,
+                 inertial.ixy, inertial.iyy, inertial.iyz,
+                 inertial.ixz, inertial.iyz, inertial.izz;
+        Joint& joint = joints[joint_idx];
+        joint.mass += inertial.mass;
+        joint.h += inertial.mass * com;
+        joint.I += R_inertial * I_com * R_inertial.transpose() - inertial.mass * skew(com) * skew(com);
+    }
+
+    for(const urdf::JointSharedPtr& urdf_joint : link->child_joints){
+        urdf::LinkConstSharedPtr child = robot_urdf->getLink(urdf_joint->child_link_name);
+        if(!child)
+            throw std::runtime_error("Child link " + urdf_joint->child_link_name + " of joint " + urdf_joint->name + " does not exist");
+
+        const urdf::Pose& origin = urdf_joint->parent_to_joint_origin_transform;
+        base::Matrix3d R_joint = R * base::Quaterniond(origin.rotation.w, origin.rotation.x, origin.rotation.y, origin.rotation.z).toRotationMatrix();
+        base::Vector3d p_joint = p + R * base::Vector3d(origin.position.x, origin.position.y, origin.position.z);
+
+        if(urdf_joint->type == urdf::Joint::FIXED){
+            addFrame(urdf_joint->name, joint_idx, R_joint, p_joint);
+            addLink(child, joint_idx, R_joint, p_joint);
+        }
+        else if(urdf_joint->type == urdf::Joint::REVOLUTE ||
+                urdf_joint->type == urdf::Joint::CONTINUOUS ||
+                urdf_joint->type == urdf::Joint::PRISMATIC){
+            Joint joint;
+            joint.name = urdf_joint->name;
+            joint.type = urdf_joint->type == urdf::Joint::PRISMATIC ? prismatic : revolute;
+            joint.parent = joint_idx;
+            joint.R = R_joint;
+            joint.p = p_joint;
+            joint.axis = base::Vector3d(urdf_joint->axis.x, urdf_joint->axis.y, urdf_joint->axis.z);
+            if(joint.axis.norm() == 0)
+                throw std::runtime_error("Joint " + joint.name + " has invalid axis");
+            joint.axis.normalize();
+            joint.idx_q = nq;
+            joint.idx_v = nv;
+            joint.nq = joint.nv = 1;
+            joint.mass = 0;
+            joint.h.setZero();
+            joint.I.setZero();
+            nq++;
+            nv++;
+            joints.push_back(joint);
+            int idx = joints.size()-1;
+            addFrame(urdf_joint->name, idx, base::Matrix3d::Identity(), base::Vector3d::Zero());
+            addLink(child, idx, base::Matrix3d::Identity(), base::Vector3d::Zero());
+        }
+        else
+            throw std::runtime_error("Joint " + urdf_joint->name + " has unsupported type. Only fixed, revolute, continuous and prismatic joints are supported");
+    }
+}
+
+std::vector<int> RobotModelCodeGenerator::supportingJoints(int joint_idx) const{
+    std::vector<int> support;
+    for(int j = joint_idx; j > 0; j = joints[j].parent)
+        support.insert(support.begin(), j);
+    return support;
+}
+
+double RobotModelCodeGenerator::subtreeMass(int joint_idx) const{
+    double mass = joints[joint_idx].mass;
+    for(size_t j = joint_idx+1; j < joints.size(); j++){
+        std::vector<int> support = supportingJoints(j);
+        if(std::find(support.begin(), support.end(), joint_idx) != support.end())
+            mass += joints[j].mass;
+    }
+    return mass;
+}
+
+double RobotModelCodeGenerator::totalMass() const{
+    double mass = 0;
+    for(size_t j = 1; j < joints.size(); j++)
+        mass += joints[j].mass;
+    return mass;
+}
+
+void RobotModelCodeGenerator::writeHeader(std::ostream& os) const{
+
+    std::string guard = class_name;
+    std::transform(guard.begin(), guard.end(), guard.begin(), ::toupper);
+    std::string blacklist;
+    for(const auto& name : robot_model_config.joint_blacklist)
+        blacklist += (blacklist.empty() ? "" : ", ") + name;
+
+    std::string header = header_template;
+    header = replaceAll(header, "@URDF@", robot_urdf->getName() + " URDF");
+    header = replaceAll(header, "@GUARD@", guard + "_HPP");
+    header = replaceAll(header, "@ROBOT@", robot_urdf->getName());
+    header = replaceAll(header, "@FLOATING_BASE@", robot_model_config.floating_base ? "true" : "false");
+    header = replaceAll(header, "@BLACKLIST@", blacklist.empty() ? "none" : blacklist);
+    header = replaceAll(header, "@NQ@", std::to_string(nq));
+    header = replaceAll(header, "@NV@", std::to_string(nv));
+    header = replaceAll(header, "@NJOINTS@", std::to_string(joints.size()));
+    header = replaceAll(header, "@NFRAMES@", std::to_string(frames.size()));
+    header = replaceAll(header, "@CLASS@", class_name);
+    os << header;
+}
+
+void RobotModelCodeGenerator::writeSource(std::ostream& os) const{
+
+    os << "// This file has been generated by RobotModelCodeGenerator from " << robot_urdf->getName() << " URDF. Do not edit!\n";
+    os << "#include \"" << class_name << ".hpp\"\n";
+    os << "#include <tools/URDFTools.hpp>\n";
+    os << "#include <base-logging/Logging.hpp>\n\n";
+    os << "namespace wbc{\n\n";
+    os << "RobotModelRegistry<" << class_name << "> " << class_name << "::reg(\"" << plugin_name << "\");\n\n";
+    os << "namespace{\n";
+    os << source_helpers << "\n";
+
+    os << "const bool FLOATING_BASE = " << (robot_model_config.floating_base ? "true" : "false") << ";\n\n";
+
+    os << "const std::array<const char*," << nv - (robot_model_config.floating_base ? 6 : 0) << "> movable_joint_names = {{\n";
+    for(size_t j = 1; j < joints.size(); j++)
+        if(joints[j].type != freeflyer)
+            os << "    \"" << joints[j].name << "\",\n";
+    os << "}};\n\n";
+
+    os << "// Inertia of the rigid body attached to each joint: mass, first moment of mass, rotational inertia w.r.t. joint origin\n";
+    os << "const std::array<double," << joints.size() << "> body_mass = {{\n";
+    for(const auto& j : joints)
+        os << "    " << num(j.mass) << ",\n";
+    os << "}};\n";
+    os << "const std::array<Eigen::Vector3d," << joints.size() << "> body_h = {{\n";
+    for(const auto& j : joints)
+        os << "    " << vec3(j.h) << ",\n";
+    os << "}};\n";
+    os << "const std::array<Eigen::Matrix3d," << joints.size() << "> body_I = {{\n";
+    for(const auto& j : joints)
+        os << "    " << mat3(j.I) << ",\n";
+    os << "}};\n\n";
+
+    os << "// Joint placements in parent joint coordinates\n";
+    os << "const std::array<Eigen::Matrix3d," << joints.size() << "> joint_R = {{\n";
+    for(const auto& j : joints)
+        os << "    " << mat3(j.R) << ",\n";
+    os << "}};\n";
+    os << "const std::array<Eigen::Vector3d," << joints.size() << "> joint_p = {{\n";
+    for(const auto& j : joints)
+        os << "    " << vec3(j.p) << ",\n";
+    os << "}};\n\n";
+
+    os << "// Frames: name, supporting joint and placement in joint coordinates\n";
+    os << "const std::array<const char*," << frames.size() << "> frame_names = {{\n";
+    for(const auto& f : frames)
+        os << "    \"" << f.name << "\",\n";
+    os << "}};\n";
+    os << "const std::array<int," << frames.size() << "> frame_joint = {{\n";
+    for(const auto& f : frames)
+        os << "    " << f.joint << ",\n";
+    os << "}};\n";
+    os << "const std::array<Eigen::Matrix3d," << frames.size() << "> frame_R = {{\n";
+    for(const auto& f : frames)
+        os << "    " << mat3(f.R) << ",\n";
+    os << "}};\n";
+    os << "const std::array<Eigen::Vector3d," << frames.size() << "> frame_p = {{\n";
+    for(const auto& f : frames)
+        os << "    " << vec3(f.p) << ",\n";
+    os << "}};\n\n";
+    os << "}\n";
+
+    os << replaceAll(source_template, "@CLASS@", class_name);
+
+    writeForwardKinematics(os);
+    writeRNEA(os);
+    writeCRBA(os);
+    writeFrameJacobian(os);
+    writeCoM(os);
+
+    os << "}\n";
+}
+
+void RobotModelCodeGenerator::writeForwardKinematics(std::ostream& os) const{
+
+    os << "\nvoid " << class_name << "::forwardKinematics(){\n\n";
+    os << "    Motion vj;\n";
+    os << "    Eigen::Matrix3d Rq;\n";
+    for(size_t k = 1; k < joints.size(); k++){
+        const Joint& joint = joints[k];
+        const std::string i = std::to_string(k);
+        const std::string parent = std::to_string(joint.parent);
+        const std::string iq = std::to_string(joint.idx_q);
+        const std::string iv = std::to_string(joint.idx_v);
+
+        os << "\n    // Joint " << k << ": " << joint.name << ", parent: " << joints[joint.parent].name << "\n";
+        if(joint.type == freeflyer){
+            os << "    oR[" << i << "] = liR[" << i << "] = Eigen::Quaterniond(q[6], q[3], q[4], q[5]).normalized().toRotationMatrix();\n";
+            os << "    op[" << i << "] = lip[" << i << "] = q.head<3>();\n";
+            os << "    v[" << i << "] = qd.head<6>();\n";
+            os << "    a[" << i << "] = qdd.head<6>();\n";
+            os << "    a_bias[" << i << "].setZero();\n";
+            continue;
+        }
+
+        std::string R_expr = isIdentity(joint.R) ? "" : "joint_R[" + i + "]*";
+        if(joint.type == revolute){
+            int axis = unitAxis(joint.axis);
+            if(axis >= 0){
+                os << "    {\n";
+                os << "        const double c = cos(q[" << iq << "]), s = sin(q[" << iq << "]);\n";
+                if(axis == 0)
+                    os << "        Rq << 1, 0, 0, 0, c, -s, 0, s, c;\n";
+                else if(axis == 1)
+                    os << "        Rq << c, 0, s, 0, 1, 0, -s, 0, c;\n";
+                else
+                    os << "        Rq << c, -s, 0, s, c, 0, 0, 0, 1;\n";
+                os << "    }\n";
+            }
+            else
+                os << "    Rq = Eigen::AngleAxisd(q[" << iq << "], " << vec3(joint.axis) << ").toRotationMatrix();\n";
+            os << "    liR[" << i << "] = " << R_expr << "Rq;\n";
+            os << "    lip[" << i << "] = joint_p[" << i << "];\n";
+        }
+        else{
+            os << "    liR[" << i << "] = joint_R[" << i << "];\n";
+            os << "    lip[" << i << "] = joint_p[" << i << "] + " << R_expr << vec3(joint.axis) << "*q[" << iq << "];\n";
+        }
+        os << "    vj.setZero();\n";
+        os << "    " << addMotion(joint, "vj", "qd[" + iv + "]") << "\n";
+        if(joint.parent == 0){
+            os << "    oR[" << i << "] = liR[" << i << "];\n";
+            os << "    op[" << i << "] = lip[" << i << "];\n";
+            os << "    v[" << i << "] = vj;\n";
+            os << "    a_bias[" << i << "].setZero();\n";
+            os << "    a[" << i << "].setZero();\n";
+        }
+        else{
+            os << "    oR[" << i << "] = oR[" << parent << "]*liR[" << i << "];\n";
+            os << "    op[" << i << "] = op[" << parent << "] + oR[" << parent << "]*lip[" << i << "];\n";
+            os << "    v[" << i << "] = actInvMotion(liR[" << i << "], lip[" << i << "], v[" << parent << "]) + vj;\n";
+            os << "    a_bias[" << i << "] = actInvMotion(liR[" << i << "], lip[" << i << "], a_bias[" << parent << "]) + crossMotion(v[" << i << "], vj);\n";
+            os << "    a[" << i << "] = actInvMotion(liR[" << i << "], lip[" << i << "], a[" << parent << "]) + crossMotion(v[" << i << "], vj);\n";
+        }
+        os << "    " << addMotion(joint, "a[" + i + "]", "qdd[" + iv + "]") << "\n";
+    }
+    os << "}\n";
+}
+
+void RobotModelCodeGenerator::writeRNEA(std::ostream& os) const{
+
+    os << "\nvoid " << class_name << "::rnea(const std::array<Motion,NJOINTS>& acc){\n\n";
+    os << "    Motion a_g;\n\n";
+    os << "    // Forward pass: Body forces\n";
+    for(size_t k = 1; k < joints.size(); k++){
+        const std::string i = std::to_string(k);
+        if(joints[k].mass == 0 && joints[k].I.isZero()){
+            os << "    f[" << i << "].setZero();\n";
+            continue;
+        }
+        os << "    a_g = acc[" << i << "];\n";
+        os << "    a_g.head<3>() -= oR[" << i << "].transpose()*gravity;\n";
+        os << "    f[" << i << "] = inertiaTimes(body_mass[" << i << "], body_h[" << i << "], body_I[" << i << "], a_g) + "
+           << "crossForce(v[" << i << "], inertiaTimes(body_mass[" << i << "], body_h[" << i << "], body_I[" << i << "], v[" << i << "]));\n";
+    }
+    os << "\n    // Backward pass: Joint torques\n";
+    for(size_t k = joints.size()-1; k > 0; k--){
+        const Joint& joint = joints[k];
+        const std::string i = std::to_string(k);
+        if(joint.type == freeflyer)
+            os << "    tau.head<6>() = f[" << i << "];\n";
+        else
+            os << "    tau[" << joint.idx_v << "] = " << projectForce(joint, "f[" + i + "]") << ";\n";
+        if(joint.parent > 0)
+            os << "    f[" << joint.parent << "] += actForce(liR[" << i << "], lip[" << i << "], f[" << i << "]);\n";
+    }
+    os << "}\n";
+}
+
+void RobotModelCodeGenerator::writeCRBA(std::ostream& os) const{
+
+    os << "\nvoid " << class_name << "::crba(){\n\n";
+    os << "    Force F;\n";
+    os << "    Motion S;\n";
+    os << "    for(int i = 0; i < NJOINTS; i++){\n";
+    os << "        mc[i] = body_mass[i];\n";
+    os << "        hc[i] = body_h[i];\n";
+    os << "        Ic[i] = body_I[i];\n";
+    os << "    }\n";
+    for(size_t k = joints.size()-1; k > 0; k--){
+        const Joint& joint = joints[k];
+        const std::string i = std::to_string(k);
+        const int iv = joint.idx_v;
+
+        os << "\n    // Joint " << k << ": " << joint.name << "\n";
+        if(joint.type == freeflyer)
+            os << "    M.topLeftCorner<6,6>() = inertiaMatrix6(mc[" << i << "], hc[" << i << "], Ic[" << i << "]);\n";
+        else{
+            os << "    S.setZero();\n";
+            os << "    " << addMotion(joint, "S", "1.0") << "\n";
+            os << "    F = inertiaTimes(mc[" << i << "], hc[" << i << "], Ic[" << i << "], S);\n";
+            os << "    M(" << iv << "," << iv << ") = " << projectForce(joint, "F") << ";\n";
+            for(int j = k; joints[j].parent > 0; j = joints[j].parent){
+                const Joint& parent = joints[joints[j].parent];
+                os << "    F = actForce(liR[" << j << "], lip[" << j << "], F);\n";
+                if(parent.type == freeflyer){
+                    os << "    M.block<6,1>(0," << iv << ") = F;\n";
+                    os << "    M.block<1,6>(" << iv << ",0) = F.transpose();\n";
+                }
+                else
+                    os << "    M(" << parent.idx_v << "," << iv << ") = M(" << iv << "," << parent.idx_v << ") = " << projectForce(parent, "F") << ";\n";
+            }
+        }
+        if(joint.parent > 0)
+            os << "    addInertia(liR[" << i << "], lip[" << i << "], mc[" << i << "], hc[" << i << "], Ic[" << i << "], "
+               << "mc[" << joint.parent << "], hc[" << joint.parent << "], Ic[" << joint.parent << "]);\n";
+    }
+    os << "}\n";
+}
+
+void RobotModelCodeGenerator::writeFrameJacobian(std::ostream& os) const{
+
+    os << "\nvoid " << class_name << "::frameJacobian(int frame_id, bool local, FrameJacobian& J) const{\n\n";
+    os << "    if(frame_id < 0 || frame_id >= NFRAMES)\n";
+    os << "        throw std::out_of_range(\"" << class_name << "::frameJacobian: Invalid frame id\");\n\n";
+    os << "    const int joint = frame_joint[frame_id];\n";
+    os << "    const Eigen::Vector3d p = op[joint] + oR[joint]*frame_p[frame_id];\n";
+    os << "    Eigen::Vector3d w;\n";
+    os << "    J.setZero();\n";
+    os << "    switch(joint){\n";
+    for(size_t k = 1; k < joints.size(); k++){
+        os << "    case " << k << ":\n";
+        for(int j : supportingJoints(k)){
+            const Joint& joint = joints[j];
+            const int iv = joint.idx_v;
+            if(joint.type == freeflyer){
+                os << "        J.block<3,3>(0,0) = oR[" << j << "];\n";
+                os << "        for(int i = 0; i < 3; i++)\n";
+                os << "            J.block<3,1>(0,3+i) = oR[" << j << "].col(i).cross(p - op[" << j << "]);\n";
+                os << "        J.block<3,3>(3,3) = oR[" << j << "];\n";
+            }
+            else if(joint.type == revolute){
+                os << "        w = " << worldAxis(joint, j) << ";\n";
+                os << "        J.block<3,1>(0," << iv << ") = w.cross(p - op[" << j << "]);\n";
+                os << "        J.block<3,1>(3," << iv << ") = w;\n";
+            }
+            else
+                os << "        J.block<3,1>(0," << iv << ") = " << worldAxis(joint, j) << ";\n";
+        }
+        os << "        break;\n";
+    }
+    os << "    default:\n";
+    os << "        break;\n";
+    os << "    }\n\n";
+    os << "    if(local){\n";
+    os << "        const Eigen::Matrix3d R = (oR[joint]*frame_R[frame_id]).transpose();\n";
+    os << "        J.topRows<3>() = R*J.topRows<3>();\n";
+    os << "        J.bottomRows<3>() = R*J.bottomRows<3>();\n";
+    os << "    }\n";
+    os << "}\n";
+}
+
+void RobotModelCodeGenerator::writeCoM(std::ostream& os) const{
+
+    const double total_mass = totalMass();
+
+    // CoM Jacobian, computed from the first moments of mass of all subtrees (in world coordinates)
+    os << "\nvoid " << class_name << "::comJac(){\n\n";
+    os << "    std::array<Eigen::Vector3d,NJOINTS> h;\n";
+    for(size_t k = 1; k < joints.size(); k++)
+        os << "    h[" << k << "] = body_mass[" << k << "]*op[" << k << "] + oR[" << k << "]*body_h[" << k << "];\n";
+    for(size_t k = joints.size()-1; k > 0; k--)
+        if(joints[k].parent > 0)
+            os << "    h[" << joints[k].parent << "] += h[" << k << "];\n";
+    for(size_t k = 1; k < joints.size(); k++){
+        const Joint& joint = joints[k];
+        const double subtree_mass = subtreeMass(k);
+        if(joint.type == freeflyer){
+            os << "    jac_com.leftCols<3>() = " << num(subtree_mass / total_mass) << "*oR[" << k << "];\n";
+            os << "    for(int i = 0; i < 3; i++)\n";
+            os << "        jac_com.col(3+i) = oR[" << k << "].col(i).cross(h[" << k << "] - " << num(subtree_mass) << "*op[" << k << "]) / " << num(total_mass) << ";\n";
+        }
+        else if(joint.type == revolute)
+            os << "    jac_com.col(" << joint.idx_v << ") = (" << worldAxis(joint, k) << ").cross(h[" << k << "] - " << num(subtree_mass) << "*op[" << k << "]) / " << num(total_mass) << ";\n";
+        else
+            os << "    jac_com.col(" << joint.idx_v << ") = " << num(subtree_mass / total_mass) << "*" << worldAxis(joint, k) << ";\n";
+    }
+    os << "}\n";
+
+    os << "\nconst base::samples::RigidBodyStateSE3& " << class_name << "::centerOfMass(){\n\n";
+    os << "    checkJointState(\"centerOfMass\");\n\n";
+    os << "    Eigen::Vector3d com = Eigen::Vector3d::Zero(), vcom = Eigen::Vector3d::Zero(), acom = Eigen::Vector3d::Zero(), momentum;\n";
+    for(size_t k = 1; k < joints.size(); k++){
+        if(joints[k].mass == 0)
+            continue;
+        const std::string i = std::to_string(k);
+        os << "    com += body_mass[" << i << "]*op[" << i << "] + oR[" << i << "]*body_h[" << i << "];\n";
+        os << "    momentum = body_mass[" << i << "]*v[" << i << "].head<3>() + v[" << i << "].tail<3>().cross(body_h[" << i << "]);\n";
+        os << "    vcom += oR[" << i << "]*momentum;\n";
+        os << "    acom += oR[" << i << "]*(body_mass[" << i << "]*a[" << i << "].head<3>() + a[" << i << "].tail<3>().cross(body_h[" << i << "]) + v[" << i << "].tail<3>().cross(momentum));\n";
+    }
+    os << "\n";
+    os << "    com_rbs.pose.position       = com / " << num(total_mass) << ";\n";
+    os << "    com_rbs.twist.linear        = vcom / " << num(total_mass) << ";\n";
+    os << "    com_rbs.acceleration.linear = acom / " << num(total_mass) << ";\n";
+    os << "    com_rbs.pose.orientation.setIdentity();\n";
+    os << "    com_rbs.twist.angular.setZero();\n";
+    os << "    com_rbs.acceleration.angular.setZero();\n";
+    os << "    com_rbs.time = joint_state.time;\n";
+    os << "    com_rbs.frame_id = world_frame;\n";
+    os << "    return com_rbs;\n";
+    os << "}\n";
+}
+
+void RobotModelCodeGenerator::write(const std::string& output_dir) const{
+
+    std::string prefix = output_dir.empty() ? class_name : output_dir + "/" + class_name;
+
+    std::ofstream header(prefix + ".hpp");
+    if(!header)
+        throw std::runtime_error("RobotModelCodeGenerator: Unable to open " + prefix + ".hpp");
+    writeHeader(header);
+
+    std::ofstream source(prefix + ".cpp");
+    if(!source)
+        throw std::runtime_error("RobotModelCodeGenerator: Unable to open " + prefix + ".cpp");
+    writeSource(source);
+}
+
+}
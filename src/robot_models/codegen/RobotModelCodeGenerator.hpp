@@ -0,0 +1,110 @@
+#ifndef ROBOT_MODEL_CODE_GENERATOR_HPP
+#define ROBOT_MODEL_CODE_GENERATOR_HPP
+
+#include "../../core/RobotModelConfig.hpp"
+#include <base/Eigen.hpp>
+#include <urdf_world/world.h>
+#include <ostream>
+
+namespace wbc {
+
+/**
+ * @brief Offline generator, which creates the C++ source code of a RobotModel plugin for one particular robot. The generated class implements
+ * forward kinematics, frame Jacobians, CRBA and RNEA unrolled for the kinematic tree given by the URDF, the joint blacklist and the floating base flag in the RobotModelConfig.
+ * All quantities are stored in fixed size Eigen matrices and frames can be looked up by integer index. The generated model uses the same joint order
+ * and frame conventions as RobotModelPinocchio, i.e.
+ *  - Joints are ordered depth-first in the order they appear in the URDF, fixed joints are merged into their parent body
+ *  - Floating base: q = [x,y,z,qx,qy,qz,qw,q_joints], qd = [v,w,qd_joints], where v and w are given in base coordinates
+ *  - Space Jacobians are expressed in world coordinates with reference point in the tip frame origin, body Jacobians in tip frame coordinates
+ *
+ * The generated header and source file have to be compiled into a shared library, which registers the model with the given plugin name in the RobotModelFactory.
+ * Continuous joints are treated as revolute joints without limits (nq = 1). Planar and floating joints within the URDF are not supported.
+ */
+class RobotModelCodeGenerator{
+public:
+    enum JointType{universe, revolute, prismatic, freeflyer};
+
+    /** Movable joint of the kinematic tree and the rigid body that is attached to it*/
+    struct Joint{
+        std::string name;
+        JointType type;
+        int parent;            /** Index of the parent joint, -1 for universe*/
+        base::Matrix3d R;      /** Orientation of the joint frame in parent joint coordinates (q = 0)*/
+        base::Vector3d p;      /** Position of the joint frame in parent joint coordinates (q = 0)*/
+        base::Vector3d axis;   /** Normalized joint axis (revolute and prismatic joints only)*/
+        int idx_q, idx_v;      /** Start index in configuration and tangent vector*/
+        int nq, nv;
+        double mass;           /** Mass of the attached rigid body (including all links attached by fixed joints)*/
+        base::Vector3d h;      /** First moment of mass, i.e. mass times center of mass in joint coordinates*/
+        base::Matrix3d I;      /** Rotational inertia w.r.t. the joint frame origin in joint coordinates*/
+    };
+
+    /** Named frame (link or joint) attached to one of the joints with constant placement*/
+    struct Frame{
+        std::string name;
+        int joint;
+        base::Matrix3d R;
+        base::Vector3d p;
+    };
+
+protected:
+    RobotModelConfig robot_model_config;
+    urdf::ModelInterfaceSharedPtr robot_urdf;
+    std::vector<Joint> joints;
+    std::vector<Frame> frames;
+    std::string class_name, plugin_name;
+    int nq, nv;
+
+    void addLink(urdf::LinkConstSharedPtr link, int joint_idx, const base::Matrix3d& R, const base::Vector3d& p);
+    void addFrame(const std::string& name, int joint_idx, const base::Matrix3d& R, const base::Vector3d& p);
+    /** Indices of all joints on the path from the root to the given joint, including the given joint*/
+    std::vector<int> supportingJoints(int joint_idx) const;
+    /** Total mass of all bodies in the subtree of the given joint*/
+    double subtreeMass(int joint_idx) const;
+    /** Total mass of the robot, except the bodies attached to the universe*/
+    double totalMass() const;
+
+    void writeForwardKinematics(std::ostream& os) const;
+    void writeRNEA(std::ostream& os) const;
+    void writeCRBA(std::ostream& os) const;
+    void writeFrameJacobian(std::ostream& os) const;
+    void writeCoM(std::ostream& os) const;
+
+public:
+    RobotModelCodeGenerator();
+    ~RobotModelCodeGenerator();
+
+    /**
+     * @brief Parse the URDF and build the kinematic tree.
+     * @param cfg Model configuration. Only file_or_string, joint_blacklist and floating_base are evaluated
+     * @param class_name Name of the generated RobotModel class. Has to be a valid C++ identifier
+     * @param plugin_name Name the generated robot model is registered with in the RobotModelFactory
+     * @return True in case of success, else false
+     */
+    bool configure(const RobotModelConfig& cfg, const std::string& class_name, const std::string& plugin_name);
+
+    /** @brief Write the header of the generated robot model class*/
+    void writeHeader(std::ostream& os) const;
+
+    /** @brief Write the source file of the generated robot model class*/
+    void writeSource(std::ostream& os) const;
+
+    /** @brief Write header and source file to the given directory. File names will be <class_name>.hpp and <class_name>.cpp*/
+    void write(const std::string& output_dir) const;
+
+    /** @brief Movable joints of the kinematic tree in generated order. Index 0 is the universe*/
+    const std::vector<Joint>& getJoints() const {return joints;}
+
+    /** @brief All frames that can be looked up in the generated robot model*/
+    const std::vector<Frame>& getFrames() const {return frames;}
+
+    /** @brief Dimension of the configuration vector*/
+    int nConfig() const {return nq;}
+
+    /** @brief Dimension of the tangent vector*/
+    int nTangent() const {return nv;}
+};
+
+}
+
+#endif
@@ -0,0 +1,154 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "../RobotModelCodeGenerator.hpp"
+#include "../../pinocchio/RobotModelPinocchio.hpp"
+#include "../../test/test_robot_model.hpp"
+#include "RobotModelKukaIiwa.hpp"
+#include "RobotModelKukaIiwaFloatingBase.hpp"
+
+using namespace std;
+using namespace wbc;
+
+void compareRbs(const base::samples::RigidBodyStateSE3& rbs_a, const base::samples::RigidBodyStateSE3& rbs_b, double accuracy = 1e-9){
+    BOOST_CHECK((rbs_a.pose.position - rbs_b.pose.position).norm() < accuracy);
+    BOOST_CHECK(rbs_a.pose.orientation.angularDistance(rbs_b.pose.orientation) < accuracy);
+    BOOST_CHECK((rbs_a.twist.linear - rbs_b.twist.linear).norm() < accuracy);
+    BOOST_CHECK((rbs_a.twist.angular - rbs_b.twist.angular).norm() < accuracy);
+    BOOST_CHECK((rbs_a.acceleration.linear - rbs_b.acceleration.linear).norm() < accuracy);
+    BOOST_CHECK((rbs_a.acceleration.angular - rbs_b.acceleration.angular).norm() < accuracy);
+}
+
+void compareWithPinocchio(RobotModelPtr robot_model, bool floating_base, const vector<string>& frames){
+
+    RobotModelConfig cfg("../../../../../models/kuka/urdf/kuka_iiwa.urdf");
+    cfg.floating_base = floating_base;
+    BOOST_CHECK(robot_model->configure(cfg));
+
+    RobotModelPtr robot_model_pinocchio = make_shared<RobotModelPinocchio>();
+    BOOST_CHECK(robot_model_pinocchio->configure(cfg));
+
+    BOOST_CHECK(robot_model->jointNames() == robot_model_pinocchio->jointNames());
+    BOOST_CHECK(robot_model->actuatedJointNames() == robot_model_pinocchio->actuatedJointNames());
+
+    base::samples::Joints joint_state = makeRandomJointState(robot_model->actuatedJointNames());
+    base::samples::RigidBodyStateSE3 floating_base_state = makeRandomFloatingBaseState();
+    robot_model->update(joint_state, floating_base_state);
+    robot_model_pinocchio->update(joint_state, floating_base_state);
+
+    for(auto tip_frame : frames){
+        compareRbs(robot_model->rigidBodyState(robot_model->worldFrame(), tip_frame),
+                   robot_model_pinocchio->rigidBodyState(robot_model->worldFrame(), tip_frame));
+        BOOST_CHECK(robot_model->spaceJacobian(robot_model->worldFrame(), tip_frame).isApprox(
+                    robot_model_pinocchio->spaceJacobian(robot_model->worldFrame(), tip_frame)));
+        BOOST_CHECK(robot_model->bodyJacobian(robot_model->worldFrame(), tip_frame).isApprox(
+                    robot_model_pinocchio->bodyJacobian(robot_model->worldFrame(), tip_frame)));
+        base::Acceleration bias_a = robot_model->spatialAccelerationBias(robot_model->worldFrame(), tip_frame);
+        base::Acceleration bias_b = robot_model_pinocchio->spatialAccelerationBias(robot_model->worldFrame(), tip_frame);
+        BOOST_CHECK((bias_a.linear - bias_b.linear).norm() < 1e-9);
+        BOOST_CHECK((bias_a.angular - bias_b.angular).norm() < 1e-9);
+    }
+
+    compareRbs(robot_model->centerOfMass(), robot_model_pinocchio->centerOfMass());
+    BOOST_CHECK(robot_model->comJacobian().isApprox(robot_model_pinocchio->comJacobian()));
+    BOOST_CHECK(robot_model->jointSpaceInertiaMatrix().isApprox(robot_model_pinocchio->jointSpaceInertiaMatrix()));
+    BOOST_CHECK(robot_model->biasForces().isApprox(robot_model_pinocchio->biasForces()));
+
+    // Compare with M*qdd + h, since computeInverseDynamics() of RobotModelPinocchio assumes a fixed base
+    base::VectorXd q, qd, qdd;
+    robot_model->systemState(q, qd, qdd);
+    base::VectorXd tau = robot_model_pinocchio->jointSpaceInertiaMatrix()*qdd + robot_model_pinocchio->biasForces();
+    base::commands::Joints solver_output;
+    solver_output.names = robot_model->actuatedJointNames();
+    solver_output.elements.resize(solver_output.names.size());
+    robot_model->computeInverseDynamics(solver_output);
+    uint start_idx = floating_base ? 6 : 0;
+    for(uint i = 0; i < solver_output.size(); i++)
+        BOOST_CHECK(fabs(solver_output[i].effort - tau[i+start_idx]) < 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(configure){
+
+    /**
+     * Verify that the code generator fails with invalid configurations
+     */
+
+    RobotModelCodeGenerator generator;
+    RobotModelConfig cfg("../../../../../models/kuka/urdf/kuka_iiwa.urdf");
+
+    BOOST_CHECK(generator.configure(cfg, "RobotModelKukaIiwa", "kuka_iiwa_generated") == true);
+    BOOST_CHECK(generator.nConfig() == 7);
+    BOOST_CHECK(generator.nTangent() == 7);
+
+    cfg.floating_base = true;
+    BOOST_CHECK(generator.configure(cfg, "RobotModelKukaIiwa", "kuka_iiwa_generated") == true);
+    BOOST_CHECK(generator.nConfig() == 14);
+    BOOST_CHECK(generator.nTangent() == 13);
+
+    // Blacklisted joints are removed from the generated model
+    cfg.floating_base = false;
+    cfg.joint_blacklist = {"kuka_lbr_l_joint_7"};
+    BOOST_CHECK(generator.configure(cfg, "RobotModelKukaIiwa", "kuka_iiwa_generated") == true);
+    BOOST_CHECK(generator.nTangent() == 6);
+
+    // Invalid blacklist
+    cfg.joint_blacklist = {"kuka_lbr_l_joint_8"};
+    BOOST_CHECK(generator.configure(cfg, "RobotModelKukaIiwa", "kuka_iiwa_generated") == false);
+
+    // Invalid class name
+    cfg.joint_blacklist.clear();
+    BOOST_CHECK(generator.configure(cfg, "1RobotModel", "kuka_iiwa_generated") == false);
+
+    // Invalid URDF
+    cfg.file_or_string = "../../../../../models/kuka/urdf/kuka_iiwa_non_existing.urdf";
+    BOOST_CHECK(generator.configure(cfg, "RobotModelKukaIiwa", "kuka_iiwa_generated") == false);
+}
+
+BOOST_AUTO_TEST_CASE(plugin){
+    RobotModel* robot_model = RobotModelFactory::createInstance("kuka_iiwa_generated");
+    BOOST_CHECK(robot_model != 0);
+    delete robot_model;
+    robot_model = RobotModelFactory::createInstance("kuka_iiwa_floating_base_generated");
+    BOOST_CHECK(robot_model != 0);
+    delete robot_model;
+}
+
+BOOST_AUTO_TEST_CASE(compare_fixed_base){
+    vector<string> frames = {"kuka_lbr_l_tcp", "kuka_lbr_l_link_4", "kuka_lbr_l_joint_3", "kuka_lbr_l_link_0"};
+    compareWithPinocchio(make_shared<RobotModelKukaIiwa>(), false, frames);
+}
+
+BOOST_AUTO_TEST_CASE(compare_floating_base){
+    vector<string> frames = {"kuka_lbr_l_tcp", "kuka_lbr_l_link_4", "kuka_lbr_l_joint_3", "kuka_lbr_l_link_0"};
+    compareWithPinocchio(make_shared<RobotModelKukaIiwaFloatingBase>(), true, frames);
+}
+
+BOOST_AUTO_TEST_CASE(space_jacobian){
+    RobotModelPtr robot_model = make_shared<RobotModelKukaIiwaFloatingBase>();
+    RobotModelConfig cfg("../../../../../models/kuka/urdf/kuka_iiwa.urdf");
+    cfg.floating_base = true;
+    BOOST_CHECK(robot_model->configure(cfg));
+    testSpaceJacobian(robot_model, "kuka_lbr_l_tcp", false);
+}
+
+BOOST_AUTO_TEST_CASE(body_jacobian){
+    RobotModelPtr robot_model = make_shared<RobotModelKukaIiwaFloatingBase>();
+    RobotModelConfig cfg("../../../../../models/kuka/urdf/kuka_iiwa.urdf");
+    cfg.floating_base = true;
+    BOOST_CHECK(robot_model->configure(cfg));
+    testBodyJacobian(robot_model, "kuka_lbr_l_tcp", false);
+}
+
+BOOST_AUTO_TEST_CASE(com_jacobian){
+    RobotModelPtr robot_model = make_shared<RobotModelKukaIiwa>();
+    RobotModelConfig cfg("../../../../../models/kuka/urdf/kuka_iiwa.urdf");
+    BOOST_CHECK(robot_model->configure(cfg));
+    testCoMJacobian(robot_model, false);
+}
+
+BOOST_AUTO_TEST_CASE(dynamics){
+    RobotModelPtr robot_model = make_shared<RobotModelKukaIiwa>();
+    RobotModelConfig cfg("../../../../../models/kuka/urdf/kuka_iiwa.urdf");
+    BOOST_CHECK(robot_model->configure(cfg));
+    testDynamics(robot_model, false);
+}
@@ -0,0 +1,54 @@
+#include "RobotModelCodeGenerator.hpp"
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+using namespace wbc;
+
+void usage(){
+    cout << "Usage: wbc_robot_model_codegen <urdf_file> <class_name> <plugin_name> <output_dir> [--floating_base] [--blacklist joint_1,joint_2,...]" << endl;
+    cout << "Generates <output_dir>/<class_name>.hpp and <output_dir>/<class_name>.cpp, which implement a RobotModel plugin for the given URDF." << endl;
+    cout << "The plugin is registered with name <plugin_name> in the RobotModelFactory." << endl;
+}
+
+int main(int argc, char** argv){
+
+    if(argc < 5){
+        usage();
+        return -1;
+    }
+
+    RobotModelConfig cfg(argv[1]);
+    string class_name = argv[2];
+    string plugin_name = argv[3];
+    string output_dir = argv[4];
+
+    for(int i = 5; i < argc; i++){
+        string arg = argv[i];
+        if(arg == "--floating_base")
+            cfg.floating_base = true;
+        else if(arg == "--blacklist" && i+1 < argc){
+            stringstream ss(argv[++i]);
+            string name;
+            while(getline(ss, name, ','))
+                if(!name.empty())
+                    cfg.joint_blacklist.push_back(name);
+        }
+        else{
+            usage();
+            return -1;
+        }
+    }
+
+    RobotModelCodeGenerator generator;
+    if(!generator.configure(cfg, class_name, plugin_name)){
+        cerr << "Failed to configure robot model code generator" << endl;
+        return -1;
+    }
+    generator.write(output_dir);
+
+    cout << "Generated " << class_name << " (" << generator.getJoints().size()-1 << " joints, nq = " << generator.nConfig()
+         << ", nv = " << generator.nTangent() << ", " << generator.getFrames().size() << " frames) in " << output_dir << endl;
+
+    return 0;
+}
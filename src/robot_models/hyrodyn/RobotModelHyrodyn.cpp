@@ -118,6 +118,9 @@ void RobotModelHyrodyn::update(const base::samples::Joints& joint_state_in,
         throw std::runtime_error("Invalid joint state");
     }
 
+    // New robot state: The factorization of the joint space inertia matrix has to be recomputed on demand
+    inertia_factorization_valid = false;
+
     if(has_floating_base){
         if(!_floating_base_state.hasValidPose() ||
            !_floating_base_state.hasValidTwist() ||
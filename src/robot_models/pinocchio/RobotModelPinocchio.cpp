@@ -5,29 +5,38 @@
 #include <pinocchio/algorithm/kinematics.hpp>
 #include <pinocchio/algorithm/jacobian.hpp>
 #include <pinocchio/algorithm/crba.hpp>
+#include <pinocchio/algorithm/cholesky.hpp>
 #include <pinocchio/algorithm/rnea.hpp>
 #include <pinocchio/algorithm/center-of-mass.hpp>
 #include <pinocchio/algorithm/joint-configuration.hpp>
+#include <pinocchio/algorithm/rnea-derivatives.hpp>
+#include <pinocchio/algorithm/aba-derivatives.hpp>
+#include <pinocchio/algorithm/kinematics-derivatives.hpp>
 
 namespace wbc{
 
-RobotModelRegistry<RobotModelPinocchio> RobotModelPinocchio::reg("pinocchio");
+template<> RobotModelRegistry<RobotModelPinocchio> RobotModelPinocchio::reg("pinocchio");
+template<> RobotModelRegistry<RobotModelPinocchioFloat> RobotModelPinocchioFloat::reg("pinocchio_float");
 
-RobotModelPinocchio::RobotModelPinocchio(){
+template<typename Scalar>
+RobotModelPinocchioTpl<Scalar>::RobotModelPinocchioTpl(){
 
 }
 
-RobotModelPinocchio::~RobotModelPinocchio(){
+template<typename Scalar>
+RobotModelPinocchioTpl<Scalar>::~RobotModelPinocchioTpl(){
 }
 
-void RobotModelPinocchio::clear(){
+template<typename Scalar>
+void RobotModelPinocchioTpl<Scalar>::clear(){
 
     RobotModel::clear();
     data.reset();
-    model = pinocchio::Model();
+    model = pinocchio::ModelTpl<Scalar>();
 }
 
-bool RobotModelPinocchio::configure(const RobotModelConfig& cfg){
+template<typename Scalar>
+bool RobotModelPinocchioTpl<Scalar>::configure(const RobotModelConfig& cfg){
 
     clear();
 
@@ -41,20 +50,25 @@ bool RobotModelPinocchio::configure(const RobotModelConfig& cfg){
     }
     base_frame =  robot_urdf->getRoot()->name;
     URDFTools::applyJointBlacklist(robot_urdf, cfg.joint_blacklist);
+    if(!URDFTools::applyJointLocks(robot_urdf, cfg.locked_joints.names, cfg.locked_joints.elements))
+        return false;
 
+    // The URDF parser of pinocchio works only in double precision, cast the model afterwards to the desired scalar type
+    pinocchio::Model model_d;
     try{
         if(cfg.floating_base){
-            pinocchio::urdf::buildModel(robot_urdf,pinocchio::JointModelFreeFlyer(), model);
+            pinocchio::urdf::buildModel(robot_urdf,pinocchio::JointModelFreeFlyer(), model_d);
         }
         else{
-            pinocchio::urdf::buildModel(robot_urdf, model);
+            pinocchio::urdf::buildModel(robot_urdf, model_d);
         }
     }
     catch(std::invalid_argument e){
         LOG_ERROR_S << "RobotModelPinocchio: Failed to load urdf model"<<std::endl;
         return false;
     }
-    data = std::make_shared<pinocchio::Data>(model);
+    model = model_d.cast<Scalar>();
+    data = std::make_shared<pinocchio::DataTpl<Scalar>>(model);
 
     // Add floating base
     has_floating_base = cfg.floating_base;
@@ -97,6 +111,11 @@ bool RobotModelPinocchio::configure(const RobotModelConfig& cfg){
     q.resize(model.nq);
     qd.resize(model.nv);
     qdd.resize(model.nv);
+    jac.resize(6,model.nv);
+    v_dq.resize(6,model.nv);
+    a_dq.resize(6,model.nv);
+    a_dv.resize(6,model.nv);
+    a_da.resize(6,model.nv);
 
     joint_state.resize(joint_names.size());
     joint_state.names = joint_names;
@@ -130,7 +149,8 @@ bool RobotModelPinocchio::configure(const RobotModelConfig& cfg){
     return true;
 }
 
-void RobotModelPinocchio::update(const base::samples::Joints& joint_state_in,
+template<typename Scalar>
+void RobotModelPinocchioTpl<Scalar>::update(const base::samples::Joints& joint_state_in,
                                  const base::samples::RigidBodyStateSE3& floating_base_state_in){
     if(joint_state_in.elements.size() != joint_state_in.names.size()){
         LOG_ERROR_S << "Size of names and size of elements in joint state do not match"<<std::endl;
@@ -142,46 +162,15 @@ void RobotModelPinocchio::update(const base::samples::Joints& joint_state_in,
         throw std::runtime_error("Invalid joint state");
     }
 
+    // New robot state: The factorization of the joint space inertia matrix has to be recomputed on demand
+    inertia_factorization_valid = false;
+
     for(auto n : actuated_joint_names)
         joint_state[n] = joint_state_in[n];
     joint_state.time = joint_state_in.time;
 
     if(has_floating_base){
-        if(!floating_base_state_in.hasValidPose() ||
-           !floating_base_state_in.hasValidTwist() ||
-           !floating_base_state_in.hasValidAcceleration()){
-           LOG_ERROR("Invalid status of floating base given! One (or all) of pose, twist or acceleration members is invalid (Either NaN or non-unit quaternion)");
-           throw std::runtime_error("Invalid floating base status");
-        }
-        if(floating_base_state_in.time.isNull()){
-            LOG_ERROR("Floating base state does not have a valid timestamp. Or do we have 1970?");
-            throw std::runtime_error("Invalid call to update()");
-        }
-
-        // Pinocchio expects the floating base twist/acceleration in local coordinates. However, we
-        // want to give the linear part in world coordinates and the angular part in local coordinates
-        floating_base_state = floating_base_state_in;
-        base::Matrix3d fb_rot = floating_base_state.pose.orientation.toRotationMatrix();
-
-        base::Twist fb_twist = floating_base_state.twist;
-        fb_twist.linear = fb_rot.transpose() * floating_base_state.twist.linear;
-
-        base::Acceleration fb_acc = floating_base_state.acceleration;
-        fb_acc.linear = fb_rot.transpose() * floating_base_state.acceleration.linear;
-
-        base::Vector3d euler = floating_base_state.pose.orientation.toRotationMatrix().eulerAngles(0, 1, 2);
-        for(int i = 0; i < 3; i++){
-            q[i]     = joint_state[joint_names_floating_base[i]].position       = floating_base_state.pose.position[i];
-            joint_state[joint_names_floating_base[i+3]].position = euler(i);
-            qd[i]    = joint_state[joint_names_floating_base[i]].speed          = fb_twist.linear[i];
-            qd[i+3]  = joint_state[joint_names_floating_base[i+3]].speed        = fb_twist.angular[i];
-            qdd[i]   = joint_state[joint_names_floating_base[i]].acceleration   = fb_acc.linear[i];
-            qdd[i+3] = joint_state[joint_names_floating_base[i+3]].acceleration = fb_acc.angular[i];
-        }
-        q[3] = floating_base_state.pose.orientation.x();
-        q[4] = floating_base_state.pose.orientation.y();
-        q[5] = floating_base_state.pose.orientation.z();
-        q[6] = floating_base_state.pose.orientation.w();
+        updateFloatingBase(floating_base_state_in);
 
         // Subtract 2 due to universe & root_joint
         for(auto name : actuated_joint_names){
@@ -195,8 +184,6 @@ void RobotModelPinocchio::update(const base::samples::Joints& joint_state_in,
             qd[model.getJointId(name)-2+6]  = state.speed;        // first 6 elements in q are floating base twist
             qdd[model.getJointId(name)-2+6] = state.acceleration; // first 6 elements in q are floating base acceleration
         }
-        if(floating_base_state.time > joint_state.time)
-            joint_state.time = floating_base_state.time;
     }
     else{
         for(auto name : actuated_joint_names){
@@ -214,13 +201,56 @@ void RobotModelPinocchio::update(const base::samples::Joints& joint_state_in,
 
 }
 
-void RobotModelPinocchio::systemState(base::VectorXd &_q, base::VectorXd &_qd, base::VectorXd &_qdd){
-    _q = q;
-    _qd = qd;
-    _qdd = qdd;
+template<typename Scalar>
+void RobotModelPinocchioTpl<Scalar>::updateFloatingBase(const base::samples::RigidBodyStateSE3& floating_base_state_in){
+    if(!floating_base_state_in.hasValidPose() ||
+       !floating_base_state_in.hasValidTwist() ||
+       !floating_base_state_in.hasValidAcceleration()){
+       LOG_ERROR("Invalid status of floating base given! One (or all) of pose, twist or acceleration members is invalid (Either NaN or non-unit quaternion)");
+       throw std::runtime_error("Invalid floating base status");
+    }
+    if(floating_base_state_in.time.isNull()){
+        LOG_ERROR("Floating base state does not have a valid timestamp. Or do we have 1970?");
+        throw std::runtime_error("Invalid call to update()");
+    }
+
+    // Pinocchio expects the floating base twist/acceleration in local coordinates. However, we
+    // want to give the linear part in world coordinates and the angular part in local coordinates
+    floating_base_state = floating_base_state_in;
+    base::Matrix3d fb_rot = floating_base_state.pose.orientation.toRotationMatrix();
+
+    base::Twist fb_twist = floating_base_state.twist;
+    fb_twist.linear = fb_rot.transpose() * floating_base_state.twist.linear;
+
+    base::Acceleration fb_acc = floating_base_state.acceleration;
+    fb_acc.linear = fb_rot.transpose() * floating_base_state.acceleration.linear;
+
+    base::Vector3d euler = floating_base_state.pose.orientation.toRotationMatrix().eulerAngles(0, 1, 2);
+    for(int i = 0; i < 3; i++){
+        q[i]     = joint_state[joint_names_floating_base[i]].position       = floating_base_state.pose.position[i];
+        joint_state[joint_names_floating_base[i+3]].position = euler(i);
+        qd[i]    = joint_state[joint_names_floating_base[i]].speed          = fb_twist.linear[i];
+        qd[i+3]  = joint_state[joint_names_floating_base[i+3]].speed        = fb_twist.angular[i];
+        qdd[i]   = joint_state[joint_names_floating_base[i]].acceleration   = fb_acc.linear[i];
+        qdd[i+3] = joint_state[joint_names_floating_base[i+3]].acceleration = fb_acc.angular[i];
+    }
+    q[3] = floating_base_state.pose.orientation.x();
+    q[4] = floating_base_state.pose.orientation.y();
+    q[5] = floating_base_state.pose.orientation.z();
+    q[6] = floating_base_state.pose.orientation.w();
+    if(floating_base_state.time > joint_state.time)
+        joint_state.time = floating_base_state.time;
+}
+
+template<typename Scalar>
+void RobotModelPinocchioTpl<Scalar>::systemState(base::VectorXd &_q, base::VectorXd &_qd, base::VectorXd &_qdd){
+    _q = q.template cast<double>();
+    _qd = qd.template cast<double>();
+    _qdd = qdd.template cast<double>();
 }
 
-const base::samples::RigidBodyStateSE3 &RobotModelPinocchio::rigidBodyState(const std::string &root_frame, const std::string &tip_frame){
+template<typename Scalar>
+const base::samples::RigidBodyStateSE3 &RobotModelPinocchioTpl<Scalar>::rigidBodyState(const std::string &root_frame, const std::string &tip_frame){
     if(joint_state.time.isNull()){
         LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
         throw std::runtime_error(" Invalid call to rigidBodyState()");
@@ -245,19 +275,34 @@ const base::samples::RigidBodyStateSE3 &RobotModelPinocchio::rigidBodyState(cons
 
     rbs.time = joint_state.time;
     rbs.frame_id = root_frame;
-    rbs.pose.position = data->oMf[idx].translation();
-    rbs.pose.orientation = base::Quaterniond(data->oMf[idx].rotation());
+    rbs.pose.position = data->oMf[idx].translation().template cast<double>();
+    rbs.pose.orientation = base::Quaterniond(data->oMf[idx].rotation().template cast<double>());
     // The LOCAL_WORLD_ALIGNED frame convention corresponds to the frame centered on the moving part (Joint, Frame, etc.)
     // but with axes aligned with the frame of the Universe. This a MIXED representation betwenn the LOCAL and the WORLD conventions.
-    rbs.twist.linear = pinocchio::getFrameVelocity(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED).linear();
-    rbs.twist.angular = pinocchio::getFrameVelocity(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED).angular();
-    rbs.acceleration.linear = pinocchio::getFrameClassicalAcceleration(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED).linear();
-    rbs.acceleration.angular = pinocchio::getFrameClassicalAcceleration(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED).angular();
+    rbs.twist.linear = pinocchio::getFrameVelocity(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED).linear().template cast<double>();
+    rbs.twist.angular = pinocchio::getFrameVelocity(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED).angular().template cast<double>();
+    rbs.acceleration.linear = pinocchio::getFrameClassicalAcceleration(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED).linear().template cast<double>();
+    rbs.acceleration.angular = pinocchio::getFrameClassicalAcceleration(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED).angular().template cast<double>();
 
     return rbs;
 }
 
-const base::MatrixXd &RobotModelPinocchio::spaceJacobian(const std::string &root_frame, const std::string &tip_frame){
+template<typename Scalar>
+void RobotModelPinocchioTpl<Scalar>::computeFrameJacobian(const pinocchio::FrameIndex idx, const pinocchio::ReferenceFrame reference_frame, base::MatrixXd &J){
+    jac.setZero();
+    pinocchio::computeFrameJacobian(model, *data, q, idx, reference_frame, jac);
+    J = jac.template cast<double>();
+}
+
+template<>
+void RobotModelPinocchioTpl<double>::computeFrameJacobian(const pinocchio::FrameIndex idx, const pinocchio::ReferenceFrame reference_frame, base::MatrixXd &J){
+    J.resize(6, model.nv);
+    J.setZero();
+    pinocchio::computeFrameJacobian(model, *data, q, idx, reference_frame, J);
+}
+
+template<typename Scalar>
+const base::MatrixXd &RobotModelPinocchioTpl<Scalar>::spaceJacobian(const std::string &root_frame, const std::string &tip_frame){
 
     if(joint_state.time.isNull()){
         LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
@@ -279,15 +324,13 @@ const base::MatrixXd &RobotModelPinocchio::spaceJacobian(const std::string &root
         throw std::runtime_error("Invalid tip frame");
     }
 
-    std::string chain_id = chainID(root_frame, tip_frame);
-    space_jac_map[chain_id].resize(6,model.nv);
-    space_jac_map[chain_id].setZero();
-    pinocchio::computeFrameJacobian(model, *data, q, idx, pinocchio::LOCAL_WORLD_ALIGNED, space_jac_map[chain_id]);
-
-    return space_jac_map[chain_id];
+    base::MatrixXd &J = space_jac_map[chainID(root_frame, tip_frame)];
+    computeFrameJacobian(idx, pinocchio::LOCAL_WORLD_ALIGNED, J);
+    return J;
 }
 
-const base::MatrixXd &RobotModelPinocchio::bodyJacobian(const std::string &root_frame, const std::string &tip_frame){
+template<typename Scalar>
+const base::MatrixXd &RobotModelPinocchioTpl<Scalar>::bodyJacobian(const std::string &root_frame, const std::string &tip_frame){
 
     if(joint_state.time.isNull()){
         LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
@@ -309,15 +352,13 @@ const base::MatrixXd &RobotModelPinocchio::bodyJacobian(const std::string &root_
         throw std::runtime_error("Invalid tip frame");
     }
 
-    std::string chain_id = chainID(root_frame, tip_frame);
-    body_jac_map[chain_id].resize(6,model.nv);
-    body_jac_map[chain_id].setZero();
-    pinocchio::computeFrameJacobian(model, *data, q, idx, pinocchio::LOCAL, body_jac_map[chain_id]);
-
-    return body_jac_map[chain_id];
+    base::MatrixXd &J = body_jac_map[chainID(root_frame, tip_frame)];
+    computeFrameJacobian(idx, pinocchio::LOCAL, J);
+    return J;
 }
 
-const base::MatrixXd &RobotModelPinocchio::comJacobian(){
+template<typename Scalar>
+const base::MatrixXd &RobotModelPinocchioTpl<Scalar>::comJacobian(){
 
     if(joint_state.time.isNull()){
         LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
@@ -326,11 +367,12 @@ const base::MatrixXd &RobotModelPinocchio::comJacobian(){
 
     pinocchio::jacobianCenterOfMass(model, *data, q);
     com_jac.resize(3,noOfJoints());
-    com_jac = data->Jcom;
+    com_jac = data->Jcom.template cast<double>();
     return com_jac;
 }
 
-const base::Acceleration &RobotModelPinocchio::spatialAccelerationBias(const std::string &root_frame, const std::string &tip_frame){
+template<typename Scalar>
+const base::Acceleration &RobotModelPinocchioTpl<Scalar>::spatialAccelerationBias(const std::string &root_frame, const std::string &tip_frame){
 
     if(joint_state.time.isNull()){
         LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
@@ -351,18 +393,46 @@ const base::Acceleration &RobotModelPinocchio::spatialAccelerationBias(const std
         LOG_ERROR_S<<"Requested Forward kinematics for tip frame "<<use_tip_frame<<" but this frame does not exist in Pinocchio"<<std::endl;
         throw std::runtime_error("Invalid tip frame");
     }
-    pinocchio::forwardKinematics(model,*data,q,qd,base::VectorXd::Zero(model.nv));
-    spatial_acc_bias.linear = pinocchio::getFrameClassicalAcceleration(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED).linear();
-    spatial_acc_bias.angular = pinocchio::getFrameClassicalAcceleration(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED).angular();
+    pinocchio::forwardKinematics(model,*data,q,qd,VectorX::Zero(model.nv));
+    spatial_acc_bias.linear = pinocchio::getFrameClassicalAcceleration(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED).linear().template cast<double>();
+    spatial_acc_bias.angular = pinocchio::getFrameClassicalAcceleration(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED).angular().template cast<double>();
     return spatial_acc_bias;
 }
 
-const base::MatrixXd &RobotModelPinocchio::jacobianDot(const std::string &root_frame, const std::string &tip_frame){
+template<typename Scalar>
+const base::MatrixXd &RobotModelPinocchioTpl<Scalar>::jacobianDot(const std::string &root_frame, const std::string &tip_frame){
+
+    if(joint_state.time.isNull()){
+        LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
+        throw std::runtime_error(" Invalid call to jacobianDot()");
+    }
+
+    if(root_frame != world_frame){
+        LOG_ERROR_S<<"Requested Jacobian derivative for kinematic chain "<<root_frame<<"->"<<tip_frame<<" but the pinocchio robot model always requires the root frame to be the root of the full model"<<std::endl;
+        throw std::runtime_error("Invalid root frame");
+    }
+
+    std::string use_tip_frame = tip_frame;
+    if(use_tip_frame == "world")
+        use_tip_frame = "universe";
 
-    throw std::runtime_error("Not implemented: jacobianDot has not been implemented for RobotModelPinocchio");
+    uint idx = model.getFrameId(use_tip_frame);
+    if(idx == model.frames.size()){
+        LOG_ERROR_S<<"Requested Jacobian derivative for tip frame "<<use_tip_frame<<" but this frame does not exist in Pinocchio"<<std::endl;
+        throw std::runtime_error("Invalid tip frame");
+    }
+
+    pinocchio::computeJointJacobiansTimeVariation(model, *data, q, qd);
+    pinocchio::updateFramePlacements(model, *data);
+    jac.setZero();
+    pinocchio::getFrameJacobianTimeVariation(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED, jac);
+    base::MatrixXd &J_dot = jac_dot_map[chainID(root_frame, tip_frame)];
+    J_dot = jac.template cast<double>();
+    return J_dot;
 }
 
-const base::MatrixXd &RobotModelPinocchio::jointSpaceInertiaMatrix(){
+template<typename Scalar>
+const base::MatrixXd &RobotModelPinocchioTpl<Scalar>::jointSpaceInertiaMatrix(){
 
     if(joint_state.time.isNull()){
         LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
@@ -370,13 +440,41 @@ const base::MatrixXd &RobotModelPinocchio::jointSpaceInertiaMatrix(){
     }
 
     pinocchio::crba(model, *data, q);
-    joint_space_inertia_mat = data->M;
+    joint_space_inertia_mat = data->M.template cast<double>();
     // copy upper right triangular part to lower left triangular part (they are symmetric), as pinocchio only computes the former
-    joint_space_inertia_mat.triangularView<Eigen::StrictlyLower>() = joint_space_inertia_mat.transpose().triangularView<Eigen::StrictlyLower>();
+    joint_space_inertia_mat.template triangularView<Eigen::StrictlyLower>() = joint_space_inertia_mat.transpose().template triangularView<Eigen::StrictlyLower>();
     return joint_space_inertia_mat;
 }
 
-const base::VectorXd &RobotModelPinocchio::biasForces(){
+template<typename Scalar>
+void RobotModelPinocchioTpl<Scalar>::factorizeJointSpaceInertiaMatrix(){
+
+    if(joint_state.time.isNull()){
+        LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
+        throw std::runtime_error(" Invalid call to factorizeJointSpaceInertiaMatrix()");
+    }
+
+    // cholesky::decompose only requires the upper triangular part of M, as computed by crba
+    pinocchio::crba(model, *data, q);
+    pinocchio::cholesky::decompose(model, *data);
+    inertia_factorization_valid = true;
+}
+
+template<typename Scalar>
+void RobotModelPinocchioTpl<Scalar>::solveFactorizedInertia(Eigen::Ref<base::MatrixXd> B){
+    inertia_rhs = B.template cast<Scalar>();
+    pinocchio::cholesky::solve(model, *data, inertia_rhs);
+    B = inertia_rhs.template cast<double>();
+}
+
+template<>
+void RobotModelPinocchioTpl<double>::solveFactorizedInertia(Eigen::Ref<base::MatrixXd> B){
+    // No conversion of the scalar type required: Solve in place
+    pinocchio::cholesky::solve(model, *data, B);
+}
+
+template<typename Scalar>
+const base::VectorXd &RobotModelPinocchioTpl<Scalar>::biasForces(){
 
     if(joint_state.time.isNull()){
         LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
@@ -384,11 +482,89 @@ const base::VectorXd &RobotModelPinocchio::biasForces(){
     }
 
     pinocchio::nonLinearEffects(model, *data, q, qd);
-    bias_forces = data->nle;
+    bias_forces = data->nle.template cast<double>();
     return bias_forces;
 }
 
-const base::samples::RigidBodyStateSE3& RobotModelPinocchio::centerOfMass(){
+template<typename Scalar>
+const base::MatrixXd &RobotModelPinocchioTpl<Scalar>::spatialAccelerationBiasDerivative(const std::string &root_frame, const std::string &tip_frame){
+
+    if(joint_state.time.isNull()){
+        LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
+        throw std::runtime_error(" Invalid call to spatialAccelerationBiasDerivative()");
+    }
+
+    if(root_frame != world_frame){
+        LOG_ERROR_S<<"Requested acceleration bias derivative for kinematic chain "<<root_frame<<"->"<<tip_frame<<" but the pinocchio robot model always requires the root frame to be the root of the full model"<<std::endl;
+        throw std::runtime_error("Invalid root frame");
+    }
+
+    std::string use_tip_frame = tip_frame;
+    if(use_tip_frame == "world")
+        use_tip_frame = "universe";
+
+    uint idx = model.getFrameId(use_tip_frame);
+    if(idx == model.frames.size()){
+        LOG_ERROR_S<<"Requested acceleration bias derivative for tip frame "<<use_tip_frame<<" but this frame does not exist in Pinocchio"<<std::endl;
+        throw std::runtime_error("Invalid tip frame");
+    }
+
+    // Derivative of the spatial acceleration with qdd = 0, i.e. of the term Jdot*qdot
+    pinocchio::computeForwardKinematicsDerivatives(model, *data, q, qd, VectorX::Zero(model.nv));
+    v_dq.setZero();
+    a_dq.setZero();
+    a_dv.setZero();
+    a_da.setZero();
+    pinocchio::getFrameAccelerationDerivatives(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED, v_dq, a_dq, a_dv, a_da);
+
+    // spatialAccelerationBias() returns the classical acceleration, which differs from the spatial acceleration in the linear part
+    // by the term w x v. Its derivative is w x dv/dq - v x dw/dq
+    pinocchio::MotionTpl<Scalar> v = pinocchio::getFrameVelocity(model, *data, idx, pinocchio::LOCAL_WORLD_ALIGNED);
+    for(int i = 0; i < model.nv; i++)
+        a_dq.col(i).template head<3>() += v.angular().cross(v_dq.col(i).template head<3>()) - v.linear().cross(v_dq.col(i).template tail<3>());
+
+    std::string chain_id = chainID(root_frame, tip_frame);
+    spatial_acc_bias_dq_map[chain_id] = a_dq.template cast<double>();
+
+    return spatial_acc_bias_dq_map[chain_id];
+}
+
+template<typename Scalar>
+void RobotModelPinocchioTpl<Scalar>::inverseDynamicsDerivatives(base::MatrixXd &dtau_dq, base::MatrixXd &dtau_dqd){
+
+    if(joint_state.time.isNull()){
+        LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
+        throw std::runtime_error(" Invalid call to inverseDynamicsDerivatives()");
+    }
+
+    pinocchio::computeRNEADerivatives(model, *data, q, qd, qdd);
+    dtau_dq = data->dtau_dq.template cast<double>();
+    dtau_dqd = data->dtau_dv.template cast<double>();
+}
+
+template<typename Scalar>
+void RobotModelPinocchioTpl<Scalar>::forwardDynamicsDerivatives(const base::VectorXd &tau, base::MatrixXd &dqdd_dq, base::MatrixXd &dqdd_dqd, base::MatrixXd &dqdd_dtau){
+
+    if(joint_state.time.isNull()){
+        LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
+        throw std::runtime_error(" Invalid call to forwardDynamicsDerivatives()");
+    }
+
+    if(tau.size() != model.nv){
+        LOG_ERROR_S<<"Size of torque vector is "<<tau.size()<<" but should be "<<model.nv<<std::endl;
+        throw std::runtime_error("Invalid call to forwardDynamicsDerivatives()");
+    }
+
+    pinocchio::computeABADerivatives(model, *data, q, qd, tau.template cast<Scalar>());
+    dqdd_dq = data->ddq_dq.template cast<double>();
+    dqdd_dqd = data->ddq_dv.template cast<double>();
+    dqdd_dtau = data->Minv.template cast<double>();
+    // copy upper right triangular part to lower left triangular part (they are symmetric), as pinocchio only computes the former
+    dqdd_dtau.triangularView<Eigen::StrictlyLower>() = dqdd_dtau.transpose().triangularView<Eigen::StrictlyLower>();
+}
+
+template<typename Scalar>
+const base::samples::RigidBodyStateSE3& RobotModelPinocchioTpl<Scalar>::centerOfMass(){
 
     if(joint_state.time.isNull()){
         LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
@@ -396,9 +572,9 @@ const base::samples::RigidBodyStateSE3& RobotModelPinocchio::centerOfMass(){
     }
 
     pinocchio::centerOfMass(model, *data, q, qd, qdd);
-    com_rbs.pose.position       = data->com[0];
-    com_rbs.twist.linear        = data->vcom[0];
-    com_rbs.acceleration.linear = data->acom[0];
+    com_rbs.pose.position       = data->com[0].template cast<double>();
+    com_rbs.twist.linear        = data->vcom[0].template cast<double>();
+    com_rbs.acceleration.linear = data->acom[0].template cast<double>();
     com_rbs.pose.orientation.setIdentity();
     com_rbs.twist.angular.setZero();
     com_rbs.acceleration.angular.setZero();
@@ -407,7 +583,8 @@ const base::samples::RigidBodyStateSE3& RobotModelPinocchio::centerOfMass(){
     return com_rbs;
 }
 
-void RobotModelPinocchio::computeInverseDynamics(base::commands::Joints &solver_output){
+template<typename Scalar>
+void RobotModelPinocchioTpl<Scalar>::computeInverseDynamics(base::commands::Joints &solver_output){
 
     if(joint_state.time.isNull()){
         LOG_ERROR("RobotModelPinocchio: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
@@ -427,4 +604,7 @@ void RobotModelPinocchio::computeInverseDynamics(base::commands::Joints &solver_
     }
 }
 
+template class RobotModelPinocchioTpl<double>;
+template class RobotModelPinocchioTpl<float>;
+
 }
@@ -7,20 +7,40 @@
 
 namespace wbc {
 
-class RobotModelPinocchio : public RobotModel{
+/**
+ * @brief Robot model based on Pinocchio (see https://github.com/stack-of-tasks/pinocchio). The template parameter defines the scalar type that is
+ * used internally for all kinematics and dynamics computations. The interface (Jacobians, mass-inertia matrix, ...) always uses double. Two variants are registered:
+ *   - "pinocchio": RobotModelPinocchio, computes in double precision
+ *   - "pinocchio_float": RobotModelPinocchioFloat, computes in single precision. This is faster and requires less memory, but
+ *     the results are only accurate to approx. 1e-5. Use it only if your controller can tolerate that.
+ */
+template<typename Scalar>
+class RobotModelPinocchioTpl : public RobotModel{
 protected:
-    static RobotModelRegistry<RobotModelPinocchio> reg;
+    static RobotModelRegistry<RobotModelPinocchioTpl<Scalar>> reg;
 
-    Eigen::VectorXd q, qd, qdd;
-    pinocchio::Model model;
-    typedef std::shared_ptr<pinocchio::Data> DataPtr;
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1> VectorX;
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> MatrixX;
+
+    VectorX q, qd, qdd;
+    pinocchio::ModelTpl<Scalar> model;
+    typedef std::shared_ptr<pinocchio::DataTpl<Scalar>> DataPtr;
     DataPtr data;
 
+    // Helper
+    MatrixX jac, v_dq, a_dq, a_dv, a_da, inertia_rhs;
+
     /** Free all data*/
     void clear();
+    /** Validate the given floating base state and write it to q, qd, qdd and the floating base entries of the joint state*/
+    void updateFloatingBase(const base::samples::RigidBodyStateSE3& floating_base_state_in);
+    /** Compute the Jacobian of the given frame into J. The double precision model writes directly into J, other variants cast the helper jac into J*/
+    void computeFrameJacobian(const pinocchio::FrameIndex idx, const pinocchio::ReferenceFrame reference_frame, base::MatrixXd &J);
+    /** Solve M*X = B in place using the sparse factorization of factorizeJointSpaceInertiaMatrix()*/
+    virtual void solveFactorizedInertia(Eigen::Ref<base::MatrixXd> B);
 public:
-    RobotModelPinocchio();
-    ~RobotModelPinocchio();
+    RobotModelPinocchioTpl();
+    ~RobotModelPinocchioTpl();
 
     /**
      * @brief Load and configure the robot model
@@ -73,9 +93,8 @@ public:
       */
     virtual const base::Acceleration &spatialAccelerationBias(const std::string &root_frame, const std::string &tip_frame);
 
-    /** @brief Returns the derivative of the Jacobian for the kinematic chain between root and the tip frame as full body Jacobian. By convention reference frame & reference point
-      *  of the Jacobian will be the root frame (corresponding to the body Jacobian). Size of the Jacobian will be 6 x nJoints, where nJoints is the number of joints of the whole robot. The order of the
-      * columns will be the same as the joint order of the robot. The columns that correspond to joints that are not part of the kinematic chain will have only zeros as entries.
+    /** @brief Returns the time derivative of the Space Jacobian (see spaceJacobian()) for the kinematic chain between root and the tip frame. Size of the Jacobian will be 6 x nJoints, where nJoints is the number of joints of the whole robot.
+      * The root frame has to be the world frame of the model. The derivative is computed analytically from the current joint positions and velocities.
       * @param root_frame Root frame of the chain. Has to be a valid link in the robot model.
       * @param tip_frame Tip frame of the chain. Has to be a valid link in the robot model.
       * @return A 6xN matrix, where N is the number of robot joints
@@ -88,6 +107,19 @@ public:
     /** @brief Compute and return the bias force vector, which is nj x 1, where nj is the number of joints of the system*/
     virtual const base::VectorXd &biasForces();
 
+    /** @brief Returns the partial derivative of the spatial acceleration bias (see spatialAccelerationBias()) w.r.t. the joint positions.
+      * @param root_frame Root frame of the chain. Has to be a valid link in the robot model.
+      * @param tip_frame Tip frame of the chain. Has to be a valid link in the robot model.
+      * @return A 6xN matrix, where N is the number of robot joints
+      */
+    virtual const base::MatrixXd &spatialAccelerationBiasDerivative(const std::string &root_frame, const std::string &tip_frame);
+
+    /** @brief Compute the partial derivatives of the inverse dynamics at the current robot state w.r.t. the joint positions and velocities. See RobotModel::inverseDynamicsDerivatives() for details*/
+    virtual void inverseDynamicsDerivatives(base::MatrixXd &dtau_dq, base::MatrixXd &dtau_dqd);
+
+    /** @brief Compute the partial derivatives of the forward dynamics at the current robot state and the given torques. See RobotModel::forwardDynamicsDerivatives() for details*/
+    virtual void forwardDynamicsDerivatives(const base::VectorXd &tau, base::MatrixXd &dqdd_dq, base::MatrixXd &dqdd_dqd, base::MatrixXd &dqdd_dtau);
+
     /** @brief Compute and return center of mass expressed in base frame*/
     virtual const base::samples::RigidBodyStateSE3& centerOfMass();
 
@@ -96,6 +128,9 @@ public:
 
 };
 
+typedef RobotModelPinocchioTpl<double> RobotModelPinocchio;
+typedef RobotModelPinocchioTpl<float> RobotModelPinocchioFloat;
+
 }
 
 #endif
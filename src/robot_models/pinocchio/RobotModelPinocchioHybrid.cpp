@@ -0,0 +1,501 @@
+#include "RobotModelPinocchioHybrid.hpp"
+#include <base-logging/Logging.hpp>
+#include <pinocchio/algorithm/frames.hpp>
+#include <pinocchio/algorithm/kinematics.hpp>
+#include <pinocchio/algorithm/jacobian.hpp>
+#include <pinocchio/algorithm/rnea.hpp>
+#include <pinocchio/algorithm/crba.hpp>
+#include <pinocchio/algorithm/center-of-mass.hpp>
+#include <pinocchio/algorithm/joint-configuration.hpp>
+#include <pinocchio/spatial/explog.hpp>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+
+namespace wbc{
+
+RobotModelRegistry<RobotModelPinocchioHybrid> RobotModelPinocchioHybrid::reg("pinocchio_hybrid");
+
+RobotModelPinocchioHybrid::RobotModelPinocchioHybrid() :
+    max_iterations(50),
+    tolerance(1e-10){
+
+}
+
+RobotModelPinocchioHybrid::~RobotModelPinocchioHybrid(){
+}
+
+bool RobotModelPinocchioHybrid::readJointNames(const std::string& file, const std::string& key, std::vector<std::string>& names){
+
+    std::ifstream stream(file);
+    if(!stream.is_open()){
+        LOG_ERROR("RobotModelPinocchioHybrid: Unable to open submechanism file %s", file.c_str());
+        return false;
+    }
+
+    // Lists are given in flow style, e.g. jointnames_active: ["j1", "j2"], and might span multiple lines
+    names.clear();
+    std::string line, list;
+    bool in_list = false;
+    while(std::getline(stream, line)){
+        if(!in_list){
+            size_t pos = line.find(key + ":");
+            if(pos == std::string::npos)
+                continue;
+            line = line.substr(pos + key.size() + 1);
+            list.clear();
+            in_list = true;
+        }
+        list += line;
+        if(line.find(']') == std::string::npos)
+            continue;
+        in_list = false;
+
+        size_t start = list.find('['), end = list.find(']');
+        if(start == std::string::npos || end < start){
+            LOG_ERROR("RobotModelPinocchioHybrid: Invalid entry %s in submechanism file %s", key.c_str(), file.c_str());
+            return false;
+        }
+        std::stringstream ss(list.substr(start+1, end-start-1));
+        std::string name;
+        while(std::getline(ss, name, ',')){
+            name.erase(std::remove_if(name.begin(), name.end(), [](char c){return std::isspace(c) || c == '"' || c == '\'';}), name.end());
+            if(!name.empty() && std::find(joint_names_floating_base.begin(), joint_names_floating_base.end(), name) == joint_names_floating_base.end())
+                names.push_back(name);
+        }
+    }
+    if(in_list){
+        LOG_ERROR("RobotModelPinocchioHybrid: Invalid entry %s in submechanism file %s", key.c_str(), file.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool RobotModelPinocchioHybrid::configure(const RobotModelConfig& cfg){
+
+    loop_closure_ids.clear();
+    idx_independent.clear();
+    idx_dependent.clear();
+    idx_active.clear();
+
+    if(!RobotModelPinocchio::configure(cfg))
+        return false;
+
+    // 1. Joints of the spanning tree. The base class configures the model with all non-fixed joints of the URDF as actuated joints
+
+    const std::vector<std::string> spanning_tree = actuated_joint_names;
+    for(const auto &name : spanning_tree){
+        const auto &joint = model.joints[model.getJointId(name)];
+        if(joint.nq() != 1 || joint.nv() != 1){
+            LOG_ERROR("RobotModelPinocchioHybrid: Joint %s has %i DoF, but only joints with a single DoF are supported", name.c_str(), joint.nv());
+            return false;
+        }
+    }
+
+    std::vector<std::string> independent, active;
+    if(!readJointNames(cfg.submechanism_file, "jointnames_independent", independent) ||
+       !readJointNames(cfg.submechanism_file, "jointnames_active", active))
+        return false;
+    if(independent.size() != active.size()){
+        LOG_ERROR("RobotModelPinocchioHybrid: Number of independent joints (%i) and active joints (%i) has to be the same", (int)independent.size(), (int)active.size());
+        return false;
+    }
+    for(const auto &name : independent + active){
+        if(std::find(spanning_tree.begin(), spanning_tree.end(), name) == spanning_tree.end()){
+            LOG_ERROR("RobotModelPinocchioHybrid: Joint %s from submechanism file is not a non-fixed joint of the spanning tree", name.c_str());
+            return false;
+        }
+    }
+
+    const int nfb = has_floating_base ? 6 : 0;
+    for(int i = 0; i < nfb; i++){
+        idx_independent.push_back(i);
+        idx_active.push_back(i);
+    }
+    for(const auto &name : independent)
+        idx_independent.push_back(model.joints[model.getJointId(name)].idx_v());
+    for(const auto &name : active)
+        idx_active.push_back(model.joints[model.getJointId(name)].idx_v());
+    for(const auto &name : spanning_tree){
+        if(std::find(independent.begin(), independent.end(), name) == independent.end())
+            idx_dependent.push_back(model.joints[model.getJointId(name)].idx_v());
+    }
+
+    // 2. Loop closures
+
+    int n_constraints = 0;
+    for(const auto &lc : cfg.loop_closures){
+        LoopClosureIds ids;
+        ids.frame_a = model.getFrameId(lc.frame_a);
+        ids.frame_b = model.getFrameId(lc.frame_b);
+        ids.full_pose = lc.full_pose;
+        if(ids.frame_a == model.frames.size() || ids.frame_b == model.frames.size()){
+            LOG_ERROR("RobotModelPinocchioHybrid: Invalid loop closure %s <-> %s. Both frames have to be valid links in the robot model", lc.frame_a.c_str(), lc.frame_b.c_str());
+            return false;
+        }
+        loop_closure_ids.push_back(ids);
+        n_constraints += lc.full_pose ? 6 : 3;
+    }
+    if(n_constraints < (int)idx_dependent.size()){
+        LOG_ERROR("RobotModelPinocchioHybrid: Model has %i dependent joints, but only %i loop closure constraints", (int)idx_dependent.size(), n_constraints);
+        return false;
+    }
+    if(idx_dependent.empty() && n_constraints > 0){
+        LOG_ERROR("RobotModelPinocchioHybrid: Loop closures are given, but all joints of the spanning tree are independent");
+        return false;
+    }
+
+    // 3. Actuation space: Joint state contains the full spanning tree, the model joints are the active joints
+
+    joint_names = joint_names_floating_base + active;
+    actuated_joint_names = active;
+    independent_joint_names = joint_names_floating_base + independent;
+
+    selection_matrix.resize(noOfActuatedJoints(),noOfJoints());
+    selection_matrix.setZero();
+    for(uint i = 0; i < actuated_joint_names.size(); i++)
+        selection_matrix(i, jointIndex(actuated_joint_names[i])) = 1.0;
+
+    // Initial guess for the loop closure solver
+    q = pinocchio::neutral(model);
+    qd.setZero();
+    qdd.setZero();
+
+    Jc.resize(n_constraints, model.nv);
+    frame_jac.resize(6, model.nv);
+    constraint_residual.resize(n_constraints);
+    constraint_bias.resize(n_constraints);
+    G_y.resize(model.nv, idx_independent.size());
+    G_u.resize(model.nv, idx_active.size());
+    g_y.resize(model.nv);
+    g_u.resize(model.nv);
+    dv.resize(model.nv);
+    q_next.resize(model.nq);
+    zero_v.setZero(model.nv);
+
+    idx_joint_state.resize(joint_state.size());
+    for(uint i = nfb; i < joint_state.size(); i++)
+        idx_joint_state[i] = model.joints[model.getJointId(joint_state.names[i])].idx_v();
+
+    // Buffers of update(), so that no memory is allocated in the control loop
+    Jc_dep.resize(n_constraints, idx_dependent.size());
+    Jc_indep.resize(n_constraints, idx_independent.size());
+    G_dep.resize(idx_dependent.size(), idx_independent.size());
+    S_u_G_y.resize(idx_active.size(), idx_independent.size());
+    S_u_G_y_inv.resize(idx_independent.size(), idx_active.size());
+    dq_dep.resize(idx_dependent.size());
+    g_dep.resize(idx_dependent.size());
+    S_u_g_y.resize(idx_active.size());
+    yd.resize(idx_independent.size());
+    ydd.resize(idx_independent.size());
+    J_st.resize(6, model.nv);
+    M_st.resize(model.nv, model.nv);
+    M_st_G_u.resize(model.nv, idx_active.size());
+    h_st.resize(model.nv);
+
+    LOG_DEBUG("------------------- WBC RobotModelPinocchioHybrid -----------------");
+    LOG_DEBUG("Independent Joint Names");
+    for(auto n : independentJointNames())
+        LOG_DEBUG_S << n << std::endl;
+    LOG_DEBUG_S << "No of loop closure constraints: " << n_constraints << std::endl;
+    LOG_DEBUG("------------------------------------------------------------");
+
+    return true;
+}
+
+void RobotModelPinocchioHybrid::computeConstraints(){
+
+    pinocchio::computeJointJacobians(model, *data, q);
+    pinocchio::updateFramePlacements(model, *data);
+
+    int row = 0;
+    for(const auto &lc : loop_closure_ids){
+        const int n = lc.full_pose ? 6 : 3;
+        const pinocchio::SE3 &oMa = data->oMf[lc.frame_a];
+        const pinocchio::SE3 &oMb = data->oMf[lc.frame_b];
+        constraint_residual.segment(row,3) = oMa.translation() - oMb.translation();
+        // Orientation error in world coordinates. Its time derivative is the difference of the angular velocities for small errors
+        if(lc.full_pose)
+            constraint_residual.segment(row+3,3) = oMb.rotation() * pinocchio::log3(oMb.rotation().transpose() * oMa.rotation());
+
+        frame_jac.setZero();
+        pinocchio::getFrameJacobian(model, *data, lc.frame_a, pinocchio::LOCAL_WORLD_ALIGNED, frame_jac);
+        Jc.middleRows(row,n) = frame_jac.topRows(n);
+        frame_jac.setZero();
+        pinocchio::getFrameJacobian(model, *data, lc.frame_b, pinocchio::LOCAL_WORLD_ALIGNED, frame_jac);
+        Jc.middleRows(row,n) -= frame_jac.topRows(n);
+        row += n;
+    }
+
+    for(uint i = 0; i < idx_dependent.size(); i++)
+        Jc_dep.col(i) = Jc.col(idx_dependent[i]);
+}
+
+void RobotModelPinocchioHybrid::solveLoopClosures(){
+
+    if(idx_dependent.empty())
+        return;
+
+    // Newton-Raphson on the dependent joints, starting from the solution of the last cycle
+    for(uint i = 0; i <= max_iterations; i++){
+        computeConstraints();
+        if(constraint_residual.cwiseAbs().maxCoeff() <= tolerance)
+            return;
+        if(i == max_iterations)
+            break;
+        cod.compute(Jc_dep);
+        dq_dep = cod.solve(constraint_residual);
+        dv.setZero();
+        for(uint j = 0; j < idx_dependent.size(); j++)
+            dv[idx_dependent[j]] = -dq_dep[j];
+        pinocchio::integrate(model, q, dv, q_next);
+        q.swap(q_next);
+    }
+
+    LOG_ERROR("RobotModelPinocchioHybrid: Loop closure constraints did not converge after %i iterations. Max. constraint violation is %f",
+              max_iterations, constraint_residual.cwiseAbs().maxCoeff());
+    throw std::runtime_error("Loop closure did not converge");
+}
+
+void RobotModelPinocchioHybrid::computeProjections(){
+
+    // Spanning tree velocities from independent velocities: Jc_dep*qd_dep + Jc_indep*yd = 0
+    G_y.setZero();
+    for(uint i = 0; i < idx_independent.size(); i++)
+        G_y(idx_independent[i], i) = 1;
+    if(!idx_dependent.empty()){
+        for(uint i = 0; i < idx_independent.size(); i++)
+            Jc_indep.col(i) = Jc.col(idx_independent[i]);
+        cod.compute(Jc_dep);
+        G_dep = cod.solve(Jc_indep);
+        for(uint i = 0; i < idx_dependent.size(); i++)
+            G_y.row(idx_dependent[i]) = -G_dep.row(i);
+    }
+
+    // Spanning tree velocities from active velocities: ud = S_u*G_y*yd  ->  qd = G_y*(S_u*G_y)^-1*ud
+    for(uint i = 0; i < idx_active.size(); i++)
+        S_u_G_y.row(i) = G_y.row(idx_active[i]);
+    lu.compute(S_u_G_y);
+    if(!lu.isInvertible()){
+        LOG_ERROR("RobotModelPinocchioHybrid: Singular configuration. The active joints do not determine the motion of the mechanism");
+        throw std::runtime_error("Singular configuration");
+    }
+    S_u_G_y_inv = lu.inverse();
+    G_u.noalias() = G_y * S_u_G_y_inv;
+}
+
+void RobotModelPinocchioHybrid::computeAccelerationBias(){
+
+    g_y.setZero();
+    g_u.setZero();
+    if(idx_dependent.empty())
+        return;
+
+    // Constraint bias dJc*qd: Relative acceleration of the loop closure frames for zero joint accelerations
+    pinocchio::forwardKinematics(model, *data, q, qd, zero_v);
+    int row = 0;
+    for(const auto &lc : loop_closure_ids){
+        const pinocchio::Motion a = pinocchio::getFrameClassicalAcceleration(model, *data, lc.frame_a, pinocchio::LOCAL_WORLD_ALIGNED);
+        const pinocchio::Motion b = pinocchio::getFrameClassicalAcceleration(model, *data, lc.frame_b, pinocchio::LOCAL_WORLD_ALIGNED);
+        constraint_bias.segment(row,3) = a.linear() - b.linear();
+        if(lc.full_pose)
+            constraint_bias.segment(row+3,3) = a.angular() - b.angular();
+        row += lc.full_pose ? 6 : 3;
+    }
+
+    // Jc*qdd + dJc*qd = 0  ->  qdd = G_y*ydd + g_y
+    g_dep = cod.solve(constraint_bias);
+    for(uint i = 0; i < idx_dependent.size(); i++)
+        g_y[idx_dependent[i]] = -g_dep[i];
+
+    // qdd = G_u*udd + g_u, where g_u does not change the active joint accelerations
+    for(uint i = 0; i < idx_active.size(); i++)
+        S_u_g_y[i] = g_y[idx_active[i]];
+    g_u = g_y;
+    g_u.noalias() -= G_u * S_u_g_y;
+}
+
+void RobotModelPinocchioHybrid::update(const base::samples::Joints& joint_state_in,
+                                       const base::samples::RigidBodyStateSE3& floating_base_state_in){
+
+    if(joint_state_in.elements.size() != joint_state_in.names.size()){
+        LOG_ERROR_S << "Size of names and size of elements in joint state do not match"<<std::endl;
+        throw std::runtime_error("Invalid joint state");
+    }
+
+    if(joint_state_in.time.isNull()){
+        LOG_ERROR_S << "Joint State does not have a valid timestamp. Or do we have 1970?"<<std::endl;
+        throw std::runtime_error("Invalid joint state");
+    }
+
+    // New robot state: The factorization of the joint space inertia matrix has to be recomputed on demand
+    inertia_factorization_valid = false;
+
+    joint_state.time = joint_state_in.time;
+    if(has_floating_base)
+        updateFloatingBase(floating_base_state_in);
+
+    // Independent joints. All joints of the spanning tree have a single DoF, so that the position index is offset only by the floating base quaternion
+    const uint nfb = has_floating_base ? 6 : 0;
+    const int q_offs = model.nq - model.nv;
+    yd.head(nfb) = qd.head(nfb);
+    ydd.head(nfb) = qdd.head(nfb);
+    for(uint i = nfb; i < independent_joint_names.size(); i++){
+        const std::string &name = independent_joint_names[i];
+        if(std::find(joint_state_in.names.begin(), joint_state_in.names.end(), name) == joint_state_in.names.end()){
+            LOG_ERROR_S << "Joint " << name << " is an independent joint in the robot model, but it is not in the joint state vector" << std::endl;
+            throw std::runtime_error("Incomplete Joint State");
+        }
+        const base::JointState &state = joint_state_in[name];
+        q[idx_independent[i] + q_offs] = state.position;
+        yd[i] = state.speed;
+        ydd[i] = state.acceleration;
+    }
+
+    // Dependent joints
+    solveLoopClosures();
+    computeProjections();
+    qd.noalias() = G_y * yd;
+    computeAccelerationBias();
+    qdd = g_y;
+    qdd.noalias() += G_y * ydd;
+
+    for(uint i = nfb; i < joint_state.size(); i++){
+        const int idx = idx_joint_state[i];
+        joint_state[i].position = q[idx + q_offs];
+        joint_state[i].speed = qd[idx];
+        joint_state[i].acceleration = qdd[idx];
+    }
+}
+
+void RobotModelPinocchioHybrid::systemState(base::VectorXd &_q, base::VectorXd &_qd, base::VectorXd &_qdd){
+    const uint nfb = has_floating_base ? 6 : 0;
+    const int q_offs = model.nq - model.nv;
+    _q.resize(idx_active.size() + q_offs);
+    _qd.resize(idx_active.size());
+    _qdd.resize(idx_active.size());
+    _q.head(nfb + q_offs) = q.head(nfb + q_offs);
+    for(uint i = 0; i < idx_active.size(); i++){
+        if(i >= nfb)
+            _q[i + q_offs] = q[idx_active[i] + q_offs];
+        _qd[i] = qd[idx_active[i]];
+        _qdd[i] = qdd[idx_active[i]];
+    }
+}
+
+pinocchio::FrameIndex RobotModelPinocchioHybrid::frameIndex(const std::string &root_frame, const std::string &tip_frame){
+
+    if(joint_state.time.isNull()){
+        LOG_ERROR("RobotModelPinocchioHybrid: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
+        throw std::runtime_error("Invalid call to frameIndex()");
+    }
+    if(root_frame != world_frame){
+        LOG_ERROR_S<<"Requested kinematics for chain "<<root_frame<<"->"<<tip_frame<<" but the pinocchio robot model always requires the root frame to be the root of the full model"<<std::endl;
+        throw std::runtime_error("Invalid root frame");
+    }
+    const pinocchio::FrameIndex idx = model.getFrameId(tip_frame == "world" ? "universe" : tip_frame);
+    if(idx == model.frames.size()){
+        LOG_ERROR_S<<"Requested kinematics for tip frame "<<tip_frame<<" but this frame does not exist in Pinocchio"<<std::endl;
+        throw std::runtime_error("Invalid tip frame");
+    }
+    return idx;
+}
+
+void RobotModelPinocchioHybrid::computeSpanningTreeInertia(){
+
+    if(joint_state.time.isNull()){
+        LOG_ERROR("RobotModelPinocchioHybrid: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
+        throw std::runtime_error("Invalid call to computeSpanningTreeInertia()");
+    }
+    pinocchio::crba(model, *data, q);
+    M_st = data->M;
+    // copy upper right triangular part to lower left triangular part (they are symmetric), as pinocchio only computes the former
+    M_st.triangularView<Eigen::StrictlyLower>() = M_st.transpose().triangularView<Eigen::StrictlyLower>();
+    M_st_G_u.noalias() = M_st * G_u;
+}
+
+const base::MatrixXd &RobotModelPinocchioHybrid::spaceJacobian(const std::string &root_frame, const std::string &tip_frame){
+    computeFrameJacobian(frameIndex(root_frame, tip_frame), pinocchio::LOCAL_WORLD_ALIGNED, J_st);
+    base::MatrixXd &jac_u = space_jac_map[chainID(root_frame, tip_frame)];
+    jac_u.noalias() = J_st * G_u;
+    return jac_u;
+}
+
+const base::MatrixXd &RobotModelPinocchioHybrid::bodyJacobian(const std::string &root_frame, const std::string &tip_frame){
+    computeFrameJacobian(frameIndex(root_frame, tip_frame), pinocchio::LOCAL, J_st);
+    base::MatrixXd &jac_u = body_jac_map[chainID(root_frame, tip_frame)];
+    jac_u.noalias() = J_st * G_u;
+    return jac_u;
+}
+
+const base::MatrixXd &RobotModelPinocchioHybrid::comJacobian(){
+    if(joint_state.time.isNull()){
+        LOG_ERROR("RobotModelPinocchioHybrid: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
+        throw std::runtime_error("Invalid call to comJacobian()");
+    }
+    pinocchio::jacobianCenterOfMass(model, *data, q);
+    com_jac.noalias() = data->Jcom * G_u;
+    return com_jac;
+}
+
+const base::Acceleration &RobotModelPinocchioHybrid::spatialAccelerationBias(const std::string &root_frame, const std::string &tip_frame){
+
+    // Spanning tree bias dJ*qd plus the acceleration due to the dependent joints for zero actuator accelerations, i.e., J*g_u
+    RobotModelPinocchio::spatialAccelerationBias(root_frame, tip_frame);
+    computeFrameJacobian(frameIndex(root_frame, tip_frame), pinocchio::LOCAL_WORLD_ALIGNED, J_st);
+    const base::Vector6d acc = J_st * g_u;
+    spatial_acc_bias.linear += acc.segment<3>(0);
+    spatial_acc_bias.angular += acc.segment<3>(3);
+    space_jac_map[chainID(root_frame, tip_frame)].noalias() = J_st * G_u;
+    return spatial_acc_bias;
+}
+
+const base::MatrixXd &RobotModelPinocchioHybrid::jointSpaceInertiaMatrix(){
+    computeSpanningTreeInertia();
+    joint_space_inertia_mat.noalias() = G_u.transpose() * M_st_G_u;
+    return joint_space_inertia_mat;
+}
+
+const base::VectorXd &RobotModelPinocchioHybrid::biasForces(){
+    computeSpanningTreeInertia();
+    pinocchio::nonLinearEffects(model, *data, q, qd);
+    h_st = data->nle;
+    h_st.noalias() += M_st * g_u;
+    bias_forces.noalias() = G_u.transpose() * h_st;
+    return bias_forces;
+}
+
+const base::MatrixXd &RobotModelPinocchioHybrid::jacobianDot(const std::string &root_frame, const std::string &tip_frame){
+    throw std::runtime_error("Not implemented: jacobianDot has not been implemented for RobotModelPinocchioHybrid");
+}
+
+const base::MatrixXd &RobotModelPinocchioHybrid::spatialAccelerationBiasDerivative(const std::string &root_frame, const std::string &tip_frame){
+    throw std::runtime_error("Not implemented: spatialAccelerationBiasDerivative has not been implemented for RobotModelPinocchioHybrid");
+}
+
+void RobotModelPinocchioHybrid::inverseDynamicsDerivatives(base::MatrixXd &dtau_dq, base::MatrixXd &dtau_dqd){
+    throw std::runtime_error("Not implemented: inverseDynamicsDerivatives has not been implemented for RobotModelPinocchioHybrid");
+}
+
+void RobotModelPinocchioHybrid::forwardDynamicsDerivatives(const base::VectorXd &tau, base::MatrixXd &dqdd_dq, base::MatrixXd &dqdd_dqd, base::MatrixXd &dqdd_dtau){
+    throw std::runtime_error("Not implemented: forwardDynamicsDerivatives has not been implemented for RobotModelPinocchioHybrid");
+}
+
+void RobotModelPinocchioHybrid::computeInverseDynamics(base::commands::Joints &solver_output){
+
+    if(joint_state.time.isNull()){
+        LOG_ERROR("RobotModelPinocchioHybrid: You have to call update() with appropriately timestamped joint data at least once before requesting kinematic information!");
+        throw std::runtime_error(" Invalid call to computeInverseDynamics()");
+    }
+
+    // Spanning tree torques to actuator forces by the principle of virtual work: tau_u = G_u^T * tau
+    pinocchio::rnea(model, *data, q, qd, qdd);
+    tau_st.noalias() = G_u.transpose() * data->tau;
+
+    const uint nfb = has_floating_base ? 6 : 0;
+    for(uint i = 0; i < actuated_joint_names.size(); i++)
+        solver_output[actuated_joint_names[i]].effort = tau_st[i + nfb];
+}
+
+}
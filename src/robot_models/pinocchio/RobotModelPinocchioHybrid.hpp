@@ -0,0 +1,141 @@
+#ifndef ROBOT_MODEL_PINOCCHIO_HYBRID_HPP
+#define ROBOT_MODEL_PINOCCHIO_HYBRID_HPP
+
+#include "RobotModelPinocchio.hpp"
+#include <Eigen/QR>
+#include <Eigen/LU>
+
+namespace wbc {
+
+/**
+ * @brief Pinocchio based robot model for series-parallel hybrid robots, i.e., robots with closed kinematic chains. Registered as "pinocchio_hybrid". Alternative to
+ * RobotModelHyrodyn that does not require the Hyrodyn library. The model requires
+ *   - The spanning tree of the robot in RobotModelConfig::file_or_string, i.e., the URDF with all loops cut open
+ *   - The loop closures in RobotModelConfig::loop_closures. Each loop closure constrains two frames of the spanning tree to coincide (3D or 6D).
+ *   - The submechanism file (RobotModelConfig::submechanism_file), from which the independent and active joints are read (keys jointnames_independent and jointnames_active).
+ *     The number of independent and active joints has to be the same.
+ *
+ * As in RobotModelHyrodyn, the input joint state of update() are the independent joints, the joint state of the model contains all spanning tree joints
+ * and the joint names of the model are the active joints (actuation space). In update(), the positions of the dependent joints are computed iteratively
+ * (Newton-Raphson) from the loop closure constraints, velocities and accelerations are computed from the constraint Jacobian Jc. With the loop closure
+ * constraints Jc*qd = 0 and Jc*qdd + dJc*qd = 0, the spanning tree velocities and accelerations can be written as qd = G*ud and qdd = G*udd + g,
+ * where u are the active joints. All Jacobians and the dynamics are projected to the actuation space: J_u = J*G, M_u = G^T*M*G, h_u = G^T*(h + M*g).
+ *
+ * Jacobian derivatives and dynamics derivatives are not implemented.
+ */
+class RobotModelPinocchioHybrid : public RobotModelPinocchio{
+protected:
+    static RobotModelRegistry<RobotModelPinocchioHybrid> reg;
+
+    struct LoopClosureIds{
+        pinocchio::FrameIndex frame_a, frame_b;
+        bool full_pose;
+    };
+    std::vector<LoopClosureIds> loop_closure_ids;
+    /** Indices of the independent (including floating base), dependent and active (including floating base) joints in the velocity vector of the spanning tree*/
+    std::vector<int> idx_independent, idx_dependent, idx_active;
+    /** Index of each element of the joint state in the velocity vector of the spanning tree*/
+    std::vector<int> idx_joint_state;
+    uint max_iterations;
+    double tolerance;
+
+    /** Constraint Jacobian, constraint residual and constraint bias (dJc*qd)*/
+    base::MatrixXd Jc, Jc_dep, Jc_indep, frame_jac;
+    base::VectorXd constraint_residual, constraint_bias;
+    Eigen::CompleteOrthogonalDecomposition<base::MatrixXd> cod;
+    Eigen::FullPivLU<base::MatrixXd> lu;
+    /** Projection from independent / active joint space to spanning tree, see class documentation*/
+    base::MatrixXd G_y, G_u, S_u_G_y;
+    base::VectorXd g_y, g_u;
+    /** Helper. Spanning tree quantities, which are projected to actuation space*/
+    base::MatrixXd M_st, M_st_G_u, J_st;
+    base::VectorXd h_st, tau_st, dv;
+    /** Helper. Preallocated in configure(), so that update() does not allocate memory*/
+    base::MatrixXd G_dep, S_u_G_y_inv;
+    base::VectorXd q_next, zero_v, dq_dep, g_dep, S_u_g_y, yd, ydd;
+
+    /** Compute the constraint residual and constraint Jacobian at the current spanning tree configuration*/
+    void computeConstraints();
+    /** Compute the positions of the dependent joints from the loop closure constraints. Throws if the iteration does not converge*/
+    void solveLoopClosures();
+    /** Compute the projections G_y and G_u from the current constraint Jacobian*/
+    void computeProjections();
+    /** Compute the constraint bias dJc*qd and the projections g_y, g_u at the current spanning tree configuration and velocity*/
+    void computeAccelerationBias();
+    /** Validate the given kinematic chain and return the frame index of the tip frame*/
+    pinocchio::FrameIndex frameIndex(const std::string &root_frame, const std::string &tip_frame);
+    /** Compute the mass-inertia matrix of the spanning tree (M_st) and M_st*G_u*/
+    void computeSpanningTreeInertia();
+    /** The projected inertia matrix does not have the sparsity of the kinematic tree, use the dense solve of RobotModel*/
+    virtual void solveFactorizedInertia(Eigen::Ref<base::MatrixXd> B){RobotModel::solveFactorizedInertia(B);}
+    /** Read a list of joint names from the given submechanism file. Lists of all submechanisms are concatenated. Floating base joints are skipped*/
+    bool readJointNames(const std::string& file, const std::string& key, std::vector<std::string>& names);
+
+public:
+    RobotModelPinocchioHybrid();
+    ~RobotModelPinocchioHybrid();
+
+    /**
+     * @brief Load and configure the robot model
+     * @param cfg Model configuration. See RobotModelConfig.hpp for details
+     * @return True in case of success, else false
+     */
+    virtual bool configure(const RobotModelConfig& cfg);
+
+    /**
+     * @brief Update the robot configuration
+     * @param joint_state The joint_state vector. Has to contain all independent joints of the model.
+     * @param poses Optional, only for floating base robots: update the floating base state of the robot model.
+     */
+    virtual void update(const base::samples::Joints& joint_state,
+                        const base::samples::RigidBodyStateSE3& floating_base_state = base::samples::RigidBodyStateSE3());
+
+    /** Return entire system state in actuation space, including floating base*/
+    virtual void systemState(base::VectorXd &q, base::VectorXd &qd, base::VectorXd &qdd);
+
+    /** @brief Returns the Space Jacobian in actuation space (see RobotModelPinocchio::spaceJacobian())*/
+    virtual const base::MatrixXd &spaceJacobian(const std::string &root_frame, const std::string &tip_frame);
+
+    /** @brief Returns the Body Jacobian in actuation space (see RobotModelPinocchio::bodyJacobian())*/
+    virtual const base::MatrixXd &bodyJacobian(const std::string &root_frame, const std::string &tip_frame);
+
+    /** @brief Returns the CoM Jacobian in actuation space (see RobotModelPinocchio::comJacobian())*/
+    virtual const base::MatrixXd &comJacobian();
+
+    /** @brief Returns the spatial acceleration bias, i.e. the acceleration of the tip frame for zero actuator accelerations*/
+    virtual const base::Acceleration &spatialAccelerationBias(const std::string &root_frame, const std::string &tip_frame);
+
+    /** @brief Compute and return the mass-inertia matrix in actuation space*/
+    virtual const base::MatrixXd &jointSpaceInertiaMatrix();
+
+    /** @brief Compute and return the bias forces in actuation space*/
+    virtual const base::VectorXd &biasForces();
+
+    /** @brief Not implemented*/
+    virtual const base::MatrixXd &jacobianDot(const std::string &root_frame, const std::string &tip_frame);
+
+    /** @brief Not implemented*/
+    virtual const base::MatrixXd &spatialAccelerationBiasDerivative(const std::string &root_frame, const std::string &tip_frame);
+
+    /** @brief Not implemented*/
+    virtual void inverseDynamicsDerivatives(base::MatrixXd &dtau_dq, base::MatrixXd &dtau_dqd);
+
+    /** @brief Not implemented*/
+    virtual void forwardDynamicsDerivatives(const base::VectorXd &tau, base::MatrixXd &dqdd_dq, base::MatrixXd &dqdd_dqd, base::MatrixXd &dqdd_dtau);
+
+    /** @brief Compute and return the inverse dynamics solution, i.e., the actuator forces*/
+    virtual void computeInverseDynamics(base::commands::Joints &solver_output);
+
+    /** @brief Dense Cholesky decomposition of the mass-inertia matrix in actuation space, see RobotModel::factorizeJointSpaceInertiaMatrix()*/
+    virtual void factorizeJointSpaceInertiaMatrix(){RobotModel::factorizeJointSpaceInertiaMatrix();}
+
+    /** Set the maximum number of iterations and the tolerance (max. constraint violation in m or rad) of the loop closure position solver. Default is 50 and 1e-10*/
+    void setLoopClosureSolverParams(const uint max_iter, const double tol){max_iterations = max_iter; tolerance = tol;}
+
+    /** Return the projection G from actuator velocities to spanning tree velocities (qd = G*ud)*/
+    const base::MatrixXd& actuationSpaceProjection(){return G_u;}
+};
+
+}
+
+#endif
@@ -2,9 +2,11 @@
 #define BOOST_TEST_MAIN
 #include <boost/test/unit_test.hpp>
 #include "../RobotModelPinocchio.hpp"
+#include "../RobotModelPinocchioHybrid.hpp"
 #include "../../../core/RobotModelConfig.hpp"
 #include "../../../tools/URDFTools.hpp"
 #include "../../test/test_robot_model.hpp"
+#include <chrono>
 
 using namespace std;
 using namespace wbc;
@@ -146,3 +148,303 @@ BOOST_AUTO_TEST_CASE(dynamics){
     testDynamics(robot_model, false);
 
 }
+
+BOOST_AUTO_TEST_CASE(float_vs_double){
+
+    /**
+     * Compare accuracy and computation time of the single precision model (RobotModelPinocchioFloat) with the double precision model
+     */
+
+    vector<string> urdf_files = {"../../../../../models/kuka/urdf/kuka_iiwa.urdf",
+                                 "../../../../../models/rh5v2/urdf/rh5v2.urdf"};
+    vector<string> tip_frames = {"kuka_lbr_l_tcp", "ALWristFT_Link"};
+    int n_samples = 1000;
+    bool verbose = false;
+
+    for(uint i = 0; i < urdf_files.size(); i++){
+        RobotModelConfig cfg(urdf_files[i]);
+        RobotModelPtr robot_model_d = make_shared<RobotModelPinocchio>();
+        RobotModelPtr robot_model_f = make_shared<RobotModelPinocchioFloat>();
+        BOOST_CHECK(robot_model_d->configure(cfg));
+        BOOST_CHECK(robot_model_f->configure(cfg));
+        const string root_frame = robot_model_d->worldFrame();
+
+        base::samples::Joints joint_state = makeRandomJointState(robot_model_d->jointNames());
+        double time_d = 0, time_f = 0;
+        for(int n = 0; n < n_samples; n++){
+            auto s = std::chrono::high_resolution_clock::now();
+            robot_model_d->update(joint_state);
+            robot_model_d->spaceJacobian(root_frame, tip_frames[i]);
+            robot_model_d->jointSpaceInertiaMatrix();
+            robot_model_d->biasForces();
+            auto e = std::chrono::high_resolution_clock::now();
+            time_d += std::chrono::duration_cast<std::chrono::nanoseconds>(e-s).count()*1e-3;
+
+            s = std::chrono::high_resolution_clock::now();
+            robot_model_f->update(joint_state);
+            robot_model_f->spaceJacobian(root_frame, tip_frames[i]);
+            robot_model_f->jointSpaceInertiaMatrix();
+            robot_model_f->biasForces();
+            e = std::chrono::high_resolution_clock::now();
+            time_f += std::chrono::duration_cast<std::chrono::nanoseconds>(e-s).count()*1e-3;
+        }
+
+        double err_jac = (robot_model_d->spaceJacobian(root_frame, tip_frames[i]) - robot_model_f->spaceJacobian(root_frame, tip_frames[i])).cwiseAbs().maxCoeff();
+        double err_mass = (robot_model_d->jointSpaceInertiaMatrix() - robot_model_f->jointSpaceInertiaMatrix()).cwiseAbs().maxCoeff();
+        double err_bias = (robot_model_d->biasForces() - robot_model_f->biasForces()).cwiseAbs().maxCoeff();
+        base::Vector3d pos_d = robot_model_d->rigidBodyState(root_frame, tip_frames[i]).pose.position;
+        base::Vector3d pos_f = robot_model_f->rigidBodyState(root_frame, tip_frames[i]).pose.position;
+        double err_fk = (pos_d - pos_f).cwiseAbs().maxCoeff();
+
+        if(verbose){
+            cout<<"Model: "<<urdf_files[i]<<endl;
+            cout<<"Avg. time double: "<<time_d/n_samples<<" (mu s), float: "<<time_f/n_samples<<" (mu s)"<<endl;
+            cout<<"Max. error FK: "<<err_fk<<", Jacobian: "<<err_jac<<", Mass matrix: "<<err_mass<<", Bias forces: "<<err_bias<<endl;
+        }
+
+        BOOST_CHECK(err_fk < 1e-4);
+        BOOST_CHECK(err_jac < 1e-4);
+        BOOST_CHECK(err_mass < 1e-3);
+        BOOST_CHECK(err_bias < 1e-2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dynamics_derivatives){
+
+    /**
+     * Compare the analytical derivatives of the inverse dynamics and the spatial acceleration bias with finite differences. Also compare
+     * the computation time of both approaches.
+     */
+
+    string urdf_file = "../../../../../models/kuka/urdf/kuka_iiwa.urdf";
+    string tip_frame = "kuka_lbr_l_tcp";
+    const double eps = 1e-6;
+    int n_samples = 100;
+    bool verbose = false;
+
+    RobotModelPtr robot_model = make_shared<RobotModelPinocchio>();
+    BOOST_CHECK(robot_model->configure(RobotModelConfig(urdf_file)));
+    const string root_frame = robot_model->worldFrame();
+    const uint nj = robot_model->noOfJoints();
+
+    base::samples::Joints joint_state = makeRandomJointState(robot_model->jointNames());
+    for(uint i = 0; i < nj; i++)
+        joint_state[i].acceleration = 0; // Inverse dynamics equals the bias forces for zero acceleration
+    robot_model->update(joint_state);
+
+    // Analytical derivatives
+    base::MatrixXd dtau_dq, dtau_dqd, dacc_dq;
+    auto s = std::chrono::high_resolution_clock::now();
+    for(int n = 0; n < n_samples; n++){
+        robot_model->update(joint_state);
+        robot_model->inverseDynamicsDerivatives(dtau_dq, dtau_dqd);
+        dacc_dq = robot_model->spatialAccelerationBiasDerivative(root_frame, tip_frame);
+    }
+    auto e = std::chrono::high_resolution_clock::now();
+    double time_analytical = std::chrono::duration_cast<std::chrono::nanoseconds>(e-s).count()*1e-3/n_samples;
+
+    // Finite differences, 2n additional model evaluations
+    base::MatrixXd dtau_dq_fd(nj,nj), dtau_dqd_fd(nj,nj), dacc_dq_fd(6,nj);
+    s = std::chrono::high_resolution_clock::now();
+    for(int n = 0; n < n_samples; n++){
+        robot_model->update(joint_state);
+        base::VectorXd tau = robot_model->biasForces();
+        base::Acceleration acc = robot_model->spatialAccelerationBias(root_frame, tip_frame);
+        for(uint i = 0; i < nj; i++){
+            base::samples::Joints js = joint_state;
+            js[i].position += eps;
+            robot_model->update(js);
+            dtau_dq_fd.col(i) = (robot_model->biasForces() - tau) / eps;
+            base::Acceleration acc_eps = robot_model->spatialAccelerationBias(root_frame, tip_frame);
+            dacc_dq_fd.col(i).segment(0,3) = (acc_eps.linear - acc.linear) / eps;
+            dacc_dq_fd.col(i).segment(3,3) = (acc_eps.angular - acc.angular) / eps;
+
+            js = joint_state;
+            js[i].speed += eps;
+            robot_model->update(js);
+            dtau_dqd_fd.col(i) = (robot_model->biasForces() - tau) / eps;
+        }
+    }
+    e = std::chrono::high_resolution_clock::now();
+    double time_fd = std::chrono::duration_cast<std::chrono::nanoseconds>(e-s).count()*1e-3/n_samples;
+
+    if(verbose){
+        cout<<"Avg. time analytical: "<<time_analytical<<" (mu s), finite differences: "<<time_fd<<" (mu s)"<<endl;
+        cout<<"dtau_dq"<<endl<<dtau_dq<<endl<<"dtau_dq (finite differences)"<<endl<<dtau_dq_fd<<endl;
+    }
+
+    BOOST_CHECK((dtau_dq - dtau_dq_fd).cwiseAbs().maxCoeff() < 1e-3);
+    BOOST_CHECK((dtau_dqd - dtau_dqd_fd).cwiseAbs().maxCoeff() < 1e-3);
+    BOOST_CHECK((dacc_dq - dacc_dq_fd).cwiseAbs().maxCoeff() < 1e-3);
+
+    // Forward dynamics derivatives: dqdd/dtau is the inverse of the mass-inertia matrix
+    robot_model->update(joint_state);
+    base::MatrixXd dqdd_dq, dqdd_dqd, dqdd_dtau;
+    robot_model->forwardDynamicsDerivatives(robot_model->biasForces(), dqdd_dq, dqdd_dqd, dqdd_dtau);
+    BOOST_CHECK((dqdd_dtau * robot_model->jointSpaceInertiaMatrix() - base::MatrixXd::Identity(nj,nj)).cwiseAbs().maxCoeff() < 1e-6);
+    // For tau = bias forces, qdd = 0 and the derivatives have to fulfill dqdd_dq = -M^-1 * dtau_dq
+    BOOST_CHECK((dqdd_dq + dqdd_dtau * dtau_dq).cwiseAbs().maxCoeff() < 1e-6);
+    BOOST_CHECK((dqdd_dqd + dqdd_dtau * dtau_dqd).cwiseAbs().maxCoeff() < 1e-6);
+
+    // Jacobian derivative: compare with the finite difference of the space Jacobian along the current joint velocities
+    robot_model->update(joint_state);
+    base::MatrixXd J = robot_model->spaceJacobian(root_frame, tip_frame);
+    base::MatrixXd J_dot = robot_model->jacobianDot(root_frame, tip_frame);
+    base::samples::Joints js = joint_state;
+    for(uint i = 0; i < nj; i++)
+        js[i].position += joint_state[i].speed * eps;
+    robot_model->update(js);
+    base::MatrixXd J_dot_fd = (robot_model->spaceJacobian(root_frame, tip_frame) - J) / eps;
+    BOOST_CHECK((J_dot - J_dot_fd).cwiseAbs().maxCoeff() < 1e-3);
+}
+
+BOOST_AUTO_TEST_CASE(hybrid_four_bar){
+
+    /**
+     * Planar four-bar linkage with the crank as independent joint and the rocker as active joint. Verify that the loop closure is fulfilled on
+     * position, velocity and acceleration level and compare the actuation space Jacobian with finite differences
+     */
+
+    RobotModelConfig cfg("../../../../../models/others/urdf/four_bar.urdf");
+    cfg.type = "pinocchio_hybrid";
+    cfg.submechanism_file = "../../../../../models/others/hyrodyn/four_bar.yml";
+    cfg.loop_closures.push_back(LoopClosure("coupler_tip", "rocker_tip"));
+
+    RobotModelPinocchioHybrid robot_model;
+    BOOST_CHECK(robot_model.configure(cfg));
+    BOOST_CHECK(robot_model.jointNames() == vector<string>({"rocker_joint"}));
+    BOOST_CHECK(robot_model.actuatedJointNames() == vector<string>({"rocker_joint"}));
+    BOOST_CHECK(robot_model.independentJointNames() == vector<string>({"crank_joint"}));
+
+    base::samples::Joints joint_state;
+    joint_state.names = robot_model.independentJointNames();
+    joint_state.elements.resize(1);
+    joint_state[0].position = 0.3;
+    joint_state[0].speed = 0.5;
+    joint_state[0].acceleration = -0.2;
+    joint_state.time = base::Time::now();
+    BOOST_CHECK_NO_THROW(robot_model.update(joint_state));
+
+    const string root = robot_model.worldFrame();
+    const string tip = "coupler_tip";
+
+    // Loop closure
+    base::samples::RigidBodyStateSE3 rbs_a = robot_model.rigidBodyState(root, "coupler_tip");
+    base::samples::RigidBodyStateSE3 rbs_b = robot_model.rigidBodyState(root, "rocker_tip");
+    BOOST_CHECK((rbs_a.pose.position - rbs_b.pose.position).norm() < 1e-8);
+    BOOST_CHECK((rbs_a.twist.linear - rbs_b.twist.linear).norm() < 1e-8);
+    BOOST_CHECK((rbs_a.acceleration.linear - rbs_b.acceleration.linear).norm() < 1e-8);
+
+    // Twist and acceleration from actuation space Jacobian and acceleration bias
+    base::JointState u = robot_model.jointState({"rocker_joint"})[0];
+    base::MatrixXd J = robot_model.spaceJacobian(root, tip);
+    base::Acceleration bias = robot_model.spatialAccelerationBias(root, tip);
+    BOOST_CHECK(J.rows() == 6 && J.cols() == 1);
+    BOOST_CHECK((J.col(0).segment(0,3)*u.speed - rbs_a.twist.linear).norm() < 1e-8);
+    BOOST_CHECK((J.col(0).segment(3,3)*u.speed - rbs_a.twist.angular).norm() < 1e-8);
+    BOOST_CHECK((J.col(0).segment(0,3)*u.acceleration + bias.linear - rbs_a.acceleration.linear).norm() < 1e-8);
+    BOOST_CHECK((J.col(0).segment(3,3)*u.acceleration + bias.angular - rbs_a.acceleration.angular).norm() < 1e-8);
+
+    // Jacobian vs. finite differences
+    const double eps = 1e-6;
+    base::samples::Joints js = joint_state;
+    js[0].position += eps;
+    robot_model.update(js);
+    const double du = robot_model.jointState({"rocker_joint"})[0].position - u.position;
+    const base::Vector3d dp = robot_model.rigidBodyState(root, tip).pose.position - rbs_a.pose.position;
+    BOOST_CHECK((dp/du - J.col(0).segment(0,3)).norm() < 1e-4);
+
+    // Inverse dynamics in actuation space
+    robot_model.update(joint_state);
+    base::commands::Joints tau;
+    tau.names = robot_model.actuatedJointNames();
+    tau.elements.resize(1);
+    robot_model.computeInverseDynamics(tau);
+    const double tau_u = robot_model.jointSpaceInertiaMatrix()(0,0) * u.acceleration + robot_model.biasForces()[0];
+    BOOST_CHECK(fabs(tau[0].effort - tau_u) < 1e-8);
+
+    // Dense factorization of the actuation space inertia matrix
+    base::VectorXd udd = base::VectorXd::Constant(1, tau_u);
+    robot_model.solveJointSpaceInertia(udd);
+    BOOST_CHECK(fabs(robot_model.jointSpaceInertiaMatrix()(0,0) * udd[0] - tau_u) < 1e-8);
+
+    // Missing loop closure
+    cfg.loop_closures.clear();
+    BOOST_CHECK(robot_model.configure(cfg) == false);
+}
+
+BOOST_AUTO_TEST_CASE(inertia_factorization){
+
+    /**
+     * Compare the sparse factorization of the joint space inertia matrix with a dense decomposition on a branched floating base robot.
+     * Also compare the computation time of both approaches.
+     */
+
+    string urdf_file = "../../../../../models/rh5/urdf/rh5.urdf";
+    vector<string> tip_frames = {"LLAnkle_FT", "LRAnkle_FT"};
+    int n_samples = 100;
+    bool verbose = false;
+
+    RobotModelPtr robot_model = make_shared<RobotModelPinocchio>();
+    RobotModelConfig cfg(urdf_file);
+    cfg.floating_base = true;
+    BOOST_CHECK(robot_model->configure(cfg));
+    const uint nj = robot_model->noOfJoints();
+
+    robot_model->update(makeRandomJointState(robot_model->actuatedJointNames()), makeRandomFloatingBaseState());
+    const string root_frame = robot_model->worldFrame();
+    base::MatrixXd J(12, nj);
+    J.topRows(6) = robot_model->spaceJacobian(root_frame, tip_frames[0]);
+    J.bottomRows(6) = robot_model->spaceJacobian(root_frame, tip_frames[1]);
+
+    // Sparse factorization
+    base::MatrixXd Minv_Jt, J_Minv_Jt;
+    auto s = std::chrono::high_resolution_clock::now();
+    for(int n = 0; n < n_samples; n++){
+        robot_model->factorizeJointSpaceInertiaMatrix();
+        robot_model->operationalSpaceInertiaInverse(J, J_Minv_Jt);
+    }
+    auto e = std::chrono::high_resolution_clock::now();
+    double time_sparse = std::chrono::duration_cast<std::chrono::nanoseconds>(e-s).count()*1e-3/n_samples;
+
+    // Dense factorization
+    base::MatrixXd J_Minv_Jt_dense;
+    s = std::chrono::high_resolution_clock::now();
+    for(int n = 0; n < n_samples; n++){
+        Eigen::LLT<base::MatrixXd> llt(robot_model->jointSpaceInertiaMatrix());
+        J_Minv_Jt_dense = J * llt.solve(J.transpose());
+    }
+    e = std::chrono::high_resolution_clock::now();
+    double time_dense = std::chrono::duration_cast<std::chrono::nanoseconds>(e-s).count()*1e-3/n_samples;
+
+    if(verbose)
+        cout<<"Avg. time sparse factorization: "<<time_sparse<<" (mu s), dense factorization: "<<time_dense<<" (mu s)"<<endl;
+
+    const base::MatrixXd M = robot_model->jointSpaceInertiaMatrix();
+    BOOST_CHECK((J_Minv_Jt - J_Minv_Jt_dense).cwiseAbs().maxCoeff() < 1e-6);
+    robot_model->inertiaInverseJacobianTranspose(J, Minv_Jt);
+    BOOST_CHECK((M * Minv_Jt - J.transpose()).cwiseAbs().maxCoeff() < 1e-6);
+
+    base::MatrixXd I = base::MatrixXd::Identity(nj,nj);
+    robot_model->solveJointSpaceInertia(I);
+    BOOST_CHECK((M * I - base::MatrixXd::Identity(nj,nj)).cwiseAbs().maxCoeff() < 1e-6);
+
+    base::VectorXd tau = robot_model->biasForces();
+    base::VectorXd qdd = tau;
+    robot_model->solveJointSpaceInertia(qdd);
+    BOOST_CHECK((M * qdd - tau).cwiseAbs().maxCoeff() < 1e-6);
+
+    // Wrong size
+    base::VectorXd v(nj+1);
+    BOOST_CHECK_THROW(robot_model->solveJointSpaceInertia(v), std::invalid_argument);
+
+    // New robot state with the same time stamp: The factorization has to be recomputed
+    base::samples::Joints joint_state = makeRandomJointState(robot_model->actuatedJointNames());
+    joint_state.time = robot_model->jointState(robot_model->actuatedJointNames()).time;
+    robot_model->update(joint_state, makeRandomFloatingBaseState());
+    const base::MatrixXd M_new = robot_model->jointSpaceInertiaMatrix();
+    BOOST_CHECK((M_new - M).cwiseAbs().maxCoeff() > 1e-6);
+    I.setIdentity();
+    robot_model->solveJointSpaceInertia(I);
+    BOOST_CHECK((M_new * I - base::MatrixXd::Identity(nj,nj)).cwiseAbs().maxCoeff() < 1e-6);
+}
@@ -38,6 +38,8 @@ bool RobotModelRBDL::configure(const RobotModelConfig& cfg){
     }
     base_frame = robot_urdf->getRoot()->name;
     URDFTools::applyJointBlacklist(robot_urdf, cfg.joint_blacklist);
+    if(!URDFTools::applyJointLocks(robot_urdf, cfg.locked_joints.names, cfg.locked_joints.elements))
+        return false;
     joint_names = URDFTools::jointNamesFromURDF(robot_urdf);
 
     // Temporary workaround: RBDL does not support rotations of the link invertias. Set them to zero.
@@ -131,6 +133,9 @@ void RobotModelRBDL::update(const base::samples::Joints& joint_state_in,
         throw std::runtime_error("Invalid joint state");
     }
 
+    // New robot state: The factorization of the joint space inertia matrix has to be recomputed on demand
+    inertia_factorization_valid = false;
+
     for(auto n : actuated_joint_names)
         joint_state[n] = joint_state_in[n];
     joint_state.time = joint_state_in.time;
@@ -4,6 +4,7 @@
 #include "robot_models/hyrodyn/RobotModelHyrodyn.hpp"
 #include "robot_models/rbdl/RobotModelRBDL.hpp"
 #include "robot_models/pinocchio/RobotModelPinocchio.hpp"
+#include "robot_models/pinocchio/RobotModelPinocchioHybrid.hpp"
 #include "test_robot_model.hpp"
 
 using namespace wbc;
@@ -291,3 +292,65 @@ BOOST_AUTO_TEST_CASE(floating_base){
 
     compareRobotModels(cfg, tip_frame, verbose);
 }
+
+BOOST_AUTO_TEST_CASE(pinocchio_hybrid){
+
+    /**
+     * Compare the pinocchio based hybrid robot model with Hyrodyn using the same submechanism files. Input are the independent joints, all quantities are given in actuation space.
+     * Besides serial models, this includes a closed loop mechanism (planar four-bar linkage), for which the loop closure is given explicitly to the pinocchio based model
+     */
+
+    vector<string> urdf_files = {"../../../../models/rh5/urdf/rh5_single_leg.urdf",
+                                 "../../../../models/kuka/urdf/kuka_iiwa.urdf",
+                                 "../../../../models/others/urdf/four_bar.urdf"};
+    vector<string> sub_mec_files = {"../../../../models/rh5/hyrodyn/rh5_single_leg.yml",
+                                   "../../../../models/kuka/hyrodyn/kuka_iiwa.yml",
+                                   "../../../../models/others/hyrodyn/four_bar.yml"};
+    vector<vector<LoopClosure>> loop_closures = {{}, {}, {LoopClosure("coupler_tip", "rocker_tip")}};
+    vector<vector<string>> passive_joints = {{}, {}, {"coupler_joint"}};
+    vector<string> tip_frames = {"LLAnkle_FT", "kuka_lbr_l_tcp", "coupler_tip"};
+
+    for(uint i = 0; i < urdf_files.size(); i++){
+
+        RobotModelConfig cfg(urdf_files[i]);
+        cfg.submechanism_file = sub_mec_files[i];
+        cfg.loop_closures = loop_closures[i];
+
+        RobotModelPinocchioHybrid robot_model_hybrid;
+        BOOST_CHECK(robot_model_hybrid.configure(cfg));
+        RobotModelHyrodyn robot_model_hyrodyn;
+        BOOST_CHECK(robot_model_hyrodyn.configure(cfg));
+        BOOST_CHECK(robot_model_hybrid.jointNames() == robot_model_hyrodyn.jointNames());
+        BOOST_CHECK(robot_model_hybrid.independentJointNames() == robot_model_hyrodyn.independentJointNames());
+
+        base::samples::Joints joint_state = makeRandomJointState(robot_model_hyrodyn.independentJointNames());
+        BOOST_CHECK_NO_THROW(robot_model_hybrid.update(joint_state));
+        BOOST_CHECK_NO_THROW(robot_model_hyrodyn.update(joint_state));
+
+        // Both models have to resolve the loop closures identically, i.e., yield the same positions, velocities and accelerations of the active and passive joints
+        vector<string> names = robot_model_hyrodyn.jointNames();
+        names.insert(names.end(), passive_joints[i].begin(), passive_joints[i].end());
+        const base::samples::Joints &spanning_tree_hyrodyn = robot_model_hyrodyn.jointState(names);
+        const base::samples::Joints &spanning_tree_hybrid = robot_model_hybrid.jointState(names);
+        for(uint j = 0; j < spanning_tree_hyrodyn.size(); j++){
+            BOOST_CHECK(fabs(spanning_tree_hybrid[j].position - spanning_tree_hyrodyn[j].position) < 1e-3);
+            BOOST_CHECK(fabs(spanning_tree_hybrid[j].speed - spanning_tree_hyrodyn[j].speed) < 1e-3);
+            BOOST_CHECK(fabs(spanning_tree_hybrid[j].acceleration - spanning_tree_hyrodyn[j].acceleration) < 1e-3);
+        }
+
+        const string root = robot_model_hybrid.worldFrame();
+        compareRbs(robot_model_hybrid.rigidBodyState(root, tip_frames[i]), robot_model_hyrodyn.rigidBodyState(root, tip_frames[i]));
+        compareJacobian(robot_model_hybrid.spaceJacobian(root, tip_frames[i]), robot_model_hyrodyn.spaceJacobian(root, tip_frames[i]),
+                        robot_model_hybrid.jointNames(), robot_model_hyrodyn.jointNames(), false);
+        compareJacobian(robot_model_hybrid.bodyJacobian(root, tip_frames[i]), robot_model_hyrodyn.bodyJacobian(root, tip_frames[i]),
+                        robot_model_hybrid.jointNames(), robot_model_hyrodyn.jointNames(), false);
+        compareMassInertiaMat(robot_model_hybrid.jointSpaceInertiaMatrix(), robot_model_hyrodyn.jointSpaceInertiaMatrix(),
+                              robot_model_hybrid.jointNames(), robot_model_hyrodyn.jointNames());
+        compareVect(robot_model_hybrid.biasForces(), robot_model_hyrodyn.biasForces(), robot_model_hybrid.jointNames(), robot_model_hyrodyn.jointNames());
+
+        base::Acceleration acc_hybrid = robot_model_hybrid.spatialAccelerationBias(root, tip_frames[i]);
+        base::Acceleration acc_hyrodyn = robot_model_hyrodyn.spatialAccelerationBias(root, tip_frames[i]);
+        BOOST_CHECK((acc_hybrid.linear - acc_hyrodyn.linear).norm() < 1e-3);
+        BOOST_CHECK((acc_hybrid.angular - acc_hyrodyn.angular).norm() < 1e-3);
+    }
+}
@@ -60,18 +60,13 @@ const HierarchicalQP& AccelerationScene::update(){
     qp.g.setZero();
     for(uint i = 0; i < tasks[prio].size(); i++){
 
-        TaskPtr task = tasks[prio][i];
+        const TaskPtr& task = tasks[prio][i];
 
         task->checkTimeout();
+        if(task->checkInactive())
+            continue;
         task->update(robot_model);
 
-        // If the activation value is zero, also set reference to zero. Activation is usually used to switch between different
-        // task phases and we don't want to store the "old" reference value, in case we switch on the task again
-        if(task->activation == 0){
-           task->y_ref.setZero();
-           task->y_ref_root.setZero();
-        }
-
         for(int i = 0; i < task->A.rows(); i++){
             task->Aw.row(i) = task->weights_root(i) * task->A.row(i) * task->activation * (!task->timeout);
             task->y_ref_root(i) = task->y_ref_root(i) * task->weights_root(i) * task->activation;
@@ -79,8 +74,12 @@ const HierarchicalQP& AccelerationScene::update(){
         for(int i = 0; i < task->A.cols(); i++)
             task->Aw.col(i) = joint_weights[i] * task->Aw.col(i);
 
-        qp.H += task->Aw.transpose()*task->Aw;
-        qp.g -= task->Aw.transpose()*task->y_ref_root;
+        // Rows with zero weight do not contribute to the cost
+        task->pruneRows();
+        const base::MatrixXd& Aw = task->activeAw();
+        const base::VectorXd& y_ref = task->activeYRef();
+        qp.H += Aw.transpose()*Aw;
+        qp.g -= Aw.transpose()*y_ref;
     }
 
     hqp.time = base::Time::now(); //  TODO: Use latest time stamp from all tasks!?
@@ -118,7 +117,7 @@ const TasksStatus &AccelerationScene::updateTasksStatus(){
 
     for(uint prio = 0; prio < tasks.size(); prio++){
         for(uint i = 0; i < tasks[prio].size(); i++){
-            TaskPtr task = tasks[prio][i];
+            const TaskPtr& task = tasks[prio][i];
             const std::string &name = task->config.name;
 
             tasks_status[name].time       = task->time;
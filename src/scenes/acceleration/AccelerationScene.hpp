@@ -23,6 +23,9 @@ namespace wbc{
  * \f$\mathbf{J}_w\f$ - Weighted task Jacobians<br>
  * \f$\mathbf{W}\f$ - Diagonal task weight matrix<br>
  * \f$\dot{\mathbf{J}}\dot{\mathbf{q}}\f$ - Acceleration bias<br>
+ *
+ * Since the problem is unconstrained, it can be solved directly with a Cholesky decomposition of the Hessian, i.e., without the overhead of a generic QP solver. To do so, pass
+ * an UnconstrainedSolver (registered as "unconstrained") to the scene.
  */
 class AccelerationScene : public Scene{
 protected:
@@ -4,6 +4,7 @@
 #include "robot_models/pinocchio/RobotModelPinocchio.hpp"
 #include "scenes/acceleration/AccelerationScene.hpp"
 #include "solvers/qpoases/QPOasesSolver.hpp"
+#include "solvers/unconstrained/UnconstrainedSolver.hpp"
 
 using namespace std;
 using namespace wbc;
@@ -72,4 +73,11 @@ BOOST_AUTO_TEST_CASE(simple_test){
         BOOST_CHECK(fabs(status[0].y_ref[i] - status[0].y_solution[i]) < 1e-4);
         BOOST_CHECK(fabs(status[0].y_ref[i+3] - status[0].y_solution[i+3]) < 1e-4);
     }
+
+    // The QP of this scene is unconstrained, so the direct solver has to yield the same solution
+    AccelerationScene wbc_scene_unconstrained(robot_model, std::make_shared<UnconstrainedSolver>(), 1e-3);
+    BOOST_CHECK_EQUAL(wbc_scene_unconstrained.configure({cart_task}), true);
+    BOOST_CHECK_NO_THROW(wbc_scene_unconstrained.setReference(cart_task.name, ref));
+    BOOST_CHECK_NO_THROW(wbc_scene_unconstrained.solve(wbc_scene_unconstrained.update()));
+    BOOST_CHECK((wbc_scene_unconstrained.getSolverOutputRaw() - wbc_scene.getSolverOutputRaw()).norm() < 1e-6);
 }
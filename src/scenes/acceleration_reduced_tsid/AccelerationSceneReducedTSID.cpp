@@ -10,6 +10,7 @@
 #include "../../constraints/ContactsAccelerationConstraint.hpp"
 #include "../../constraints/JointLimitsAccelerationConstraint.hpp"
 #include "../../constraints/EffortLimitsAccelerationConstraint.hpp"
+#include "../../constraints/ContactsFrictionPointConstraint.hpp"
 #include "../../constraints/ContactsFrictionSurfaceConstraint.hpp"
 
 
@@ -21,17 +22,36 @@ AccelerationSceneReducedTSID::AccelerationSceneReducedTSID(RobotModelPtr robot_m
     Scene(robot_model, solver, dt),
     hessian_regularizer(1e-8){
 
+    // Default constraints, used if no constraint configuration is passed to configure()
+    default_constraint_config = {ConstraintConfig(dynamics_constraint),
+                                 ConstraintConfig(contacts_constraint),
+                                 ConstraintConfig(joint_limits_constraint),
+                                 ConstraintConfig(effort_limits_constraint),
+                                 ConstraintConfig(friction_surface_constraint)};
+}
+
+ConstraintPtr AccelerationSceneReducedTSID::createConstraint(const ConstraintConfig &config){
+
     // whether or not torques are removed  from the qp problem
-    // this formulation includes torques !!!
     bool reduced = true; // DO NOT CHANGE
 
-    // for now manually adding constraint to this scene (an option would be to take them during configuration)
-    constraints.resize(1);
-    constraints[0].push_back(std::make_shared<RigidbodyDynamicsConstraint>(reduced));
-    constraints[0].push_back(std::make_shared<ContactsAccelerationConstraint>(reduced));
-    constraints[0].push_back(std::make_shared<JointLimitsAccelerationConstraint>(dt, reduced));
-    constraints[0].push_back(std::make_shared<EffortLimitsAccelerationConstraint>());
-    constraints[0].push_back(std::make_shared<ContactsFrictionSurfaceConstraint>(reduced));
+    switch(config.type){
+    case dynamics_constraint:
+        return std::make_shared<RigidbodyDynamicsConstraint>(reduced);
+    case contacts_constraint:
+        return std::make_shared<ContactsAccelerationConstraint>(reduced);
+    case joint_limits_constraint:
+        return std::make_shared<JointLimitsAccelerationConstraint>(dt, reduced, config.margin);
+    case effort_limits_constraint:
+        return std::make_shared<EffortLimitsAccelerationConstraint>(config.margin);
+    case friction_point_constraint:
+        return std::make_shared<ContactsFrictionPointConstraint>(reduced);
+    case friction_surface_constraint:
+        return std::make_shared<ContactsFrictionSurfaceConstraint>(reduced);
+    default:
+        LOG_ERROR("AccelerationSceneReducedTSID does not support constraints of type %i", config.type);
+        throw std::invalid_argument("Invalid constraint config");
+    }
 }
 
 TaskPtr AccelerationSceneReducedTSID::createTask(const TaskConfig &config){
@@ -66,7 +86,7 @@ const HierarchicalQP& AccelerationSceneReducedTSID::update(){
 
     bool has_bounds = false;
     size_t total_eqs = 0, total_ineqs = 0;
-    for(auto contraint : constraints[prio]) {
+    for(const ConstraintPtr& contraint : constraints[prio]) {
         contraint->update(robot_model);
         if(contraint->type() == Constraint::equality)
             total_eqs += contraint->size();
@@ -114,18 +134,13 @@ const HierarchicalQP& AccelerationSceneReducedTSID::update(){
     qp.g.setZero();
     for(uint i = 0; i < tasks[prio].size(); i++){
         
-        TaskPtr task = tasks[prio][i];
+        const TaskPtr& task = tasks[prio][i];
 
         task->checkTimeout();
+        if(task->checkInactive())
+            continue;
         task->update(robot_model);
 
-        // If the activation value is zero, also set reference to zero. Activation is usually used to switch between different
-        // task phases and we don't want to store the "old" reference value, in case we switch on the task again
-        if(task->activation == 0){
-           task->y_ref.setZero();
-           task->y_ref_root.setZero();
-        }
-
         for(int i = 0; i < task->A.rows(); i++){
             task->Aw.row(i) = task->weights_root(i) * task->A.row(i) * task->activation * (!task->timeout);
             task->y_ref_root(i) = task->y_ref_root(i) * task->weights_root(i) * task->activation;
@@ -133,8 +148,12 @@ const HierarchicalQP& AccelerationSceneReducedTSID::update(){
         for(int i = 0; i < task->A.cols(); i++)
             task->Aw.col(i) = joint_weights[i] * task->Aw.col(i);
 
-        qp.H.block(0,0,nj,nj) += task->Aw.transpose()*task->Aw; // NOTE! good only if tasks involve only acceleration
-        qp.g.segment(0,nj) -= task->Aw.transpose()*task->y_ref_root;
+        // Rows with zero weight do not contribute to the cost
+        task->pruneRows();
+        const base::MatrixXd& Aw = task->activeAw();
+        const base::VectorXd& y_ref = task->activeYRef();
+        qp.H.block(0,0,nj,nj) += Aw.transpose()*Aw; // NOTE! good only if tasks involve only acceleration
+        qp.g.segment(0,nj) -= Aw.transpose()*y_ref;
     }
 
     qp.H.block(0,0, nj, nj).diagonal().array() += hessian_regularizer;
@@ -213,7 +232,7 @@ const TasksStatus& AccelerationSceneReducedTSID::updateTasksStatus(){
 
     for(uint prio = 0; prio < tasks.size(); prio++){
         for(uint i = 0; i < tasks[prio].size(); i++){
-            TaskPtr task = tasks[prio][i];
+            const TaskPtr& task = tasks[prio][i];
             const std::string &name = task->config.name;
 
             tasks_status[name].time       = task->time;
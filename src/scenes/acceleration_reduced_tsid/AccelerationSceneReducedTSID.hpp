@@ -42,7 +42,6 @@ protected:
 
     // Helper variables
     base::VectorXd robot_acc, solver_output_acc;
-    base::samples::Wrenches contact_wrenches;
     double hessian_regularizer;
 
     /**
@@ -50,6 +49,12 @@ protected:
      */
     virtual TaskPtr createTask(const TaskConfig &config);
 
+    /**
+     * @brief Create a constraint. Supported types: dynamics_constraint, contacts_constraint, joint_limits_constraint, effort_limits_constraint, friction_point_constraint,
+     * friction_surface_constraint. Default: dynamics_constraint, contacts_constraint, joint_limits_constraint, effort_limits_constraint, friction_surface_constraint.
+     */
+    virtual ConstraintPtr createConstraint(const ConstraintConfig &config);
+
     base::Time stamp;
 
 public:
@@ -73,11 +78,6 @@ public:
      */
     virtual const TasksStatus &updateTasksStatus();
 
-    /**
-     * @brief Get estimated contact wrenches
-     */
-    const base::samples::Wrenches& getContactWrenches(){return contact_wrenches;}
-
     /**
      * @brief setHessianRegularizer
      * @param reg This value is added to the diagonal of the Hessian matrix inside the QP to reduce the risk of infeasibility. Default is 1e-8
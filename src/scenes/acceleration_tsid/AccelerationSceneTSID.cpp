@@ -9,6 +9,7 @@
 #include "../../constraints/RigidbodyDynamicsConstraint.hpp"
 #include "../../constraints/ContactsAccelerationConstraint.hpp"
 #include "../../constraints/JointLimitsAccelerationConstraint.hpp"
+#include "../../constraints/ContactsFrictionPointConstraint.hpp"
 #include "../../constraints/ContactsFrictionSurfaceConstraint.hpp"
 
 namespace wbc {
@@ -19,16 +20,33 @@ AccelerationSceneTSID::AccelerationSceneTSID(RobotModelPtr robot_model, QPSolver
     Scene(robot_model, solver, dt),
     hessian_regularizer(1e-8){
 
+    // Default constraints, used if no constraint configuration is passed to configure()
+    default_constraint_config = {ConstraintConfig(dynamics_constraint),
+                                 ConstraintConfig(contacts_constraint),
+                                 ConstraintConfig(joint_limits_constraint),
+                                 ConstraintConfig(friction_surface_constraint)};
+}
+
+ConstraintPtr AccelerationSceneTSID::createConstraint(const ConstraintConfig &config){
+
     // whether or not torques are removed  from the qp problem
-    // this formulation includes torques !!!
     bool reduced = false; // DO NOT CHANGE
 
-    // for now manually adding constraint to this scene (an option would be to take them during configuration)
-    constraints.resize(1);
-    constraints[0].push_back(std::make_shared<RigidbodyDynamicsConstraint>(reduced));
-    constraints[0].push_back(std::make_shared<ContactsAccelerationConstraint>(reduced));
-    constraints[0].push_back(std::make_shared<JointLimitsAccelerationConstraint>(dt, reduced));
-    constraints[0].push_back(std::make_shared<ContactsFrictionSurfaceConstraint>(reduced));
+    switch(config.type){
+    case dynamics_constraint:
+        return std::make_shared<RigidbodyDynamicsConstraint>(reduced);
+    case contacts_constraint:
+        return std::make_shared<ContactsAccelerationConstraint>(reduced);
+    case joint_limits_constraint:
+        return std::make_shared<JointLimitsAccelerationConstraint>(dt, reduced, config.margin);
+    case friction_point_constraint:
+        return std::make_shared<ContactsFrictionPointConstraint>(reduced);
+    case friction_surface_constraint:
+        return std::make_shared<ContactsFrictionSurfaceConstraint>(reduced);
+    default:
+        LOG_ERROR("AccelerationSceneTSID does not support constraints of type %i", config.type);
+        throw std::invalid_argument("Invalid constraint config");
+    }
 }
 
 TaskPtr AccelerationSceneTSID::createTask(const TaskConfig &config){
@@ -45,6 +63,35 @@ TaskPtr AccelerationSceneTSID::createTask(const TaskConfig &config){
     }
 }
 
+void AccelerationSceneTSID::updateTasks(QuadraticProgram& qp, uint nj){
+
+    qp.H.setZero();
+    qp.g.setZero();
+    for(uint i = 0; i < tasks[0].size(); i++){
+        
+        const TaskPtr& task = tasks[0][i];
+
+        task->checkTimeout();
+        if(task->checkInactive())
+            continue;
+        task->update(robot_model);
+
+        for(int i = 0; i < task->A.rows(); i++){
+            task->Aw.row(i) = task->weights_root(i) * task->A.row(i) * task->activation * (!task->timeout);
+            task->y_ref_root(i) = task->y_ref_root(i) * task->weights_root(i) * task->activation;
+        }
+        for(int i = 0; i < task->A.cols(); i++)
+            task->Aw.col(i) = joint_weights[i] * task->Aw.col(i);
+
+        // Rows with zero weight do not contribute to the cost
+        task->pruneRows();
+        const base::MatrixXd& Aw = task->activeAw();
+        const base::VectorXd& y_ref = task->activeYRef();
+        qp.H.block(0,0,nj,nj) += Aw.transpose()*Aw;
+        qp.g.segment(0,nj) -= Aw.transpose()*y_ref;
+    }
+}
+
 const HierarchicalQP& AccelerationSceneTSID::update(){
 
     if(!configured)
@@ -64,7 +111,7 @@ const HierarchicalQP& AccelerationSceneTSID::update(){
 
     bool has_bounds = false;
     size_t total_eqs = 0, total_ineqs = 0;
-    for(auto contraint : constraints[prio]) {
+    for(const ConstraintPtr& contraint : constraints[prio]) {
         contraint->update(robot_model);
         if(contraint->type() == Constraint::equality)
             total_eqs += contraint->size();
@@ -100,32 +147,7 @@ const HierarchicalQP& AccelerationSceneTSID::update(){
 
     ///////// Tasks
 
-    qp.H.setZero();
-    qp.g.setZero();
-    for(uint i = 0; i < tasks[prio].size(); i++){
-        
-        TaskPtr task = tasks[prio][i];
-
-        task->checkTimeout();
-        task->update(robot_model);
-
-        // If the activation value is zero, also set reference to zero. Activation is usually used to switch between different
-        // task phases and we don't want to store the "old" reference value, in case we switch on the task again
-        if(task->activation == 0){
-           task->y_ref.setZero();
-           task->y_ref_root.setZero();
-        }
-
-        for(int i = 0; i < task->A.rows(); i++){
-            task->Aw.row(i) = task->weights_root(i) * task->A.row(i) * task->activation * (!task->timeout);
-            task->y_ref_root(i) = task->y_ref_root(i) * task->weights_root(i) * task->activation;
-        }
-        for(int i = 0; i < task->A.cols(); i++)
-            task->Aw.col(i) = joint_weights[i] * task->Aw.col(i);
-
-        qp.H.block(0,0,nj,nj) += task->Aw.transpose()*task->Aw;
-        qp.g.segment(0,nj) -= task->Aw.transpose()*task->y_ref_root;
-    }
+    updateTasks(qp, nj);
 
     qp.H.block(0,0, nj, nj).diagonal().array() += hessian_regularizer;
 
@@ -189,7 +211,7 @@ const TasksStatus& AccelerationSceneTSID::updateTasksStatus(){
 
     for(uint prio = 0; prio < tasks.size(); prio++){
         for(uint i = 0; i < tasks[prio].size(); i++){
-            TaskPtr task = tasks[prio][i];
+            const TaskPtr& task = tasks[prio][i];
             const std::string &name = task->config.name;
 
             tasks_status[name].time       = task->time;
@@ -42,7 +42,6 @@ protected:
 
     // Helper variables
     base::VectorXd robot_acc, solver_output_acc;
-    base::samples::Wrenches contact_wrenches;
     double hessian_regularizer;
 
     /**
@@ -50,8 +49,19 @@ protected:
      */
     virtual TaskPtr createTask(const TaskConfig &config);
 
+    /**
+     * @brief Create a constraint. Supported types: dynamics_constraint, contacts_constraint, joint_limits_constraint, friction_point_constraint, friction_surface_constraint.
+     * Default: dynamics_constraint, contacts_constraint, joint_limits_constraint, friction_surface_constraint.
+     */
+    virtual ConstraintPtr createConstraint(const ConstraintConfig &config);
+
     base::Time stamp;
 
+    /**
+     * @brief Update all tasks and add them to the cost function of the given QP. Only the first nj variables (joint velocities/accelerations) are affected.
+     */
+    void updateTasks(QuadraticProgram& qp, uint nj);
+
 public:
     AccelerationSceneTSID(RobotModelPtr robot_model, QPSolverPtr solver, const double dt);
     virtual ~AccelerationSceneTSID(){
@@ -74,11 +84,6 @@ public:
      */
     virtual const TasksStatus &updateTasksStatus();
 
-    /**
-     * @brief Get estimated contact wrenches
-     */
-    const base::samples::Wrenches& getContactWrenches(){return contact_wrenches;}
-
     /**
      * @brief setHessianRegularizer
      * @param reg This value is added to the diagonal of the Hessian matrix inside the QP to reduce the risk of infeasibility. Default is 1e-8
@@ -4,6 +4,7 @@
 #include "robot_models/pinocchio/RobotModelPinocchio.hpp"
 #include "scenes/acceleration_tsid/AccelerationSceneTSID.hpp"
 #include "solvers/qpoases/QPOasesSolver.hpp"
+#include "solvers/frontends/ContactSwitchSolver.hpp"
 
 using namespace std;
 using namespace wbc;
@@ -92,3 +93,147 @@ BOOST_AUTO_TEST_CASE(simple_test){
         BOOST_CHECK(fabs(status[0].y_ref[i+3] - status[0].y_solution[i+3]) < 1e3);
     }
 }
+
+BOOST_AUTO_TEST_CASE(constraint_config){
+
+    /**
+     * Check if the constraints of the scene can be selected and ordered via configure()
+     */
+
+    shared_ptr<RobotModelPinocchio> robot_model = make_shared<RobotModelPinocchio>();
+    RobotModelConfig config;
+    config.file_or_string = "../../../../../models/rh5/urdf/rh5_legs.urdf";
+    config.floating_base = true;
+    config.contact_points.names = {"FL_SupportCenter", "FR_SupportCenter"};
+    wbc::ActiveContact contact(1,0.6);
+    contact.wx = 0.2;
+    contact.wy = 0.08;
+    config.contact_points.elements = {contact, contact};
+    BOOST_CHECK_EQUAL(robot_model->configure(config), true);
+
+    base::samples::Joints joint_state;
+    joint_state.names = robot_model->actuatedJointNames();
+    for(uint i = 0; i < robot_model->noOfActuatedJoints(); i++){
+        base::JointState js;
+        js.position = 0.1;
+        js.speed = js.acceleration = 0;
+        joint_state.elements.push_back(js);
+    }
+    joint_state.time = base::Time::now();
+
+    base::samples::RigidBodyStateSE3 rbs;
+    rbs.pose.position = base::Vector3d(-0.175,0,0.876);
+    rbs.pose.orientation.setIdentity();
+    rbs.twist.setZero();
+    rbs.acceleration.setZero();
+    rbs.time = base::Time::now();
+    BOOST_CHECK_NO_THROW(robot_model->update(joint_state,rbs));
+
+    TaskConfig cart_task("cart_pos_ctrl", 0, "world", "RH5_Root_Link", "world", 1);
+
+    // Default constraints
+    AccelerationSceneTSID wbc_scene(robot_model, std::make_shared<QPOASESSolver>(), 1e-3);
+    BOOST_CHECK_EQUAL(wbc_scene.configure({cart_task}), true);
+    BOOST_CHECK(wbc_scene.getConstraintConfig().size() == 4);
+    HierarchicalQP hqp_default = wbc_scene.update();
+    BOOST_CHECK(hqp_default[0].bounded);
+
+    // Point instead of surface friction cones: 4 inequalities per contact
+    BOOST_CHECK_EQUAL(wbc_scene.configure({cart_task}, {ConstraintConfig(dynamics_constraint),
+                                                        ConstraintConfig(contacts_constraint),
+                                                        ConstraintConfig(joint_limits_constraint, 0.01),
+                                                        ConstraintConfig(friction_point_constraint)}), true);
+    HierarchicalQP hqp = wbc_scene.update();
+    BOOST_CHECK(hqp[0].neq == hqp_default[0].neq);
+    BOOST_CHECK(hqp[0].nin == 8);
+    BOOST_CHECK(hqp[0].bounded);
+
+    // No contact related constraints, no joint limits
+    BOOST_CHECK_EQUAL(wbc_scene.configure({cart_task}, {ConstraintConfig(dynamics_constraint)}), true);
+    hqp = wbc_scene.update();
+    BOOST_CHECK(hqp[0].neq == (int)robot_model->noOfJoints());
+    BOOST_CHECK(hqp[0].nin == 0);
+    BOOST_CHECK(!hqp[0].bounded);
+
+    // Invalid configurations: Unsupported constraint type and negative margin
+    BOOST_CHECK_EQUAL(wbc_scene.configure({cart_task}, {ConstraintConfig(effort_limits_constraint)}), false);
+    BOOST_CHECK_EQUAL(wbc_scene.configure({cart_task}, {ConstraintConfig(joint_limits_constraint, -1)}), false);
+}
+
+BOOST_AUTO_TEST_CASE(contact_switch){
+
+    /**
+     * Announce a contact switch with ContactSwitchSolver::prepare(): At the actual switch, the scene should be solved with the prepared backend
+     * instead of setting up a new one, and the solution should match a freshly set up solver
+     */
+
+    shared_ptr<RobotModelPinocchio> robot_model = make_shared<RobotModelPinocchio>();
+    RobotModelConfig config;
+    config.file_or_string = "../../../../../models/rh5/urdf/rh5_legs.urdf";
+    config.floating_base = true;
+    config.contact_points.names = {"FL_SupportCenter", "FR_SupportCenter"};
+    wbc::ActiveContact contact(1,0.6);
+    contact.wx = 0.2;
+    contact.wy = 0.08;
+    config.contact_points.elements = {contact, contact};
+    BOOST_CHECK_EQUAL(robot_model->configure(config), true);
+
+    base::samples::Joints joint_state;
+    joint_state.names = robot_model->actuatedJointNames();
+    for(uint i = 0; i < robot_model->noOfActuatedJoints(); i++){
+        base::JointState js;
+        js.position = 0.1;
+        js.speed = js.acceleration = 0;
+        joint_state.elements.push_back(js);
+    }
+    joint_state.time = base::Time::now();
+
+    base::samples::RigidBodyStateSE3 rbs;
+    rbs.pose.position = base::Vector3d(-0.175,0,0.876);
+    rbs.pose.orientation.setIdentity();
+    rbs.twist.setZero();
+    rbs.acceleration.setZero();
+    rbs.time = base::Time::now();
+    BOOST_CHECK_NO_THROW(robot_model->update(joint_state,rbs));
+
+    auto create_backend = [](){
+        shared_ptr<QPOASESSolver> solver = make_shared<QPOASESSolver>();
+        solver->setMaxNoWSR(1000);
+        return solver;
+    };
+    shared_ptr<ContactSwitchSolver> solver = make_shared<ContactSwitchSolver>(create_backend);
+    ScenePtr wbc_scene = make_shared<AccelerationSceneTSID>(robot_model, solver, 1e-3);
+    TaskConfig cart_task("cart_pos_ctrl", 0, "world", "RH5_Root_Link", "world", 1);
+    BOOST_CHECK_EQUAL(wbc_scene->configure({cart_task}), true);
+
+    BOOST_CHECK_NO_THROW(wbc_scene->solve(wbc_scene->update()));
+    BOOST_CHECK(solver->setupInSolve() == true);
+
+    // Announce lift-off of the right foot. The active contacts of the robot model must not change
+    ActiveContacts double_support = robot_model->getActiveContacts();
+    ActiveContacts single_support = double_support;
+    single_support[1].active = 0;
+    BOOST_CHECK(solver->prepare(wbc_scene, single_support));
+    BOOST_CHECK(solver->waitForPreparation());
+    BOOST_CHECK(robot_model->getActiveContacts()[1].active == 1);
+    BOOST_CHECK(solver->getNoBackends() == 2);
+
+    // Contact switch: Prepared backend is used
+    robot_model->setActiveContacts(single_support);
+    HierarchicalQP hqp = wbc_scene->update();
+    BOOST_CHECK_NO_THROW(wbc_scene->solve(hqp));
+    BOOST_CHECK(solver->setupInSolve() == false);
+    BOOST_CHECK(solver->getNoSwaps() == 1);
+
+    base::VectorXd reference_output;
+    QPSolverPtr reference_solver = create_backend();
+    BOOST_CHECK_NO_THROW(reference_solver->solve(hqp, reference_output));
+    BOOST_CHECK((wbc_scene->getSolverOutputRaw() - reference_output).cwiseAbs().maxCoeff() < 1e-6);
+
+    // Back to double support: The backend of the first structure is reused
+    robot_model->setActiveContacts(double_support);
+    BOOST_CHECK_NO_THROW(wbc_scene->solve(wbc_scene->update()));
+    BOOST_CHECK(solver->setupInSolve() == false);
+    BOOST_CHECK(solver->getNoSwaps() == 2);
+    BOOST_CHECK(solver->getNoSetups() == 1);
+}
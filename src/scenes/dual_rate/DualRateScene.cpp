@@ -0,0 +1,161 @@
+#include "DualRateScene.hpp"
+#include <base-logging/Logging.hpp>
+#include <chrono>
+#include <cmath>
+
+namespace wbc{
+
+DualRateScene::DualRateScene(ScenePtr scene, const double slow_period, const double fast_period) :
+    scene(scene),
+    cycle_count(0),
+    n_fast_since_slow(0),
+    slow_cycle(false),
+    fast_update_mode(dynamics_reprojection){
+    if(!scene)
+        throw std::invalid_argument("DualRateScene: Scene must not be null");
+    robot_model = scene->getRobotModel();
+    setPeriods(slow_period, fast_period);
+}
+
+DualRateScene::~DualRateScene(){
+}
+
+void DualRateScene::setPeriods(const double slow_period, const double fast_period){
+    if(fast_period <= 0 || slow_period < fast_period){
+        LOG_ERROR("DualRateScene: Invalid periods. Slow period is %f, fast period is %f, but 0 < fast period <= slow period is required", slow_period, fast_period);
+        throw std::invalid_argument("Invalid periods");
+    }
+    double ratio = slow_period / fast_period;
+    if(std::abs(ratio - std::round(ratio)) > 1e-6){
+        LOG_ERROR("DualRateScene: Slow period (%f) has to be an integer multiple of the fast period (%f)", slow_period, fast_period);
+        throw std::invalid_argument("Invalid periods");
+    }
+    this->slow_period = slow_period;
+    this->fast_period = fast_period;
+    n_fast_per_slow = std::round(ratio);
+    reset();
+}
+
+void DualRateScene::setJointImpedance(const base::VectorXd &stiffness, const base::VectorXd &damping){
+    uint na = robot_model->noOfActuatedJoints();
+    if(stiffness.size() != (int)na || damping.size() != (int)na){
+        LOG_ERROR("DualRateScene: Size of stiffness and damping vector has to be %i, but is %i and %i", (int)na, (int)stiffness.size(), (int)damping.size());
+        throw std::invalid_argument("Invalid joint impedance");
+    }
+    this->stiffness = stiffness;
+    this->damping = damping;
+}
+
+const base::commands::Joints& DualRateScene::update(){
+
+    auto start = std::chrono::steady_clock::now();
+
+    // The stored solution is invalid if the number of joints or contacts has changed, e.g. after a model reduction
+    uint nj = robot_model->noOfJoints();
+    uint nc = robot_model->getActiveContacts().size();
+    slow_cycle = cycle_count % n_fast_per_slow == 0 || qdd.size() != (int)nj || contact_wrenches.size() != (int)(6*nc) ||
+                 cmd_slow.size() != robot_model->noOfActuatedJoints();
+    if(slow_cycle){
+        slowUpdate();
+        cycle_count = 0;
+    }
+    else
+        fastUpdate();
+    cycle_count++;
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if(slow_cycle)
+        slow_loop_statistics.add(elapsed, slow_period);
+    else
+        fast_loop_statistics.add(elapsed, fast_period);
+    return cmd;
+}
+
+void DualRateScene::slowUpdate(){
+
+    const HierarchicalQP& hqp = scene->update();
+    cmd_slow = scene->solve(hqp);
+    cmd = cmd_slow;
+    n_fast_since_slow = 0;
+
+    // Extract joint accelerations and contact wrenches from the raw solver output, see class documentation for the supported layouts
+    const base::VectorXd& solver_output = scene->getSolverOutputRaw();
+    uint nj = robot_model->noOfJoints();
+    uint na = robot_model->noOfActuatedJoints();
+    uint nc = robot_model->getActiveContacts().size();
+    qdd = solver_output.head(nj);
+    if(solver_output.size() == (int)(nj + na + 6*nc))
+        contact_wrenches = solver_output.segment(nj+na, 6*nc);
+    else if(solver_output.size() == (int)(nj + 6*nc))
+        contact_wrenches = solver_output.segment(nj, 6*nc);
+    else if(solver_output.size() == (int)nj)
+        contact_wrenches.setZero(6*nc);
+    else{
+        LOG_ERROR("DualRateScene: Size of the raw solver output is %i, which does not match any supported layout. Is this an acceleration-based scene?", (int)solver_output.size());
+        throw std::runtime_error("Invalid solver output");
+    }
+
+    const std::vector<std::string>& actuated_joint_names = robot_model->actuatedJointNames();
+    const base::samples::Joints& joint_state = robot_model->jointState(actuated_joint_names);
+    q_slow.resize(na);
+    qd_slow.resize(na);
+    cmd_index.resize(na);
+    joint_index.resize(na);
+    for(uint i = 0; i < na; i++){
+        q_slow(i) = joint_state[i].position;
+        qd_slow(i) = joint_state[i].speed;
+        cmd_index[i] = cmd.mapNameToIndex(actuated_joint_names[i]);
+        joint_index[i] = robot_model->jointIndex(actuated_joint_names[i]);
+    }
+}
+
+void DualRateScene::reprojectDynamics(){
+
+    // tau = M*qdd + h - Jc^T*f. The contact wrenches are given in the body frame of the contact points, as in RigidbodyDynamicsConstraint
+    tau.noalias() = robot_model->jointSpaceInertiaMatrix() * qdd;
+    tau += robot_model->biasForces();
+    const ActiveContacts& contacts = robot_model->getActiveContacts();
+    for(uint i = 0; i < contacts.size(); i++){
+        if(contacts[i].active)
+            tau.noalias() -= robot_model->bodyJacobian(robot_model->worldFrame(), contacts.names[i]).transpose() * contact_wrenches.segment(i*6,6);
+    }
+}
+
+void DualRateScene::fastUpdate(){
+
+    n_fast_since_slow++;
+    // cmd has the same names and size as cmd_slow (see slowUpdate()), so only the element values have to be copied
+    std::copy(cmd_slow.elements.begin(), cmd_slow.elements.end(), cmd.elements.begin());
+    uint na = cmd_index.size();
+
+    switch(fast_update_mode){
+    case zero_order_hold:
+        break;
+    case dynamics_reprojection:{
+        reprojectDynamics();
+        for(uint i = 0; i < na; i++)
+            cmd[cmd_index[i]].effort = tau[joint_index[i]];
+        break;
+    }
+    case joint_impedance:{
+        double t = n_fast_since_slow * fast_period;
+        const base::samples::Joints& joint_state = robot_model->jointState(robot_model->actuatedJointNames());
+        for(uint i = 0; i < na; i++){
+            base::JointState& c = cmd[cmd_index[i]];
+            double acc = qdd[joint_index[i]];
+            double q_d = q_slow(i) + qd_slow(i)*t + 0.5*acc*t*t;
+            double qd_d = qd_slow(i) + acc*t;
+            c.position = q_d;
+            c.speed = qd_d;
+            if(stiffness.size() == (int)na && !base::isNaN(c.effort))
+                c.effort += stiffness(i)*(q_d - joint_state[i].position) + damping(i)*(qd_d - joint_state[i].speed);
+        }
+        break;
+    }
+    default:
+        throw std::runtime_error("DualRateScene: Invalid fast update mode");
+    }
+    cmd.time = base::Time::now();
+}
+
+}
@@ -0,0 +1,162 @@
+#ifndef WBC_DUAL_RATE_SCENE_HPP
+#define WBC_DUAL_RATE_SCENE_HPP
+
+#include "../../core/Scene.hpp"
+#include <algorithm>
+
+namespace wbc{
+
+/**
+ * @brief Timing statistics of a control loop. All times are in seconds.
+ */
+struct LoopStatistics{
+    LoopStatistics(){reset();}
+
+    /** Number of cycles*/
+    uint n_cycles;
+    /** Number of cycles whose computation time exceeded the cycle period*/
+    uint n_overruns;
+    /** Computation time of the last cycle*/
+    double last;
+    /** Mean computation time over all cycles*/
+    double mean;
+    /** Max. computation time over all cycles*/
+    double max;
+
+    /** Add the computation time of a cycle*/
+    void add(const double time, const double period){
+        n_cycles++;
+        if(time > period)
+            n_overruns++;
+        last = time;
+        mean += (time - mean) / n_cycles;
+        max = std::max(max, time);
+    }
+
+    void reset(){
+        n_cycles = n_overruns = 0;
+        last = mean = max = 0;
+    }
+};
+
+/**
+ * @brief Wrapper that runs a WBC scene at two rates: The full QP of the scene is set up and solved at the (slow) scene rate, e.g. 250-500 Hz. In between,
+ * the joint command is updated at the (fast) command rate, e.g. 2 kHz, using a cheap update that does not solve a QP. Call update() at the fast rate, after updating the robot model:
+ * \code
+ *     DualRateScene dual_rate_scene(scene, 4e-3, 5e-4);
+ *     while(running){
+ *         robot_model->update(joint_state);
+ *         scene->setReference("cart_pos_ctrl", ref); // Only has an effect in slow cycles
+ *         const base::commands::Joints& cmd = dual_rate_scene.update();
+ *     }
+ * \endcode
+ * Every n-th call to update(), with n = slow_period / fast_period, is a slow cycle. The first call is always a slow cycle. The fast update is selected with setFastUpdateMode(), see FastUpdateMode.
+ *
+ * The fast updates require an acceleration-based scene, whose raw solver output contains the joint accelerations of all joints, optionally followed by the actuator
+ * torques and the contact wrenches of all contact points: [qdd; tau; f] (e.g. AccelerationSceneTSID, OperationalSpaceScene), [qdd; f] (AccelerationSceneReducedTSID) or [qdd] (AccelerationScene, contact wrenches are assumed zero).
+ * The wrapper is not a Scene and is not registered in the SceneFactory. Tasks and references are set on the wrapped scene.
+ */
+class DualRateScene{
+public:
+    enum FastUpdateMode{
+        /** Hold the last QP solution*/
+        zero_order_hold,
+        /** Map the joint accelerations and contact wrenches of the last QP solution through the current dynamics: tau = M*qdd + h - Jc^T*f.
+          * In contrast to the QP solution, the torques track the changes of the inertia matrix, gravity and Coriolis/centrifugal terms and contact Jacobians*/
+        dynamics_reprojection,
+        /** Integrate the last QP solution from the robot state of the last slow cycle (q_d, qd_d) and add a joint impedance term to the torques of the QP solution:
+          * tau = tau_qp + Kp*(q_d - q) + Kd*(qd_d - qd). The integrated position and velocity are part of the joint command, so that they can also be used by a
+          * joint impedance controller on the hardware. If the scene does not output torques, the effort of the command is not set*/
+        joint_impedance
+    };
+
+    /**
+     * @param scene Configured scene that is solved at the slow rate
+     * @param slow_period Period of the slow cycle (QP solve) in seconds
+     * @param fast_period Period of the fast cycle (calls to update()) in seconds. The slow period has to be an integer multiple of the fast period
+     */
+    DualRateScene(ScenePtr scene, const double slow_period, const double fast_period);
+    ~DualRateScene();
+
+    /**
+     * @brief Set the cycle periods of the slow and fast loop in seconds. The slow period has to be an integer multiple of the fast period. Triggers a slow cycle in the next call of update().
+     */
+    void setPeriods(const double slow_period, const double fast_period);
+
+    /** Return the period of the slow cycle (QP solve) in seconds*/
+    double getSlowPeriod(){return slow_period;}
+
+    /** Return the period of the fast cycle in seconds*/
+    double getFastPeriod(){return fast_period;}
+
+    /** Select the update of the joint command in fast cycles. Default is dynamics_reprojection*/
+    void setFastUpdateMode(const FastUpdateMode mode){fast_update_mode = mode;}
+
+    /** Return the update of the joint command in fast cycles*/
+    FastUpdateMode getFastUpdateMode(){return fast_update_mode;}
+
+    /**
+     * @brief Set the stiffness and damping of the joint impedance (only used in mode joint_impedance). Size of both vectors has to be the number of actuated joints,
+     * in the order of RobotModel::actuatedJointNames(). Default is zero stiffness and damping
+     */
+    void setJointImpedance(const base::VectorXd &stiffness, const base::VectorXd &damping);
+
+    /**
+     * @brief Compute the joint command. Solves the QP of the scene in slow cycles and applies the fast update in all other cycles. The robot model has to be updated
+     * before calling this method.
+     * @return Joint command for all actuated joints
+     */
+    const base::commands::Joints& update();
+
+    /** Trigger a slow cycle (QP solve) in the next call of update(), e.g. after the contacts or the task configuration have changed*/
+    void reset(){cycle_count = 0;}
+
+    /** True if the QP has been solved in the last call to update()*/
+    bool isSlowCycle(){return slow_cycle;}
+
+    /** Timing statistics of the slow cycles, i.e., scene update and solve*/
+    const LoopStatistics& getSlowLoopStatistics(){return slow_loop_statistics;}
+
+    /** Timing statistics of the fast cycles*/
+    const LoopStatistics& getFastLoopStatistics(){return fast_loop_statistics;}
+
+    /** Reset the timing statistics of both loops*/
+    void resetStatistics(){slow_loop_statistics.reset(); fast_loop_statistics.reset();}
+
+    /** Return the wrapped scene*/
+    ScenePtr getScene(){return scene;}
+
+    /** Return the current joint command*/
+    const base::commands::Joints& getCommand(){return cmd;}
+
+protected:
+    /** Solve the QP of the scene and store the solution*/
+    void slowUpdate();
+    /** Update the joint command without solving the QP*/
+    void fastUpdate();
+    /** Compute the joint torques from the stored joint accelerations and contact wrenches with the current dynamics*/
+    void reprojectDynamics();
+
+    ScenePtr scene;
+    RobotModelPtr robot_model;
+    double slow_period, fast_period;
+    uint n_fast_per_slow, cycle_count, n_fast_since_slow;
+    bool slow_cycle;
+    FastUpdateMode fast_update_mode;
+    base::VectorXd stiffness, damping;
+    LoopStatistics slow_loop_statistics, fast_loop_statistics;
+
+    /** Joint command of the last slow cycle and current joint command*/
+    base::commands::Joints cmd_slow, cmd;
+    /** Joint accelerations and contact wrenches of the last QP solution*/
+    base::VectorXd qdd, contact_wrenches;
+    /** Robot state of the actuated joints in the last slow cycle*/
+    base::VectorXd q_slow, qd_slow;
+    /** For each actuated joint: index in the joint command and index in the joint vector of the robot model. Updated in each slow cycle*/
+    std::vector<uint> cmd_index, joint_index;
+    base::VectorXd tau;
+};
+
+}
+
+#endif
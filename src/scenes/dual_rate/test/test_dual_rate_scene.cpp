@@ -0,0 +1,154 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "robot_models/pinocchio/RobotModelPinocchio.hpp"
+#include "scenes/acceleration_tsid/AccelerationSceneTSID.hpp"
+#include "scenes/dual_rate/DualRateScene.hpp"
+#include "solvers/qpoases/QPOasesSolver.hpp"
+
+using namespace std;
+using namespace wbc;
+
+void updateKuka(RobotModelPtr robot_model, double position, double speed){
+    base::samples::Joints joint_state;
+    joint_state.names = robot_model->jointNames();
+    for(auto n : robot_model->jointNames()){
+        base::JointState js;
+        js.position = position;
+        js.speed = speed;
+        js.acceleration = 0;
+        joint_state.elements.push_back(js);
+    }
+    joint_state.time = base::Time::now();
+    robot_model->update(joint_state);
+}
+
+ScenePtr makeScene(RobotModelPtr robot_model){
+    RobotModelConfig config;
+    config.file_or_string = "../../../../../models/kuka/urdf/kuka_iiwa.urdf";
+    BOOST_CHECK(robot_model->configure(config));
+    updateKuka(robot_model, 0.5, 0.1);
+
+    QPSolverPtr solver = std::make_shared<QPOASESSolver>();
+    qpOASES::Options options = dynamic_pointer_cast<QPOASESSolver>(solver)->getOptions();
+    options.printLevel = qpOASES::PL_NONE;
+    dynamic_pointer_cast<QPOASESSolver>(solver)->setOptions(options);
+    dynamic_pointer_cast<QPOASESSolver>(solver)->setMaxNoWSR(1000);
+
+    ScenePtr scene = make_shared<AccelerationSceneTSID>(robot_model, solver, 1e-3);
+    TaskConfig cart_task("cart_pos_ctrl", 0, "kuka_lbr_l_link_0", "kuka_lbr_l_tcp", "kuka_lbr_l_link_0", 1);
+    BOOST_CHECK(scene->configure({cart_task}));
+
+    base::samples::RigidBodyStateSE3 ref;
+    ref.acceleration.linear = base::Vector3d(0.5, -0.2, 0.1);
+    ref.acceleration.angular.setZero();
+    scene->setReference(cart_task.name, ref);
+    return scene;
+}
+
+BOOST_AUTO_TEST_CASE(rates_and_statistics){
+
+    /**
+     * Check if the QP is solved in every n-th cycle only and if the timing statistics of both loops are recorded
+     */
+
+    RobotModelPtr robot_model = make_shared<RobotModelPinocchio>();
+    ScenePtr scene = makeScene(robot_model);
+
+    BOOST_CHECK_THROW(DualRateScene(scene, 1e-3, 2e-3), std::invalid_argument);
+    BOOST_CHECK_THROW(DualRateScene(scene, 1e-3, 3e-4), std::invalid_argument);
+
+    DualRateScene dual_rate_scene(scene, 2e-3, 5e-4);
+    for(int i = 0; i < 8; i++){
+        updateKuka(robot_model, 0.5 + 1e-3*i, 0.1);
+        BOOST_CHECK_NO_THROW(dual_rate_scene.update());
+        BOOST_CHECK_EQUAL(dual_rate_scene.isSlowCycle(), i % 4 == 0);
+        BOOST_CHECK_EQUAL(dual_rate_scene.getCommand().size(), robot_model->noOfActuatedJoints());
+    }
+    BOOST_CHECK_EQUAL(dual_rate_scene.getSlowLoopStatistics().n_cycles, 2);
+    BOOST_CHECK_EQUAL(dual_rate_scene.getFastLoopStatistics().n_cycles, 6);
+    BOOST_CHECK(dual_rate_scene.getSlowLoopStatistics().mean > 0);
+    BOOST_CHECK(dual_rate_scene.getSlowLoopStatistics().max >= dual_rate_scene.getSlowLoopStatistics().mean);
+
+    // reset() triggers a slow cycle
+    dual_rate_scene.reset();
+    dual_rate_scene.update();
+    BOOST_CHECK(dual_rate_scene.isSlowCycle());
+
+    dual_rate_scene.resetStatistics();
+    BOOST_CHECK_EQUAL(dual_rate_scene.getSlowLoopStatistics().n_cycles, 0);
+}
+
+BOOST_AUTO_TEST_CASE(dynamics_reprojection){
+
+    /**
+     * Check if the fast update reproduces the QP torques for an unchanged robot state and tracks the dynamics for a changed state
+     */
+
+    RobotModelPtr robot_model = make_shared<RobotModelPinocchio>();
+    ScenePtr scene = makeScene(robot_model);
+    DualRateScene dual_rate_scene(scene, 2e-3, 1e-3);
+    BOOST_CHECK(dual_rate_scene.getFastUpdateMode() == DualRateScene::dynamics_reprojection);
+
+    base::commands::Joints cmd_slow = dual_rate_scene.update();
+    BOOST_CHECK(dual_rate_scene.isSlowCycle());
+    base::commands::Joints cmd_fast = dual_rate_scene.update();
+    BOOST_CHECK(!dual_rate_scene.isSlowCycle());
+    for(uint i = 0; i < cmd_slow.size(); i++){
+        BOOST_CHECK(fabs(cmd_slow[i].effort - cmd_fast[i].effort) < 1e-6);
+        BOOST_CHECK_EQUAL(cmd_slow[i].acceleration, cmd_fast[i].acceleration);
+    }
+
+    // Next slow cycle
+    cmd_slow = dual_rate_scene.update();
+    BOOST_CHECK(dual_rate_scene.isSlowCycle());
+
+    // Changed robot state: tau = M*qdd + h
+    updateKuka(robot_model, 0.6, 0.5);
+    cmd_fast = dual_rate_scene.update();
+    uint nj = robot_model->noOfJoints();
+    base::VectorXd qdd(nj);
+    for(uint i = 0; i < nj; i++)
+        qdd(i) = cmd_slow[robot_model->jointNames()[i]].acceleration;
+    base::VectorXd tau = robot_model->jointSpaceInertiaMatrix()*qdd + robot_model->biasForces();
+    double diff = 0;
+    for(uint i = 0; i < nj; i++){
+        const std::string& name = robot_model->jointNames()[i];
+        BOOST_CHECK(fabs(cmd_fast[name].effort - tau(i)) < 1e-9);
+        diff += fabs(cmd_fast[name].effort - cmd_slow[name].effort);
+    }
+    BOOST_CHECK(diff > 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(joint_impedance){
+
+    /**
+     * Check if the fast update integrates the QP solution and adds the joint impedance torques
+     */
+
+    RobotModelPtr robot_model = make_shared<RobotModelPinocchio>();
+    ScenePtr scene = makeScene(robot_model);
+    double dt = 5e-4;
+    DualRateScene dual_rate_scene(scene, 4*dt, dt);
+    dual_rate_scene.setFastUpdateMode(DualRateScene::joint_impedance);
+    uint na = robot_model->noOfActuatedJoints();
+    BOOST_CHECK_THROW(dual_rate_scene.setJointImpedance(base::VectorXd::Ones(na+1), base::VectorXd::Ones(na)), std::invalid_argument);
+    dual_rate_scene.setJointImpedance(base::VectorXd::Constant(na, 100), base::VectorXd::Constant(na, 10));
+
+    base::commands::Joints cmd_slow = dual_rate_scene.update();
+    BOOST_CHECK(dual_rate_scene.isSlowCycle());
+
+    // Robot does not move, so the impedance torques act against the integrated motion
+    for(int n = 1; n < 4; n++){
+        base::commands::Joints cmd_fast = dual_rate_scene.update();
+        BOOST_CHECK(!dual_rate_scene.isSlowCycle());
+        double t = n*dt;
+        for(uint i = 0; i < na; i++){
+            double q_d = 0.5 + 0.1*t + 0.5*cmd_slow[i].acceleration*t*t;
+            double qd_d = 0.1 + cmd_slow[i].acceleration*t;
+            BOOST_CHECK(fabs(cmd_fast[i].position - q_d) < 1e-12);
+            BOOST_CHECK(fabs(cmd_fast[i].speed - qd_d) < 1e-12);
+            BOOST_CHECK(fabs(cmd_fast[i].effort - (cmd_slow[i].effort + 100*(q_d - 0.5) + 10*(qd_d - 0.1))) < 1e-9);
+        }
+    }
+}
@@ -0,0 +1,213 @@
+#include "OperationalSpaceScene.hpp"
+#include "../../core/RobotModel.hpp"
+#include <base-logging/Logging.hpp>
+#include <limits>
+#include <algorithm>
+
+#include "../../tasks/JointAccelerationTask.hpp"
+#include "../../tasks/CartesianAccelerationTask.hpp"
+#include "../../tasks/CoMAccelerationTask.hpp"
+
+namespace wbc{
+
+SceneRegistry<OperationalSpaceScene> OperationalSpaceScene::reg("operational_space");
+
+OperationalSpaceScene::OperationalSpaceScene(RobotModelPtr robot_model, QPSolverPtr solver, const double dt) :
+    Scene(robot_model, solver, dt),
+    damping(1e-6),
+    eigenvalue_threshold(1e-9){
+
+}
+
+TaskPtr OperationalSpaceScene::createTask(const TaskConfig &config){
+
+    if(config.type == cart)
+        return std::make_shared<CartesianAccelerationTask>(config, robot_model->noOfJoints());
+    else if(config.type == com)
+        return std::make_shared<CoMAccelerationTask>(config, robot_model->noOfJoints());
+    else if(config.type == jnt)
+        return std::make_shared<JointAccelerationTask>(config, robot_model->noOfJoints());
+    else{
+        LOG_ERROR("Task with name %s has an invalid task type: %i", config.name.c_str(), config.type);
+        throw std::invalid_argument("Invalid task config");
+    }
+}
+
+bool OperationalSpaceScene::configure(const std::vector<TaskConfig> &config, const std::vector<ConstraintConfig> &_constraint_config){
+
+    if(robot_model->hasFloatingBase()){
+        LOG_ERROR("OperationalSpaceScene does not support floating base robots");
+        return false;
+    }
+    if(!Scene::configure(config, _constraint_config))
+        return false;
+
+    // Effort limits. Joints without valid limits are not clamped
+    uint nj = robot_model->noOfJoints();
+    tau_min.setConstant(nj, -std::numeric_limits<double>::infinity());
+    tau_max.setConstant(nj, std::numeric_limits<double>::infinity());
+    for(auto n : robot_model->actuatedJointNames()){
+        size_t idx = robot_model->jointIndex(n);
+        const base::JointLimitRange &range = robot_model->jointLimits().getElementByName(n);
+        if(std::isnan(range.min.effort) || std::isnan(range.max.effort) || range.max.effort <= range.min.effort)
+            continue;
+        tau_min(idx) = range.min.effort;
+        tau_max(idx) = range.max.effort;
+    }
+    return true;
+}
+
+void OperationalSpaceScene::setDamping(const double d){
+    if(d <= 0){
+        LOG_ERROR("Damping has to be > 0, but is %f", d);
+        throw std::invalid_argument("Invalid damping");
+    }
+    damping = d;
+}
+
+const HierarchicalQP& OperationalSpaceScene::update(){
+
+    if(!configured)
+        throw std::runtime_error("OperationalSpaceScene has not been configured!. PLease call configure() before calling update() for the first time!");
+
+    ///////// Tasks
+
+    // Note: As in VelocityScene, all tasks are modeled as linear equalities. The QP is not solved, but used as input for the closed form solution in solve()
+    uint nj = robot_model->noOfJoints();
+    for(uint prio = 0; prio < tasks.size(); prio++){
+
+        // Inactive tasks and rows with zero weight don't contribute to the solution, so they are pruned from the equation system of this priority
+        uint nc = 0;
+        for(uint i = 0; i < tasks[prio].size(); i++){
+
+            const TaskPtr& task = tasks[prio][i];
+
+            task->checkTimeout();
+            if(task->checkInactive())
+                continue;
+            task->update(robot_model);
+            nc += task->updateActiveRows();
+        }
+
+        hqp[prio].resizeEqualityOnly(nj, nc);
+
+        uint row_index = 0;
+        for(uint i = 0; i < tasks[prio].size(); i++){
+
+            const TaskPtr& task = tasks[prio][i];
+            if(task->inactive)
+                continue;
+
+            for(uint row : task->active_rows){
+                hqp[prio].Wy(row_index) = task->weights_root(row) * task->activation;
+                hqp[prio].A.row(row_index) = task->A.row(row);
+                hqp[prio].b(row_index) = task->y_ref_root(row);
+                row_index++;
+            }
+        }
+    }
+
+    hqp.time = base::Time::now();
+    hqp.Wq = base::VectorXd::Map(joint_weights.elements.data(), robot_model->noOfJoints());
+    return hqp;
+}
+
+const base::commands::Joints& OperationalSpaceScene::solve(const HierarchicalQP& hqp){
+
+    uint nj = robot_model->noOfJoints();
+
+    // Gravity and Coriolis/centrifugal compensation
+    tau = robot_model->biasForces();
+    qdd.setZero(nj);
+    N.setIdentity(nj, nj);
+
+    for(uint prio = 0; prio < hqp.size(); prio++){
+        const QuadraticProgram& qp = hqp[prio];
+        if(qp.neq == 0)
+            continue;
+
+        // Weighted Jacobian, restricted to the null space of all higher priorities, and weighted task error
+        J_bar.noalias() = qp.Wy.asDiagonal() * qp.A * N;
+        task_error = qp.Wy.cwiseProduct(qp.b - qp.A * qdd);
+
+        // Inverse operational space inertia matrix, using the factorization of M cached in the robot model
+        robot_model->inertiaInverseJacobianTranspose(J_bar, Minv_Jt_bar);
+        lambda_inv.noalias() = J_bar * Minv_Jt_bar;
+
+        // Damped pseudo-inverse. The restricted Jacobians of lower priorities are rank deficient, a regularization of the full matrix would let the
+        // task forces leak into the task spaces of higher priorities, so directions with (numerically) zero eigenvalue are discarded
+        lambda_inv_eig.compute(lambda_inv);
+        const base::VectorXd& ev = lambda_inv_eig.eigenvalues();
+        const double ev_min = eigenvalue_threshold * std::max(ev.maxCoeff(), 0.0);
+        lambda_eig_inv.resize(ev.size());
+        for(int i = 0; i < ev.size(); i++)
+            lambda_eig_inv(i) = ev(i) > ev_min ? ev(i) / (ev(i)*ev(i) + damping*damping) : 0;
+        lambda.noalias() = lambda_inv_eig.eigenvectors() * lambda_eig_inv.asDiagonal() * lambda_inv_eig.eigenvectors().transpose();
+
+        // Task force and its contribution to the joint torques and accelerations
+        force.noalias() = lambda * task_error;
+        tau.noalias() += J_bar.transpose() * force;
+        qdd.noalias() += Minv_Jt_bar * force;
+
+        // Dynamically consistent null space of priorities 0..prio
+        if(prio < hqp.size() - 1)
+            N.noalias() -= Minv_Jt_bar * (lambda * J_bar);
+    }
+
+    // Clamp to the effort limits and recompute the accelerations from the equations of motion: qdd = M^-1 * (tau - h)
+    if((tau.array() < tau_min.array()).any() || (tau.array() > tau_max.array()).any()){
+        tau = tau.cwiseMax(tau_min).cwiseMin(tau_max);
+        qdd = tau - robot_model->biasForces();
+        robot_model->solveJointSpaceInertia(qdd);
+    }
+
+    solver_output.resize(2*nj);
+    solver_output << qdd, tau;
+
+    // Convert Output
+    solver_output_joints.resize(robot_model->noOfActuatedJoints());
+    solver_output_joints.names = robot_model->actuatedJointNames();
+    for(uint i = 0; i < robot_model->noOfActuatedJoints(); i++){
+        const std::string& name = robot_model->actuatedJointNames()[i];
+        uint idx = robot_model->jointIndex(name);
+        if(base::isNaN(tau[idx]))
+            throw std::runtime_error("Solver output (force/torque) for joint " + name + " is NaN");
+        solver_output_joints[name].acceleration = qdd[idx];
+        solver_output_joints[name].effort = tau[idx];
+    }
+    solver_output_joints.time = base::Time::now();
+    return solver_output_joints;
+}
+
+const TasksStatus& OperationalSpaceScene::updateTasksStatus(){
+
+    uint nj = robot_model->noOfJoints();
+    const base::samples::Joints& joint_state = robot_model->jointState(robot_model->jointNames());
+    robot_acc.resize(nj);
+    for(size_t i = 0; i < nj; i++)
+        robot_acc(i) = joint_state[i].acceleration;
+
+    for(uint prio = 0; prio < tasks.size(); prio++){
+        for(uint i = 0; i < tasks[prio].size(); i++){
+            const TaskPtr& task = tasks[prio][i];
+            const std::string &name = task->config.name;
+
+            // Inactive tasks have been skipped in update(), so the task matrix has to be updated here
+            if(task->inactive && !tasks_require_locked_joints[prio][i])
+                task->update(robot_model);
+
+            tasks_status[name].time       = task->time;
+            tasks_status[name].config     = task->config;
+            tasks_status[name].activation = task->activation;
+            tasks_status[name].timeout    = task->timeout;
+            tasks_status[name].weights    = task->weights;
+            tasks_status[name].y_ref      = task->y_ref_root;
+            tasks_status[name].y_solution = task->A * solver_output.head(nj);
+            tasks_status[name].y          = task->A * robot_acc;
+        }
+    }
+
+    return tasks_status;
+}
+
+} // namespace wbc
@@ -0,0 +1,108 @@
+#ifndef WBC_OPERATIONAL_SPACE_SCENE_HPP
+#define WBC_OPERATIONAL_SPACE_SCENE_HPP
+
+#include "../../core/Scene.hpp"
+#include <Eigen/Eigenvalues>
+
+namespace wbc{
+
+/**
+ * @brief QP-free torque-based implementation of the WBC Scene using the prioritized operational space formulation (Khatib, Sentis). The joint torques
+ * are computed in closed form, priority by priority:
+ *  \f[
+ *        \begin{array}{l}
+ *        \bar{\mathbf{J}}_k = \mathbf{W}_k\mathbf{J}_k\mathbf{N}_{k-1}, \quad \mathbf{\Lambda}_k = (\bar{\mathbf{J}}_k\mathbf{M}^{-1}\bar{\mathbf{J}}_k^T)^{\#} \\
+ *        \mathbf{F}_k = \mathbf{\Lambda}_k\mathbf{W}_k(\dot{\mathbf{v}}_{d,k} - \mathbf{J}_k\ddot{\mathbf{q}}_{k-1}) \\
+ *        \mathbf{\tau}_k = \mathbf{\tau}_{k-1} + \bar{\mathbf{J}}_k^T\mathbf{F}_k, \quad \ddot{\mathbf{q}}_k = \ddot{\mathbf{q}}_{k-1} + \mathbf{M}^{-1}\bar{\mathbf{J}}_k^T\mathbf{F}_k \\
+ *        \mathbf{N}_k = \mathbf{N}_{k-1} - \mathbf{M}^{-1}\bar{\mathbf{J}}_k^T\mathbf{\Lambda}_k\bar{\mathbf{J}}_k
+ *        \end{array}
+ *  \f]
+ * with \f$\mathbf{\tau}_0 = \mathbf{h}\f$, \f$\ddot{\mathbf{q}}_0 = \mathbf{0}\f$, \f$\mathbf{N}_0 = \mathbf{I}\f$.<br>
+ * \f$\ddot{\mathbf{q}}\f$ - Vector of robot joint accelerations<br>
+ * \f$\mathbf{\tau}\f$ - Joint torques<br>
+ * \f$\dot{\mathbf{v}}_{d,k}\f$ - Desired task space accelerations (minus acceleration bias) of all tasks on priority k stacked in a vector<br>
+ * \f$\mathbf{J}_k\f$ - Task Jacobians of all tasks on priority k stacked in a single matrix<br>
+ * \f$\mathbf{W}_k\f$ - Diagonal task weight matrix (task weights times activation)<br>
+ * \f$\mathbf{M}\f$ - Joint space inertia matrix<br>
+ * \f$\mathbf{h}\f$ - Bias forces/torques (gravity, Coriolis and centrifugal terms)<br>
+ * \f$\mathbf{\Lambda}_k\f$ - Operational space inertia matrix of priority k<br>
+ * \f$\mathbf{N}_k\f$ - Dynamically consistent null space projector of priorities 1..k<br>
+ * \f$(\cdot)^{\#}\f$ - Damped pseudo-inverse, computed from the eigenvalue decomposition. Eigenvalues \f$\sigma\f$ are inverted as \f$\sigma/(\sigma^2+\lambda^2)\f$,
+ * eigenvalues close to zero (rank deficient tasks) are discarded. \f$\lambda\f$ is the damping, see setDamping()<br>
+ *
+ * The torques of lower priorities are projected into the dynamically consistent null space of all higher priorities, i.e., they do not generate accelerations
+ * in the task spaces of higher priorities. The mass-inertia matrix is never inverted explicitly, all products with \f$\mathbf{M}^{-1}\f$ use the cached factorization
+ * of the robot model (see RobotModel::factorizeJointSpaceInertiaMatrix()). Since no QP is solved, the scene is suitable for high control rates, but in contrast to
+ * AccelerationSceneTSID it cannot consider contacts or inequality constraints:
+ *   - Only fixed base robots are supported
+ *   - Constraints are not supported. Joint torques are clamped to the effort limits of the robot model after the computation. If a torque is clamped,
+ *     the output accelerations are recomputed from the clamped torques, so that they are consistent with the equations of motion
+ *   - As in VelocityScene, the task weights only weight the task rows against each other. In particular, an activation between 0 and 1 does not scale the
+ *     task acceleration
+ *   - The joint weights are not used
+ *
+ * Update() sets up one equality-only QP per priority (A = task Jacobians, b = desired task accelerations, Wy = task weights), solve() computes the torques
+ * from it. The QP solver is not used and may be a nullptr.
+ */
+class OperationalSpaceScene : public Scene{
+protected:
+    static SceneRegistry<OperationalSpaceScene> reg;
+
+    double damping;
+    /** Eigenvalues of the inverse operational space inertia matrix below this value (relative to the largest eigenvalue) are treated as zero*/
+    double eigenvalue_threshold;
+    base::VectorXd tau_min, tau_max;
+
+    // Helper variables
+    base::VectorXd qdd, tau, task_error, force, robot_acc;
+    base::VectorXd lambda_eig_inv;
+    base::MatrixXd N, J_bar, Minv_Jt_bar, lambda_inv, lambda;
+    Eigen::SelfAdjointEigenSolver<base::MatrixXd> lambda_inv_eig;
+
+    /**
+     * @brief Create a task and add it to the WBC scene
+     */
+    virtual TaskPtr createTask(const TaskConfig &config);
+
+public:
+    OperationalSpaceScene(RobotModelPtr robot_model, QPSolverPtr solver, const double dt);
+    virtual ~OperationalSpaceScene(){
+    }
+
+    /**
+     * @brief Configure the WBC scene, see Scene::configure(). Fails if the robot model has a floating base or if constraints are given.
+     */
+    virtual bool configure(const std::vector<TaskConfig> &config, const std::vector<ConstraintConfig> &_constraint_config = std::vector<ConstraintConfig>());
+
+    /**
+     * @brief Update all tasks and set up one equality-only QP per priority
+     */
+    virtual const HierarchicalQP& update();
+
+    /**
+     * @brief Compute the joint torques and accelerations in closed form, see class documentation
+     * @return Solver output as joint torque (effort) and acceleration command. The raw solver output contains the accelerations and torques of all joints, i.e., [qdd; tau]
+     */
+    virtual const base::commands::Joints& solve(const HierarchicalQP& hqp);
+
+    /**
+     * @brief Compute y and y_solution for each task. y_solution denotes the task acceleration (without acceleration bias) that is achieved with the computed
+     * joint accelerations and y the one that is achieved with the actual joint accelerations of the robot
+     */
+    virtual const TasksStatus &updateTasksStatus();
+
+    /**
+     * @brief Damping of the pseudo-inverse of the inverse operational space inertia matrix of each priority, see class documentation. Avoids large torques close
+     * to singularities, at the cost of task accuracy. Has to be > 0. Default is 1e-6
+     */
+    void setDamping(const double d);
+
+    /**
+     * @brief Return the current damping
+     */
+    double getDamping(){return damping;}
+};
+
+} // namespace wbc
+
+#endif
@@ -0,0 +1,146 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "robot_models/pinocchio/RobotModelPinocchio.hpp"
+#include "scenes/operational_space/OperationalSpaceScene.hpp"
+
+using namespace std;
+using namespace wbc;
+
+void updateKuka(RobotModelPtr robot_model){
+    base::samples::Joints joint_state;
+    joint_state.names = robot_model->jointNames();
+    for(auto n : robot_model->jointNames()){
+        base::JointState js;
+        js.position = 0.5;
+        js.speed = 0.1;
+        js.acceleration = 0;
+        joint_state.elements.push_back(js);
+    }
+    joint_state.time = base::Time::now();
+    robot_model->update(joint_state);
+}
+
+BOOST_AUTO_TEST_CASE(configuration_test){
+
+    /**
+     * Check if the scene can be configured without QP solver and fails to configure for floating base robots and with constraints
+     */
+
+    TaskConfig cart_task("cart_pos_ctrl_left", 0, "kuka_lbr_l_link_0", "kuka_lbr_l_tcp", "kuka_lbr_l_link_0", 1);
+
+    shared_ptr<RobotModelPinocchio> robot_model = make_shared<RobotModelPinocchio>();
+    RobotModelConfig config;
+    config.file_or_string = "../../../../../models/kuka/urdf/kuka_iiwa.urdf";
+    BOOST_CHECK_EQUAL(robot_model->configure(config), true);
+
+    OperationalSpaceScene wbc_scene(robot_model, nullptr, 1e-3);
+    BOOST_CHECK_EQUAL(wbc_scene.configure({cart_task}), true);
+    BOOST_CHECK_EQUAL(wbc_scene.configure({cart_task}, {ConstraintConfig(joint_limits_constraint)}), false);
+    BOOST_CHECK_THROW(wbc_scene.setDamping(0), std::invalid_argument);
+
+    config.floating_base = true;
+    BOOST_CHECK_EQUAL(robot_model->configure(config), true);
+    BOOST_CHECK_EQUAL(wbc_scene.configure({cart_task}), false);
+}
+
+BOOST_AUTO_TEST_CASE(simple_test){
+
+    /**
+     * Check if the computed joint accelerations achieve the reference spatial acceleration and if accelerations and torques fulfill the equations of motion
+     */
+
+    shared_ptr<RobotModelPinocchio> robot_model = make_shared<RobotModelPinocchio>();
+    RobotModelConfig config;
+    config.file_or_string = "../../../../../models/kuka/urdf/kuka_iiwa.urdf";
+    BOOST_CHECK(robot_model->configure(config));
+    BOOST_CHECK_NO_THROW(updateKuka(robot_model));
+
+    OperationalSpaceScene wbc_scene(robot_model, nullptr, 1e-3);
+    TaskConfig cart_task("cart_pos_ctrl_left", 0, "kuka_lbr_l_link_0", "kuka_lbr_l_tcp", "kuka_lbr_l_link_0", 1);
+    BOOST_CHECK_EQUAL(wbc_scene.configure({cart_task}), true);
+
+    // Set random Reference
+    base::samples::RigidBodyStateSE3 ref;
+    srand (time(NULL));
+    ref.acceleration.linear = base::Vector3d(((double)rand())/RAND_MAX, ((double)rand())/RAND_MAX, ((double)rand())/RAND_MAX);
+    ref.acceleration.angular = base::Vector3d(((double)rand())/RAND_MAX, ((double)rand())/RAND_MAX, ((double)rand())/RAND_MAX);
+    BOOST_CHECK_NO_THROW(wbc_scene.setReference(cart_task.name, ref));
+
+    // Solve
+    BOOST_CHECK_NO_THROW(wbc_scene.update());
+    HierarchicalQP qp;
+    wbc_scene.getHierarchicalQP(qp);
+    BOOST_CHECK_NO_THROW(wbc_scene.solve(qp));
+
+    // Check task
+    wbc_scene.updateTasksStatus();
+    TasksStatus status = wbc_scene.getTasksStatus();
+    for(int i = 0; i < 6; i++)
+        BOOST_CHECK(fabs(status[0].y_ref[i] - status[0].y_solution[i]) < 1e-5);
+
+    // Check equations of motion: M*qdd + h = tau
+    uint nj = robot_model->noOfJoints();
+    const base::VectorXd& solver_output = wbc_scene.getSolverOutputRaw();
+    base::VectorXd residual = robot_model->jointSpaceInertiaMatrix()*solver_output.segment(0,nj) + robot_model->biasForces() - solver_output.segment(nj,nj);
+    BOOST_CHECK(residual.norm() < 1e-6);
+
+    base::commands::Joints solver_output_joints = wbc_scene.getSolverOutput();
+    for(uint i = 0; i < nj; i++){
+        const std::string& name = robot_model->jointNames()[i];
+        BOOST_CHECK_EQUAL(solver_output_joints[name].effort, solver_output[nj+i]);
+        BOOST_CHECK_EQUAL(solver_output_joints[name].acceleration, solver_output[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hierarchies){
+
+    /**
+     * Check if the task on the lower priority does not affect the task on the higher priority. The joint space task on the lower priority
+     * conflicts with the Cartesian position task, so it can only be achieved partially
+     */
+
+    shared_ptr<RobotModelPinocchio> robot_model = make_shared<RobotModelPinocchio>();
+    RobotModelConfig config;
+    config.file_or_string = "../../../../../models/kuka/urdf/kuka_iiwa.urdf";
+    BOOST_CHECK(robot_model->configure(config));
+    BOOST_CHECK_NO_THROW(updateKuka(robot_model));
+
+    OperationalSpaceScene wbc_scene(robot_model, nullptr, 1e-3);
+    TaskConfig cart_task("cart_pos_ctrl_left", 0, "kuka_lbr_l_link_0", "kuka_lbr_l_tcp", "kuka_lbr_l_link_0", 1, {1,1,1,0,0,0});
+    TaskConfig jnt_task("jnt_ctrl", 1, robot_model->jointNames(), vector<double>(robot_model->noOfJoints(),1), 1);
+    BOOST_CHECK_EQUAL(wbc_scene.configure({cart_task, jnt_task}), true);
+
+    base::samples::RigidBodyStateSE3 cart_ref;
+    cart_ref.acceleration.linear = base::Vector3d(0.5, -0.2, 0.1);
+    cart_ref.acceleration.angular.setZero();
+    BOOST_CHECK_NO_THROW(wbc_scene.setReference(cart_task.name, cart_ref));
+
+    base::samples::Joints jnt_ref;
+    jnt_ref.names = robot_model->jointNames();
+    for(uint i = 0; i < robot_model->noOfJoints(); i++){
+        base::JointState js;
+        js.acceleration = 1.0;
+        jnt_ref.elements.push_back(js);
+    }
+    BOOST_CHECK_NO_THROW(wbc_scene.setReference(jnt_task.name, jnt_ref));
+
+    HierarchicalQP qp = wbc_scene.update();
+    BOOST_CHECK_EQUAL(qp.size(), 2);
+    BOOST_CHECK_EQUAL(qp[0].neq, 3);
+    BOOST_CHECK_NO_THROW(wbc_scene.solve(qp));
+
+    wbc_scene.updateTasksStatus();
+    TaskStatus cart_status = wbc_scene.getTasksStatus()[cart_task.name];
+    TaskStatus jnt_status = wbc_scene.getTasksStatus()[jnt_task.name];
+    for(int i = 0; i < 3; i++)
+        BOOST_CHECK(fabs(cart_status.y_ref[i] - cart_status.y_solution[i]) < 1e-5);
+    BOOST_CHECK((jnt_status.y_ref - jnt_status.y_solution).norm() > 1e-3);
+
+    // Deactivating the high priority task, the joint space task can be achieved
+    wbc_scene.setTaskActivation(cart_task.name, 0);
+    BOOST_CHECK_NO_THROW(wbc_scene.solve(wbc_scene.update()));
+    wbc_scene.updateTasksStatus();
+    jnt_status = wbc_scene.getTasksStatus()[jnt_task.name];
+    BOOST_CHECK((jnt_status.y_ref - jnt_status.y_solution).norm() < 1e-5);
+}
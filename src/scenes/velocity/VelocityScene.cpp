@@ -40,38 +40,37 @@ const HierarchicalQP& VelocityScene::update(){
     uint nj = robot_model->noOfJoints();
     for(uint prio = 0; prio < tasks.size(); prio++){
 
-        uint nc = n_task_variables_per_prio[prio];
-        hqp[prio].resize(nj, nc, 0, false);
-
-        // Walk through all tasks of current priority
-        uint row_index = 0;
+        // Update all active tasks and count the task variables with non-zero weight. Inactive tasks and rows with zero weight
+        // don't contribute to the solution, so they are pruned from the equation system of this priority
+        uint nc = 0;
         for(uint i = 0; i < tasks[prio].size(); i++){
 
-            TaskPtr task = tasks[prio][i];
+            const TaskPtr& task = tasks[prio][i];
 
             task->checkTimeout();
+            if(task->checkInactive())
+                continue;
             task->update(robot_model);
-            
-            uint n_vars = task->config.nVariables();
-
-            // If the activation value is zero, also set reference to zero. Activation is usually used to switch between different
-            // task phases and we don't want to store the "old" reference value, in case we switch on the task again
-            if(task->activation == 0){
-               task->y_ref.setZero();
-               task->y_ref_root.setZero();
-            }
+            nc += task->updateActiveRows();
+        }
+
+        // The HLS solver only requires A, b and Wy
+        hqp[prio].resizeEqualityOnly(nj, nc);
 
-            // Insert tasks into equation system of current priority at the correct position. Note: Weights will be zero if activations
-            // for this task is zero or if the task is in timeout
-            hqp[prio].Wy.segment(row_index, n_vars) = task->weights_root * task->activation * (!task->timeout);
-            hqp[prio].A.block(row_index, 0, n_vars, robot_model->noOfJoints()) = task->A;
-            hqp[prio].b.segment(row_index, n_vars) = task->y_ref_root;
-            hqp[prio].H.setIdentity();
-            hqp[prio].lower_x.resize(0);
-            hqp[prio].upper_x.resize(0);
-            hqp[prio].g.setZero();
+        // Insert the active rows of all tasks into equation system of current priority
+        uint row_index = 0;
+        for(uint i = 0; i < tasks[prio].size(); i++){
 
-            row_index += n_vars;
+            const TaskPtr& task = tasks[prio][i];
+            if(task->inactive)
+                continue;
+
+            for(uint row : task->active_rows){
+                hqp[prio].Wy(row_index) = task->weights_root(row) * task->activation;
+                hqp[prio].A.row(row_index) = task->A.row(row);
+                hqp[prio].b(row_index) = task->y_ref_root(row);
+                row_index++;
+            }
 
         } // tasks on prio
     } // priorities
@@ -112,9 +111,14 @@ const TasksStatus& VelocityScene::updateTasksStatus(){
 
     for(uint prio = 0; prio < tasks.size(); prio++){
         for(uint i = 0; i < tasks[prio].size(); i++){
-            TaskPtr task = tasks[prio][i];
+            const TaskPtr& task = tasks[prio][i];
             const std::string &name = task->config.name;
 
+            // Inactive tasks have been skipped in update(), so the task matrix has to be updated here. This is not possible
+            // if the task requires joints that have been locked by the automatic model reduction
+            if(task->inactive && !tasks_require_locked_joints[prio][i])
+                task->update(robot_model);
+
             tasks_status[name].time       = task->time;
             tasks_status[name].config     = task->config;
             tasks_status[name].activation = task->activation;
@@ -93,3 +93,147 @@ BOOST_AUTO_TEST_CASE(simple_test){
         BOOST_CHECK(fabs(status[0].y_ref[i+3] - status[0].y_solution[i]) < 1e5);
     }
 }
+
+BOOST_AUTO_TEST_CASE(row_pruning){
+
+    /**
+     * Check if task variables with zero weight are pruned from the equation system and if the remaining task variables are still tracked correctly
+     */
+
+    shared_ptr<RobotModelPinocchio> robot_model = make_shared<RobotModelPinocchio>();
+    RobotModelConfig config;
+    config.file_or_string = "../../../../../models/kuka/urdf/kuka_iiwa.urdf";
+    BOOST_CHECK(robot_model->configure(config));
+
+    base::samples::Joints joint_state;
+    joint_state.names = robot_model->jointNames();
+    for(auto n : robot_model->jointNames()){
+        base::JointState js;
+        js.position = 0.5;
+        joint_state.elements.push_back(js);
+    }
+    joint_state.time = base::Time::now();
+    BOOST_CHECK_NO_THROW(robot_model->update(joint_state));
+
+    QPSolverPtr solver = std::make_shared<HierarchicalLSSolver>();
+    (std::dynamic_pointer_cast<HierarchicalLSSolver>(solver))->setMaxSolverOutputNorm(1000);
+
+    // Position-only task
+    VelocityScene wbc_scene(robot_model, solver, 1e-3);
+    TaskConfig cart_task("cart_pos_ctrl_left", 0, "kuka_lbr_l_link_0", "kuka_lbr_l_tcp", "kuka_lbr_l_link_0", 1);
+    cart_task.weights = {1,1,1,0,0,0};
+    BOOST_CHECK_EQUAL(wbc_scene.configure({cart_task}), true);
+
+    base::samples::RigidBodyStateSE3 ref;
+    ref.twist.linear = base::Vector3d(0.1,0.2,0.3);
+    ref.twist.angular = base::Vector3d(0.3,0.2,0.1);
+    BOOST_CHECK_NO_THROW(wbc_scene.setReference(cart_task.name, ref));
+
+    HierarchicalQP hqp;
+    BOOST_CHECK_NO_THROW(wbc_scene.update());
+    wbc_scene.getHierarchicalQP(hqp);
+    BOOST_CHECK(hqp[0].A.rows() == 3);
+    BOOST_CHECK(hqp[0].b.size() == 3);
+    BOOST_CHECK(hqp[0].Wy.size() == 3);
+    BOOST_CHECK_NO_THROW(wbc_scene.solve(hqp));
+
+    wbc_scene.updateTasksStatus();
+    TasksStatus status = wbc_scene.getTasksStatus();
+    for(int i = 0; i < 3; i++)
+        BOOST_CHECK(fabs(status[0].y_ref[i] - status[0].y_solution[i]) < 1e-5);
+
+    // Re-enable the orientation: Number of rows has to change accordingly
+    BOOST_CHECK_NO_THROW(wbc_scene.setTaskWeights(cart_task.name, base::VectorXd::Ones(6)));
+    BOOST_CHECK_NO_THROW(wbc_scene.update());
+    wbc_scene.getHierarchicalQP(hqp);
+    BOOST_CHECK(hqp[0].A.rows() == 6);
+    BOOST_CHECK_NO_THROW(wbc_scene.solve(hqp));
+
+    // Deactivate the task: No rows left
+    BOOST_CHECK_NO_THROW(wbc_scene.setTaskActivation(cart_task.name, 0));
+    BOOST_CHECK_NO_THROW(wbc_scene.update());
+    wbc_scene.getHierarchicalQP(hqp);
+    BOOST_CHECK(hqp[0].A.rows() == 0);
+    BOOST_CHECK_NO_THROW(wbc_scene.solve(hqp));
+    base::commands::Joints solver_output = wbc_scene.getSolverOutput();
+    for(uint i = 0; i < solver_output.size(); i++)
+        BOOST_CHECK(solver_output[i].speed == 0);
+}
+
+BOOST_AUTO_TEST_CASE(auto_model_reduction){
+
+    /**
+     * Check if joints that are not required by any active task are locked at their current position and if they are unlocked when a task that requires them is activated
+     */
+
+    shared_ptr<RobotModelPinocchio> robot_model = make_shared<RobotModelPinocchio>();
+    RobotModelConfig config;
+    config.file_or_string = "../../../../../models/kuka/urdf/kuka_iiwa.urdf";
+    BOOST_CHECK(robot_model->configure(config));
+
+    base::samples::Joints joint_state;
+    joint_state.names = robot_model->jointNames();
+    for(auto n : robot_model->jointNames()){
+        base::JointState js;
+        js.position = 0.5;
+        js.speed = js.acceleration = 0;
+        joint_state.elements.push_back(js);
+    }
+    joint_state.time = base::Time::now();
+    BOOST_CHECK_NO_THROW(robot_model->update(joint_state));
+    base::samples::RigidBodyStateSE3 tcp_full = robot_model->rigidBodyState("kuka_lbr_l_link_0", "kuka_lbr_l_tcp");
+
+    QPSolverPtr solver = std::make_shared<HierarchicalLSSolver>();
+    VelocityScene wbc_scene(robot_model, solver, 1e-3);
+    wbc_scene.setAutoModelReduction(true);
+
+    // Only joints 1-3 are required by the active task
+    TaskConfig jnt_task_1("jnt_ctrl_1", 0, {"kuka_lbr_l_joint_1", "kuka_lbr_l_joint_2", "kuka_lbr_l_joint_3"}, {1,1,1}, 1);
+    TaskConfig jnt_task_2("jnt_ctrl_2", 0, {"kuka_lbr_l_joint_5"}, {1}, 0);
+    BOOST_CHECK_EQUAL(wbc_scene.configure({jnt_task_1, jnt_task_2}), true);
+    BOOST_CHECK(robot_model->noOfJoints() == 3);
+    BOOST_CHECK(wbc_scene.getLockedJoints().size() == 4);
+
+    // Locked joints keep their position, so the forward kinematics must not change
+    base::samples::RigidBodyStateSE3 tcp_reduced = robot_model->rigidBodyState("kuka_lbr_l_link_0", "kuka_lbr_l_tcp");
+    BOOST_CHECK((tcp_full.pose.position - tcp_reduced.pose.position).norm() < 1e-9);
+
+    base::commands::Joints ref;
+    ref.names = jnt_task_1.joint_names;
+    for(int i = 0; i < 3; i++)
+        ref.elements.push_back(base::JointState::Speed(0.1*(i+1)));
+    BOOST_CHECK_NO_THROW(wbc_scene.setReference(jnt_task_1.name, ref));
+    HierarchicalQP hqp;
+    BOOST_CHECK_NO_THROW(wbc_scene.update());
+    wbc_scene.getHierarchicalQP(hqp);
+    BOOST_CHECK_NO_THROW(wbc_scene.solve(hqp));
+    BOOST_CHECK(wbc_scene.getSolverOutput().size() == 3);
+    BOOST_CHECK_NO_THROW(wbc_scene.updateTasksStatus());
+
+    // Activating the second task unlocks joint 5. The reference of the first task is kept
+    BOOST_CHECK_NO_THROW(wbc_scene.setTaskActivation(jnt_task_2.name, 1));
+    BOOST_CHECK(robot_model->noOfJoints() == 4);
+    BOOST_CHECK(robot_model->hasJoint("kuka_lbr_l_joint_5"));
+    BOOST_CHECK(wbc_scene.getLockedJoints().size() == 3);
+    tcp_reduced = robot_model->rigidBodyState("kuka_lbr_l_link_0", "kuka_lbr_l_tcp");
+    BOOST_CHECK((tcp_full.pose.position - tcp_reduced.pose.position).norm() < 1e-9);
+
+    base::commands::Joints ref_2;
+    ref_2.names = jnt_task_2.joint_names;
+    ref_2.elements.push_back(base::JointState::Speed(0.5));
+    BOOST_CHECK_NO_THROW(wbc_scene.setReference(jnt_task_2.name, ref_2));
+    BOOST_CHECK_NO_THROW(wbc_scene.update());
+    wbc_scene.getHierarchicalQP(hqp);
+    BOOST_CHECK_NO_THROW(wbc_scene.solve(hqp));
+    base::commands::Joints solver_output = wbc_scene.getSolverOutput();
+    BOOST_CHECK(solver_output.size() == 4);
+    for(int i = 0; i < 3; i++)
+        BOOST_CHECK(fabs(solver_output[ref.names[i]].speed - ref[i].speed) < 1e-6);
+    BOOST_CHECK(fabs(solver_output["kuka_lbr_l_joint_5"].speed - 0.5) < 1e-6);
+
+    // Disabling the model reduction unlocks all joints on the next configure
+    wbc_scene.setAutoModelReduction(false);
+    BOOST_CHECK_EQUAL(wbc_scene.configure({jnt_task_1, jnt_task_2}), true);
+    BOOST_CHECK(robot_model->noOfJoints() == 7);
+    BOOST_CHECK(wbc_scene.getLockedJoints().empty());
+}
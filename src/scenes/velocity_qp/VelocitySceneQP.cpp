@@ -19,10 +19,52 @@ VelocitySceneQP::VelocitySceneQP(RobotModelPtr robot_model, QPSolverPtr solver,
     VelocityScene(robot_model, solver, dt),
     hessian_regularizer(1e-8){
 
-    // for now manually adding constraint to this scene (an option would be to take them during configuration)
-    constraints.resize(1);
-    constraints[0].push_back(std::make_shared<ContactsVelocityConstraint>());
-    constraints[0].push_back(std::make_shared<JointLimitsVelocityConstraint>(dt));
+    // Default constraints, used if no constraint configuration is passed to configure()
+    default_constraint_config = {ConstraintConfig(contacts_constraint),
+                                 ConstraintConfig(joint_limits_constraint)};
+}
+
+ConstraintPtr VelocitySceneQP::createConstraint(const ConstraintConfig &config){
+
+    switch(config.type){
+    case contacts_constraint:
+        return std::make_shared<ContactsVelocityConstraint>();
+    case joint_limits_constraint:
+        return std::make_shared<JointLimitsVelocityConstraint>(dt, config.margin);
+    default:
+        LOG_ERROR("VelocitySceneQP does not support constraints of type %i", config.type);
+        throw std::invalid_argument("Invalid constraint config");
+    }
+}
+
+void VelocitySceneQP::updateTasks(QuadraticProgram& qp, uint nj){
+
+    qp.H.setZero();
+    qp.g.setZero();
+    for(uint i = 0; i < tasks[0].size(); i++){
+        
+        const TaskPtr& task = tasks[0][i];
+
+        task->checkTimeout();
+        if(task->checkInactive())
+            continue;
+        task->update(robot_model);
+
+        for(int i = 0; i < task->A.rows(); i++){
+            task->Aw.row(i) = task->weights_root(i) * task->A.row(i) * task->activation * (!task->timeout);
+            task->y_ref_root(i) = task->y_ref_root(i) * task->weights_root(i) * task->activation;
+        }
+        for(int i = 0; i < task->A.cols(); i++)
+            task->Aw.col(i) = joint_weights[i] * task->Aw.col(i);
+
+        // Rows with zero weight do not contribute to the cost
+        task->pruneRows();
+        const base::MatrixXd& Aw = task->activeAw();
+        const base::VectorXd& y_ref = task->activeYRef();
+        qp.H.block(0,0,nj,nj) += Aw.transpose()*Aw;
+        qp.g.segment(0,nj) -= Aw.transpose()*y_ref;
+
+    } // tasks on prio
 }
 
 const HierarchicalQP& VelocitySceneQP::update(){
@@ -43,7 +85,7 @@ const HierarchicalQP& VelocitySceneQP::update(){
     // check problem size
     size_t total_eqs = 0, total_ineqs = 0;
     bool has_bounds = false;
-    for(auto constraint : constraints[prio]) {
+    for(const ConstraintPtr& constraint : constraints[prio]) {
         constraint->update(robot_model);
         if(constraint->type() == Constraint::equality)
             total_eqs += constraint->size();
@@ -87,34 +129,9 @@ const HierarchicalQP& VelocitySceneQP::update(){
         }
     }
 
-    ///////// Tasks    
-    qp.H.setZero();
-    qp.g.setZero();
-    for(uint i = 0; i < tasks[prio].size(); i++){
-        
-        TaskPtr task = tasks[prio][i];
-
-        task->checkTimeout();
-        task->update(robot_model);
-
-        // If the activation value is zero, also set reference to zero. Activation is usually used to switch between different
-        // task phases and we don't want to store the "old" reference value, in case we switch on the task again
-        if(task->activation == 0){
-           task->y_ref.setZero();
-           task->y_ref_root.setZero();
-        }
-
-        for(int i = 0; i < task->A.rows(); i++){
-            task->Aw.row(i) = task->weights_root(i) * task->A.row(i) * task->activation * (!task->timeout);
-            task->y_ref_root(i) = task->y_ref_root(i) * task->weights_root(i) * task->activation;
-        }
-        for(int i = 0; i < task->A.cols(); i++)
-            task->Aw.col(i) = joint_weights[i] * task->Aw.col(i);
-
-        qp.H.block(0,0,nj,nj) += task->Aw.transpose()*task->Aw;
-        qp.g.segment(0,nj) -= task->Aw.transpose()*task->y_ref_root;
+    ///////// Tasks
 
-    } // tasks on prio
+    updateTasks(qp, nj);
 
     // Add regularization term
     qp.H.block(0,0,nj,nj).diagonal().array() += hessian_regularizer;
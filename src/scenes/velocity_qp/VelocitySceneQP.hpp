@@ -38,6 +38,16 @@ protected:
     base::MatrixXd sing_vect_r, U;
     double hessian_regularizer;
 
+    /**
+     * @brief Update all tasks and add them to the cost function of the given QP. Only the first nj variables (joint velocities/accelerations) are affected.
+     */
+    void updateTasks(QuadraticProgram& qp, uint nj);
+
+    /**
+     * @brief Create a constraint. Supported types: contacts_constraint, joint_limits_constraint. Default: contacts_constraint, joint_limits_constraint.
+     */
+    virtual ConstraintPtr createConstraint(const ConstraintConfig &config);
+
 public:
     /**
      * @brief WbcVelocityScene
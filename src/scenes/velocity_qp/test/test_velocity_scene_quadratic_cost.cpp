@@ -4,6 +4,10 @@
 #include "robot_models/pinocchio/RobotModelPinocchio.hpp"
 #include "scenes/velocity_qp/VelocitySceneQP.hpp"
 #include "solvers/qpoases/QPOasesSolver.hpp"
+#include "solvers/unconstrained/UnconstrainedFirstSolver.hpp"
+#include "core/StaticScene.hpp"
+#include "tasks/CartesianVelocityTask.hpp"
+#include "constraints/JointLimitsVelocityConstraint.hpp"
 
 using namespace std;
 using namespace wbc;
@@ -90,3 +94,213 @@ BOOST_AUTO_TEST_CASE(simple_test){
         BOOST_CHECK(fabs(status[0].y_ref[i+3] - status[0].y_solution[i+3]) < 1e-3);
     }
 }
+
+BOOST_AUTO_TEST_CASE(inactive_tasks){
+
+    /**
+     * Check if inactive tasks (activation zero or timeout) are skipped, i.e., the QP must be the same as without the inactive tasks
+     */
+
+    shared_ptr<RobotModelPinocchio> robot_model = make_shared<RobotModelPinocchio>();
+    RobotModelConfig config;
+    config.file_or_string = "../../../../../models/rh5/urdf/rh5_legs.urdf";
+    config.floating_base = true;
+    config.contact_points.names = {"FL_SupportCenter", "FR_SupportCenter"};
+    config.contact_points.elements = {ActiveContact(1,0.6),ActiveContact(1,0.6)};
+    BOOST_CHECK_EQUAL(robot_model->configure(config), true);
+
+    base::samples::Joints joint_state;
+    joint_state.names = robot_model->actuatedJointNames();
+    for(uint i = 0; i < robot_model->noOfActuatedJoints(); i++){
+        base::JointState js;
+        js.position = 0.1;
+        js.speed = js.acceleration = 0;
+        joint_state.elements.push_back(js);
+    }
+    joint_state.time = base::Time::now();
+
+    base::samples::RigidBodyStateSE3 rbs;
+    rbs.pose.position = base::Vector3d(-0.175,0,0.876);
+    rbs.pose.orientation.setIdentity();
+    rbs.twist.setZero();
+    rbs.acceleration.setZero();
+    rbs.time = base::Time::now();
+    BOOST_CHECK_NO_THROW(robot_model->update(joint_state,rbs));
+
+    QPSolverPtr solver = std::make_shared<QPOASESSolver>();
+
+    TaskConfig cart_task;
+    cart_task.type = cart;
+    cart_task.name = "cart_pos_ctrl";
+    cart_task.root = "world";
+    cart_task.tip = "RH5_Root_Link";
+    cart_task.ref_frame = "world";
+    cart_task.weights = {1,1,1,1,1,1};
+    cart_task.priority = 0;
+    cart_task.activation = 1;
+
+    TaskConfig swing_task = cart_task;
+    swing_task.name = "swing_ctrl";
+    swing_task.root = "RH5_Root_Link";
+    swing_task.tip = "FL_SupportCenter";
+    swing_task.ref_frame = "RH5_Root_Link";
+    swing_task.activation = 0;
+
+    TaskConfig grasp_task = swing_task;
+    grasp_task.name = "grasp_ctrl";
+    grasp_task.tip = "FR_SupportCenter";
+    grasp_task.activation = 1;
+
+    base::samples::RigidBodyStateSE3 ref;
+    ref.twist.linear = base::Vector3d(0.1,0.2,0.3);
+    ref.twist.angular = base::Vector3d(0.3,0.2,0.1);
+
+    // Scene with inactive tasks: swing_ctrl has zero activation, grasp_ctrl never received a reference and is in timeout
+    VelocitySceneQP scene(robot_model, solver, 1e-3);
+    BOOST_CHECK_EQUAL(scene.configure({cart_task, swing_task, grasp_task}), true);
+    BOOST_CHECK_NO_THROW(scene.setReference(cart_task.name, ref));
+    BOOST_CHECK_NO_THROW(scene.setReference(swing_task.name, ref));
+    HierarchicalQP hqp = scene.update();
+    BOOST_CHECK(scene.getTask(cart_task.name)->inactive == false);
+    BOOST_CHECK(scene.getTask(swing_task.name)->inactive == true);
+    BOOST_CHECK(scene.getTask(grasp_task.name)->inactive == true);
+    BOOST_CHECK(scene.getTask(swing_task.name)->Aw.isZero());
+    BOOST_CHECK(scene.getTask(grasp_task.name)->Aw.isZero());
+
+    // Reference scene without these tasks
+    VelocitySceneQP ref_scene(robot_model, std::make_shared<QPOASESSolver>(), 1e-3);
+    BOOST_CHECK_EQUAL(ref_scene.configure({cart_task}), true);
+    BOOST_CHECK_NO_THROW(ref_scene.setReference(cart_task.name, ref));
+    HierarchicalQP ref_hqp = ref_scene.update();
+    BOOST_CHECK(hqp[0].H.isApprox(ref_hqp[0].H));
+    BOOST_CHECK(hqp[0].g.isApprox(ref_hqp[0].g));
+
+    // Activate swing task again
+    BOOST_CHECK_NO_THROW(scene.setTaskActivation(swing_task.name, 1));
+    BOOST_CHECK_NO_THROW(scene.update());
+    BOOST_CHECK(scene.getTask(swing_task.name)->inactive == false);
+    BOOST_CHECK(!scene.getTask(swing_task.name)->Aw.isZero());
+}
+
+BOOST_AUTO_TEST_CASE(static_scene){
+
+    /**
+     * Check if a compile-time composed scene produces the same QP and solution as the equivalent VelocitySceneQP
+     */
+
+    shared_ptr<RobotModelPinocchio> robot_model = make_shared<RobotModelPinocchio>();
+    RobotModelConfig config;
+    config.file_or_string = "../../../../../models/kuka/urdf/kuka_iiwa.urdf";
+    BOOST_CHECK(robot_model->configure(config));
+
+    base::samples::Joints joint_state;
+    joint_state.names = robot_model->jointNames();
+    for(auto n : robot_model->jointNames()){
+        base::JointState js;
+        js.position = 0.5;
+        js.speed = js.acceleration = 0;
+        joint_state.elements.push_back(js);
+    }
+    joint_state.time = base::Time::now();
+    BOOST_CHECK_NO_THROW(robot_model->update(joint_state));
+
+    const double dt = 1e-3;
+    TaskConfig cart_task("cart_pos_ctrl_left", 0, "kuka_lbr_l_link_0", "kuka_lbr_l_tcp", "kuka_lbr_l_link_0", 1);
+
+    base::samples::RigidBodyStateSE3 ref;
+    ref.twist.linear = base::Vector3d(0.1,0.2,0.3);
+    ref.twist.angular = base::Vector3d(0.3,0.2,0.1);
+    ref.time = base::Time::now();
+
+    // Dynamic scene
+    VelocitySceneQP scene(robot_model, std::make_shared<QPOASESSolver>(), dt);
+    BOOST_CHECK_EQUAL(scene.configure({cart_task}, {ConstraintConfig(joint_limits_constraint)}), true);
+    BOOST_CHECK_NO_THROW(scene.setReference(cart_task.name, ref));
+    HierarchicalQP hqp = scene.update();
+    BOOST_CHECK_NO_THROW(scene.solve(hqp));
+
+    // Static scene
+    typedef StaticScene<7, 7, TaskList<CartesianVelocityTask>, ConstraintList<JointLimitsVelocityConstraint>> StaticVelocityScene;
+    StaticVelocityScene static_scene(robot_model, std::make_shared<QPOASESSolver>(),
+                                     std::make_tuple(CartesianVelocityTask(cart_task, robot_model->noOfJoints())),
+                                     std::make_tuple(JointLimitsVelocityConstraint(dt)));
+    BOOST_CHECK_NO_THROW(static_scene.getTask<0>().setReference(ref));
+    HierarchicalQP static_hqp = static_scene.update();
+    base::VectorXd static_solution = static_scene.solve(static_hqp);
+
+    BOOST_CHECK(static_hqp[0].H.isApprox(hqp[0].H));
+    BOOST_CHECK(static_hqp[0].g.isApprox(hqp[0].g));
+    BOOST_CHECK(static_hqp[0].lower_x.isApprox(hqp[0].lower_x));
+    BOOST_CHECK(static_hqp[0].upper_x.isApprox(hqp[0].upper_x));
+    for(uint i = 0; i < 7; i++)
+        BOOST_CHECK(fabs(static_solution[i] - scene.getSolverOutputRaw()[i]) < 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(reconfigure_wrapped_solver){
+
+    /**
+     * Reconfigure a scene with a different constraint set, so that the number of QP constraints changes. A solver front-end has to reset its backend on reconfiguration,
+     * otherwise qpOASES would keep the problem size of the previous configuration.
+     */
+
+    shared_ptr<RobotModelPinocchio> robot_model = make_shared<RobotModelPinocchio>();
+    RobotModelConfig config;
+    config.file_or_string = "../../../../../models/rh5/urdf/rh5_legs.urdf";
+    config.floating_base = true;
+    config.contact_points.names = {"FL_SupportCenter", "FR_SupportCenter"};
+    config.contact_points.elements = {ActiveContact(1,0.6),ActiveContact(1,0.6)};
+    BOOST_CHECK_EQUAL(robot_model->configure(config), true);
+
+    base::samples::Joints joint_state;
+    joint_state.names = robot_model->actuatedJointNames();
+    vector<double> q_in = {0,0,-0.35,0.64,0,-0.27, 0,0,-0.35,0.64,0,-0.27};
+    for(uint i = 0; i < robot_model->noOfActuatedJoints(); i++){
+        base::JointState js;
+        js.position = q_in[i];
+        js.speed = js.acceleration = 0;
+        joint_state.elements.push_back(js);
+    }
+    joint_state.time = base::Time::now();
+    base::samples::RigidBodyStateSE3 rbs;
+    rbs.pose.position = base::Vector3d(-0.175,0,0.876);
+    rbs.pose.orientation.setIdentity();
+    rbs.twist.setZero();
+    rbs.acceleration.setZero();
+    rbs.time = base::Time::now();
+    BOOST_CHECK_NO_THROW(robot_model->update(joint_state,rbs));
+
+    TaskConfig cart_task;
+    cart_task.type = cart;
+    cart_task.name = "cart_pos_ctrl";
+    cart_task.root = "world";
+    cart_task.tip = "RH5_Root_Link";
+    cart_task.ref_frame = "world";
+    cart_task.weights = {1,1,1,1,1,1};
+    cart_task.priority = 0;
+    cart_task.activation = 1;
+
+    // Large reference, so that the joint velocity limits become active and the backend has to be called
+    base::samples::RigidBodyStateSE3 ref;
+    ref.twist.linear = base::Vector3d(0,0,-50);
+    ref.twist.angular = base::Vector3d(10,0,0);
+
+    shared_ptr<UnconstrainedFirstSolver> solver = make_shared<UnconstrainedFirstSolver>(make_shared<QPOASESSolver>());
+    VelocitySceneQP scene(robot_model, solver, 1e-3);
+    vector< vector<ConstraintConfig> > constraint_sets = {{ConstraintConfig(contacts_constraint), ConstraintConfig(joint_limits_constraint)},
+                                                          {ConstraintConfig(joint_limits_constraint)},
+                                                          {ConstraintConfig(contacts_constraint), ConstraintConfig(joint_limits_constraint)}};
+    for(const auto &constraints : constraint_sets){
+        BOOST_CHECK_EQUAL(scene.configure({cart_task}, constraints), true);
+        BOOST_CHECK_NO_THROW(scene.setReference(cart_task.name, ref));
+        HierarchicalQP hqp = scene.update();
+        BOOST_CHECK_EQUAL(hqp[0].neq, constraints.size() == 2 ? 6 : 0);
+        BOOST_CHECK_NO_THROW(scene.solve(hqp));
+        BOOST_CHECK(solver->shortcutTaken() == false);
+
+        // Compare with a fresh solver
+        QPOASESSolver reference_solver;
+        base::VectorXd reference_output;
+        reference_solver.solve(hqp, reference_output);
+        BOOST_CHECK((scene.getSolverOutputRaw() - reference_output).norm() < 1e-6);
+    }
+}
@@ -0,0 +1,360 @@
+#include "BatchADMMSolver.hpp"
+#include "../../core/QuadraticProgram.hpp"
+#include <base-logging/Logging.hpp>
+#include <stdexcept>
+#include <algorithm>
+
+namespace wbc{
+
+QPSolverRegistry<BatchADMMSolver> BatchADMMSolver::reg("batch_admm");
+
+BatchADMMSolver::BatchADMMSolver() :
+    max_iterations(4000),
+    check_interval(10),
+    block_size(64),
+    adaptive_rho_interval(50),
+    n_iterations(0),
+    eps_abs(1e-6),
+    eps_rel(1e-6),
+    rho(0.1),
+    rho_min(1e-6),
+    rho_max(1e6),
+    sigma(1e-6),
+    alpha(1.6),
+    nq(0),
+    neq(0),
+    nin(0),
+    nc(0),
+    bounded(false){
+}
+
+BatchADMMSolver::~BatchADMMSolver(){
+}
+
+void BatchADMMSolver::setMaxIterations(const uint n){
+    if(n == 0)
+        throw std::invalid_argument("BatchADMMSolver: Max. number of iterations has to be > 0");
+    max_iterations = n;
+}
+
+void BatchADMMSolver::setParameter(const std::string &name, const std::string &value){
+    if(name == "max_iter")
+        setMaxIterations(std::stoi(value));
+    else if(name == "eps_abs")
+        setTolerances(std::stod(value), eps_rel);
+    else if(name == "eps_rel")
+        setTolerances(eps_abs, std::stod(value));
+    else if(name == "rho")
+        setRho(std::stod(value));
+    else if(name == "sigma")
+        setSigma(std::stod(value));
+    else if(name == "alpha")
+        setAlpha(std::stod(value));
+    else if(name == "block_size")
+        setBlockSize(std::stoi(value));
+    else
+        QPSolver::setParameter(name, value);
+}
+
+void BatchADMMSolver::setTolerances(const double eps_abs, const double eps_rel){
+    if(eps_abs < 0 || eps_rel < 0 || (eps_abs == 0 && eps_rel == 0))
+        throw std::invalid_argument("BatchADMMSolver: Tolerances have to be >= 0 and at least one of them > 0");
+    this->eps_abs = eps_abs;
+    this->eps_rel = eps_rel;
+}
+
+void BatchADMMSolver::setRho(const double rho){
+    if(rho <= 0)
+        throw std::invalid_argument("BatchADMMSolver: Rho has to be > 0");
+    this->rho = rho;
+}
+
+void BatchADMMSolver::setSigma(const double sigma){
+    if(sigma <= 0)
+        throw std::invalid_argument("BatchADMMSolver: Sigma has to be > 0");
+    this->sigma = sigma;
+}
+
+void BatchADMMSolver::setAlpha(const double alpha){
+    if(alpha <= 0 || alpha >= 2)
+        throw std::invalid_argument("BatchADMMSolver: Alpha has to be in (0,2)");
+    this->alpha = alpha;
+}
+
+void BatchADMMSolver::setCheckInterval(const uint n){
+    if(n == 0)
+        throw std::invalid_argument("BatchADMMSolver: Check interval has to be > 0");
+    check_interval = n;
+}
+
+void BatchADMMSolver::setAdaptiveRhoInterval(const uint n){
+    adaptive_rho_interval = n;
+}
+
+void BatchADMMSolver::setBlockSize(const uint n){
+    if(n == 0)
+        throw std::invalid_argument("BatchADMMSolver: Block size has to be > 0");
+    block_size = n;
+}
+
+uint BatchADMMSolver::getNoConverged(){
+    return std::count(converged.begin(), converged.end(), true);
+}
+
+void BatchADMMSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output){
+    std::vector<wbc::HierarchicalQP> hqps(1, hierarchical_qp);
+    std::vector<base::VectorXd> solver_outputs;
+    solveBatch(hqps, solver_outputs);
+    if(!converged[0]){
+        LOG_ERROR("BatchADMMSolver: Solver did not converge within %i iterations", (int)max_iterations);
+        throw std::runtime_error("BatchADMMSolver: Solver did not converge");
+    }
+    solver_output = solver_outputs[0];
+}
+
+void BatchADMMSolver::loadBlock(const std::vector<wbc::HierarchicalQP> &hqps, const uint first, const uint nb){
+
+    H.resize(nb, nq*nq);
+    C.resize(nb, nc*nq);
+    g.resize(nb, nq);
+    lower.resize(nb, nc);
+    upper.resize(nb, nc);
+    R.resize(nb, nc);
+
+    C.setZero();
+    for(uint k = 0; k < nb; k++){
+        const wbc::QuadraticProgram &qp = hqps[first+k][0];
+        for(int i = 0; i < nq; i++){
+            for(int j = 0; j < nq; j++)
+                H(k, i*nq+j) = qp.H(i,j);
+            g(k,i) = qp.g.size() == 0 ? 0 : qp.g(i);
+        }
+        // Stacked constraints: equalities, inequalities, bounds
+        for(int r = 0; r < neq; r++){
+            for(int i = 0; i < nq; i++)
+                C(k, r*nq+i) = qp.A(r,i);
+            lower(k,r) = upper(k,r) = qp.b(r);
+        }
+        for(int r = 0; r < nin; r++){
+            for(int i = 0; i < nq; i++)
+                C(k, (neq+r)*nq+i) = qp.C(r,i);
+            lower(k,neq+r) = qp.lower_y(r);
+            upper(k,neq+r) = qp.upper_y(r);
+        }
+        if(bounded){
+            for(int i = 0; i < nq; i++){
+                C(k, (neq+nin+i)*nq+i) = 1;
+                lower(k,neq+nin+i) = qp.lower_x(i);
+                upper(k,neq+nin+i) = qp.upper_x(i);
+            }
+        }
+    }
+
+    // Step sizes as in OSQP: Large for equalities, minimal for rows without finite bounds
+    const double inf = 1e20;
+    R_factor.resize(nb, nc);
+    for(int r = 0; r < nc; r++){
+        for(uint k = 0; k < nb; k++){
+            if(upper(k,r) - lower(k,r) < 1e-9)
+                R_factor(k,r) = 1e3;
+            else if(lower(k,r) < -inf && upper(k,r) > inf)
+                R_factor(k,r) = 0;
+            else
+                R_factor(k,r) = 1;
+        }
+    }
+    rho_lanes.setConstant(nb, rho);
+    updateStepSizes();
+}
+
+void BatchADMMSolver::updateStepSizes(){
+    R.resize(R_factor.rows(), nc);
+    for(int r = 0; r < nc; r++)
+        R.col(r) = (R_factor.col(r) * rho_lanes).max(rho_min);
+}
+
+void BatchADMMSolver::factorizeBlock(){
+
+    const int nb = H.rows();
+    L.resize(nb, nq*nq);
+    D_inv.resize(nb, nq);
+
+    // Lower triangle of H + sigma*I + C^T*R*C
+    for(int i = 0; i < nq; i++){
+        for(int j = 0; j <= i; j++){
+            L.col(i*nq+j) = H.col(i*nq+j);
+            for(int r = 0; r < nc; r++)
+                L.col(i*nq+j) += C.col(r*nq+i) * R.col(r) * C.col(r*nq+j);
+        }
+        L.col(i*nq+i) += sigma;
+    }
+
+    // Cholesky decomposition (in place, lower triangle), one lane per instance
+    for(int j = 0; j < nq; j++){
+        for(int p = 0; p < j; p++)
+            L.col(j*nq+j) -= L.col(j*nq+p).square();
+        if((L.col(j*nq+j) <= 0).any())
+            throw std::runtime_error("BatchADMMSolver: Linear system is not positive definite. Is H positive semi-definite?");
+        L.col(j*nq+j) = L.col(j*nq+j).sqrt();
+        D_inv.col(j) = L.col(j*nq+j).inverse();
+        for(int i = j+1; i < nq; i++){
+            for(int p = 0; p < j; p++)
+                L.col(i*nq+j) -= L.col(i*nq+p) * L.col(j*nq+p);
+            L.col(i*nq+j) *= D_inv.col(j);
+        }
+    }
+}
+
+void BatchADMMSolver::multiplyC(const Lanes &in, Lanes &out){
+    out.setZero(in.rows(), nc);
+    for(int r = 0; r < nc; r++)
+        for(int i = 0; i < nq; i++)
+            out.col(r) += C.col(r*nq+i) * in.col(i);
+}
+
+void BatchADMMSolver::multiplyCt(const Lanes &in, Lanes &out){
+    out.setZero(in.rows(), nq);
+    for(int r = 0; r < nc; r++)
+        for(int i = 0; i < nq; i++)
+            out.col(i) += C.col(r*nq+i) * in.col(r);
+}
+
+bool BatchADMMSolver::checkConvergence(){
+
+    const int nb = x.rows();
+    Hx.setZero(nb, nq);
+    for(int i = 0; i < nq; i++)
+        for(int j = 0; j < nq; j++)
+            Hx.col(i) += H.col(i*nq+j) * x.col(j);
+    multiplyCt(y, Cty);
+
+    // Dual residual ||Hx + g + C^T*y||, primal residual ||Cx - z||, both relative to the magnitude of their terms
+    Eigen::ArrayXd dual = (Hx + g + Cty).abs().rowwise().maxCoeff();
+    Eigen::ArrayXd dual_scale = Hx.abs().rowwise().maxCoeff().max(g.abs().rowwise().maxCoeff()).max(Cty.abs().rowwise().maxCoeff());
+    block_converged = dual <= eps_abs + eps_rel*dual_scale;
+    dual_residual = dual / dual_scale.max(1e-10);
+    if(nc > 0){
+        multiplyC(x, Cx);
+        Eigen::ArrayXd prim = (Cx - z).abs().rowwise().maxCoeff();
+        Eigen::ArrayXd prim_scale = Cx.abs().rowwise().maxCoeff().max(z.abs().rowwise().maxCoeff());
+        block_converged = block_converged && (prim <= eps_abs + eps_rel*prim_scale);
+        primal_residual = prim / prim_scale.max(1e-10);
+    }
+    return block_converged.all();
+}
+
+bool BatchADMMSolver::adaptRho(){
+
+    if(nc == 0)
+        return false;
+
+    // rho_new = rho*sqrt(primal residual / dual residual), both relative to the magnitude of their terms (OSQP). Refactorize only if rho changes significantly for any instance
+    Eigen::ArrayXd rho_new = (rho_lanes * (primal_residual / dual_residual.max(1e-10)).sqrt()).max(rho_min).min(rho_max);
+    Eigen::Array<bool,Eigen::Dynamic,1> change = (rho_new > 5*rho_lanes) || (rho_new < 0.2*rho_lanes);
+    if(!change.any())
+        return false;
+    rho_lanes = change.select(rho_new, rho_lanes);
+    updateStepSizes();
+    factorizeBlock();
+    return true;
+}
+
+uint BatchADMMSolver::iterateBlock(){
+
+    for(uint it = 1; it <= max_iterations; it++){
+
+        // rhs = sigma*x - g + C^T*(R*z - y)
+        w = R*z - y;
+        multiplyCt(w, rhs);
+        rhs += sigma*x - g;
+
+        // Forward and backward substitution with L*L^T
+        for(int i = 0; i < nq; i++){
+            for(int j = 0; j < i; j++)
+                rhs.col(i) -= L.col(i*nq+j) * rhs.col(j);
+            rhs.col(i) *= D_inv.col(i);
+        }
+        for(int i = nq-1; i >= 0; i--){
+            for(int j = i+1; j < nq; j++)
+                rhs.col(i) -= L.col(j*nq+i) * rhs.col(j);
+            rhs.col(i) *= D_inv.col(i);
+        }
+        x_tilde = rhs;
+
+        // Relaxed updates of x, z and y
+        multiplyC(x_tilde, z_hat);
+        z_hat = alpha*z_hat + (1-alpha)*z;
+        x = alpha*x_tilde + (1-alpha)*x;
+        w = z_hat + y/R;
+        z = w.max(lower).min(upper);
+        y += R*(z_hat - z);
+
+        if(it % check_interval == 0 || it == max_iterations){
+            if(checkConvergence())
+                return it;
+            if(adaptive_rho_interval > 0 && it % adaptive_rho_interval == 0)
+                adaptRho();
+        }
+    }
+    return max_iterations;
+}
+
+void BatchADMMSolver::solveBatch(const std::vector<wbc::HierarchicalQP> &hqps, std::vector<base::VectorXd> &solver_outputs){
+
+    const uint K = hqps.size();
+    solver_outputs.resize(K);
+    converged.assign(K, false);
+    n_iterations = 0;
+    if(K == 0)
+        return;
+
+    for(uint k = 0; k < K; k++){
+        if(hqps[k].size() != 1)
+            throw std::runtime_error("BatchADMMSolver::solveBatch: Number of task hierarchies must be 1 for the current implementation");
+        hqps[k][0].check();
+    }
+    const wbc::QuadraticProgram &qp0 = hqps[0][0];
+    for(uint k = 1; k < K; k++){
+        const wbc::QuadraticProgram &qp = hqps[k][0];
+        if(qp.nq != qp0.nq || qp.neq != qp0.neq || qp.nin != qp0.nin || qp.bounded != qp0.bounded){
+            LOG_ERROR("BatchADMMSolver: All QPs of a batch must have the same structure. QP %i has nq=%i, neq=%i, nin=%i, but QP 0 has nq=%i, neq=%i, nin=%i",
+                      (int)k, qp.nq, qp.neq, qp.nin, qp0.nq, qp0.neq, qp0.nin);
+            throw std::runtime_error("BatchADMMSolver::solveBatch: Invalid batch");
+        }
+    }
+
+    // Warm start if batch size and structure did not change
+    bool warm_start = configured && qp0.nq == nq && qp0.neq == neq && qp0.nin == nin && qp0.bounded == bounded && x_all.rows() == (int)K;
+    nq = qp0.nq;
+    neq = qp0.neq;
+    nin = qp0.nin;
+    bounded = qp0.bounded;
+    nc = neq + nin + (bounded ? nq : 0);
+    if(!warm_start){
+        x_all.setZero(K, nq);
+        z_all.setZero(K, nc);
+        y_all.setZero(K, nc);
+    }
+    configured = true;
+
+    for(uint first = 0; first < K; first += block_size){
+        const uint nb = std::min(block_size, K - first);
+        loadBlock(hqps, first, nb);
+        factorizeBlock();
+
+        x = x_all.middleRows(first, nb);
+        z = z_all.middleRows(first, nb);
+        y = y_all.middleRows(first, nb);
+        n_iterations = std::max(n_iterations, iterateBlock());
+
+        x_all.middleRows(first, nb) = x;
+        z_all.middleRows(first, nb) = z;
+        y_all.middleRows(first, nb) = y;
+        for(uint k = 0; k < nb; k++){
+            converged[first+k] = block_converged(k);
+            solver_outputs[first+k] = x.row(k).transpose().matrix();
+        }
+    }
+}
+
+}
@@ -0,0 +1,139 @@
+#ifndef WBC_SOLVERS_BATCH_ADMM_SOLVER_HPP
+#define WBC_SOLVERS_BATCH_ADMM_SOLVER_HPP
+
+#include <base/Eigen.hpp>
+#include <vector>
+#include "../../core/QPSolver.hpp"
+
+namespace wbc{
+
+class HierarchicalQP;
+
+/**
+ * @brief Dense ADMM solver for batches of many small, independent QPs with identical structure (same nq, neq, nin and bounds), e.g. for Monte-Carlo studies on a single scene.
+ * All constraints are stacked as \f$\mathbf{l} \leq \mathbf{Cx} \leq \mathbf{u}\f$ (equalities with l = u, variable bounds as identity rows) and solved with the
+ * fixed-structure ADMM iteration of OSQP (Stellato et al., "OSQP: an operator splitting solver for quadratic programs", 2020), without preconditioning:
+ *  \f[
+ *        \begin{array}{l}
+ *        (\mathbf{H} + \sigma\mathbf{I} + \mathbf{C}^T\mathbf{R}\mathbf{C})\tilde{\mathbf{x}} = \sigma\mathbf{x} - \mathbf{g} + \mathbf{C}^T(\mathbf{R}\mathbf{z} - \mathbf{y}) \\
+ *        \hat{\mathbf{z}} = \alpha\mathbf{C}\tilde{\mathbf{x}} + (1-\alpha)\mathbf{z}, \quad \mathbf{x} \leftarrow \alpha\tilde{\mathbf{x}} + (1-\alpha)\mathbf{x} \\
+ *        \mathbf{z} \leftarrow \Pi_{[\mathbf{l},\mathbf{u}]}(\hat{\mathbf{z}} + \mathbf{R}^{-1}\mathbf{y}), \quad \mathbf{y} \leftarrow \mathbf{y} + \mathbf{R}(\hat{\mathbf{z}} - \mathbf{z}) \\
+ *        \end{array}
+ *  \f]
+ * R is the diagonal matrix of step sizes: 1e3*rho for equality rows, rho for inequality rows and 1e-6 for rows without finite bounds. The matrix on the left hand side is
+ * factorized once per solve (Cholesky), each iteration costs two triangular solves and three matrix-vector products. Since the problems are not preconditioned, rho is
+ * adapted per instance to balance the primal and dual residuals as in OSQP (see setAdaptiveRhoInterval()), which requires a new factorization.
+ *
+ * The problem data is stored interleaved (lane-major): Each matrix or vector entry is a contiguous column of the values of all instances in a block. Each step of
+ * the factorization and iteration is then an Eigen array operation over all instances of the block, which is vectorized with SIMD instructions (compile with optimization
+ * and e.g. -march=native to use the widest available instruction set). All instances of a block run the same number of iterations, i.e., until all of them have converged.
+ * The instances are processed in blocks of setBlockSize() instances to keep the working set in cache.
+ *
+ * H has to be positive semi-definite. Only single priority QPs are supported. The solver is registered as "batch_admm"; solve() solves a single instance, warm-started
+ * with the previous solution.
+ */
+class BatchADMMSolver : public QPSolver{
+private:
+    static QPSolverRegistry<BatchADMMSolver> reg;
+
+public:
+    BatchADMMSolver();
+    virtual ~BatchADMMSolver();
+
+    /**
+     * @brief solve Solve the given quadratic program. Throws if the solver did not converge
+     * @param hierarchical_qp Description of the hierarchical quadratic program to solve.
+     * @param solver_output solution of the quadratic program
+     */
+    virtual void solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output);
+
+    /**
+     * @brief solveBatch Solve a batch of independent QPs with identical structure. Does not throw if instances did not converge, see isConverged().
+     * If the number of instances and the structure are the same as in the last call, each instance is warm-started with the corresponding solution of the last call.
+     * @param hierarchical_qps QPs to solve. All have to have exactly one priority of the same dimensions
+     * @param solver_outputs Solution of each QP
+     */
+    void solveBatch(const std::vector<wbc::HierarchicalQP> &hierarchical_qps, std::vector<base::VectorXd> &solver_outputs);
+
+    /** True if the given instance of the last batch has converged*/
+    bool isConverged(const uint instance){return converged.at(instance);}
+
+    /** Number of converged instances of the last batch*/
+    uint getNoConverged();
+
+    /** Max. number of iterations of all blocks of the last batch*/
+    uint getNoIterations(){return n_iterations;}
+
+    /** Set the max. number of ADMM iterations. Default is 4000*/
+    void setMaxIterations(const uint n);
+
+    /** Get the max. number of ADMM iterations*/
+    uint getMaxIterations(){return max_iterations;}
+
+    /** Set the absolute and relative tolerance of the primal and dual residuals. Default is 1e-6 for both*/
+    void setTolerances(const double eps_abs, const double eps_rel);
+
+    /** Set the ADMM step size rho (>0). Default is 0.1*/
+    void setRho(const double rho);
+
+    /** Set the regularization sigma (>0) of the linear system. Default is 1e-6*/
+    void setSigma(const double sigma);
+
+    /** Set the relaxation parameter alpha (0 < alpha < 2). Default is 1.6*/
+    void setAlpha(const double alpha);
+
+    /** Check the termination criteria every n iterations. Default is 10*/
+    void setCheckInterval(const uint n);
+
+    /** Adapt rho every n iterations (rounded to the check interval). 0 disables the adaptation. Default is 50*/
+    void setAdaptiveRhoInterval(const uint n);
+
+    /** Set the number of instances that are interleaved and processed together. Default is 64*/
+    void setBlockSize(const uint n);
+
+    /** Get the number of instances that are interleaved and processed together*/
+    uint getBlockSize(){return block_size;}
+
+    /** Set a parameter by name. Valid parameters are "max_iter", "eps_abs", "eps_rel", "rho", "sigma", "alpha" and "block_size", see the respective setters*/
+    virtual void setParameter(const std::string &name, const std::string &value);
+
+protected:
+    typedef Eigen::ArrayXXd Lanes;
+
+    /** Load the given instances into the interleaved block data, including step sizes*/
+    void loadBlock(const std::vector<wbc::HierarchicalQP> &hierarchical_qps, const uint first, const uint nb);
+    /** Factorize H + sigma*I + C^T*R*C of all instances of the block*/
+    void factorizeBlock();
+    /** Run the ADMM iteration on the current block. Return the number of iterations*/
+    uint iterateBlock();
+    /** Compute the convergence flags and relative residuals of all instances of the block*/
+    bool checkConvergence();
+    /** Update rho of all instances of the block from the last residuals and refactorize if required. Return true if rho has been changed*/
+    bool adaptRho();
+    /** Compute the step sizes R of the block from rho of each instance*/
+    void updateStepSizes();
+    /** out.col(r) = sum_i C(r,i)*in.col(i) for all rows r*/
+    void multiplyC(const Lanes &in, Lanes &out);
+    /** out.col(i) = sum_r C(r,i)*in.col(r) for all columns i*/
+    void multiplyCt(const Lanes &in, Lanes &out);
+
+    uint max_iterations, check_interval, block_size, adaptive_rho_interval, n_iterations;
+    double eps_abs, eps_rel, rho, rho_min, rho_max, sigma, alpha;
+    int nq, neq, nin, nc;
+    bool bounded;
+
+    /** Interleaved data of the current block: column (i*nq+j) of H/L holds entry (i,j) of all instances, column (r*nq+i) of C entry (r,i)*/
+    Lanes H, L, C, g, lower, upper, R, R_factor, D_inv;
+    /** Step size rho and relative residuals of each instance of the current block*/
+    Eigen::ArrayXd rho_lanes, primal_residual, dual_residual;
+    /** Iterates of the current block and workspace*/
+    Lanes x, z, y, x_tilde, z_hat, rhs, w, Cx, Hx, Cty;
+    Eigen::Array<bool,Eigen::Dynamic,1> block_converged;
+
+    /** Solution and dual variables of all instances of the last batch, for warm start (one row per instance)*/
+    Lanes x_all, z_all, y_all;
+    std::vector<bool> converged;
+};
+
+}
+#endif
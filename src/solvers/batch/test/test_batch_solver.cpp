@@ -0,0 +1,85 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "core/QuadraticProgram.hpp"
+#include "solvers/batch/BatchADMMSolver.hpp"
+#include "solvers/qpoases/QPOasesSolver.hpp"
+
+using namespace wbc;
+using namespace std;
+
+/** Random feasible QP with equality and inequality constraints and bounds*/
+wbc::HierarchicalQP randomQP(const uint nq, const uint neq, const uint nin){
+    wbc::QuadraticProgram qp;
+    qp.resize(nq, neq, nin, true);
+    base::MatrixXd J = base::MatrixXd::Random(nq, nq);
+    qp.H = J.transpose()*J + base::MatrixXd::Identity(nq, nq);
+    qp.g = 5*base::VectorXd::Random(nq);
+    base::VectorXd x0 = 0.3*base::VectorXd::Random(nq);
+    qp.A.setRandom();
+    qp.b = qp.A*x0;
+    qp.C.setRandom();
+    qp.lower_y = qp.C*x0 - base::VectorXd::Constant(nin, 0.2);
+    qp.upper_y = qp.C*x0 + base::VectorXd::Constant(nin, 0.2);
+    qp.lower_x.setConstant(-1);
+    qp.upper_x.setConstant(1);
+    wbc::HierarchicalQP hqp;
+    hqp << qp;
+    hqp.Wq.setOnes(nq);
+    return hqp;
+}
+
+BOOST_AUTO_TEST_CASE(solver_batch_admm)
+{
+    /**
+     * Solve a batch of random QPs, whose size is not a multiple of the block size, and compare each solution with qpOASES
+     */
+
+    const uint NO_JOINTS = 7;
+    const uint NO_EQ_CONSTRAINTS = 2;
+    const uint NO_IN_CONSTRAINTS = 3;
+    const uint NO_INSTANCES = 100;
+
+    vector<wbc::HierarchicalQP> hqps;
+    for(uint k = 0; k < NO_INSTANCES; k++)
+        hqps.push_back(randomQP(NO_JOINTS, NO_EQ_CONSTRAINTS, NO_IN_CONSTRAINTS));
+
+    BatchADMMSolver solver;
+    solver.setBlockSize(16);
+    solver.setTolerances(1e-8, 1e-8);
+    vector<base::VectorXd> solver_outputs;
+    BOOST_CHECK_NO_THROW(solver.solveBatch(hqps, solver_outputs));
+    BOOST_CHECK(solver_outputs.size() == NO_INSTANCES);
+    BOOST_CHECK(solver.getNoConverged() == NO_INSTANCES);
+
+    QPOASESSolver reference_solver;
+    base::VectorXd reference_output;
+    for(uint k = 0; k < NO_INSTANCES; k++){
+        BOOST_CHECK(solver.isConverged(k));
+        reference_solver.reset();
+        reference_solver.solve(hqps[k], reference_output);
+        for(uint i = 0; i < NO_JOINTS; i++)
+            BOOST_CHECK(fabs(solver_outputs[k](i) - reference_output(i)) < 1e-5);
+    }
+
+    // Warm start with the same problems should converge immediately
+    uint n_iterations = solver.getNoIterations();
+    solver.solveBatch(hqps, solver_outputs);
+    BOOST_CHECK(solver.getNoIterations() < n_iterations);
+    BOOST_CHECK(solver.getNoConverged() == NO_INSTANCES);
+
+    // Single instance through the QPSolver interface
+    base::VectorXd solver_output;
+    BOOST_CHECK_NO_THROW(solver.solve(hqps[0], solver_output));
+    reference_solver.reset();
+    reference_solver.solve(hqps[0], reference_output);
+    for(uint i = 0; i < NO_JOINTS; i++)
+        BOOST_CHECK(fabs(solver_output(i) - reference_output(i)) < 1e-5);
+
+    // Different structure within a batch
+    hqps.push_back(randomQP(NO_JOINTS, NO_EQ_CONSTRAINTS+1, NO_IN_CONSTRAINTS));
+    BOOST_CHECK_THROW(solver.solveBatch(hqps, solver_outputs), std::runtime_error);
+
+    BOOST_CHECK_THROW(solver.setAlpha(2), std::invalid_argument);
+    BOOST_CHECK_THROW(solver.setBlockSize(0), std::invalid_argument);
+}
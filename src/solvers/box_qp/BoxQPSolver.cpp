@@ -0,0 +1,263 @@
+#include "BoxQPSolver.hpp"
+#include "../../core/QuadraticProgram.hpp"
+#include <base-logging/Logging.hpp>
+#include <stdexcept>
+#include <limits>
+
+namespace wbc{
+
+QPSolverRegistry<BoxQPSolver> BoxQPSolver::reg("box_qp");
+
+BoxQPSolver::BoxQPSolver() :
+    max_iterations(50),
+    n_iterations(0),
+    rank(0),
+    has_solution(false){
+}
+
+BoxQPSolver::~BoxQPSolver(){
+}
+
+void BoxQPSolver::setMaxIterations(const uint n){
+    if(n == 0)
+        throw std::invalid_argument("BoxQPSolver: Max. number of iterations has to be > 0");
+    max_iterations = n;
+}
+
+void BoxQPSolver::setParameter(const std::string &name, const std::string &value){
+    if(name == "max_iter")
+        setMaxIterations(std::stoi(value));
+    else
+        QPSolver::setParameter(name, value);
+}
+
+bool BoxQPSolver::getActiveSet(Eigen::VectorXi &constraints, Eigen::VectorXi &bounds){
+    if(!has_solution)
+        return false;
+    constraints.resize(0);
+    bounds = active_bounds;
+    return true;
+}
+
+void BoxQPSolver::updateIterate(const base::VectorXd &lower, const base::VectorXd &upper, const int p, const double t){
+
+    // P_WW*nu_W = (x_u)_W - bounds_W - P_Wp*t, x = x_u - P_:,W*nu_W - P_:,p*t. t is the signed multiplier of the constraint p that is currently added (if p >= 0)
+    const int k = working_set.size();
+    P_WW.resize(k,k);
+    nu_W.resize(k);
+    for(int r = 0; r < k; r++){
+        const int i = working_set[r];
+        for(int c = 0; c < k; c++)
+            P_WW(r,c) = P(i, working_set[c]);
+        nu_W[r] = x_u[i] - (active_bounds[i] == ACTIVE_SET_UPPER ? upper[i] : lower[i]);
+        if(p >= 0)
+            nu_W[r] -= P(i,p) * t;
+    }
+    x = x_u;
+    if(p >= 0)
+        x.noalias() -= P.col(p) * t;
+    if(k == 0)
+        return;
+    ldlt.compute(P_WW);
+    nu_W = ldlt.solve(nu_W);
+    for(int r = 0; r < k; r++)
+        x.noalias() -= P.col(working_set[r]) * nu_W[r];
+}
+
+void BoxQPSolver::removeFromWorkingSet(const int r){
+    active_bounds[working_set[r]] = ACTIVE_SET_INACTIVE;
+    working_set.erase(working_set.begin() + r);
+}
+
+void BoxQPSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output){
+
+    if(hierarchical_qp.size() != 1)
+        throw std::runtime_error("BoxQPSolver::solve: Number of task hierarchies must be 1 for the current implementation");
+
+    const wbc::QuadraticProgram &qp = hierarchical_qp[0];
+    qp.check();
+    if(qp.nin > 0){
+        LOG_ERROR("BoxQPSolver: QP has %i inequality constraints, but only equality constraints and bounds are supported", qp.nin);
+        throw std::runtime_error("BoxQPSolver::solve: Inequality constraints are not supported");
+    }
+
+    const int n = qp.nq;
+    const double inf = std::numeric_limits<double>::infinity();
+    const base::VectorXd lower = qp.bounded ? qp.lower_x : base::VectorXd::Constant(n, -inf);
+    const base::VectorXd upper = qp.bounded ? qp.upper_x : base::VectorXd::Constant(n, inf);
+
+    // Eliminate the equality constraints: A^T*Pi = Q*R, so that Pi^T*A*x = R^T*Q^T*x = Pi^T*b. With Q = [Y Z], x = x_p + Z*w
+    if(qp.neq > 0){
+        qr.compute(qp.A.transpose());
+        rank = qr.rank();
+        Q = qr.householderQ();
+        b_perm = qr.colsPermutation().transpose() * qp.b;
+        x_p.noalias() = Q.leftCols(rank) * qr.matrixR().topLeftCorner(rank, rank).template triangularView<Eigen::Upper>().transpose().solve(b_perm.head(rank));
+        Z = Q.rightCols(n - rank);
+    }
+    else{
+        rank = 0;
+        x_p.setZero(n);
+        Z.setIdentity(n, n);
+    }
+
+    // Reset warm start after reset() or if the problem size has changed
+    if(!configured || active_bounds.size() != n){
+        active_bounds.setConstant(n, ACTIVE_SET_INACTIVE);
+        configured = true;
+    }
+
+    if(rank == (uint)n){
+        // Solution is fully determined by the equality constraints
+        solver_output = x_p;
+        active_bounds.setConstant(n, ACTIVE_SET_INACTIVE);
+        n_iterations = 0;
+        has_solution = true;
+        updateWarmStartPredictor(hierarchical_qp, solver_output);
+        return;
+    }
+
+    // Reduced problem: min 0.5*w^T*Z^T*H*Z*w + w^T*Z^T*(H*x_p + g)
+    HZ.noalias() = qp.H * Z;
+    H_red.noalias() = Z.transpose() * HZ;
+    llt.compute(H_red);
+    if(llt.info() != Eigen::Success){
+        LOG_ERROR("BoxQPSolver: Reduced Hessian is not positive definite");
+        throw std::runtime_error("BoxQPSolver::solve: Reduced Hessian is not positive definite");
+    }
+    g_red.noalias() = HZ.transpose() * x_p;
+    if(qp.g.size() > 0)
+        g_red.noalias() += Z.transpose() * qp.g;
+    x_u = x_p;
+    x_u.noalias() -= Z * llt.solve(g_red);
+    P.noalias() = Z * llt.solve(Z.transpose());
+
+    const double tol = 1e-10;
+
+    // Warm start from the predicted or the last active set. Use only linearly independent variables, i.e., those whose Schur complement w.r.t. the working set is positive
+    if(predictWarmStart(hierarchical_qp) && warm_start.hasActiveSet(qp))
+        active_bounds_last = warm_start.active_bounds;
+    else
+        active_bounds_last = active_bounds;
+    active_bounds.setConstant(n, ACTIVE_SET_INACTIVE);
+    working_set.clear();
+    for(int i = 0; i < n; i++){
+        if(active_bounds_last[i] == ACTIVE_SET_INACTIVE)
+            continue;
+        const int k = working_set.size();
+        double schur = P(i,i);
+        if(k > 0){
+            updateIterate(lower, upper, -1, 0);
+            P_Wp.resize(k);
+            for(int r = 0; r < k; r++)
+                P_Wp[r] = P(working_set[r], i);
+            schur -= P_Wp.dot(ldlt.solve(P_Wp));
+        }
+        if(schur > tol){
+            working_set.push_back(i);
+            active_bounds[i] = active_bounds_last[i];
+        }
+    }
+
+    // The initial point of the dual method has to be dual feasible: Drop the constraint with the most negative multiplier until all multipliers have the correct sign
+    n_iterations = 0;
+    updateIterate(lower, upper, -1, 0);
+    while(!working_set.empty()){
+        int r_min = -1;
+        double min_mult = -tol;
+        for(uint r = 0; r < working_set.size(); r++){
+            double mult = active_bounds[working_set[r]] * nu_W[r];
+            if(mult < min_mult){
+                min_mult = mult;
+                r_min = r;
+            }
+        }
+        if(r_min < 0)
+            break;
+        n_iterations++;
+        removeFromWorkingSet(r_min);
+        updateIterate(lower, upper, -1, 0);
+    }
+
+    // Dual active set iteration (Goldfarb-Idnani)
+    while(true){
+
+        // Most violated bound
+        int p = -1;
+        double max_violation = tol;
+        for(int i = 0; i < n; i++){
+            if(active_bounds[i] != ACTIVE_SET_INACTIVE)
+                continue;
+            double violation = std::max(x[i] - upper[i], lower[i] - x[i]);
+            if(violation > max_violation){
+                max_violation = violation;
+                p = i;
+            }
+        }
+        if(p < 0)
+            break;
+
+        const int s = x[p] > upper[p] ? ACTIVE_SET_UPPER : ACTIVE_SET_LOWER;
+        const double bound = s == ACTIVE_SET_UPPER ? upper[p] : lower[p];
+        double t_p = 0;
+        while(true){
+            if(++n_iterations > max_iterations){
+                has_solution = false;
+                active_bounds.setConstant(n, ACTIVE_SET_INACTIVE);
+                LOG_ERROR("BoxQPSolver: Active set did not converge within %i iterations", (int)max_iterations);
+                throw std::runtime_error("BoxQPSolver::solve: Max. number of iterations exceeded");
+            }
+
+            // Step direction: Increasing the multiplier of p by t moves x by -d*s*t and the multipliers of the working set by r*t
+            const int k = working_set.size();
+            P_Wp.resize(k);
+            for(int r = 0; r < k; r++)
+                P_Wp[r] = P(working_set[r], p);
+            if(k > 0)
+                P_Wp = ldlt.solve(P_Wp);
+            double d_p = P(p,p);
+            for(int r = 0; r < k; r++)
+                d_p -= P(p, working_set[r]) * P_Wp[r];
+
+            // Full step (constraint p becomes active) and max. dual step (a multiplier of the working set becomes zero)
+            double t_full = d_p > tol ? s*(x[p] - bound) / d_p : inf;
+            double t_dual = inf;
+            int r_drop = -1;
+            for(int r = 0; r < k; r++){
+                const double sr = -active_bounds[working_set[r]] * s * P_Wp[r];
+                if(sr < 0){
+                    const double t = active_bounds[working_set[r]] * nu_W[r] / -sr;
+                    if(t < t_dual){
+                        t_dual = t;
+                        r_drop = r;
+                    }
+                }
+            }
+            if(t_full == inf && t_dual == inf){
+                has_solution = false;
+                active_bounds.setConstant(n, ACTIVE_SET_INACTIVE);
+                LOG_ERROR("BoxQPSolver: QP is infeasible");
+                throw std::runtime_error("BoxQPSolver::solve: QP is infeasible");
+            }
+
+            if(t_full <= t_dual){
+                working_set.push_back(p);
+                active_bounds[p] = s;
+                updateIterate(lower, upper, -1, 0);
+                break;
+            }
+            t_p += t_dual;
+            removeFromWorkingSet(r_drop);
+            updateIterate(lower, upper, p, s*t_p);
+        }
+    }
+
+    // Remove rounding errors of the fixed variables
+    for(int i : working_set)
+        x[i] = active_bounds[i] == ACTIVE_SET_UPPER ? upper[i] : lower[i];
+    has_solution = true;
+    solver_output = x;
+    updateWarmStartPredictor(hierarchical_qp, solver_output);
+}
+
+}
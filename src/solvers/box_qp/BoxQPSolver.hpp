@@ -0,0 +1,95 @@
+#ifndef WBC_SOLVERS_BOX_QP_SOLVER_HPP
+#define WBC_SOLVERS_BOX_QP_SOLVER_HPP
+
+#include <base/Eigen.hpp>
+#include <Eigen/QR>
+#include <Eigen/Cholesky>
+#include <vector>
+#include "../../core/QPSolver.hpp"
+
+namespace wbc{
+
+class HierarchicalQP;
+
+/**
+ * @brief Dedicated solver for QPs with equality constraints and simple bounds, but without general inequality constraints, as generated by VelocitySceneQP (least-squares cost,
+ * ContactsVelocityConstraint equalities and JointLimitsVelocityConstraint bounds):
+ *  \f[
+ *        \begin{array}{ccc}
+ *        min(\mathbf{x}) & \frac{1}{2} \mathbf{x}^T\mathbf{H}\mathbf{x}+\mathbf{x}^T\mathbf{g}& \\
+ *             & & \\
+ *        s.t. & \mathbf{Ax} = \mathbf{b}& \\
+ *             & \mathbf{l} \leq \mathbf{x} \leq \mathbf{u}& \\
+ *        \end{array}
+ *  \f]
+ * The equality constraints are eliminated once per solve: A pivoted QR decomposition of \f$\mathbf{A}^T\f$ yields a particular solution \f$\mathbf{x}_p\f$ and an orthonormal
+ * nullspace basis Z, so that \f$\mathbf{x} = \mathbf{x}_p + \mathbf{Zw}\f$. The reduced Hessian \f$\mathbf{Z}^T\mathbf{HZ}\f$ has to be positive definite and is factorized once.
+ * With the unconstrained minimizer \f$\mathbf{x}_u\f$ of the reduced problem and \f$\mathbf{P} = \mathbf{Z}(\mathbf{Z}^T\mathbf{HZ})^{-1}\mathbf{Z}^T\f$, the solution for
+ * a set W of variables fixed at their bounds is \f$\mathbf{x} = \mathbf{x}_u - \mathbf{P}_{:,W}\boldsymbol{\nu}\f$ with \f$\mathbf{P}_{WW}\boldsymbol{\nu} = (\mathbf{x}_u)_W - \mathbf{x}_W\f$,
+ * i.e., each active-set iteration only requires the factorization of a small |W| x |W| matrix. The bounds are treated as inequality constraints of the reduced problem and
+ * the active set is computed with the dual method of Goldfarb and Idnani ("A numerically stable dual method for solving strictly convex quadratic programs", 1983):
+ * Starting from a dual feasible point, the most violated bound is added to the working set, dropping bounds whose multipliers would change sign. In contrast to primal
+ * active-set methods, no feasible starting point is required.
+ *
+ * The active set of the last solve is used as warm start (bounds with wrong multiplier sign are dropped first), so that typically only few iterations are required in
+ * a control loop. Alternatively, the active set can be provided by a WarmStartPredictor. Only single priority QPs without inequality constraints (nin = 0) are supported. The solver is registered as "box_qp".
+ */
+class BoxQPSolver : public QPSolver{
+private:
+    static QPSolverRegistry<BoxQPSolver> reg;
+
+public:
+    BoxQPSolver();
+    virtual ~BoxQPSolver();
+
+    /**
+     * @brief solve Solve the given quadratic program. Throws if the QP contains inequality constraints, if the reduced Hessian is not positive definite or if the
+     * active set did not converge within the max. number of iterations
+     * @param hierarchical_qp Description of the hierarchical quadratic program to solve.
+     * @param solver_output solution of the quadratic program
+     */
+    virtual void solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output);
+
+    /** Return the active bounds of the last solution. There are no inequality constraints, so that constraints is always empty*/
+    virtual bool getActiveSet(Eigen::VectorXi &constraints, Eigen::VectorXi &bounds);
+
+    /** Set the max. number of active set iterations per solve. Default is 50*/
+    void setMaxIterations(const uint n);
+
+    /** Get the max. number of active set iterations per solve*/
+    uint getMaxIterations(){return max_iterations;}
+
+    /** Number of active set changes (added and dropped bounds) in the last solve*/
+    uint getNoIterations(){return n_iterations;}
+
+    /** Rank of the equality constraint matrix in the last solve*/
+    uint getRank(){return rank;}
+
+    /** Set a parameter by name. Valid parameters are "max_iter" (see setMaxIterations())*/
+    virtual void setParameter(const std::string &name, const std::string &value);
+
+    /** The active bounds predicted by the warm start predictor replace the active set of the last solve as warm start*/
+    virtual bool supportsWarmStart(){return true;}
+
+protected:
+    /** Compute the solution x and the multipliers of the working set, for a given signed multiplier t of the variable p (p < 0: none)*/
+    void updateIterate(const base::VectorXd &lower, const base::VectorXd &upper, const int p, const double t);
+    /** Remove the r-th entry from the working set*/
+    void removeFromWorkingSet(const int r);
+
+    uint max_iterations, n_iterations, rank;
+    bool has_solution;
+
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr;
+    Eigen::LLT<Eigen::MatrixXd> llt;
+    Eigen::LDLT<Eigen::MatrixXd> ldlt;
+    Eigen::MatrixXd Q, Z, HZ, H_red, P, P_WW;
+    Eigen::VectorXd b_perm, x_p, x_u, g_red, x, nu_W, P_Wp;
+
+    /** Status of each variable (see ActiveSetStatus) in the current and the last solve, indices of the fixed variables*/
+    Eigen::VectorXi active_bounds, active_bounds_last;
+    std::vector<int> working_set;
+};
+
+}
+#endif
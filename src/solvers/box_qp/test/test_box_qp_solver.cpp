@@ -0,0 +1,170 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "core/QuadraticProgram.hpp"
+#include "solvers/box_qp/BoxQPSolver.hpp"
+#include "solvers/qpoases/QPOasesSolver.hpp"
+
+using namespace wbc;
+using namespace std;
+
+/** Random least-squares QP with equality constraints (b = 0, as for contact constraints) and symmetric bounds*/
+wbc::HierarchicalQP randomQP(const uint nq, const uint neq, const double bound){
+    wbc::QuadraticProgram qp;
+    qp.resize(nq, neq, 0, true);
+    base::MatrixXd J = base::MatrixXd::Random(nq+3, nq);
+    qp.H = J.transpose()*J;
+    qp.g = 5*base::VectorXd::Random(nq);
+    qp.A.setRandom();
+    qp.b.setZero();
+    qp.lower_x.setConstant(-bound);
+    qp.upper_x.setConstant(bound);
+    wbc::HierarchicalQP hqp;
+    hqp << qp;
+    hqp.Wq.setOnes(nq);
+    return hqp;
+}
+
+BOOST_AUTO_TEST_CASE(solver_box_qp)
+{
+    /**
+     * Compare the solution of random equality and bound constrained QPs with qpOASES, with and without active bounds
+     */
+
+    const uint NO_JOINTS = 10;
+    const uint NO_EQ_CONSTRAINTS = 4;
+
+    BoxQPSolver solver;
+    QPOASESSolver reference_solver;
+    base::VectorXd solver_output, reference_output;
+    Eigen::VectorXi active_constraints, active_bounds;
+    BOOST_CHECK(solver.getActiveSet(active_constraints, active_bounds) == false);
+
+    for(double bound : {1e3, 0.5, 0.05}){
+        for(uint n = 0; n < 20; n++){
+            wbc::HierarchicalQP hqp = randomQP(NO_JOINTS, NO_EQ_CONSTRAINTS, bound);
+            BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+            reference_solver.reset();
+            reference_solver.solve(hqp, reference_output);
+            for(uint i = 0; i < NO_JOINTS; i++)
+                BOOST_CHECK(fabs(solver_output(i) - reference_output(i)) < 1e-6);
+            BOOST_CHECK(solver.getRank() == NO_EQ_CONSTRAINTS);
+            BOOST_CHECK((hqp[0].A*solver_output).norm() < 1e-9);
+
+            BOOST_CHECK(solver.getActiveSet(active_constraints, active_bounds));
+            BOOST_CHECK(active_constraints.size() == 0);
+            for(uint i = 0; i < NO_JOINTS; i++){
+                if(active_bounds[i] == ACTIVE_SET_UPPER)
+                    BOOST_CHECK(solver_output[i] == bound);
+                else if(active_bounds[i] == ACTIVE_SET_LOWER)
+                    BOOST_CHECK(solver_output[i] == -bound);
+                else
+                    BOOST_CHECK(fabs(solver_output[i]) <= bound);
+            }
+            if(bound == 1e3)
+                BOOST_CHECK(active_bounds.isZero());
+        }
+    }
+
+    // Inequality constraints are not supported
+    wbc::QuadraticProgram qp;
+    qp.resize(NO_JOINTS, 0, 1, true);
+    wbc::HierarchicalQP hqp;
+    hqp << qp;
+    BOOST_CHECK_THROW(solver.solve(hqp, solver_output), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(solver_box_qp_warm_start)
+{
+    /**
+     * Slowly varying QP with active bounds: With warm start, the active set of the last solve should be reused
+     */
+
+    const uint NO_JOINTS = 10;
+    const uint NO_EQ_CONSTRAINTS = 4;
+
+    wbc::HierarchicalQP hqp = randomQP(NO_JOINTS, NO_EQ_CONSTRAINTS, 0.05);
+    BoxQPSolver solver;
+    QPOASESSolver reference_solver;
+    base::VectorXd solver_output, reference_output;
+
+    BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+    uint n_iterations_cold = solver.getNoIterations();
+    BOOST_CHECK(n_iterations_cold > 0);
+
+    uint n_iterations_warm = 0;
+    for(uint n = 0; n < 10; n++){
+        hqp[0].g += 1e-3*base::VectorXd::Random(NO_JOINTS);
+        BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+        n_iterations_warm = std::max(n_iterations_warm, solver.getNoIterations());
+        reference_solver.solve(hqp, reference_output);
+        for(uint i = 0; i < NO_JOINTS; i++)
+            BOOST_CHECK(fabs(solver_output(i) - reference_output(i)) < 1e-6);
+    }
+    BOOST_CHECK(n_iterations_warm < n_iterations_cold);
+
+    // reset() discards the warm start
+    solver.reset();
+    BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+    BOOST_CHECK(solver.getNoIterations() > 0);
+}
+
+/** Predictor that returns a fixed warm start and counts the calls*/
+class FixedPredictor : public WarmStartPredictor{
+public:
+    FixedPredictor(const WarmStart &prediction) : prediction(prediction), n_updates(0){}
+    virtual bool predict(const HierarchicalQP &hierarchical_qp, WarmStart &warm_start){
+        warm_start = prediction;
+        return true;
+    }
+    virtual void update(const HierarchicalQP &hierarchical_qp, const WarmStart &solution){
+        n_updates++;
+        last_solution = solution;
+    }
+    WarmStart prediction, last_solution;
+    uint n_updates;
+};
+
+BOOST_AUTO_TEST_CASE(solver_box_qp_warm_start_predictor)
+{
+    /**
+     * A correctly predicted active set should be used as warm start, so that no active set changes are required. A wrong prediction must not affect the solution.
+     */
+
+    const uint NO_JOINTS = 10;
+    const uint NO_EQ_CONSTRAINTS = 4;
+
+    wbc::HierarchicalQP hqp = randomQP(NO_JOINTS, NO_EQ_CONSTRAINTS, 0.05);
+    BoxQPSolver reference_solver;
+    base::VectorXd solver_output, reference_output;
+    reference_solver.solve(hqp, reference_output);
+    BOOST_CHECK(reference_solver.getNoIterations() > 0);
+
+    WarmStart prediction;
+    Eigen::VectorXi active_constraints;
+    reference_solver.getActiveSet(active_constraints, prediction.active_bounds);
+
+    BoxQPSolver solver;
+    BOOST_CHECK(solver.supportsWarmStart());
+    std::shared_ptr<FixedPredictor> predictor = std::make_shared<FixedPredictor>(prediction);
+    solver.setWarmStartPredictor(predictor);
+    BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+    BOOST_CHECK(solver.getNoIterations() == 0);
+    for(uint i = 0; i < NO_JOINTS; i++)
+        BOOST_CHECK(fabs(solver_output(i) - reference_output(i)) < 1e-9);
+    BOOST_CHECK(predictor->n_updates == 1);
+    BOOST_CHECK(predictor->last_solution.x == solver_output);
+    BOOST_CHECK(predictor->last_solution.active_bounds == prediction.active_bounds);
+
+    // Wrong prediction
+    predictor->prediction.active_bounds.setConstant(NO_JOINTS, ACTIVE_SET_UPPER);
+    BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+    for(uint i = 0; i < NO_JOINTS; i++)
+        BOOST_CHECK(fabs(solver_output(i) - reference_output(i)) < 1e-9);
+
+    // Prediction with wrong size is ignored
+    predictor->prediction.active_bounds.setConstant(NO_JOINTS+1, ACTIVE_SET_UPPER);
+    BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+    for(uint i = 0; i < NO_JOINTS; i++)
+        BOOST_CHECK(fabs(solver_output(i) - reference_output(i)) < 1e-9);
+}
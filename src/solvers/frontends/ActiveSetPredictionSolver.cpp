@@ -0,0 +1,156 @@
+#include "ActiveSetPredictionSolver.hpp"
+#include "../../core/QuadraticProgram.hpp"
+#include <stdexcept>
+
+namespace wbc{
+
+ActiveSetPredictionSolver::ActiveSetPredictionSolver(QPSolverPtr backend, const double tolerance) :
+    backend(backend),
+    prediction_hit(false),
+    has_prediction(false),
+    n_solves(0),
+    n_hits(0){
+    if(!backend)
+        throw std::invalid_argument("ActiveSetPredictionSolver: Backend solver must not be null");
+    setTolerance(tolerance);
+}
+
+ActiveSetPredictionSolver::~ActiveSetPredictionSolver(){
+}
+
+void ActiveSetPredictionSolver::setTolerance(const double tol){
+    if(tol < 0)
+        throw std::invalid_argument("ActiveSetPredictionSolver: Tolerance has to be >= 0");
+    tolerance = tol;
+}
+
+void ActiveSetPredictionSolver::reset(){
+    QPSolver::reset();
+    backend->reset();
+    has_prediction = false;
+}
+
+bool ActiveSetPredictionSolver::getActiveSet(Eigen::VectorXi &constraints, Eigen::VectorXi &bounds){
+    if(!has_prediction)
+        return false;
+    constraints = active_constraints;
+    bounds = active_bounds;
+    return true;
+}
+
+bool ActiveSetPredictionSolver::solvePredicted(const wbc::QuadraticProgram &qp, base::VectorXd &x){
+
+    // The problem structure might have changed since the last cycle
+    if(active_constraints.size() != qp.nin || active_bounds.size() != (qp.bounded ? qp.nq : 0))
+        return false;
+
+    llt.compute(qp.H);
+    if(llt.info() != Eigen::Success)
+        return false;
+
+    // Stack equalities, active constraints and active bounds into a single equality constraint A_active*x = b_active.
+    // status stores the side of each active row (0 for equalities)
+    const int m = qp.neq + (active_constraints.array() != 0).count() + (active_bounds.array() != 0).count();
+    A_active.resize(m, qp.nq);
+    b_active.resize(m);
+    status.resize(m);
+    A_active.topRows(qp.neq) = qp.A;
+    b_active.head(qp.neq) = qp.b;
+    status.head(qp.neq).setZero();
+    int k = qp.neq;
+    for(int i = 0; i < active_constraints.size(); i++){
+        if(active_constraints[i] == ACTIVE_SET_INACTIVE)
+            continue;
+        A_active.row(k) = qp.C.row(i);
+        b_active[k] = active_constraints[i] == ACTIVE_SET_LOWER ? qp.lower_y[i] : qp.upper_y[i];
+        status[k] = qp.upper_y[i] - qp.lower_y[i] <= tolerance ? 0 : active_constraints[i];
+        k++;
+    }
+    for(int i = 0; i < active_bounds.size(); i++){
+        if(active_bounds[i] == ACTIVE_SET_INACTIVE)
+            continue;
+        A_active.row(k).setZero();
+        A_active(k,i) = 1;
+        b_active[k] = active_bounds[i] == ACTIVE_SET_LOWER ? qp.lower_x[i] : qp.upper_x[i];
+        status[k] = qp.upper_x[i] - qp.lower_x[i] <= tolerance ? 0 : active_bounds[i];
+        k++;
+    }
+
+    // Unconstrained minimum: x0 = -H^-1 * g
+    x0 = -qp.g;
+    llt.solveInPlace(x0);
+
+    if(m > 0){
+        // KKT conditions: H*x + g + A^T*lambda = 0, A*x = b. Eliminating x gives
+        // (A*H^-1*A^T) * lambda = A*x0 - b, x = x0 - H^-1*A^T*lambda.
+        // LDLT is used for the Schur complement, since the active rows may be linearly dependent
+        Hinv_At = A_active.transpose();
+        llt.solveInPlace(Hinv_At);
+        schur.noalias() = A_active * Hinv_At;
+        schur_ldlt.compute(schur);
+        lambda.noalias() = A_active * x0;
+        lambda -= b_active;
+        lambda = schur_ldlt.solve(lambda);
+        x.noalias() = x0 - Hinv_At * lambda;
+
+        // Active rows might be inconsistent
+        if(((A_active * x - b_active).array().abs() > tolerance).any())
+            return false;
+
+        // Dual feasibility: lambda >= 0 for rows active at the upper bound, lambda <= 0 for rows active at the lower bound
+        if((status.cast<double>().array() * lambda.array() < -tolerance).any())
+            return false;
+    }
+    else
+        x = x0;
+
+    // Primal feasibility of all inequality constraints and bounds
+    return isFeasible(qp, x, tolerance);
+}
+
+void ActiveSetPredictionSolver::updatePrediction(const wbc::QuadraticProgram &qp, const base::VectorXd &x){
+
+    has_prediction = true;
+    if(backend->getActiveSet(active_constraints, active_bounds)){
+        if(!qp.bounded)
+            active_bounds.resize(0);
+        return;
+    }
+
+    // Backend does not report its active set: Estimate it from the primal solution
+    estimateActiveSet(qp, x, tolerance, active_constraints, active_bounds);
+}
+
+void ActiveSetPredictionSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output){
+
+    n_solves++;
+    prediction_hit = false;
+
+    if(hierarchical_qp.size() != 1){
+        has_prediction = false;
+        backend->solve(hierarchical_qp, solver_output);
+        return;
+    }
+
+    const wbc::QuadraticProgram &qp = hierarchical_qp[0];
+    if(predictWarmStart(hierarchical_qp) && warm_start.hasActiveSet(qp)){
+        active_constraints = warm_start.active_constraints;
+        active_bounds = warm_start.active_bounds;
+        has_prediction = true;
+    }
+    if(has_prediction){
+        solver_output.resize(qp.nq);
+        if(solvePredicted(qp, solver_output)){
+            prediction_hit = true;
+            n_hits++;
+            updateWarmStartPredictor(hierarchical_qp, solver_output);
+            return;
+        }
+    }
+
+    backend->solve(hierarchical_qp, solver_output);
+    updatePrediction(qp, solver_output);
+    updateWarmStartPredictor(hierarchical_qp, solver_output);
+}
+
+}
@@ -0,0 +1,99 @@
+#ifndef WBC_SOLVERS_ACTIVE_SET_PREDICTION_SOLVER_HPP
+#define WBC_SOLVERS_ACTIVE_SET_PREDICTION_SOLVER_HPP
+
+#include "../../core/QPSolver.hpp"
+#include <Eigen/Cholesky>
+
+namespace wbc{
+
+class HierarchicalQP;
+class QuadraticProgram;
+
+/**
+ * @brief Solver front-end that predicts the active set of the current QP from the solution of the previous cycle. The active inequality constraints and bounds
+ * are treated as equalities and the resulting equality constrained problem is solved directly from its KKT conditions, using a Cholesky decomposition of H and
+ * the Schur complement of the active constraints. The solution is accepted if
+ *   - it fulfills all inequality constraints and bounds (primal feasibility) and
+ *   - the Lagrange multipliers of the active constraints have the correct sign, i.e., >= 0 for constraints active at the upper bound and <= 0 for constraints
+ *     active at the lower bound (dual feasibility).
+ * Together with the stationarity condition, which is fulfilled by construction, these are the KKT conditions of the full QP, so the accepted solution is optimal.
+ * Otherwise the QP is passed to the backend solver, which should be able to warm start from its previous solution (e.g. qpoases). After each backend call, the
+ * active set is taken from the backend (see QPSolver::getActiveSet()). If the backend does not report its active set, it is estimated from the primal solution.
+ *
+ * Since the front-end requires a backend solver, it is not registered in the QPSolverFactory, e.g. use
+ * \code
+ *     QPSolverPtr solver = std::make_shared<ActiveSetPredictionSolver>(std::make_shared<QPOASESSolver>());
+ * \endcode
+ */
+class ActiveSetPredictionSolver : public QPSolver{
+public:
+    /**
+     * @param backend Solver that is used if the predicted active set is wrong
+     * @param tolerance Allowed violation of constraints, bounds and dual signs
+     */
+    ActiveSetPredictionSolver(QPSolverPtr backend, const double tolerance = 1e-9);
+    virtual ~ActiveSetPredictionSolver();
+
+    /**
+     * @brief solve Solve the given quadratic program
+     * @param hierarchical_qp Description of the hierarchical quadratic program to solve. Hierarchical QPs with more than one priority are directly passed to the backend.
+     * @param solver_output solution of the quadratic program
+     */
+    virtual void solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output);
+
+    /** The active set predicted by the warm start predictor replaces the active set of the last solution. Can be used to provide predicted active sets for backends that do not support warm starts*/
+    virtual bool supportsWarmStart(){return true;}
+
+    /** Return the predicted active set, i.e. the active set of the last solution*/
+    virtual bool getActiveSet(Eigen::VectorXi &constraints, Eigen::VectorXi &bounds);
+
+    /** Enforce reconfiguration of the backend at the next call to solve() and forget the current active set*/
+    virtual void reset();
+
+    /** Return the backend solver*/
+    QPSolverPtr getBackend(){return backend;}
+
+    /** Set the allowed violation of constraints, bounds and dual signs*/
+    void setTolerance(const double tol);
+
+    /** Get the allowed violation of constraints, bounds and dual signs*/
+    double getTolerance(){return tolerance;}
+
+    /** True if the predicted active set was correct in the last call to solve(), i.e., the backend has not been called*/
+    bool predictionHit(){return prediction_hit;}
+
+    /** Number of calls to solve() since construction or last call to resetCounters()*/
+    uint getNoSolves(){return n_solves;}
+
+    /** Number of calls to solve() with correctly predicted active set since construction or last call to resetCounters()*/
+    uint getNoHits(){return n_hits;}
+
+    /** Ratio of correctly predicted active sets and calls to solve(). Zero if solve() has not been called yet*/
+    double getHitRate(){return n_solves == 0 ? 0 : (double)n_hits / n_solves;}
+
+    /** Set all counters to zero*/
+    void resetCounters(){n_solves = n_hits = 0;}
+
+    /** Forget the current active set. The next call to solve() will use the backend solver*/
+    void resetPrediction(){has_prediction = false;}
+
+protected:
+    /** Solve the QP with the predicted active set. Return false if the solution violates any of the KKT conditions*/
+    bool solvePredicted(const wbc::QuadraticProgram &qp, base::VectorXd &x);
+    /** Update the predicted active set after a call to the backend solver*/
+    void updatePrediction(const wbc::QuadraticProgram &qp, const base::VectorXd &x);
+
+    QPSolverPtr backend;
+    double tolerance;
+    bool prediction_hit, has_prediction;
+    uint n_solves, n_hits;
+
+    Eigen::VectorXi active_constraints, active_bounds, status;
+    Eigen::LLT<Eigen::MatrixXd> llt;
+    Eigen::LDLT<Eigen::MatrixXd> schur_ldlt;
+    Eigen::MatrixXd A_active, Hinv_At, schur;
+    Eigen::VectorXd b_active, x0, lambda;
+};
+
+}
+#endif
@@ -0,0 +1,163 @@
+#include "ContactSwitchSolver.hpp"
+#include "../../core/RobotModel.hpp"
+#include <base-logging/Logging.hpp>
+#include <stdexcept>
+#include <chrono>
+
+namespace wbc{
+
+ContactSwitchSolver::ContactSwitchSolver(BackendFactory create_backend) :
+    create_backend(create_backend),
+    setup_in_solve(false),
+    n_solves(0),
+    n_swaps(0),
+    n_setups(0){
+    if(!create_backend)
+        throw std::invalid_argument("ContactSwitchSolver: Backend factory must not be empty");
+}
+
+ContactSwitchSolver::~ContactSwitchSolver(){
+    if(pending.valid())
+        pending.wait();
+}
+
+ContactSwitchSolver::Structure ContactSwitchSolver::structure(const wbc::HierarchicalQP &hqp){
+    Structure s;
+    s.push_back(hqp.size());
+    for(size_t i = 0; i < hqp.size(); i++){
+        s.push_back(hqp[i].nq);
+        s.push_back(hqp[i].neq);
+        s.push_back(hqp[i].nin);
+        s.push_back(hqp[i].bounded);
+    }
+    return s;
+}
+
+bool ContactSwitchSolver::hasStructure(const wbc::HierarchicalQP &hqp, const Structure &s){
+    if(s.size() != 1 + 4*hqp.size() || s[0] != (int)hqp.size())
+        return false;
+    for(size_t i = 0; i < hqp.size(); i++){
+        if(s[1+4*i] != (int)hqp[i].nq || s[2+4*i] != (int)hqp[i].neq || s[3+4*i] != (int)hqp[i].nin || s[4+4*i] != (int)hqp[i].bounded)
+            return false;
+    }
+    return true;
+}
+
+bool ContactSwitchSolver::preparationRunning(){
+    collectPreparation(false);
+    return pending.valid();
+}
+
+bool ContactSwitchSolver::collectPreparation(bool blocking){
+    if(!pending.valid())
+        return false;
+    if(!blocking && pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return false;
+    try{
+        // Keep an existing backend, e.g. if the structure has been set up synchronously in the meantime
+        QPSolverPtr prepared = pending.get();
+        backends.emplace(pending_structure, prepared);
+    }
+    catch(const std::exception &e){
+        LOG_ERROR("ContactSwitchSolver: Preparation of backend failed: %s", e.what());
+        return false;
+    }
+    return true;
+}
+
+bool ContactSwitchSolver::prepare(const wbc::HierarchicalQP &hierarchical_qp){
+    bool running = preparationRunning();
+    if(running && hasStructure(hierarchical_qp, pending_structure))
+        return true;
+    Structure s = structure(hierarchical_qp);
+    if(backends.count(s))
+        return true;
+    if(running)
+        return false;
+
+    // The background thread only works on its own copy of the QP and on the new backend instance, the result is handed over by the future
+    std::shared_ptr<wbc::HierarchicalQP> hqp = std::make_shared<wbc::HierarchicalQP>(hierarchical_qp);
+    BackendFactory factory = create_backend;
+    pending_structure = s;
+    pending = std::async(std::launch::async, [factory, hqp](){
+        QPSolverPtr solver = factory();
+        base::VectorXd solver_output;
+        solver->solve(*hqp, solver_output);
+        return solver;
+    });
+    return true;
+}
+
+bool ContactSwitchSolver::prepare(ScenePtr scene, const ActiveContacts &contacts){
+    if(preparationRunning())
+        return false;
+    RobotModelPtr robot_model = scene->getRobotModel();
+    ActiveContacts current_contacts = robot_model->getActiveContacts();
+    wbc::HierarchicalQP hqp;
+    robot_model->setActiveContacts(contacts);
+    try{
+        hqp = scene->update();
+    }
+    catch(...){
+        robot_model->setActiveContacts(current_contacts);
+        throw;
+    }
+    robot_model->setActiveContacts(current_contacts);
+    scene->update();
+    return prepare(hqp);
+}
+
+bool ContactSwitchSolver::waitForPreparation(){
+    return collectPreparation(true);
+}
+
+bool ContactSwitchSolver::isPrepared(const wbc::HierarchicalQP &hierarchical_qp){
+    collectPreparation(false);
+    return backends.count(structure(hierarchical_qp)) > 0;
+}
+
+void ContactSwitchSolver::clear(){
+    collectPreparation(true);
+    backends.clear();
+    backend.reset();
+    current_structure.clear();
+}
+
+void ContactSwitchSolver::reset(){
+    QPSolver::reset();
+    clear();
+}
+
+bool ContactSwitchSolver::getActiveSet(Eigen::VectorXi &constraints, Eigen::VectorXi &bounds){
+    if(!backend)
+        return false;
+    return backend->getActiveSet(constraints, bounds);
+}
+
+void ContactSwitchSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output){
+
+    n_solves++;
+    setup_in_solve = false;
+    collectPreparation(false);
+
+    // Compare with the current structure first, the structure key is only built (and looked up) if the structure has changed
+    if(!backend || !hasStructure(hierarchical_qp, current_structure)){
+        Structure s = structure(hierarchical_qp);
+        auto it = backends.find(s);
+        if(it != backends.end()){
+            backend = it->second;
+            n_swaps++;
+        }
+        else{
+            // Structure has not been prepared (or preparation is still running): Set up a new backend, as without the front-end
+            backend = create_backend();
+            backends[s] = backend;
+            setup_in_solve = true;
+            n_setups++;
+        }
+        current_structure = s;
+    }
+    backend->solve(hierarchical_qp, solver_output);
+}
+
+}
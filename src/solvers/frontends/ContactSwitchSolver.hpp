@@ -0,0 +1,131 @@
+#ifndef WBC_SOLVERS_CONTACT_SWITCH_SOLVER_HPP
+#define WBC_SOLVERS_CONTACT_SWITCH_SOLVER_HPP
+
+#include "../../core/QPSolver.hpp"
+#include "../../core/QuadraticProgram.hpp"
+#include "../../core/Scene.hpp"
+#include <functional>
+#include <future>
+
+namespace wbc{
+
+/**
+ * @brief Solver front-end that avoids the latency spike of the QP solver at contact switches. If the active contacts change (RobotModel::setActiveContacts()), the number of
+ * contact constraints in the QP of the TSID scenes changes. Solvers with a fixed problem structure then have to re-run their setup (e.g. OSQP), re-initialize (e.g. qpOASES, which
+ * also loses its working set) or fail (e.g. ProxQP). This front-end keeps one backend instance per problem structure (number of priorities and nq, neq, nin, bounded of each priority):
+ *   - An upcoming contact set can be announced with prepare(), e.g. when the swing foot is about to touch down. The QP of the scene for this contact set is built and a new backend
+ *     is created and solved once for this QP on a background thread. This sets up the solver workspace and warm-starts the backend with the solution of the anticipated QP.
+ *   - In solve(), the backend is selected by the structure of the given QP. At the actual contact switch, this is a swap of the backend pointer. Backends of previous structures are
+ *     kept, so that switching back (e.g. during walking) does not require a new setup either.
+ *   - If a structure has not been prepared, or if the preparation has not finished yet, a new backend is set up synchronously, as without the front-end.
+ * The backend instances are created with the given function, e.g.
+ * \code
+ *     ContactSwitchSolver solver([](){return std::make_shared<QPOASESSolver>();});
+ *     ...
+ *     solver.prepare(scene, next_contacts); // some cycles before the contact switch
+ *     ...
+ *     robot_model->setActiveContacts(next_contacts);
+ *     scene->solve(scene->update());      // uses the prepared backend
+ * \endcode
+ * Since the front-end requires a backend solver, it is not registered in the QPSolverFactory.
+ */
+class ContactSwitchSolver : public QPSolver{
+public:
+    typedef std::function<QPSolverPtr()> BackendFactory;
+
+    /**
+     * @param create_backend Function that creates a new, unconfigured instance of the backend solver, including all solver options. Called from the background thread in prepare()
+     */
+    ContactSwitchSolver(BackendFactory create_backend);
+    virtual ~ContactSwitchSolver();
+
+    /**
+     * @brief solve Solve the given quadratic program with the backend that has been set up for its structure, see class documentation
+     * @param hierarchical_qp Description of the hierarchical quadratic program to solve
+     * @param solver_output solution of the quadratic program
+     */
+    virtual void solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output);
+
+    /** Return the active set of the backend that solved the last QP*/
+    virtual bool getActiveSet(Eigen::VectorXi &constraints, Eigen::VectorXi &bounds);
+
+    /** Delete all backends (see clear()), e.g. after reconfiguration of the scene. The backends of the new configuration are set up at the next call to solve() or by prepare()*/
+    virtual void reset();
+
+    /**
+     * @brief Set up a backend for the structure of the given QP on a background thread and solve it once for warm start. Does nothing if a backend for
+     * this structure exists already or is being prepared. The call never waits for the background thread, but it is not free: The QP is copied for
+     * the background thread and a new thread is started, both of which allocate memory. Call it some cycles ahead of the contact switch, not in every cycle.
+     * @return False if another preparation is still running. The request is ignored in this case and can be repeated in a later cycle
+     */
+    bool prepare(const wbc::HierarchicalQP &hierarchical_qp);
+
+    /**
+     * @brief Build the QP of the given scene for the given contact set and set up a backend for it on a background thread, see prepare(const HierarchicalQP&).
+     * The QP is built on the calling thread, since the robot model and scene are not thread-safe. Cost and side effects:
+     *   - Scene::update() is called twice, once with the given contacts and once with the current contacts, to restore the QP of the scene. This doubles the
+     *     update cost of the scene in this cycle (the robot model itself is not updated).
+     *   - The active contacts of the robot model are restored afterwards, also if the first update throws.
+     *   - All data computed by Scene::update() (task status, QP, timestamps) is recomputed for the current contacts, i.e., a HierarchicalQP reference obtained
+     *     from Scene::update() before this call stays valid.
+     * If the second update does not fit into the cycle, build the QP for the upcoming contacts at a convenient time and use prepare(const HierarchicalQP&) instead.
+     * @return False if another preparation is still running, see prepare(const HierarchicalQP&). The scene is not updated in this case
+     */
+    bool prepare(ScenePtr scene, const ActiveContacts &contacts);
+
+    /** Block until a running preparation has finished. Return true if it was successful, false if it failed or if there was no preparation*/
+    bool waitForPreparation();
+
+    /** True if a backend has been set up for the structure of the given QP*/
+    bool isPrepared(const wbc::HierarchicalQP &hierarchical_qp);
+
+    /** True if the last call to solve() had to set up a new backend synchronously*/
+    bool setupInSolve(){return setup_in_solve;}
+
+    /** Return the backend that solved the last QP. Null before the first call to solve()*/
+    QPSolverPtr getBackend(){return backend;}
+
+    /** Number of backends, i.e., problem structures, that have been set up*/
+    uint getNoBackends(){return backends.size();}
+
+    /** Number of calls to solve() since construction or last call to resetCounters()*/
+    uint getNoSolves(){return n_solves;}
+
+    /** Number of structure changes in solve() that used an existing backend since construction or last call to resetCounters()*/
+    uint getNoSwaps(){return n_swaps;}
+
+    /** Number of calls to solve() that had to set up a new backend since construction or last call to resetCounters()*/
+    uint getNoSetups(){return n_setups;}
+
+    /** Set all counters to zero*/
+    void resetCounters(){n_solves = n_swaps = n_setups = 0;}
+
+    /** Wait for a running preparation and delete all backends*/
+    void clear();
+
+protected:
+    typedef std::vector<int> Structure;
+
+    /** Compute the structure key of the given QP*/
+    static Structure structure(const wbc::HierarchicalQP &hqp);
+    /** True if the given QP has the given structure. Does not allocate, unlike structure()*/
+    static bool hasStructure(const wbc::HierarchicalQP &hqp, const Structure &s);
+    /** True if a preparation has been started and its result has not been collected yet*/
+    bool preparationRunning();
+    /** Move the result of a finished preparation into the backends. If blocking is false, a running preparation is not awaited. Return false if the preparation failed*/
+    bool collectPreparation(bool blocking);
+
+    BackendFactory create_backend;
+    std::map<Structure, QPSolverPtr> backends;
+    QPSolverPtr backend;
+    Structure current_structure;
+    bool setup_in_solve;
+    uint n_solves, n_swaps, n_setups;
+
+    /** Running preparation: Structure and backend under construction*/
+    std::future<QPSolverPtr> pending;
+    Structure pending_structure;
+};
+
+}
+#endif
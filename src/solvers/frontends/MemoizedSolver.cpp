@@ -0,0 +1,133 @@
+#include "MemoizedSolver.hpp"
+#include <stdexcept>
+#include <cmath>
+
+namespace wbc{
+
+template<typename Derived>
+static void addBlock(const Eigen::DenseBase<Derived> &block, std::vector<int> &dims, std::vector<double> &norms, std::vector<double> &sizes){
+    dims.push_back(block.rows());
+    dims.push_back(block.cols());
+    norms.push_back(block.size() == 0 ? 0 : block.derived().cwiseAbs().sum());
+    sizes.push_back(block.size());
+}
+
+template<typename Derived>
+static bool equalWithin(const Eigen::DenseBase<Derived> &a, const Eigen::DenseBase<Derived> &b, const double tol){
+    if(a.rows() != b.rows() || a.cols() != b.cols())
+        return false;
+    // Exact equality covers +-inf, which would otherwise yield NaN differences
+    return ((a.derived().array() == b.derived().array()) || ((a.derived() - b.derived()).array().abs() <= tol)).all();
+}
+
+MemoizedSolver::MemoizedSolver(QPSolverPtr backend, const double tolerance) :
+    backend(backend),
+    max_consecutive_hits(0),
+    consecutive_hits(0),
+    cache_hit(false),
+    has_cache(false),
+    n_solves(0),
+    n_hits(0){
+    if(!backend)
+        throw std::invalid_argument("MemoizedSolver: Backend solver must not be null");
+    setTolerance(tolerance);
+}
+
+MemoizedSolver::~MemoizedSolver(){
+}
+
+void MemoizedSolver::reset(){
+    QPSolver::reset();
+    backend->reset();
+    has_cache = false;
+}
+
+void MemoizedSolver::setTolerance(const double tol){
+    if(tol < 0)
+        throw std::invalid_argument("MemoizedSolver: Tolerance has to be >= 0");
+    tolerance = tol;
+}
+
+void MemoizedSolver::fingerprint(const wbc::HierarchicalQP &hqp, Fingerprint &fp){
+    fp.dims.clear();
+    fp.norms.clear();
+    fp.sizes.clear();
+    fp.dims.push_back(hqp.size());
+    addBlock(hqp.Wq, fp.dims, fp.norms, fp.sizes);
+    for(size_t i = 0; i < hqp.size(); i++){
+        const wbc::QuadraticProgram &qp = hqp[i];
+        fp.dims.push_back(qp.nq);
+        fp.dims.push_back(qp.neq);
+        fp.dims.push_back(qp.nin);
+        fp.dims.push_back(qp.bounded);
+        addBlock(qp.H, fp.dims, fp.norms, fp.sizes);
+        addBlock(qp.g, fp.dims, fp.norms, fp.sizes);
+        addBlock(qp.A, fp.dims, fp.norms, fp.sizes);
+        addBlock(qp.b, fp.dims, fp.norms, fp.sizes);
+        addBlock(qp.C, fp.dims, fp.norms, fp.sizes);
+        addBlock(qp.lower_y, fp.dims, fp.norms, fp.sizes);
+        addBlock(qp.upper_y, fp.dims, fp.norms, fp.sizes);
+        addBlock(qp.lower_x, fp.dims, fp.norms, fp.sizes);
+        addBlock(qp.upper_x, fp.dims, fp.norms, fp.sizes);
+        addBlock(qp.Wy, fp.dims, fp.norms, fp.sizes);
+    }
+}
+
+bool MemoizedSolver::isUnchanged(const wbc::HierarchicalQP &hqp){
+
+    // Fingerprint: Dimensions have to match exactly. The sums of absolute values of two blocks with n entries, whose entries differ by at most
+    // the tolerance, differ by at most n*tolerance. NaN sums (e.g. from infinite bounds) pass this test and are handled by the element-wise comparison
+    if(current_fingerprint.dims != cached_fingerprint.dims)
+        return false;
+    for(size_t i = 0; i < current_fingerprint.norms.size(); i++){
+        if(std::abs(current_fingerprint.norms[i] - cached_fingerprint.norms[i]) > current_fingerprint.sizes[i] * tolerance)
+            return false;
+    }
+
+    // Max-abs-delta
+    if(!equalWithin(hqp.Wq, cached_qp.Wq, tolerance))
+        return false;
+    for(size_t i = 0; i < hqp.size(); i++){
+        const wbc::QuadraticProgram &qp = hqp[i];
+        const wbc::QuadraticProgram &cached = cached_qp[i];
+        if(!equalWithin(qp.H, cached.H, tolerance) ||
+           !equalWithin(qp.g, cached.g, tolerance) ||
+           !equalWithin(qp.A, cached.A, tolerance) ||
+           !equalWithin(qp.b, cached.b, tolerance) ||
+           !equalWithin(qp.C, cached.C, tolerance) ||
+           !equalWithin(qp.lower_y, cached.lower_y, tolerance) ||
+           !equalWithin(qp.upper_y, cached.upper_y, tolerance) ||
+           !equalWithin(qp.lower_x, cached.lower_x, tolerance) ||
+           !equalWithin(qp.upper_x, cached.upper_x, tolerance) ||
+           !equalWithin(qp.Wy, cached.Wy, tolerance))
+            return false;
+    }
+    return true;
+}
+
+void MemoizedSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output){
+
+    n_solves++;
+    cache_hit = false;
+
+    fingerprint(hierarchical_qp, current_fingerprint);
+    if(has_cache && (max_consecutive_hits == 0 || consecutive_hits < max_consecutive_hits) && isUnchanged(hierarchical_qp)){
+        solver_output = cached_solution;
+        cache_hit = true;
+        consecutive_hits++;
+        n_hits++;
+        return;
+    }
+
+    // Invalidate the cache first, in case the backend throws
+    has_cache = false;
+    consecutive_hits = 0;
+    backend->solve(hierarchical_qp, solver_output);
+
+    cached_qp = hierarchical_qp;
+    cached_solution = solver_output;
+    std::swap(cached_fingerprint, current_fingerprint);
+    has_cache = true;
+}
+
+}
@@ -0,0 +1,100 @@
+#ifndef WBC_SOLVERS_MEMOIZED_SOLVER_HPP
+#define WBC_SOLVERS_MEMOIZED_SOLVER_HPP
+
+#include "../../core/QPSolver.hpp"
+#include "../../core/QuadraticProgram.hpp"
+
+namespace wbc{
+
+/**
+ * @brief Solver front-end that skips the backend solver if the QP did not change since the last solve. This is typically the case if the robot holds a static posture
+ * with constant references. The current QP is compared with the last QP that was actually passed to the backend:
+ *   - Fingerprint: The problem dimensions and the sum of absolute values of each block (H, g, A, b, C, bounds, weights) are compared first. This rejects clearly
+ *     different problems without an element-wise comparison, since \f$||a|_1 - |b|_1| \leq n \cdot max|a_i-b_i|\f$.
+ *   - Max-abs-delta: If the fingerprints match, all entries are compared element-wise. Entries that are equal (including +-inf) or differ by at most the
+ *     given tolerance are considered unchanged. NaN entries are always considered changed.
+ * If the QP is unchanged, the cached solution is returned. Since the comparison is done against the last solved QP and not against the QP of the previous cycle,
+ * slow drifts of the QP will eventually trigger a new solve.
+ *
+ * Since the front-end requires a backend solver, it is not registered in the QPSolverFactory, e.g. use
+ * \code
+ *     QPSolverPtr solver = std::make_shared<MemoizedSolver>(std::make_shared<QPOASESSolver>(), 1e-9);
+ * \endcode
+ */
+class MemoizedSolver : public QPSolver{
+public:
+    /**
+     * @param backend Solver that is used if the QP has changed
+     * @param tolerance Maximum absolute difference of each QP entry that is considered unchanged
+     */
+    MemoizedSolver(QPSolverPtr backend, const double tolerance = 1e-9);
+    virtual ~MemoizedSolver();
+
+    /**
+     * @brief solve Solve the given quadratic program or return the cached solution if the QP did not change
+     * @param hierarchical_qp Description of the hierarchical quadratic program to solve
+     * @param solver_output solution of the quadratic program
+     */
+    virtual void solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output);
+
+    /** Return the active set of the backend, i.e., the active set of the cached solution*/
+    virtual bool getActiveSet(Eigen::VectorXi &constraints, Eigen::VectorXi &bounds){return backend->getActiveSet(constraints, bounds);}
+
+    /** Enforce reconfiguration of the backend at the next call to solve() and invalidate the cached solution*/
+    virtual void reset();
+
+    /** Return the backend solver*/
+    QPSolverPtr getBackend(){return backend;}
+
+    /** Set the maximum absolute difference of each QP entry that is considered unchanged*/
+    void setTolerance(const double tol);
+
+    /** Get the maximum absolute difference of each QP entry that is considered unchanged*/
+    double getTolerance(){return tolerance;}
+
+    /** Set the maximum number of consecutive cache hits. After that, the backend is called even if the QP did not change. 0 (default) means no limit*/
+    void setMaxConsecutiveHits(const uint n){max_consecutive_hits = n;}
+
+    /** Get the maximum number of consecutive cache hits*/
+    uint getMaxConsecutiveHits(){return max_consecutive_hits;}
+
+    /** True if the last call to solve() returned the cached solution, i.e., the backend has not been called*/
+    bool cacheHit(){return cache_hit;}
+
+    /** Number of calls to solve() since construction or last call to resetCounters()*/
+    uint getNoSolves(){return n_solves;}
+
+    /** Number of calls to solve() that returned the cached solution since construction or last call to resetCounters()*/
+    uint getNoHits(){return n_hits;}
+
+    /** Set all counters to zero*/
+    void resetCounters(){n_solves = n_hits = 0;}
+
+    /** Invalidate the cached solution. The next call to solve() will use the backend solver*/
+    void resetCache(){has_cache = false;}
+
+protected:
+    /** Return true if the given QP equals the cached QP within tolerance*/
+    bool isUnchanged(const wbc::HierarchicalQP &hqp);
+    /** Fingerprint of a QP: Dimensions of the QP and all blocks, sum of absolute values of each block*/
+    struct Fingerprint{
+        std::vector<int> dims;
+        std::vector<double> norms;
+        std::vector<double> sizes;
+    };
+    /** Compute the fingerprint of the given QP*/
+    void fingerprint(const wbc::HierarchicalQP &hqp, Fingerprint &fp);
+
+    QPSolverPtr backend;
+    double tolerance;
+    uint max_consecutive_hits, consecutive_hits;
+    bool cache_hit, has_cache;
+    uint n_solves, n_hits;
+
+    wbc::HierarchicalQP cached_qp;
+    base::VectorXd cached_solution;
+    Fingerprint cached_fingerprint, current_fingerprint;
+};
+
+}
+#endif
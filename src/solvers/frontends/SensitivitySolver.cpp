@@ -0,0 +1,195 @@
+#include "SensitivitySolver.hpp"
+#include "../../core/QuadraticProgram.hpp"
+#include <stdexcept>
+
+namespace wbc{
+
+SensitivitySolver::SensitivitySolver(QPSolverPtr backend, const double tolerance) :
+    backend(backend),
+    max_extrapolations(0),
+    n_consecutive(0),
+    is_extrapolated(false),
+    has_sensitivity(false),
+    n_solves(0),
+    n_extrapolations(0),
+    n_backend_failures(0),
+    nq(0),
+    neq(0),
+    nin(0),
+    bounded(false),
+    n_active(0){
+    if(!backend)
+        throw std::invalid_argument("SensitivitySolver: Backend solver must not be null");
+    setTolerance(tolerance);
+}
+
+SensitivitySolver::~SensitivitySolver(){
+}
+
+void SensitivitySolver::reset(){
+    QPSolver::reset();
+    backend->reset();
+    has_sensitivity = false;
+}
+
+void SensitivitySolver::setTolerance(const double tol){
+    if(tol < 0)
+        throw std::invalid_argument("SensitivitySolver: Tolerance has to be >= 0");
+    tolerance = tol;
+}
+
+bool SensitivitySolver::getActiveSet(Eigen::VectorXi &constraints, Eigen::VectorXi &bounds){
+    if(!has_sensitivity)
+        return false;
+    constraints = active_constraints;
+    bounds = active_bounds;
+    return true;
+}
+
+bool SensitivitySolver::sameStructure(const wbc::QuadraticProgram &qp){
+    return qp.nq == nq && qp.neq == neq && qp.nin == nin && qp.bounded == bounded;
+}
+
+void SensitivitySolver::activeRhs(const wbc::QuadraticProgram &qp, base::VectorXd &b){
+    b.resize(n_active);
+    b.head(qp.neq) = qp.b;
+    int k = qp.neq;
+    for(int i = 0; i < active_constraints.size(); i++){
+        if(active_constraints[i] != ACTIVE_SET_INACTIVE)
+            b[k++] = active_constraints[i] == ACTIVE_SET_LOWER ? qp.lower_y[i] : qp.upper_y[i];
+    }
+    for(int i = 0; i < active_bounds.size(); i++){
+        if(active_bounds[i] != ACTIVE_SET_INACTIVE)
+            b[k++] = active_bounds[i] == ACTIVE_SET_LOWER ? qp.lower_x[i] : qp.upper_x[i];
+    }
+}
+
+bool SensitivitySolver::updateSensitivity(const wbc::QuadraticProgram &qp, const base::VectorXd &x){
+
+    if(!backend->getActiveSet(active_constraints, active_bounds))
+        estimateActiveSet(qp, x, tolerance, active_constraints, active_bounds);
+    if(!qp.bounded)
+        active_bounds.resize(0);
+
+    llt.compute(qp.H);
+    if(llt.info() != Eigen::Success)
+        return false;
+
+    // Stack equalities, active constraints and active bounds into the first rows of A_active
+    const int max_rows = qp.neq + qp.nin + (qp.bounded ? qp.nq : 0);
+    if(A_active.rows() != max_rows || A_active.cols() != (int)qp.nq)
+        A_active.resize(max_rows, qp.nq);
+    A_active.topRows(qp.neq) = qp.A;
+    int k = qp.neq;
+    for(int i = 0; i < active_constraints.size(); i++){
+        if(active_constraints[i] != ACTIVE_SET_INACTIVE)
+            A_active.row(k++) = qp.C.row(i);
+    }
+    for(int i = 0; i < active_bounds.size(); i++){
+        if(active_bounds[i] != ACTIVE_SET_INACTIVE){
+            A_active.row(k).setZero();
+            A_active(k++,i) = 1;
+        }
+    }
+    n_active = k;
+
+    // Factorize the Schur complement S = A*H^-1*A^T. LDLT is used, since the active rows may be linearly dependent
+    if(n_active > 0){
+        Hinv_At = A_active.topRows(n_active).transpose();
+        llt.solveInPlace(Hinv_At);
+        schur.noalias() = A_active.topRows(n_active) * Hinv_At;
+        schur_ldlt.compute(schur);
+    }
+
+    // Linearization point
+    x0 = x;
+    g0 = qp.g;
+    activeRhs(qp, b0);
+    nq = qp.nq;
+    neq = qp.neq;
+    nin = qp.nin;
+    bounded = qp.bounded;
+    return true;
+}
+
+const base::MatrixXd& SensitivitySolver::gradientSensitivity(){
+    if(!has_sensitivity){
+        dx_dg.resize(0,0);
+        return dx_dg;
+    }
+    // dx/dg = -H^-1 + H^-1*A^T*S^-1*A*H^-1
+    dx_dg.setIdentity(nq, nq);
+    llt.solveInPlace(dx_dg);
+    dx_dg *= -1;
+    if(n_active > 0)
+        dx_dg.noalias() += Hinv_At * schur_ldlt.solve(Hinv_At.transpose());
+    return dx_dg;
+}
+
+const base::MatrixXd& SensitivitySolver::activeConstraintSensitivity(){
+    if(!has_sensitivity){
+        dx_db.resize(0,0);
+        return dx_db;
+    }
+    // dx/db = H^-1*A^T*S^-1
+    if(n_active > 0)
+        dx_db = schur_ldlt.solve(Hinv_At.transpose()).transpose();
+    else
+        dx_db.resize(nq, 0);
+    return dx_db;
+}
+
+bool SensitivitySolver::extrapolate(const wbc::QuadraticProgram &qp, base::VectorXd &x){
+    if(!has_sensitivity || !sameStructure(qp))
+        return false;
+
+    // x = x0 + dx/dg*dg + dx/db*db = x0 - H^-1*dg + H^-1*A^T*S^-1*(A*H^-1*dg + db), see class documentation
+    delta_x = qp.g - g0;
+    llt.solveInPlace(delta_x);
+    x = x0 - delta_x;
+    if(n_active > 0){
+        activeRhs(qp, b_active);
+        lambda = b_active - b0;
+        lambda.noalias() += A_active.topRows(n_active) * delta_x;
+        schur_ldlt.solveInPlace(lambda);
+        x.noalias() += Hinv_At * lambda;
+    }
+    return true;
+}
+
+void SensitivitySolver::solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output){
+
+    n_solves++;
+    is_extrapolated = false;
+
+    if(hierarchical_qp.size() != 1){
+        has_sensitivity = false;
+        backend->solve(hierarchical_qp, solver_output);
+        return;
+    }
+
+    const wbc::QuadraticProgram &qp = hierarchical_qp[0];
+    if(n_consecutive < max_extrapolations && extrapolate(qp, solver_output) && isFeasible(qp, solver_output, tolerance)){
+        is_extrapolated = true;
+        n_consecutive++;
+        n_extrapolations++;
+        return;
+    }
+
+    try{
+        backend->solve(hierarchical_qp, solver_output);
+    }
+    catch(const std::exception&){
+        // Missed deadline or failed solve: Return the best available solution
+        if(!extrapolate(qp, solver_output))
+            throw;
+        is_extrapolated = true;
+        n_extrapolations++;
+        n_backend_failures++;
+        return;
+    }
+    n_consecutive = 0;
+    has_sensitivity = updateSensitivity(qp, solver_output);
+}
+
+}
@@ -0,0 +1,141 @@
+#ifndef WBC_SOLVERS_SENSITIVITY_SOLVER_HPP
+#define WBC_SOLVERS_SENSITIVITY_SOLVER_HPP
+
+#include "../../core/QPSolver.hpp"
+#include <Eigen/Cholesky>
+
+namespace wbc{
+
+class HierarchicalQP;
+class QuadraticProgram;
+
+/**
+ * @brief Solver front-end that computes the parametric sensitivity of the QP solution and uses it to extrapolate the solution between full solves of the backend.
+ * After each backend solve, the active inequality constraints and bounds are treated as equalities A_a*x = b_a (together with the equality constraints) and the
+ * KKT conditions H*x + g + A_a^T*lambda = 0, A_a*x = b_a are differentiated w.r.t. the gradient vector g and the right hand side b_a:
+ *  \f[
+ *        \frac{\partial \mathbf{x}}{\partial \mathbf{g}} = -\mathbf{H}^{-1} + \mathbf{H}^{-1}\mathbf{A}_a^T\mathbf{S}^{-1}\mathbf{A}_a\mathbf{H}^{-1}, \quad
+ *        \frac{\partial \mathbf{x}}{\partial \mathbf{b}_a} = \mathbf{H}^{-1}\mathbf{A}_a^T\mathbf{S}^{-1}, \quad \mathbf{S} = \mathbf{A}_a\mathbf{H}^{-1}\mathbf{A}_a^T
+ *  \f]
+ * After each backend solve, only the Cholesky factorization of H and the factorization of S are computed, the dense matrices are never formed in the control loop. The task references enter the QP of the scenes linearly through g
+ * (e.g. \f$\mathbf{g} = -\mathbf{J}_w^T\mathbf{y}_{ref,w}\f$), and the robot state mainly through g, b and the constraint bounds (e.g. bias forces, joint limits),
+ * so the derivative w.r.t. a task reference is obtained by the chain rule from dx/dg. Changes of H and the constraint matrices are neglected.
+ *
+ * In the following calls to solve(), the first-order corrected solution \f$\mathbf{x} = \mathbf{x}_0 + \frac{\partial \mathbf{x}}{\partial \mathbf{g}}\Delta\mathbf{g} +
+ * \frac{\partial \mathbf{x}}{\partial \mathbf{b}_a}\Delta\mathbf{b}_a\f$ is returned instead of calling the backend. It is obtained by applying the stored factorizations to
+ * \f$\Delta\mathbf{g}\f$ and \f$\Delta\mathbf{b}_a\f$, which costs O(nq^2) operations. This is done
+ *   - for at most max_extrapolations consecutive cycles (see setMaxExtrapolations()), as long as the problem structure does not change and the extrapolated solution fulfills
+ *     all inequality constraints and bounds, i.e., the active set does not change. Default is 0, i.e., the backend is called in every cycle.
+ *   - if the backend throws, e.g. because it exceeded its maximum number of working set recalculations or its CPU time (missed deadline). In this case the extrapolated
+ *     solution is returned even if it violates inequality constraints. If no sensitivity is available, the exception is rethrown.
+ * Since the scenes convert the raw solver output in Scene::solve(), the scene output is then the extrapolated solution.
+ *
+ * The active set is taken from the backend (see QPSolver::getActiveSet()). If the backend does not report its active set, it is estimated from the primal solution.
+ * Only single priority QPs are supported, hierarchical QPs are directly passed to the backend. Since the front-end requires a backend solver, it is not registered in the QPSolverFactory, e.g. use
+ * \code
+ *     QPSolverPtr solver = std::make_shared<SensitivitySolver>(std::make_shared<QPOASESSolver>());
+ * \endcode
+ */
+class SensitivitySolver : public QPSolver{
+public:
+    /**
+     * @param backend Solver that computes the full solution
+     * @param tolerance Allowed violation of constraints and bounds of the extrapolated solution. Also used to estimate the active set, if the backend does not report it
+     */
+    SensitivitySolver(QPSolverPtr backend, const double tolerance = 1e-9);
+    virtual ~SensitivitySolver();
+
+    /**
+     * @brief solve Solve the given quadratic program with the backend or return the extrapolated solution, see class documentation
+     * @param hierarchical_qp Description of the hierarchical quadratic program to solve
+     * @param solver_output solution of the quadratic program
+     */
+    virtual void solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output);
+
+    /** Return the active set of the last backend solution*/
+    virtual bool getActiveSet(Eigen::VectorXi &constraints, Eigen::VectorXi &bounds);
+
+    /**
+     * @brief Compute the first-order corrected solution of the given QP from the sensitivity of the last backend solution, without checking the constraints
+     * @return False if no sensitivity is available or if the problem structure has changed
+     */
+    bool extrapolate(const wbc::QuadraticProgram &qp, base::VectorXd &x);
+
+    /** True if a sensitivity is available, i.e., the last backend solve was successful*/
+    bool hasSensitivity(){return has_sensitivity;}
+
+    /** Derivative of the solution w.r.t. the gradient vector g of the QP (nq x nq), at the last backend solution. The matrix is computed from the stored
+      * factorizations in each call (O(nq^3)), it is not required for the extrapolation*/
+    const base::MatrixXd& gradientSensitivity();
+
+    /** Derivative of the solution w.r.t. the right hand side of the active constraints (nq x na), at the last backend solution.
+      * The active rows are ordered: equality constraints, active inequality constraints, active bounds. The matrix is computed from the stored
+      * factorizations in each call, it is not required for the extrapolation*/
+    const base::MatrixXd& activeConstraintSensitivity();
+
+    /** Enforce reconfiguration of the backend at the next call to solve() and discard the current sensitivities*/
+    virtual void reset();
+
+    /** Return the backend solver*/
+    QPSolverPtr getBackend(){return backend;}
+
+    /** Set the maximum number of consecutive cycles in which the extrapolated solution is returned instead of calling the backend. 0 (default) means that the
+      * extrapolation is only used if the backend throws*/
+    void setMaxExtrapolations(const uint n){max_extrapolations = n;}
+
+    /** Get the maximum number of consecutive extrapolations*/
+    uint getMaxExtrapolations(){return max_extrapolations;}
+
+    /** Set the allowed violation of constraints and bounds of the extrapolated solution*/
+    void setTolerance(const double tol);
+
+    /** Get the allowed violation of constraints and bounds of the extrapolated solution*/
+    double getTolerance(){return tolerance;}
+
+    /** True if the last call to solve() returned the extrapolated solution*/
+    bool extrapolated(){return is_extrapolated;}
+
+    /** Number of calls to solve() since construction or last call to resetCounters()*/
+    uint getNoSolves(){return n_solves;}
+
+    /** Number of calls to solve() that returned the extrapolated solution (including backend failures) since construction or last call to resetCounters()*/
+    uint getNoExtrapolations(){return n_extrapolations;}
+
+    /** Number of calls to solve() in which the backend threw and the extrapolated solution was returned since construction or last call to resetCounters()*/
+    uint getNoBackendFailures(){return n_backend_failures;}
+
+    /** Set all counters to zero*/
+    void resetCounters(){n_solves = n_extrapolations = n_backend_failures = 0;}
+
+    /** Invalidate the sensitivity. The next call to solve() will use the backend solver*/
+    void resetSensitivity(){has_sensitivity = false;}
+
+protected:
+    /** Factorize H and the Schur complement S at the given backend solution. Return false if H is not positive definite*/
+    bool updateSensitivity(const wbc::QuadraticProgram &qp, const base::VectorXd &x);
+    /** Stack the right hand side of the equality constraints and the active inequality constraints and bounds*/
+    void activeRhs(const wbc::QuadraticProgram &qp, base::VectorXd &b);
+    /** True if the given QP has the same structure as the QP of the last backend solve*/
+    bool sameStructure(const wbc::QuadraticProgram &qp);
+
+    QPSolverPtr backend;
+    double tolerance;
+    uint max_extrapolations, n_consecutive;
+    bool is_extrapolated, has_sensitivity;
+    uint n_solves, n_extrapolations, n_backend_failures;
+    int nq, neq, nin;
+    bool bounded;
+    /** Number of active rows, i.e., equality constraints, active inequality constraints and active bounds*/
+    int n_active;
+
+    Eigen::VectorXi active_constraints, active_bounds;
+    Eigen::LLT<Eigen::MatrixXd> llt;
+    Eigen::LDLT<Eigen::MatrixXd> schur_ldlt;
+    /** Active rows in the first n_active rows. Allocated for the max. number of active rows (nq x (neq + nin + nq))*/
+    Eigen::MatrixXd A_active;
+    Eigen::MatrixXd Hinv_At, schur, dx_dg, dx_db;
+    Eigen::VectorXd x0, g0, b0, b_active, delta_x, lambda;
+};
+
+}
+#endif
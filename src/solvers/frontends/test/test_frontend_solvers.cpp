@@ -0,0 +1,334 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "solvers/frontends/MemoizedSolver.hpp"
+#include "solvers/frontends/SensitivitySolver.hpp"
+#include "solvers/frontends/ContactSwitchSolver.hpp"
+#include "solvers/frontends/ActiveSetPredictionSolver.hpp"
+#include "solvers/unconstrained/UnconstrainedFirstSolver.hpp"
+#include "solvers/qpoases/QPOasesSolver.hpp"
+#include "core/QuadraticProgram.hpp"
+
+using namespace wbc;
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(solver_memoized)
+{
+    /**
+     * Solve the same QP repeatedly: Only the first cycle should require the backend. Changes below the tolerance should return the cached solution,
+     * changes above the tolerance, as well as accumulated small changes, should trigger a new solve
+     */
+
+    const uint NO_JOINTS = 6;
+    const uint NO_EQ_CONSTRAINTS = 2;
+    const uint NO_CYCLES = 10;
+    const double tolerance = 1e-6;
+
+    wbc::QuadraticProgram qp;
+    qp.resize(NO_JOINTS, NO_EQ_CONSTRAINTS, 0, true);
+    base::MatrixXd J = base::MatrixXd::Random(NO_JOINTS, NO_JOINTS);
+    qp.H = J.transpose()*J + base::MatrixXd::Identity(NO_JOINTS, NO_JOINTS);
+    qp.g.setRandom();
+    qp.A.setRandom();
+    qp.b.setRandom();
+    qp.lower_x.setConstant(-std::numeric_limits<double>::infinity());
+    qp.upper_x.setConstant(std::numeric_limits<double>::infinity());
+    wbc::HierarchicalQP hqp;
+    hqp << qp;
+    hqp.Wq.setOnes(NO_JOINTS);
+
+    MemoizedSolver solver(std::make_shared<QPOASESSolver>(), tolerance);
+    QPOASESSolver reference_solver;
+
+    base::VectorXd solver_output, reference_output;
+    for(uint n = 0; n < NO_CYCLES; n++){
+        BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+        BOOST_CHECK(solver.cacheHit() == (n > 0));
+        BOOST_CHECK_NO_THROW(reference_solver.solve(hqp, reference_output));
+        for(uint i = 0; i < NO_JOINTS; i++)
+            BOOST_CHECK(fabs(solver_output(i) - reference_output(i)) < 1e-6);
+    }
+    BOOST_CHECK(solver.getNoSolves() == NO_CYCLES);
+    BOOST_CHECK(solver.getNoHits() == NO_CYCLES - 1);
+
+    // Change below tolerance: Cached solution
+    hqp[0].g[0] += 0.6*tolerance;
+    solver.solve(hqp, solver_output);
+    BOOST_CHECK(solver.cacheHit() == true);
+
+    // Accumulated change above tolerance (compared to the last solved QP): New solve
+    hqp[0].g[0] += 0.6*tolerance;
+    solver.solve(hqp, solver_output);
+    BOOST_CHECK(solver.cacheHit() == false);
+
+    // Change of the problem structure: New solve
+    hqp[0].lower_x.setConstant(-1e3);
+    solver.solve(hqp, solver_output);
+    BOOST_CHECK(solver.cacheHit() == false);
+    solver.solve(hqp, solver_output);
+    BOOST_CHECK(solver.cacheHit() == true);
+
+    // Limit the number of consecutive cache hits
+    solver.setMaxConsecutiveHits(2);
+    solver.resetCache();
+    for(uint n = 0; n < 6; n++){
+        solver.solve(hqp, solver_output);
+        BOOST_CHECK(solver.cacheHit() == (n % 3 != 0));
+    }
+
+    // Reset, e.g. after reconfiguration of the scene: The backend has to be called, even though the QP did not change
+    solver.setMaxConsecutiveHits(0);
+    solver.reset();
+    solver.solve(hqp, solver_output);
+    BOOST_CHECK(solver.cacheHit() == false);
+    solver.solve(hqp, solver_output);
+    BOOST_CHECK(solver.cacheHit() == true);
+}
+
+/** Backend that fails on request, e.g. to simulate a missed deadline*/
+class FailingSolver : public QPOASESSolver{
+public:
+    FailingSolver() : fail(false){}
+    virtual void solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output){
+        if(fail)
+            throw std::runtime_error("Max. CPU time exceeded");
+        QPOASESSolver::solve(hierarchical_qp, solver_output);
+    }
+    bool fail;
+};
+
+BOOST_AUTO_TEST_CASE(solver_sensitivity)
+{
+    /**
+     * Solve a QP with active bounds, then change the gradient vector, the equality constraints and the active bounds slightly. The extrapolated solution should
+     * match the backend solution, since the active set does not change. If the backend fails, the extrapolated solution should be returned
+     */
+
+    const uint NO_JOINTS = 6;
+    const uint NO_EQ_CONSTRAINTS = 2;
+
+    wbc::QuadraticProgram qp;
+    qp.resize(NO_JOINTS, NO_EQ_CONSTRAINTS, 0, true);
+    base::MatrixXd J = base::MatrixXd::Random(NO_JOINTS, NO_JOINTS);
+    qp.H = J.transpose()*J + base::MatrixXd::Identity(NO_JOINTS, NO_JOINTS);
+    qp.g.setRandom();
+    qp.A.setRandom();
+    qp.b.setRandom();
+    qp.lower_x.setConstant(-1e3);
+    qp.upper_x.setConstant(1e3);
+
+    // Choose the bounds such that some of them are active
+    base::VectorXd x_free;
+    wbc::HierarchicalQP hqp;
+    hqp << qp;
+    UnconstrainedFirstSolver unconstrained_solver(std::make_shared<QPOASESSolver>());
+    unconstrained_solver.solve(hqp, x_free);
+    double max = x_free.cwiseAbs().maxCoeff();
+    hqp[0].lower_x.setConstant(-0.5*max);
+    hqp[0].upper_x.setConstant(0.5*max);
+
+    std::shared_ptr<FailingSolver> backend = std::make_shared<FailingSolver>();
+    SensitivitySolver solver(backend);
+    QPOASESSolver reference_solver;
+    base::VectorXd solver_output, reference_output;
+
+    // Default: Backend is used in every cycle
+    BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+    BOOST_CHECK(solver.extrapolated() == false);
+    BOOST_CHECK(solver.hasSensitivity());
+    BOOST_CHECK(solver.gradientSensitivity().rows() == NO_JOINTS);
+    BOOST_CHECK(solver.activeConstraintSensitivity().cols() > NO_EQ_CONSTRAINTS);
+
+    solver.setMaxExtrapolations(3);
+    for(uint n = 0; n < 8; n++){
+        hqp[0].g += base::VectorXd::Constant(NO_JOINTS, 1e-4);
+        hqp[0].b += base::VectorXd::Constant(NO_EQ_CONSTRAINTS, 1e-4);
+        hqp[0].upper_x.array() += 1e-4;
+        BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+        BOOST_CHECK(solver.extrapolated() == (n % 4 != 3));
+        BOOST_CHECK_NO_THROW(reference_solver.solve(hqp, reference_output));
+        for(uint i = 0; i < NO_JOINTS; i++)
+            BOOST_CHECK(fabs(solver_output(i) - reference_output(i)) < 1e-6);
+    }
+    BOOST_CHECK(solver.getNoSolves() == 9);
+    BOOST_CHECK(solver.getNoExtrapolations() == 6);
+
+    // Backend fails: Return the extrapolated solution
+    solver.setMaxExtrapolations(0);
+    backend->fail = true;
+    hqp[0].g += base::VectorXd::Constant(NO_JOINTS, 1e-4);
+    BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+    BOOST_CHECK(solver.extrapolated() == true);
+    BOOST_CHECK(solver.getNoBackendFailures() == 1);
+    BOOST_CHECK_NO_THROW(reference_solver.solve(hqp, reference_output));
+    for(uint i = 0; i < NO_JOINTS; i++)
+        BOOST_CHECK(fabs(solver_output(i) - reference_output(i)) < 1e-6);
+
+    // No sensitivity available: Exception is passed on
+    solver.resetSensitivity();
+    BOOST_CHECK_THROW(solver.solve(hqp, solver_output), std::runtime_error);
+
+    // Reset, e.g. after reconfiguration of the scene: The sensitivities of the previous configuration must not be used
+    backend->fail = false;
+    BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+    BOOST_CHECK(solver.hasSensitivity());
+    solver.reset();
+    BOOST_CHECK(solver.hasSensitivity() == false);
+    backend->fail = true;
+    BOOST_CHECK_THROW(solver.solve(hqp, solver_output), std::runtime_error);
+}
+
+wbc::HierarchicalQP randomQP(const uint nq, const uint neq){
+    wbc::QuadraticProgram qp;
+    qp.resize(nq, neq, 0, true);
+    base::MatrixXd J = base::MatrixXd::Random(nq, nq);
+    qp.H = J.transpose()*J + base::MatrixXd::Identity(nq, nq);
+    qp.g.setRandom();
+    qp.A.setRandom();
+    qp.b.setRandom();
+    qp.lower_x.setConstant(-1e3);
+    qp.upper_x.setConstant(1e3);
+    wbc::HierarchicalQP hqp;
+    hqp << qp;
+    hqp.Wq.setOnes(nq);
+    return hqp;
+}
+
+BOOST_AUTO_TEST_CASE(solver_contact_switch)
+{
+    /**
+     * Switch between QPs with different numbers of equality constraints, e.g. contact constraints. A prepared structure should be solved by swapping the backend,
+     * an unprepared structure should be set up synchronously. All solutions should match the reference solver
+     */
+
+    const uint NO_JOINTS = 6;
+
+    wbc::HierarchicalQP hqp_one_contact = randomQP(NO_JOINTS, 3);
+    wbc::HierarchicalQP hqp_two_contacts = randomQP(NO_JOINTS, 6);
+    wbc::HierarchicalQP hqp_no_contact = randomQP(NO_JOINTS, 0);
+
+    ContactSwitchSolver solver([](){return std::make_shared<QPOASESSolver>();});
+    BOOST_CHECK_THROW(ContactSwitchSolver(ContactSwitchSolver::BackendFactory()), std::invalid_argument);
+
+    base::VectorXd solver_output, reference_output;
+    BOOST_CHECK_NO_THROW(solver.solve(hqp_one_contact, solver_output));
+    BOOST_CHECK(solver.setupInSolve() == true);
+
+    // Announce the upcoming contact set
+    solver.prepare(hqp_two_contacts);
+    BOOST_CHECK(solver.waitForPreparation());
+    BOOST_CHECK(solver.isPrepared(hqp_two_contacts));
+    BOOST_CHECK(!solver.isPrepared(hqp_no_contact));
+    BOOST_CHECK(solver.getNoBackends() == 2);
+
+    // Switch to prepared structure and back: Only swaps
+    std::vector<wbc::HierarchicalQP> sequence = {hqp_one_contact, hqp_two_contacts, hqp_two_contacts, hqp_one_contact, hqp_two_contacts};
+    for(const wbc::HierarchicalQP& hqp : sequence){
+        BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+        BOOST_CHECK(solver.setupInSolve() == false);
+        QPOASESSolver reference_solver;
+        BOOST_CHECK_NO_THROW(reference_solver.solve(hqp, reference_output));
+        for(uint i = 0; i < NO_JOINTS; i++)
+            BOOST_CHECK(fabs(solver_output(i) - reference_output(i)) < 1e-6);
+    }
+    BOOST_CHECK(solver.getNoSwaps() == 3);
+    BOOST_CHECK(solver.getNoSetups() == 1);
+
+    // Preparing an existing structure does nothing
+    solver.prepare(hqp_one_contact);
+    BOOST_CHECK(solver.waitForPreparation() == false);
+
+    // Unprepared structure: Synchronous setup
+    BOOST_CHECK_NO_THROW(solver.solve(hqp_no_contact, solver_output));
+    BOOST_CHECK(solver.setupInSolve() == true);
+    BOOST_CHECK(solver.getNoSetups() == 2);
+    BOOST_CHECK(solver.getNoBackends() == 3);
+
+    solver.clear();
+    BOOST_CHECK(solver.getNoBackends() == 0);
+    BOOST_CHECK(solver.getBackend() == nullptr);
+
+    // Reset, e.g. after reconfiguration of the scene: Prepared backends are discarded
+    solver.prepare(hqp_two_contacts);
+    BOOST_CHECK(solver.waitForPreparation());
+    solver.reset();
+    BOOST_CHECK(!solver.isPrepared(hqp_two_contacts));
+    BOOST_CHECK_NO_THROW(solver.solve(hqp_two_contacts, solver_output));
+    BOOST_CHECK(solver.setupInSolve() == true);
+}
+
+BOOST_AUTO_TEST_CASE(solver_active_set_prediction)
+{
+    /**
+     * Solve a sequence of slowly changing QPs with active bounds and compare with the backend solution. The active set does not change between
+     * cycles, so only the first cycle should require the backend
+     */
+
+    const uint NO_JOINTS = 6;
+    const uint NO_EQ_CONSTRAINTS = 2;
+    const uint NO_CYCLES = 10;
+
+    wbc::QuadraticProgram qp;
+    qp.resize(NO_JOINTS, NO_EQ_CONSTRAINTS, 0, true);
+    base::MatrixXd J = base::MatrixXd::Random(NO_JOINTS, NO_JOINTS);
+    qp.H = J.transpose()*J + base::MatrixXd::Identity(NO_JOINTS, NO_JOINTS);
+    qp.g.setRandom();
+    qp.A.setRandom();
+    qp.b.setRandom();
+    qp.lower_x.setConstant(-1e3);
+    qp.upper_x.setConstant(1e3);
+
+    // Choose the bounds such that some of them are active
+    base::VectorXd x_free;
+    wbc::HierarchicalQP hqp;
+    hqp << qp;
+    UnconstrainedFirstSolver unconstrained_solver(std::make_shared<QPOASESSolver>());
+    unconstrained_solver.solve(hqp, x_free);
+    double max = x_free.cwiseAbs().maxCoeff();
+    hqp[0].lower_x.setConstant(-0.5*max);
+    hqp[0].upper_x.setConstant(0.5*max);
+
+    std::shared_ptr<QPOASESSolver> backend = std::make_shared<QPOASESSolver>();
+    ActiveSetPredictionSolver solver(backend);
+    QPOASESSolver reference_solver;
+
+    base::VectorXd solver_output, reference_output;
+    for(uint n = 0; n < NO_CYCLES; n++){
+        hqp[0].g += base::VectorXd::Constant(NO_JOINTS, 1e-4);
+        BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+        BOOST_CHECK(solver.predictionHit() == (n > 0));
+        BOOST_CHECK_NO_THROW(reference_solver.solve(hqp, reference_output));
+        for(uint i = 0; i < NO_JOINTS; i++)
+            BOOST_CHECK(fabs(solver_output(i) - reference_output(i)) < 1e-6);
+    }
+    BOOST_CHECK(solver.getNoSolves() == NO_CYCLES);
+    BOOST_CHECK(solver.getNoHits() == NO_CYCLES - 1);
+    BOOST_CHECK(fabs(solver.getHitRate() - (double)(NO_CYCLES-1)/NO_CYCLES) < 1e-9);
+
+    // Move the unconstrained minimum to the interior of the bounds: Prediction fails, backend is called
+    hqp[0].lower_x.setConstant(-1e3);
+    hqp[0].upper_x.setConstant(1e3);
+    BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+    BOOST_CHECK(solver.predictionHit() == false);
+    BOOST_CHECK_NO_THROW(reference_solver.solve(hqp, reference_output));
+    for(uint i = 0; i < NO_JOINTS; i++)
+        BOOST_CHECK(fabs(solver_output(i) - reference_output(i)) < 1e-6);
+
+    // Reset, e.g. after reconfiguration of the scene: The prediction is discarded and the backend has to accept a QP of different size
+    solver.reset();
+    Eigen::VectorXi constraints, bounds;
+    BOOST_CHECK(solver.getActiveSet(constraints, bounds) == false);
+    wbc::HierarchicalQP hqp_no_eq;
+    hqp_no_eq << hqp[0];
+    hqp_no_eq[0].resize(NO_JOINTS, 0, 0, true);
+    hqp_no_eq[0].H = hqp[0].H;
+    hqp_no_eq[0].g = hqp[0].g;
+    hqp_no_eq[0].lower_x = hqp[0].lower_x;
+    hqp_no_eq[0].upper_x = hqp[0].upper_x;
+    BOOST_CHECK_NO_THROW(solver.solve(hqp_no_eq, solver_output));
+    BOOST_CHECK(solver.predictionHit() == false);
+    QPOASESSolver fresh_solver;
+    BOOST_CHECK_NO_THROW(fresh_solver.solve(hqp_no_eq, reference_output));
+    for(uint i = 0; i < NO_JOINTS; i++)
+        BOOST_CHECK(fabs(solver_output(i) - reference_output(i)) < 1e-6);
+}
@@ -1,5 +1,6 @@
 #include "HierarchicalLSSolver.hpp"
 #include <stdexcept>
+#include <type_traits>
 #include <tools/SVD.hpp>
 #include "../../core/QuadraticProgram.hpp"
 
@@ -7,18 +8,34 @@ using namespace std;
 
 namespace wbc{
 
-QPSolverRegistry<HierarchicalLSSolver> HierarchicalLSSolver::reg("hls");
+/** Return the input in the scalar type of the solver. If the scalar types differ, the input is cast into the given (preallocated) buffer, otherwise it is returned without copy*/
+template<typename Out, typename In>
+const Out& toScalar(const In& in, Out& buffer){
+    buffer = in.template cast<typename Out::Scalar>();
+    return buffer;
+}
+template<typename T>
+const T& toScalar(const T& in, T&){
+    return in;
+}
+
+template<> QPSolverRegistry<HierarchicalLSSolver> HierarchicalLSSolver::reg("hls");
+template<> QPSolverRegistry<HierarchicalLSSolverFloat> HierarchicalLSSolverFloat::reg("hls_float");
 
-HierarchicalLSSolver::HierarchicalLSSolver() :
+template<typename Scalar>
+HierarchicalLSSolverTpl<Scalar>::HierarchicalLSSolverTpl() :
     no_of_joints(0),
-    min_eigenvalue(1e-9),
+    // In single precision, singular values below approx. 1e-5 cannot be distinguished from numerical noise
+    min_eigenvalue(std::is_same<Scalar,float>::value ? 1e-5 : 1e-9),
     max_solver_output_norm(10){
 }
 
-HierarchicalLSSolver::~HierarchicalLSSolver(){
+template<typename Scalar>
+HierarchicalLSSolverTpl<Scalar>::~HierarchicalLSSolverTpl(){
 }
 
-bool HierarchicalLSSolver::configure(const std::vector<int>& n_constraints_per_prio, const unsigned int n_joints){
+template<typename Scalar>
+bool HierarchicalLSSolverTpl<Scalar>::configure(const std::vector<int>& n_constraints_per_prio, const unsigned int n_joints){
 
     priorities.clear();
 
@@ -29,8 +46,8 @@ bool HierarchicalLSSolver::configure(const std::vector<int>& n_constraints_per_p
         throw std::invalid_argument("Invalid Solver config. No of priority levels (size of n_constraints_per_prio) has to be > 0");
 
     for(uint i = 0; i < n_constraints_per_prio.size(); i++){
-        if(n_constraints_per_prio[i] == 0)
-            throw std::invalid_argument("Invalid Solver config. No of constraint variables on each priority level must be > 0");
+        if(n_constraints_per_prio[i] < 0)
+            throw std::invalid_argument("Invalid Solver config. No of constraint variables on each priority level must be >= 0");
     }
 
     for(uint prio = 0; prio < n_constraints_per_prio.size(); prio++)
@@ -48,12 +65,14 @@ bool HierarchicalLSSolver::configure(const std::vector<int>& n_constraints_per_p
     Wq_V_s_vals_inv.setZero(no_of_joints, no_of_joints);
     Wq_V_damped_s_vals_inv.setZero(no_of_joints, no_of_joints);
     tmp.setZero(no_of_joints);
+    solution.setZero(no_of_joints);
 
     configured = true;
     return true;
 }
 
-void HierarchicalLSSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output){
+template<typename Scalar>
+void HierarchicalLSSolverTpl<Scalar>::solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output){
 
     if(!configured){
         uint n_joints;
@@ -71,7 +90,7 @@ void HierarchicalLSSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, bas
         throw std::invalid_argument("Invalid solver input. Number of priorities in solver: " + std::to_string(priorities.size())
                                     + ", Size of input vector: " + std::to_string(hierarchical_qp.size()));
 
-    solver_output.setZero(no_of_joints);
+    solution.setZero(no_of_joints);
 
     // Init projection matrix as identity, so that the highest priority can look for a solution in whole configuration space
     proj_mat.setIdentity();
@@ -80,31 +99,43 @@ void HierarchicalLSSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, bas
 
     for(uint prio = 0; prio < priorities.size(); prio++){
 
-        if(hierarchical_qp[prio].A.rows() != priorities[prio].n_constraint_variables ||
-           hierarchical_qp[prio].A.cols() != no_of_joints ||
-           hierarchical_qp[prio].b.size() != priorities[prio].n_constraint_variables){
+        if(hierarchical_qp[prio].A.cols() != no_of_joints ||
+           hierarchical_qp[prio].b.size() != hierarchical_qp[prio].A.rows()){
 
-            string nc = to_string(priorities[prio].n_constraint_variables), nq = to_string(no_of_joints);
+            string nc = to_string(hierarchical_qp[prio].A.rows()), nq = to_string(no_of_joints);
             string a_rows = to_string(hierarchical_qp[prio].A.rows()), a_cols = to_string(hierarchical_qp[prio].A.cols());
             string y_rows = to_string(hierarchical_qp[prio].b.size());
             throw std::invalid_argument("Expected input size on priority level " + to_string(prio) + ": " +  "A: " + nc + " x " + nq +
                       ", b: " + nc + " x 1, actual input: " + "A: " + a_rows + " x " + a_cols +", b: " + y_rows + " x 1");
         }
 
+        // The number of constraint variables may change between calls, e.g. if the scene prunes rows with zero weight.
+        // Resize the row dependent priority data only in this case
+        if(hierarchical_qp[prio].A.rows() != priorities[prio].n_constraint_variables)
+            priorities[prio].resize(hierarchical_qp[prio].A.rows(), no_of_joints);
+        const MatrixX& A = toScalar(hierarchical_qp[prio].A, priorities[prio].A);
+        const VectorX& b = toScalar(hierarchical_qp[prio].b, priorities[prio].b);
+
+        // Priorities without constraint variables don't change the solution and the nullspace projection
+        if(priorities[prio].n_constraint_variables == 0){
+            priorities[prio].solution_prio.setZero();
+            priorities[prio].sing_vals.setZero();
+            continue;
+        }
+
         // Set weights for this prioritiy
         if(hierarchical_qp[prio].Wy.size() != 0)
             setTaskWeights(hierarchical_qp[prio].Wy, prio);
         if(hierarchical_qp.Wq.size() != 0)
             setJointWeights(hierarchical_qp.Wq, prio);
 
-        priorities[prio].y_comp.setZero();
-
         // Compensate y for part of the solution already met in higher priorities. For the first priority y_comp will be equal to  y
-        priorities[prio].y_comp = hierarchical_qp[prio].b - hierarchical_qp[prio].A*solver_output;
+        priorities[prio].y_comp = b;
+        priorities[prio].y_comp.noalias() -= A*solution;
 
         // projection of A on the null space of previous priorities: A_proj = A * P = A * ( P(p-1) - (A_wdls)^# * A )
         // For the first priority P == Identity
-        priorities[prio].A_proj = hierarchical_qp[prio].A * proj_mat;
+        priorities[prio].A_proj.noalias() = A * proj_mat;
 
         // Compute weighted, projected mat: A_proj_w = Wy * A_proj * Wq^-1
         // Since the weight matrices are diagonal, there is no need for full matrix multiplication
@@ -121,7 +152,7 @@ void HierarchicalLSSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, bas
         // A.A. Maciejewski, C.A. Klein, “Numerical Filtering for the Operation of
         // Robotic Manipulators through Kinematically Singular Configurations”,
         // Journal of Robotic Systems, Vol. 5, No. 6, pp. 527 - 552, 1988.
-        double s_min = s_vals.block(0,0,min(no_of_joints, priorities[prio].n_constraint_variables),1).minCoeff();
+        Scalar s_min = s_vals.block(0,0,min(no_of_joints, priorities[prio].n_constraint_variables),1).minCoeff();
         if(s_min <= (1/max_solver_output_norm)/2)
             priorities[prio].damping = (1/max_solver_output_norm)/2;
         else if(s_min >= (1/max_solver_output_norm))
@@ -161,7 +192,7 @@ void HierarchicalLSSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, bas
 
         // x = x + A^# * y
         priorities[prio].solution_prio = priorities[prio].A_proj_inv_wdls * priorities[prio].y_comp;
-        solver_output += priorities[prio].solution_prio;
+        solution += priorities[prio].solution_prio;
 
         // Compute projection matrix for the next priority. Use here the undamped inverse to have a correct solution
         proj_mat -= priorities[prio].A_proj_inv_wls * priorities[prio].A_proj;
@@ -173,17 +204,21 @@ void HierarchicalLSSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, bas
 
     } //priority loop
 
+    solver_output = solution.template cast<double>();
+
     ///////////////
 }
 
-void HierarchicalLSSolver::setJointWeights(const base::VectorXd& weights){
+template<typename Scalar>
+void HierarchicalLSSolverTpl<Scalar>::setJointWeights(const base::VectorXd& weights){
     if(!configured)
         throw std::runtime_error("setJointWeights: Solver has not been configured yet!");
     for(size_t i = 0; i < priorities.size(); i++)
         setJointWeights(weights, i);
 }
 
-void HierarchicalLSSolver::setJointWeights(const base::VectorXd& weights, const uint prio){
+template<typename Scalar>
+void HierarchicalLSSolverTpl<Scalar>::setJointWeights(const base::VectorXd& weights, const uint prio){
     if(!configured)
         throw std::runtime_error("setJointWeights: Solver has not been configured yet!");
     if(prio < 0 ||prio >= priorities.size())
@@ -205,7 +240,8 @@ void HierarchicalLSSolver::setJointWeights(const base::VectorXd& weights, const
     }
 }
 
-void HierarchicalLSSolver::setTaskWeights(const base::VectorXd& weights, const uint prio){
+template<typename Scalar>
+void HierarchicalLSSolverTpl<Scalar>::setTaskWeights(const base::VectorXd& weights, const uint prio){
     if(!configured)
         throw std::runtime_error("setTaskWeights: Solver has not been configured yet!");
 
@@ -226,17 +262,23 @@ void HierarchicalLSSolver::setTaskWeights(const base::VectorXd& weights, const u
     }
 }
 
-void HierarchicalLSSolver::setMinEigenvalue(double _min_eigenvalue){
+template<typename Scalar>
+void HierarchicalLSSolverTpl<Scalar>::setMinEigenvalue(double _min_eigenvalue){
     if(_min_eigenvalue <= 0){
         throw std::invalid_argument("Min. Eigenvalue has to be > 0!");
     }
     min_eigenvalue = _min_eigenvalue;
 }
 
-void HierarchicalLSSolver::setMaxSolverOutputNorm(double norm_max){
+template<typename Scalar>
+void HierarchicalLSSolverTpl<Scalar>::setMaxSolverOutputNorm(double norm_max){
     if(norm_max <= 0){
         throw std::invalid_argument("Norm Max has to be > 0!");
     }
     max_solver_output_norm = norm_max;
 }
+
+template class HierarchicalLSSolverTpl<double>;
+template class HierarchicalLSSolverTpl<float>;
+
 }
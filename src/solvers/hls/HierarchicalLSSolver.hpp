@@ -28,12 +28,19 @@ class HierarchicalQP;
  * of priority level i.
  * The solver ensures a hierarchy between the different tasks using nullspace projections. That is, the equation system with the highest priority will be solved fully if (n_rows <= n_cols),
  * the eqn. system of the next priority will be solved in the nullspace of the priovious priority, and so on. Additionally the solver can include weights in joint space and task space.
+ * Only A, b and Wy of each priority and the joint weights Wq are used, i.e., the priorities can use the slim representation of QuadraticProgram::resizeEqualityOnly().
+ *
+ * The template parameter defines the scalar type used for all internal computations. Input and output are always double. Two variants are registered:
+ * "hls" (HierarchicalLSSolver, double precision) and "hls_float" (HierarchicalLSSolverFloat, single precision).
  */
-class HierarchicalLSSolver : public QPSolver{
+template<typename Scalar>
+class HierarchicalLSSolverTpl : public QPSolver{
 private:
-    static QPSolverRegistry<HierarchicalLSSolver> reg;
+    static QPSolverRegistry<HierarchicalLSSolverTpl<Scalar>> reg;
 
 public:
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> MatrixX;
+    typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1> VectorX;
 
     /**
      * @brief The PriorityDataIntern class Manages all priority dependent information, i.e. all matrices that have to be resized according to
@@ -43,8 +50,17 @@ public:
     public:
         PriorityData(){}
         PriorityData(const unsigned int _n_constraint_variables, const unsigned int n_joints){
-            n_constraint_variables = _n_constraint_variables;
             solution_prio.setZero(n_joints);
+            joint_weight_mat.resize(n_joints, n_joints);
+            joint_weight_mat.setIdentity();
+            sing_vals.resize(n_joints);
+            resize(_n_constraint_variables, n_joints);
+        }
+        /** Resize only the matrices that depend on the number of constraint variables. The buffers that only depend on the number of joints are kept*/
+        void resize(const unsigned int _n_constraint_variables, const unsigned int n_joints){
+            n_constraint_variables = _n_constraint_variables;
+            A.setZero(_n_constraint_variables, n_joints);
+            b.setZero(_n_constraint_variables);
             A_proj.setZero(_n_constraint_variables, n_joints);
             A_proj_w.setZero(_n_constraint_variables,n_joints);
             U.setZero(_n_constraint_variables, n_joints);
@@ -53,32 +69,32 @@ public:
             y_comp.setZero(_n_constraint_variables);
             constraint_weight_mat.resize(_n_constraint_variables, _n_constraint_variables);
             constraint_weight_mat.setIdentity();
-            joint_weight_mat.resize(n_joints, n_joints);
-            joint_weight_mat.setIdentity();
             u_t_weight_mat.setZero(n_joints, _n_constraint_variables);
-            sing_vals.resize(n_joints);
         }
-        base::VectorXd solution_prio;         /** Solution for the current priority*/
-        base::MatrixXd A_proj;                /** Constraint Matrix projected into nullspace of the higher priority */
-        base::MatrixXd A_proj_w;              /** Constraint Matrix projected into nullspace of the higher priority with weighting*/
-        base::MatrixXd U;                     /** Matrix of left singular vector of A_proj_w */
-        base::MatrixXd A_proj_inv_wls;        /** Least square inverse of A_proj_w*/
-        base::MatrixXd A_proj_inv_wdls;       /** Damped Least square inverse of A_proj_w*/
-        base::VectorXd y_comp;                /** Input variables which are compensated for the part of solution already met in higher priorities */
-        base::MatrixXd constraint_weight_mat; /** Constraint weight matrix of this priority*/
-        base::MatrixXd joint_weight_mat;      /** Joint weight matrix of this priority*/
-        base::MatrixXd u_t_weight_mat;        /** Matrix U_transposed * constraint_weight_mat*/
-        base::VectorXd sing_vals;             /** Singular values of this priority */
-        double damping;                        /** Damping term for matrix inversion on this priority*/
+        MatrixX A;                            /** Constraint matrix in the scalar type of the solver. Only used if Scalar is not double*/
+        VectorX b;                            /** Reference in the scalar type of the solver. Only used if Scalar is not double*/
+        VectorX solution_prio;                 /** Solution for the current priority*/
+        MatrixX A_proj;                       /** Constraint Matrix projected into nullspace of the higher priority */
+        MatrixX A_proj_w;                   /** Constraint Matrix projected into nullspace of the higher priority with weighting*/
+        MatrixX U;                     /** Matrix of left singular vector of A_proj_w */
+        MatrixX A_proj_inv_wls;               /** Least square inverse of A_proj_w*/
+        MatrixX A_proj_inv_wdls;             /** Damped Least square inverse of A_proj_w*/
+        VectorX y_comp;                       /** Input variables which are compensated for the part of solution already met in higher priorities */
+        MatrixX constraint_weight_mat; /** Constraint weight matrix of this priority*/
+        MatrixX joint_weight_mat;           /** Joint weight matrix of this priority*/
+        MatrixX u_t_weight_mat;               /** Matrix U_transposed * constraint_weight_mat*/
+        VectorX sing_vals;                         /** Singular values of this priority */
+        Scalar damping;                        /** Damping term for matrix inversion on this priority*/
         unsigned int n_constraint_variables;   /** Number of constraint variables of this priority*/
     };
 
-    HierarchicalLSSolver();
-    virtual ~HierarchicalLSSolver();
+    HierarchicalLSSolverTpl();
+    virtual ~HierarchicalLSSolverTpl();
 
     /**
      * @brief configure Resizes member variables
-     * @param constraint_variables_per_prio Number of constraint variables per priority, i.e. number of row of the constraint Jacobian of that priority
+     * @param constraint_variables_per_prio Number of constraint variables per priority, i.e. number of row of the constraint Jacobian of that priority. Priorities with zero constraint variables are skipped.
+     * If the number of constraint variables changes in a later call to solve(), the corresponding priority will be resized
      * @param no_of_joints Number of robot joints
      * @return true in case of successful initialization, false otherwise
      */
@@ -141,14 +157,14 @@ public:
 
 protected:
     std::vector<PriorityData> priorities;     /** Contains priority specific matrices etc. */
-    base::MatrixXd proj_mat;                 /** Projection Matrix that performs the nullspace projection onto the next lower priority*/
-    base::VectorXd s_vals;                   /** Singular value vector*/
-    base::MatrixXd s_vals_inv;               /** Diagonal matrix containing the reciprocal singular values*/
-    base::MatrixXd sing_vect_r;              /** Matrix of right singular vectors*/
-    base::MatrixXd damped_s_vals_inv;        /** Diagonal matrix containing the reciprocal singular values with damping*/
-    base::MatrixXd Wq_V;                     /** Column weight matrix times Matrix of Vectors of right singular vectors*/
-    base::MatrixXd Wq_V_s_vals_inv;          /** Wq_V * s_vals_inv */
-    base::MatrixXd Wq_V_damped_s_vals_inv;   /** Wq_V * damped_s_vals_inv */
+    MatrixX proj_mat;                        /** Projection Matrix that performs the nullspace projection onto the next lower priority*/
+    VectorX s_vals;                          /** Singular value vector*/
+    MatrixX s_vals_inv;                      /** Diagonal matrix containing the reciprocal singular values*/
+    MatrixX sing_vect_r;                     /** Matrix of right singular vectors*/
+    MatrixX damped_s_vals_inv;               /** Diagonal matrix containing the reciprocal singular values with damping*/
+    MatrixX Wq_V;                            /** Column weight matrix times Matrix of Vectors of right singular vectors*/
+    MatrixX Wq_V_s_vals_inv;                 /** Wq_V * s_vals_inv */
+    MatrixX Wq_V_damped_s_vals_inv;          /** Wq_V * damped_s_vals_inv */
 
     unsigned int no_of_joints;             /** Number of joints */
 
@@ -157,8 +173,13 @@ protected:
     double max_solver_output_norm;   /** Maximum norm of (J#) * y */
 
     //Helpers
-    base::VectorXd tmp;
+    VectorX tmp;
+    VectorX solution;
 };
+
+typedef HierarchicalLSSolverTpl<double> HierarchicalLSSolver;
+typedef HierarchicalLSSolverTpl<float> HierarchicalLSSolverFloat;
+
 }
 #endif
 
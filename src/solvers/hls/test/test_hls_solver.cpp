@@ -75,3 +75,32 @@ BOOST_AUTO_TEST_CASE(solver_hls)
 
     //cout<<"\n............................."<<endl;
 }
+
+BOOST_AUTO_TEST_CASE(solver_hls_float)
+{
+    /**
+     * Compare the single precision solver with the double precision solver on a random problem
+     */
+
+    const uint NO_JOINTS = 7;
+    const uint NO_EQ_CONSTRAINTS = 6;
+
+    wbc::QuadraticProgram qp;
+    qp.resize(NO_JOINTS, NO_EQ_CONSTRAINTS, 0, false);
+    qp.A.setRandom();
+    qp.b.setRandom();
+    wbc::HierarchicalQP hqp;
+    hqp.Wq.setOnes(NO_JOINTS);
+    hqp << qp;
+
+    HierarchicalLSSolver solver_d;
+    HierarchicalLSSolverFloat solver_f;
+    solver_d.setMaxSolverOutputNorm(100);
+    solver_f.setMaxSolverOutputNorm(100);
+
+    base::VectorXd solver_output_d, solver_output_f;
+    solver_d.solve(hqp, solver_output_d);
+    solver_f.solve(hqp, solver_output_f);
+
+    BOOST_CHECK((solver_output_d - solver_output_f).norm() < 1e-3 * (1 + solver_output_d.norm()));
+}
@@ -3,7 +3,16 @@
 
 namespace wbc {
 
-OsqpSolver::OsqpSolver() : configured(false){
+QPSolverRegistry<OsqpSolver> OsqpSolver::reg("osqp");
+
+OsqpSolver::OsqpSolver() :
+    rho(0.1),
+    sigma(1e-6),
+    alpha(1.6),
+    eps_abs(1e-3),
+    eps_rel(1e-3),
+    polish(false),
+    max_iter(4000){
 }
 
 OsqpSolver::~OsqpSolver(){
@@ -18,6 +27,12 @@ void OsqpSolver::solve(const HierarchicalQP& hierarchical_qp, base::VectorXd& so
     uint nc = qp.bounded ? qp.neq + qp.nin + qp.nq : qp.neq + qp.nin;
 
     if(!configured){
+        // After reset(), the workspace of the previous problem (including the previous solution used for warm start) has to be deleted
+        if(solver.isInitialized()){
+            solver.clearSolver();
+            solver.data()->clearHessianMatrix();
+            solver.data()->clearLinearConstraintsMatrix();
+        }
         hessian_sparse.resize(qp.nq,qp.nq);
         gradient.resize(qp.nq);
         constraint_mat_dense.resize(nc,qp.nq);
@@ -32,6 +47,7 @@ void OsqpSolver::solve(const HierarchicalQP& hierarchical_qp, base::VectorXd& so
         constraint_mat_sparse.setZero();
         solver.settings()->setVerbosity(false);
         solver.settings()->setWarmStart(true);
+        applySettings();
         solver.data()->setNumberOfVariables(qp.nq);
         configured = true;
         solver.data()->setNumberOfConstraints(nc);
@@ -62,6 +78,7 @@ void OsqpSolver::solve(const HierarchicalQP& hierarchical_qp, base::VectorXd& so
         constraint_mat_sparse.setZero();
         solver.settings()->setVerbosity(false);
         solver.settings()->setWarmStart(true);
+        applySettings();
         solver.data()->setNumberOfVariables(qp.nq);
         solver.data()->setNumberOfConstraints(nc);
         solver.data()->setHessianMatrix(hessian_sparse);
@@ -97,12 +114,56 @@ void OsqpSolver::solve(const HierarchicalQP& hierarchical_qp, base::VectorXd& so
     solver.updateGradient(gradient);
     solver.updateBounds(lower_bound,upper_bound);
 
+    // Multipliers have the same order as the rows of the merged constraint matrix
+    if(predictWarmStart(hierarchical_qp)){
+        if(warm_start.hasPrimal())
+            solver.setPrimalVariable(warm_start.x);
+        if(warm_start.hasDual(qp)){
+            dual_guess.resize(nc);
+            dual_guess.segment(0,qp.neq) = warm_start.y_eq;
+            dual_guess.segment(qp.neq,qp.nin) = warm_start.y_in;
+            if(qp.bounded)
+                dual_guess.segment(qp.neq+qp.nin,qp.nq) = warm_start.y_bounds;
+            solver.setDualVariable(dual_guess);
+        }
+    }
+
     OsqpEigen::ErrorExitFlag flag = solver.solveProblem();
     if(flag != OsqpEigen::ErrorExitFlag::NoError){
         qp.print();
         throw std::runtime_error("Error solving QP: " + exitFlagToString(flag));
     }
     solver_output = solver.getSolution();
+    updateWarmStartPredictor(hierarchical_qp, solver_output);
+}
+
+void OsqpSolver::applySettings(){
+    solver.settings()->setRho(rho);
+    solver.settings()->setSigma(sigma);
+    solver.settings()->setAlpha(alpha);
+    solver.settings()->setPolish(polish);
+    solver.settings()->setAbsoluteTolerance(eps_abs);
+    solver.settings()->setRelativeTolerance(eps_rel);
+    solver.settings()->setMaxIteration(max_iter);
+}
+
+void OsqpSolver::setParameter(const std::string &name, const std::string &value){
+    if(name == "rho")
+        rho = std::stod(value);
+    else if(name == "sigma")
+        sigma = std::stod(value);
+    else if(name == "alpha")
+        alpha = std::stod(value);
+    else if(name == "polish")
+        polish = std::stoi(value) != 0;
+    else if(name == "eps_abs")
+        eps_abs = std::stod(value);
+    else if(name == "eps_rel")
+        eps_rel = std::stod(value);
+    else if(name == "max_iter")
+        max_iter = std::stoi(value);
+    else
+        QPSolver::setParameter(name, value);
 }
 
 }
@@ -9,15 +9,29 @@
 namespace wbc {
 
 class OsqpSolver : public QPSolver{
+private:
+    static QPSolverRegistry<OsqpSolver> reg;
+
 public:
     OsqpSolver();
     ~OsqpSolver();
 
     virtual void solve(const HierarchicalQP& hierarchical_qp, base::VectorXd& solver_output);
 
+    /**
+     * Set a parameter by name. Valid parameters are the OSQP settings "rho", "sigma", "alpha", "polish" (0/1), "eps_abs", "eps_rel" and "max_iter". Defaults are the
+     * OSQP defaults. The parameters are applied when the solver is initialized, i.e., they have to be set before the first call to solve().
+     */
+    virtual void setParameter(const std::string &name, const std::string &value);
+
+    /** The primal and dual guess of the warm start predictor replace the solution of the previous solve as initial iterate. The active set is not used*/
+    virtual bool supportsWarmStart(){return true;}
+
 protected:
-    bool configured;
     OsqpEigen::Solver solver;
+    double rho, sigma, alpha, eps_abs, eps_rel;
+    bool polish;
+    int max_iter;
 
     Eigen::MatrixXd hessian_dense;
     Eigen::SparseMatrix<double> hessian_sparse;
@@ -26,8 +40,10 @@ protected:
     Eigen::VectorXd gradient;
     Eigen::VectorXd lower_bound;
     Eigen::VectorXd upper_bound;
+    Eigen::VectorXd dual_guess;
 
     void resetData(uint nq, uint nc);
+    void applySettings();
     std::string exitFlagToString(OsqpEigen::ErrorExitFlag flag){
         switch(flag){
             case OsqpEigen::ErrorExitFlag::DataValidationError: return "DataValidationError";
@@ -3,25 +3,30 @@
 #include <base/Eigen.hpp>
 #include <Eigen/Core>
 #include <iostream>
+#include <type_traits>
 
 #include <proxsuite/proxqp/dense/dense.hpp>
 #include <proxsuite/proxqp/status.hpp>
 
 namespace wbc {
 
-QPSolverRegistry<ProxQPSolver> ProxQPSolver::reg("proxqp");
+template<> QPSolverRegistry<ProxQPSolver> ProxQPSolver::reg("proxqp");
+template<> QPSolverRegistry<ProxQPSolverFloat> ProxQPSolverFloat::reg("proxqp_float");
 
-ProxQPSolver::ProxQPSolver()
+template<typename Scalar>
+ProxQPSolverTpl<Scalar>::ProxQPSolverTpl()
 {
     _n_iter = 10000;
-    _eps_abs = 1e-9;
+    // 1e-9 cannot be reached in single precision
+    _eps_abs = std::is_same<Scalar,float>::value ? 1e-4 : 1e-9;
 }
 
 /// solve problem:
 /// min  0.5 * x'Hx + g'x
 /// s.t. Ax = b
 ///      l < Cx < u 
-void ProxQPSolver::solve(const wbc::HierarchicalQP& hierarchical_qp, base::VectorXd& solver_output)
+template<typename Scalar>
+void ProxQPSolverTpl<Scalar>::solve(const wbc::HierarchicalQP& hierarchical_qp, base::VectorXd& solver_output)
 {
     namespace pqp = proxsuite::proxqp;
 
@@ -41,10 +46,10 @@ void ProxQPSolver::solve(const wbc::HierarchicalQP& hierarchical_qp, base::Vecto
     _l_vec.resize(n_in);
     _u_vec.resize(n_in);
 
-    _C_mtx.topRows(qp.nin) = qp.C;
+    _C_mtx.topRows(qp.nin) = qp.C.template cast<Scalar>();
     _C_mtx.bottomRows(qp.lower_x.size()).setIdentity();
-    _l_vec << qp.lower_y, qp.lower_x;
-    _u_vec << qp.upper_y, qp.upper_x;
+    _l_vec << qp.lower_y.template cast<Scalar>(), qp.lower_x.template cast<Scalar>();
+    _u_vec << qp.upper_y.template cast<Scalar>(), qp.upper_x.template cast<Scalar>();
 
     if(!configured) 
     {
@@ -52,14 +57,14 @@ void ProxQPSolver::solve(const wbc::HierarchicalQP& hierarchical_qp, base::Vecto
         _n_eq_init = n_eq;
         _n_in_init = n_in;
 
-        _solver_ptr = std::make_shared<pqp::dense::QP<double>>(n_var, n_eq, n_in);
+        _solver_ptr = std::make_shared<pqp::dense::QP<Scalar>>(n_var, n_eq, n_in);
         _solver_ptr->settings.eps_abs = _eps_abs;
         _solver_ptr->settings.max_iter = _n_iter;
         // _solver_ptr->settings.eps_primal_inf = 1e-6;
         // _solver_ptr->settings.preconditioner_max_iter = 100;
         // _solver_ptr->settings.initial_guess = pqp::InitialGuessStatus::NO_INITIAL_GUESS;
 
-        _solver_ptr->init(qp.H, qp.g, qp.A, qp.b, _C_mtx, _l_vec, _u_vec);
+        _solver_ptr->init(qp.H.template cast<Scalar>(), qp.g.template cast<Scalar>(), qp.A.template cast<Scalar>(), qp.b.template cast<Scalar>(), _C_mtx, _l_vec, _u_vec);
 
         configured = true;
     }
@@ -71,7 +76,7 @@ void ProxQPSolver::solve(const wbc::HierarchicalQP& hierarchical_qp, base::Vecto
             throw std::runtime_error("QP problem changed dynamically. Not supported at the moment.");
 
         _solver_ptr->settings.initial_guess = pqp::InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT;
-        _solver_ptr->update(qp.H, qp.g, qp.A, qp.b, _C_mtx, _l_vec, _u_vec);
+        _solver_ptr->update(qp.H.template cast<Scalar>(), qp.g.template cast<Scalar>(), qp.A.template cast<Scalar>(), qp.b.template cast<Scalar>(), _C_mtx, _l_vec, _u_vec);
     }
 
 //     std::cerr << "qp.nq = " << qp.nq <<std::endl;
@@ -86,10 +91,33 @@ void ProxQPSolver::solve(const wbc::HierarchicalQP& hierarchical_qp, base::Vecto
 //     std::cerr << "eps_abs: " << _solver_ptr->settings.eps_abs << std::endl;
 //     std::cerr << "max_iter: " << _solver_ptr->settings.max_iter << std::endl;
 
-    _solver_ptr->solve();
+    // Warm start from the predictor. The inequality multipliers are ordered as the rows of _C_mtx, i.e., [constraints, bounds]
+    if(predictWarmStart(hierarchical_qp) && (warm_start.hasPrimal() || warm_start.hasDual(qp)))
+    {
+        proxsuite::optional<pqp::dense::VecRef<Scalar>> x_guess, y_guess, z_guess;
+        if(warm_start.hasPrimal())
+        {
+            _x_guess = warm_start.x.template cast<Scalar>();
+            x_guess.emplace(_x_guess);
+        }
+        if(warm_start.hasDual(qp))
+        {
+            _y_guess = warm_start.y_eq.template cast<Scalar>();
+            _z_guess.resize(n_in);
+            _z_guess.head(qp.nin) = warm_start.y_in.template cast<Scalar>();
+            if(qp.bounded)
+                _z_guess.tail(qp.nq) = warm_start.y_bounds.template cast<Scalar>();
+            y_guess.emplace(_y_guess);
+            z_guess.emplace(_z_guess);
+        }
+        _solver_ptr->settings.initial_guess = pqp::InitialGuessStatus::WARM_START;
+        _solver_ptr->solve(x_guess, y_guess, z_guess);
+    }
+    else
+        _solver_ptr->solve();
     
     solver_output.resize(qp.nq);
-    solver_output = _solver_ptr->results.x;
+    solver_output = _solver_ptr->results.x.template cast<double>();
 
     auto status = _solver_ptr->results.info.status;
 
@@ -108,6 +136,21 @@ void ProxQPSolver::solve(const wbc::HierarchicalQP& hierarchical_qp, base::Vecto
         throw std::runtime_error("ProxQP returned error status: problem is dual infeasible.");
 
     _actual_n_iter = _solver_ptr->results.info.iter;
+    updateWarmStartPredictor(hierarchical_qp, solver_output);
+}
+
+template<typename Scalar>
+void ProxQPSolverTpl<Scalar>::setParameter(const std::string &name, const std::string &value)
+{
+    if(name == "eps_abs")
+        setEpsAbs(std::stod(value));
+    else if(name == "max_iter")
+        setMaxNIter(std::stoi(value));
+    else
+        QPSolver::setParameter(name, value);
 }
 
+template class ProxQPSolverTpl<double>;
+template class ProxQPSolverTpl<float>;
+
 } // namespace wbc
@@ -23,14 +23,18 @@ class HierarchicalQP;
  *             & \mathbf{l} \leq \mathbf{Cx} \leq \mathbf{u}& \\
  *        \end{array}
  *  \f]
+ *
+ * The template parameter defines the scalar type used inside the solver. Input and output are always double. Two variants are registered:
+ * "proxqp" (ProxQPSolver, double precision) and "proxqp_float" (ProxQPSolverFloat, single precision).
  */
-class ProxQPSolver : public QPSolver{
+template<typename Scalar>
+class ProxQPSolverTpl : public QPSolver{
 private:
-    static QPSolverRegistry<ProxQPSolver> reg;
+    static QPSolverRegistry<ProxQPSolverTpl<Scalar>> reg;
 
 public:
-    ProxQPSolver();
-    virtual ~ProxQPSolver() noexcept { };
+    ProxQPSolverTpl();
+    virtual ~ProxQPSolverTpl() noexcept { };
 
     /**
      * @brief solve Solve the given quadratic program
@@ -49,11 +53,23 @@ public:
     /** Get number of working set recalculations actually performed*/
     int getNter(){ return _actual_n_iter; }
 
+    /** Set the absolute tolerance of the solver. Default is 1e-9 (double) and 1e-4 (float)*/
+    void setEpsAbs(const Scalar eps_abs){ _eps_abs = eps_abs; }
+
+    /** Get the absolute tolerance of the solver*/
+    Scalar getEpsAbs(){ return _eps_abs; }
+
+    /** Set a parameter by name. Valid parameters are "eps_abs" and "max_iter". The parameters are applied on the next solver initialization, i.e., after reset()*/
+    virtual void setParameter(const std::string &name, const std::string &value);
+
+    /** The primal and dual guess of the warm start predictor replace the solution of the previous solve as initial iterate. The active set is not used*/
+    virtual bool supportsWarmStart(){ return true; }
+
 protected:
 
-    std::shared_ptr<proxsuite::proxqp::dense::QP<double>> _solver_ptr;
+    std::shared_ptr<proxsuite::proxqp::dense::QP<Scalar>> _solver_ptr;
 
-    double _eps_abs = 1e-9;
+    Scalar _eps_abs;
     int _n_iter;
     int _actual_n_iter;
 
@@ -61,11 +77,15 @@ protected:
     size_t _n_eq_init;  // number of equalities in the configured solver instance
     size_t _n_in_init;  // number of inequalities in the configured solver instance (inclusing bounds)
 
-    Eigen::MatrixXd _C_mtx; // inequalities matrix (including bounds)
-    Eigen::VectorXd _l_vec; // inequalities lower bounds
-    Eigen::VectorXd _u_vec; // inequalities upper bounds
+    Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic> _C_mtx; // inequalities matrix (including bounds)
+    Eigen::Matrix<Scalar,Eigen::Dynamic,1> _l_vec; // inequalities lower bounds
+    Eigen::Matrix<Scalar,Eigen::Dynamic,1> _u_vec; // inequalities upper bounds
+    Eigen::Matrix<Scalar,Eigen::Dynamic,1> _x_guess, _y_guess, _z_guess; // warm start from the predictor
 };
 
+typedef ProxQPSolverTpl<double> ProxQPSolver;
+typedef ProxQPSolverTpl<float> ProxQPSolverFloat;
+
 }
 
 #endif
@@ -12,6 +12,7 @@ QPSolverRegistry<QPOASESSolver> QPOASESSolver::reg("qpoases");
 
 QPOASESSolver::QPOASESSolver(){
     n_wsr = 1000;
+    neq = 0;
     options.setToFast();
     options.printLevel = PL_NONE;
 }
@@ -78,9 +79,42 @@ void QPOASESSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, base::Vect
     if(qp.g.size() > 0)
         g_ptr = (real_t*)qp.g.data();
 
+    // Guessed working set and primal/dual guess from the warm start predictor. qpOASES uses the opposite sign convention for the multipliers
+    // and orders them as [bounds, constraints]
+    Bounds guessed_bounds;
+    Constraints guessed_constraints;
+    Bounds* guessed_bounds_ptr = 0;
+    Constraints* guessed_constraints_ptr = 0;
+    real_t* x_guess_ptr = 0;
+    real_t* y_guess_ptr = 0;
+    if(predictWarmStart(hierarchical_qp)){
+        if(warm_start.hasActiveSet(qp)){
+            guessed_bounds.init(qp.nq);
+            for(int i = 0; i < qp.nq; i++)
+                guessed_bounds.setupBound(i, qp.bounded ? (SubjectToStatus)warm_start.active_bounds[i] : ST_INACTIVE);
+            guessed_constraints.init(nc);
+            for(int i = 0; i < qp.neq; i++)
+                guessed_constraints.setupConstraint(i, ST_LOWER);
+            for(int i = 0; i < qp.nin; i++)
+                guessed_constraints.setupConstraint(qp.neq + i, (SubjectToStatus)warm_start.active_constraints[i]);
+            guessed_bounds_ptr = &guessed_bounds;
+            guessed_constraints_ptr = &guessed_constraints;
+        }
+        if(warm_start.hasPrimal())
+            x_guess_ptr = warm_start.x.data();
+        if(warm_start.hasDual(qp)){
+            y_guess.setZero(qp.nq + nc);
+            if(qp.bounded)
+                y_guess.head(qp.nq) = -warm_start.y_bounds;
+            y_guess.segment(qp.nq, qp.neq) = -warm_start.y_eq;
+            y_guess.tail(qp.nin) = -warm_start.y_in;
+            y_guess_ptr = y_guess.data();
+        }
+    }
+
     actual_n_wsr = n_wsr;
     if(!sq_problem.isInitialised()){
-        ret_val = sq_problem.init(H_ptr, g_ptr, A_ptr, lb_ptr, ub_ptr, lbA_ptr, ubA_ptr, actual_n_wsr, 0);
+        ret_val = sq_problem.init(H_ptr, g_ptr, A_ptr, lb_ptr, ub_ptr, lbA_ptr, ubA_ptr, actual_n_wsr, 0, x_guess_ptr, y_guess_ptr, guessed_bounds_ptr, guessed_constraints_ptr);
         if(ret_val != SUCCESSFUL_RETURN){
             options.print();
             qp.print();
@@ -88,7 +122,7 @@ void QPOASESSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, base::Vect
         }
     }
     else{
-        ret_val = sq_problem.hotstart(H_ptr, g_ptr, A_ptr, lb_ptr, ub_ptr, lbA_ptr, ubA_ptr, actual_n_wsr, 0);
+        ret_val = sq_problem.hotstart(H_ptr, g_ptr, A_ptr, lb_ptr, ub_ptr, lbA_ptr, ubA_ptr, actual_n_wsr, 0, guessed_bounds_ptr, guessed_constraints_ptr);
         if(ret_val != SUCCESSFUL_RETURN){
             options.print();
             qp.print();
@@ -99,6 +133,25 @@ void QPOASESSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, base::Vect
     solver_output.resize(qp.nq);
     if(sq_problem.getPrimalSolution( solver_output.data() ) == RET_QP_NOT_SOLVED)
         throw std::runtime_error("SQ Problem getPrimalSolution() returned " + std::to_string(RET_QP_NOT_SOLVED));
+    neq = qp.neq;
+    updateWarmStartPredictor(hierarchical_qp, solver_output);
+}
+
+bool QPOASESSolver::getActiveSet(Eigen::VectorXi &constraints, Eigen::VectorXi &bounds){
+    if(!sq_problem.isSolved())
+        return false;
+
+    // qpOASES encodes the working set as +1 (upper bound active), -1 (lower bound active), 0 (inactive), which matches ActiveSetStatus.
+    // Equality constraints are stored in the first neq rows of the constraint matrix
+    working_set_bounds.resize(sq_problem.getNV());
+    working_set_constraints.resize(sq_problem.getNC());
+    if(sq_problem.getWorkingSetBounds(working_set_bounds.data()) != SUCCESSFUL_RETURN ||
+       sq_problem.getWorkingSetConstraints(working_set_constraints.data()) != SUCCESSFUL_RETURN)
+        return false;
+
+    bounds = working_set_bounds.cast<int>();
+    constraints = working_set_constraints.tail(sq_problem.getNC() - neq).cast<int>();
+    return true;
 }
 
 returnValue QPOASESSolver::getReturnValue(){
@@ -134,4 +187,24 @@ void QPOASESSolver::setOptionsPreset(const qpOASES::optionPresets& opt){
     sq_problem.setOptions(options);
 }
 
+void QPOASESSolver::setParameter(const std::string &name, const std::string &value){
+    if(name == "preset"){
+        PrintLevel print_level = options.printLevel;
+        if(value == "default")
+            setOptionsPreset(qp_default);
+        else if(value == "reliable")
+            setOptionsPreset(qp_reliable);
+        else if(value == "fast")
+            setOptionsPreset(qp_fast);
+        else
+            throw std::invalid_argument("QPOASESSolver::setParameter: Invalid preset: " + value);
+        options.printLevel = print_level;
+        sq_problem.setOptions(options);
+    }
+    else if(name == "max_n_wsr")
+        setMaxNoWSR(std::stoi(value));
+    else
+        QPSolver::setParameter(name, value);
+}
+
 }
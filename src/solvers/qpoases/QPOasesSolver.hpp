@@ -55,6 +55,18 @@ public:
     void setOptionsPreset(const qpOASES::optionPresets& opt);
     /** Get Quadratic program*/
     const qpOASES::SQProblem& getSQProblem(){return sq_problem;}
+    /** Return the working set of the last solution. Equality constraints are not included in the constraint status*/
+    virtual bool getActiveSet(Eigen::VectorXi &constraints, Eigen::VectorXi &bounds);
+    /**
+     * Set a parameter by name. Valid parameters are "preset" (default, reliable or fast, see setOptionsPreset(); the print level is kept) and "max_n_wsr"
+     * (see setMaxNoWSR())
+     */
+    virtual void setParameter(const std::string &name, const std::string &value);
+    /**
+     * The prediction of the warm start predictor is used as guessed working set for init() and hotstart(). The primal and dual guess are only used in init(),
+     * i.e., in the first solve after construction or reset().
+     */
+    virtual bool supportsWarmStart(){return true;}
 
 protected:
     qpOASES::Options options;
@@ -64,6 +76,9 @@ protected:
     Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> H;
     Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> A;
     base::Time stamp;
+    int neq;
+    Eigen::VectorXd working_set_bounds, working_set_constraints;
+    Eigen::VectorXd y_guess;
 };
 
 }
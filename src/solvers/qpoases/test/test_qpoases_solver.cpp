@@ -283,3 +283,40 @@ BOOST_AUTO_TEST_CASE(solver_qpoases_bounded)
         BOOST_CHECK((qp.lower_x(j)-1e-9) <= solver_output(j) && solver_output(j) <= (qp.upper_x(j)+1e-9));
 
 }
+
+BOOST_AUTO_TEST_CASE(solver_qpoases_warm_start_predictor)
+{
+    // Bounded least-squares problem with active bounds: Initializing a new solver with the working set of a previous solution (provided by a warm start predictor)
+    // should require fewer working set recalculations than a cold start and yield the same solution
+
+    const int NO_JOINTS = 6;
+
+    wbc::QuadraticProgram qp;
+    qp.resize(NO_JOINTS, 0, 0, true);
+    base::MatrixXd A = base::MatrixXd::Random(NO_JOINTS, NO_JOINTS);
+    base::VectorXd y = base::VectorXd::Random(NO_JOINTS);
+    qp.H = A.transpose()*A + 1e-3*base::MatrixXd::Identity(NO_JOINTS, NO_JOINTS);
+    qp.g = -(A.transpose()*y);
+    qp.lower_x.setConstant(-0.1);
+    qp.upper_x.setConstant(+0.1);
+    wbc::HierarchicalQP hqp;
+    hqp << qp;
+
+    QPOASESSolver cold_solver;
+    base::VectorXd cold_output, warm_output;
+    BOOST_CHECK_NO_THROW(cold_solver.solve(hqp, cold_output));
+
+    WarmStart solution;
+    solution.x = cold_output;
+    BOOST_CHECK(cold_solver.getActiveSet(solution.active_constraints, solution.active_bounds));
+    WarmStartPredictorPtr predictor = std::make_shared<ExtrapolationPredictor>();
+    predictor->update(hqp, solution);
+
+    QPOASESSolver warm_solver;
+    BOOST_CHECK(warm_solver.supportsWarmStart());
+    warm_solver.setWarmStartPredictor(predictor);
+    BOOST_CHECK_NO_THROW(warm_solver.solve(hqp, warm_output));
+    BOOST_CHECK(warm_solver.getNoWSR() <= cold_solver.getNoWSR());
+    for(uint j = 0; j < NO_JOINTS; ++j)
+        BOOST_CHECK(fabs(warm_output(j) - cold_output(j)) < 1e-9);
+}
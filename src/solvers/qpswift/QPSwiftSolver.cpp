@@ -125,4 +125,17 @@ void QPSwiftSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, base::Vect
         solver_output[i] = my_qp->x[i];
 }
 
+void QPSwiftSolver::setParameter(const std::string &name, const std::string &value){
+    if(name == "max_iter")
+        setMaxIter(std::stoi(value));
+    else if(name == "rel_tol")
+        setRelTol(std::stod(value));
+    else if(name == "abs_tol")
+        setAbsTol(std::stod(value));
+    else if(name == "sigma")
+        setSigma(std::stod(value));
+    else
+        QPSolver::setParameter(name, value);
+}
+
 }
@@ -46,6 +46,9 @@ public:
     void setAbsTol(double val){abs_tol=val;}
     void setSigma(double val){sigma=val;}
     void setVerboseLevel(uint val){verbose_level=val;}
+
+    /** Set a parameter by name. Valid parameters are "max_iter", "rel_tol", "abs_tol" and "sigma"*/
+    virtual void setParameter(const std::string &name, const std::string &value);
 };
 }
 
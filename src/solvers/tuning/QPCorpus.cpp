@@ -0,0 +1,157 @@
+#include "QPCorpus.hpp"
+#include <base-logging/Logging.hpp>
+#include <cstring>
+#include <cstdint>
+
+namespace wbc{
+
+static const char QP_SEQUENCE_MAGIC[8] = {'W','B','C','Q','P','S','E','Q'};
+static const int32_t QP_SEQUENCE_VERSION = 1;
+
+template<typename T> void writeValue(std::ofstream &stream, const T &val){
+    stream.write(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+template<typename T> void readValue(std::ifstream &stream, T &val){
+    stream.read(reinterpret_cast<char*>(&val), sizeof(T));
+}
+
+static void writeMatrix(std::ofstream &stream, const base::MatrixXd &mat){
+    writeValue(stream, (int32_t)mat.rows());
+    writeValue(stream, (int32_t)mat.cols());
+    stream.write(reinterpret_cast<const char*>(mat.data()), mat.size()*sizeof(double));
+}
+
+static void writeVector(std::ofstream &stream, const base::VectorXd &vec){
+    writeValue(stream, (int32_t)vec.size());
+    stream.write(reinterpret_cast<const char*>(vec.data()), vec.size()*sizeof(double));
+}
+
+static void readMatrix(std::ifstream &stream, base::MatrixXd &mat){
+    int32_t rows = -1, cols = -1;
+    readValue(stream, rows);
+    readValue(stream, cols);
+    if(!stream || rows < 0 || cols < 0)
+        throw std::runtime_error("loadQPSequence: Invalid matrix size");
+    mat.resize(rows, cols);
+    stream.read(reinterpret_cast<char*>(mat.data()), mat.size()*sizeof(double));
+}
+
+static void readVector(std::ifstream &stream, base::VectorXd &vec){
+    int32_t size = -1;
+    readValue(stream, size);
+    if(!stream || size < 0)
+        throw std::runtime_error("loadQPSequence: Invalid vector size");
+    vec.resize(size);
+    stream.read(reinterpret_cast<char*>(vec.data()), vec.size()*sizeof(double));
+}
+
+QPRecorder::QPRecorder(const std::string &filename) :
+    n_recorded(0){
+    stream.open(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if(!stream.is_open()){
+        LOG_ERROR("QPRecorder: Unable to open file %s", filename.c_str());
+        throw std::runtime_error("QPRecorder: Unable to open file " + filename);
+    }
+    stream.write(QP_SEQUENCE_MAGIC, sizeof(QP_SEQUENCE_MAGIC));
+    writeValue(stream, QP_SEQUENCE_VERSION);
+}
+
+QPRecorder::~QPRecorder(){
+    close();
+}
+
+void QPRecorder::record(const HierarchicalQP &hierarchical_qp){
+    if(!stream.is_open())
+        throw std::runtime_error("QPRecorder::record: File has already been closed");
+
+    writeValue(stream, (int32_t)hierarchical_qp.size());
+    writeValue(stream, (int64_t)hierarchical_qp.time.toMicroseconds());
+    writeVector(stream, hierarchical_qp.Wq);
+    for(const QuadraticProgram &qp : hierarchical_qp.prios){
+        writeValue(stream, (int32_t)qp.nq);
+        writeValue(stream, (int32_t)qp.neq);
+        writeValue(stream, (int32_t)qp.nin);
+        writeValue(stream, (uint8_t)qp.bounded);
+        writeMatrix(stream, qp.H);
+        writeVector(stream, qp.g);
+        writeMatrix(stream, qp.A);
+        writeVector(stream, qp.b);
+        writeMatrix(stream, qp.C);
+        writeVector(stream, qp.lower_y);
+        writeVector(stream, qp.upper_y);
+        writeVector(stream, qp.lower_x);
+        writeVector(stream, qp.upper_x);
+        writeVector(stream, qp.Wy);
+    }
+    if(!stream)
+        throw std::runtime_error("QPRecorder::record: Failed to write QP");
+    n_recorded++;
+}
+
+void QPRecorder::close(){
+    if(stream.is_open())
+        stream.close();
+}
+
+std::vector<HierarchicalQP> loadQPSequence(const std::string &filename){
+    std::ifstream stream(filename.c_str(), std::ios::binary);
+    if(!stream.is_open()){
+        LOG_ERROR("loadQPSequence: Unable to open file %s", filename.c_str());
+        throw std::runtime_error("loadQPSequence: Unable to open file " + filename);
+    }
+
+    char magic[sizeof(QP_SEQUENCE_MAGIC)];
+    int32_t version = 0;
+    stream.read(magic, sizeof(magic));
+    readValue(stream, version);
+    if(!stream || memcmp(magic, QP_SEQUENCE_MAGIC, sizeof(magic)) != 0 || version != QP_SEQUENCE_VERSION){
+        LOG_ERROR("loadQPSequence: File %s is not a QP sequence of version %i", filename.c_str(), QP_SEQUENCE_VERSION);
+        throw std::runtime_error("loadQPSequence: Invalid file header in " + filename);
+    }
+
+    std::vector<HierarchicalQP> sequence;
+    int32_t n_prios;
+    while(stream.peek() != EOF){
+        readValue(stream, n_prios);
+        int64_t time_us = 0;
+        readValue(stream, time_us);
+        if(!stream || n_prios < 0)
+            throw std::runtime_error("loadQPSequence: Invalid QP header in " + filename);
+
+        HierarchicalQP hqp;
+        hqp.time = base::Time::fromMicroseconds(time_us);
+        readVector(stream, hqp.Wq);
+        hqp.resize(n_prios);
+        for(QuadraticProgram &qp : hqp.prios){
+            int32_t nq = 0, neq = 0, nin = 0;
+            uint8_t bounded = 0;
+            readValue(stream, nq);
+            readValue(stream, neq);
+            readValue(stream, nin);
+            readValue(stream, bounded);
+            qp.nq = nq;
+            qp.neq = neq;
+            qp.nin = nin;
+            qp.bounded = bounded != 0;
+            readMatrix(stream, qp.H);
+            readVector(stream, qp.g);
+            readMatrix(stream, qp.A);
+            readVector(stream, qp.b);
+            readMatrix(stream, qp.C);
+            readVector(stream, qp.lower_y);
+            readVector(stream, qp.upper_y);
+            readVector(stream, qp.lower_x);
+            readVector(stream, qp.upper_x);
+            readVector(stream, qp.Wy);
+        }
+        if(!stream){
+            LOG_ERROR("loadQPSequence: File %s is truncated after %i QPs", filename.c_str(), (int)sequence.size());
+            throw std::runtime_error("loadQPSequence: Truncated file " + filename);
+        }
+        sequence.push_back(hqp);
+    }
+    return sequence;
+}
+
+}
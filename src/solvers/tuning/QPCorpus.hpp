@@ -0,0 +1,43 @@
+#ifndef WBC_SOLVERS_QP_CORPUS_HPP
+#define WBC_SOLVERS_QP_CORPUS_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include "../../core/QuadraticProgram.hpp"
+
+namespace wbc{
+
+/**
+ * @brief Records a sequence of hierarchical QPs, e.g., the output of Scene::update() in a control loop, to a binary file. The recorded sequences (a corpus)
+ * can be loaded with loadQPSequence() and replayed, e.g., by the QPSolverTuner. Each QP is written completely (all matrices with their actual size,
+ * so that also the slim equality-only representation is preserved). Data is stored in native byte order.
+ */
+class QPRecorder{
+public:
+    /** Open the given file for writing. Throws if the file cannot be opened*/
+    QPRecorder(const std::string &filename);
+    ~QPRecorder();
+
+    /** Append the given QP to the file*/
+    void record(const HierarchicalQP &hierarchical_qp);
+
+    /** Flush and close the file. Called automatically on destruction*/
+    void close();
+
+    /** Number of QPs recorded so far*/
+    uint getNoRecorded(){return n_recorded;}
+
+protected:
+    std::ofstream stream;
+    uint n_recorded;
+};
+
+/**
+ * @brief loadQPSequence Load a sequence of QPs recorded with the QPRecorder. Throws if the file cannot be opened, has an invalid header or is truncated.
+ */
+std::vector<HierarchicalQP> loadQPSequence(const std::string &filename);
+
+}
+
+#endif
@@ -0,0 +1,167 @@
+#include "QPSolverTuner.hpp"
+#include <base-logging/Logging.hpp>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <cmath>
+
+namespace wbc{
+
+QPSolverTuner::QPSolverTuner() :
+    max_error(1e-6),
+    max_p99_time(std::numeric_limits<double>::infinity()),
+    n_repetitions(3){
+    reference.type = "qpoases";
+    reference.parameters["preset"] = "reliable";
+}
+
+void QPSolverTuner::addSequence(const std::vector<HierarchicalQP> &sequence){
+    if(sequence.empty())
+        throw std::invalid_argument("QPSolverTuner::addSequence: Sequence must not be empty");
+    corpus.push_back(sequence);
+}
+
+void QPSolverTuner::setReference(const QPSolverConfig &config){
+    reference = config;
+}
+
+void QPSolverTuner::setMaxError(const double max_error){
+    if(max_error <= 0)
+        throw std::invalid_argument("QPSolverTuner: Max. error has to be > 0");
+    this->max_error = max_error;
+}
+
+void QPSolverTuner::setMaxP99Time(const double max_p99_time){
+    if(max_p99_time <= 0)
+        throw std::invalid_argument("QPSolverTuner: Max. p99 solve time has to be > 0");
+    this->max_p99_time = max_p99_time;
+}
+
+void QPSolverTuner::setNoRepetitions(const uint n){
+    if(n == 0)
+        throw std::invalid_argument("QPSolverTuner: Number of repetitions has to be > 0");
+    n_repetitions = n;
+}
+
+void QPSolverTuner::addCandidate(const QPSolverConfig &config){
+    candidates.push_back(config);
+}
+
+void QPSolverTuner::addGrid(const std::string &type, const std::map<std::string, std::vector<std::string> > &grid){
+    std::vector<QPSolverConfig> configs(1, QPSolverConfig(type, ""));
+    for(const auto &param : grid){
+        std::vector<QPSolverConfig> extended;
+        for(const QPSolverConfig &cfg : configs){
+            for(const std::string &value : param.second){
+                extended.push_back(cfg);
+                extended.back().parameters[param.first] = value;
+            }
+        }
+        configs = extended;
+    }
+    candidates.insert(candidates.end(), configs.begin(), configs.end());
+}
+
+QPSolverPtr QPSolverTuner::createSolver(const QPSolverConfig &config){
+    QPSolverPtr solver(QPSolverFactory::createInstance(config.type));
+    solver->applyConfig(config);
+    return solver;
+}
+
+void QPSolverTuner::computeReference(){
+    reference_solutions.resize(corpus.size());
+    for(size_t i = 0; i < corpus.size(); i++){
+        QPSolverPtr solver = createSolver(reference);
+        reference_solutions[i].resize(corpus[i].size());
+        for(size_t k = 0; k < corpus[i].size(); k++){
+            try{
+                solver->solve(corpus[i][k], reference_solutions[i][k]);
+            }
+            catch(std::exception &e){
+                LOG_ERROR("QPSolverTuner: Reference solver %s failed on QP %i of sequence %i: %s", reference.type.c_str(), (int)k, (int)i, e.what());
+                throw std::runtime_error("QPSolverTuner: Reference solver failed");
+            }
+        }
+    }
+}
+
+QPSolverTuningResult QPSolverTuner::evaluate(const QPSolverConfig &config){
+    QPSolverTuningResult result;
+    result.config = config;
+    result.n_solves = result.n_failures = 0;
+    result.max_error = result.mean_time = result.p99_time = 0;
+    result.valid = false;
+
+    std::vector<double> solve_times;
+    base::VectorXd solver_output;
+    for(uint r = 0; r < n_repetitions; r++){
+        for(size_t i = 0; i < corpus.size(); i++){
+            QPSolverPtr solver;
+            try{
+                solver = createSolver(config);
+            }
+            catch(std::exception &e){
+                // E.g. unknown solver type or invalid parameter: Count all QPs as failed
+                LOG_ERROR("QPSolverTuner: Failed to create solver %s: %s", config.type.c_str(), e.what());
+                for(const auto &sequence : corpus)
+                    result.n_failures += sequence.size();
+                result.n_failures *= n_repetitions;
+                result.n_solves = result.n_failures;
+                return result;
+            }
+            for(size_t k = 0; k < corpus[i].size(); k++){
+                result.n_solves++;
+                auto start = std::chrono::high_resolution_clock::now();
+                try{
+                    solver->solve(corpus[i][k], solver_output);
+                }
+                catch(std::exception &e){
+                    // Continue with a new solver instance, as the internal state might be invalid
+                    result.n_failures++;
+                    solver = createSolver(config);
+                    continue;
+                }
+                auto end = std::chrono::high_resolution_clock::now();
+                solve_times.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+                double error = std::numeric_limits<double>::infinity();
+                if(solver_output.size() == reference_solutions[i][k].size() && solver_output.allFinite())
+                    error = (solver_output - reference_solutions[i][k]).cwiseAbs().maxCoeff();
+                result.max_error = std::max(result.max_error, error);
+            }
+        }
+    }
+
+    if(!solve_times.empty()){
+        std::sort(solve_times.begin(), solve_times.end());
+        double sum = 0;
+        for(double t : solve_times)
+            sum += t;
+        result.mean_time = sum / solve_times.size();
+        result.p99_time = solve_times[std::min(solve_times.size()-1, (size_t)std::ceil(0.99*solve_times.size())-1)];
+    }
+    result.valid = result.n_failures == 0 && result.max_error <= max_error && result.p99_time <= max_p99_time;
+    return result;
+}
+
+const std::vector<QPSolverTuningResult>& QPSolverTuner::run(){
+    if(corpus.empty())
+        throw std::runtime_error("QPSolverTuner::run: QP corpus is empty");
+    computeReference();
+    results.clear();
+    for(const QPSolverConfig &config : candidates)
+        results.push_back(evaluate(config));
+    return results;
+}
+
+const QPSolverTuningResult& QPSolverTuner::getBest(){
+    int best = -1;
+    for(size_t i = 0; i < results.size(); i++){
+        if(results[i].valid && (best < 0 || results[i].mean_time < results[best].mean_time))
+            best = i;
+    }
+    if(best < 0)
+        throw std::runtime_error("QPSolverTuner::getBest: No configuration meets the accuracy and latency constraints");
+    return results[best];
+}
+
+}
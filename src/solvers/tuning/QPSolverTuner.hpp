@@ -0,0 +1,91 @@
+#ifndef WBC_SOLVERS_QP_SOLVER_TUNER_HPP
+#define WBC_SOLVERS_QP_SOLVER_TUNER_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include "../../core/QPSolver.hpp"
+#include "../../core/QuadraticProgram.hpp"
+
+namespace wbc{
+
+/** Evaluation of a single solver configuration on the QP corpus*/
+struct QPSolverTuningResult{
+    QPSolverConfig config;  /** Evaluated solver type and parameters*/
+    uint n_solves;          /** Number of solved QPs (all sequences and repetitions)*/
+    uint n_failures;        /** Number of QPs for which the solver threw an exception*/
+    double max_error;       /** Max. deviation (infinity norm) of a solution from the reference solution*/
+    double mean_time;       /** Mean solve time in microseconds*/
+    double p99_time;        /** 99th percentile of the solve time in microseconds*/
+    bool valid;             /** True if no solve failed and the accuracy and latency constraints are met*/
+};
+
+/**
+ * @brief Offline tuning of the QP solver backend and its parameters. A corpus of recorded QP sequences (see QPRecorder) is replayed through a set
+ * of candidate solver configurations (solver type from the QPSolverFactory plus parameters, see QPSolver::setParameter()), e.g., a grid over the
+ * parameters of all available backends. Each sequence is solved in order, starting with a newly created solver, so that warm starting is evaluated as in the
+ * control loop. All solutions are compared with those of a reference solver with tight tolerances. The fastest configuration (mean solve time) that
+ * solves all QPs within the given accuracy and p99 solve time is returned and can be written to a solver config file (QPSolverConfig::save()).
+ */
+class QPSolverTuner{
+public:
+    QPSolverTuner();
+
+    /** Add a sequence of QPs to the corpus. Throws if the sequence is empty*/
+    void addSequence(const std::vector<HierarchicalQP> &sequence);
+
+    /** Set the reference solver. Default is qpOASES with the "reliable" preset*/
+    void setReference(const QPSolverConfig &config);
+
+    /** Max. allowed deviation (infinity norm) from the reference solution. Default is 1e-6*/
+    void setMaxError(const double max_error);
+
+    /** Max. allowed 99th percentile of the solve time in microseconds. Default is infinity, i.e., no latency constraint*/
+    void setMaxP99Time(const double max_p99_time);
+
+    /** Number of times the corpus is replayed for each configuration to gather timing statistics. Default is 3*/
+    void setNoRepetitions(const uint n);
+
+    /** Add a single candidate configuration*/
+    void addCandidate(const QPSolverConfig &config);
+
+    /**
+     * @brief addGrid Add one candidate for each combination of the given parameter values (cartesian product). An empty grid adds a single candidate with
+     * default parameters.
+     * @param type Solver type as registered in the QPSolverFactory
+     * @param grid Parameter name and the values to be tested for this parameter
+     */
+    void addGrid(const std::string &type, const std::map<std::string, std::vector<std::string> > &grid);
+
+    /** Evaluate all candidates. Throws if the corpus is empty or if the reference solver fails on any QP*/
+    const std::vector<QPSolverTuningResult>& run();
+
+    /** Results of the last run(), in the order of the candidates*/
+    const std::vector<QPSolverTuningResult>& getResults(){return results;}
+
+    /** Fastest valid configuration of the last run(). Throws if no configuration is valid*/
+    const QPSolverTuningResult& getBest();
+
+    /** Candidate configurations*/
+    const std::vector<QPSolverConfig>& getCandidates(){return candidates;}
+
+protected:
+    /** Create a solver from the given config*/
+    QPSolverPtr createSolver(const QPSolverConfig &config);
+    /** Solve the corpus with the reference solver*/
+    void computeReference();
+    /** Replay the corpus with the given configuration*/
+    QPSolverTuningResult evaluate(const QPSolverConfig &config);
+
+    std::vector<std::vector<HierarchicalQP> > corpus;
+    std::vector<std::vector<base::VectorXd> > reference_solutions;
+    std::vector<QPSolverConfig> candidates;
+    std::vector<QPSolverTuningResult> results;
+    QPSolverConfig reference;
+    double max_error, max_p99_time;
+    uint n_repetitions;
+};
+
+}
+
+#endif
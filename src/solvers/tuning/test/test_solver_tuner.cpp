@@ -0,0 +1,118 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "core/QuadraticProgram.hpp"
+#include "solvers/tuning/QPCorpus.hpp"
+#include "solvers/tuning/QPSolverTuner.hpp"
+#include "solvers/box_qp/BoxQPSolver.hpp"
+#include "solvers/qpoases/QPOasesSolver.hpp"
+
+using namespace wbc;
+using namespace std;
+
+/** Slowly varying sequence of random least-squares QPs with equality constraints and bounds*/
+vector<HierarchicalQP> randomSequence(const uint nq, const uint neq, const uint length){
+    QuadraticProgram qp;
+    qp.resize(nq, neq, 0, true);
+    base::MatrixXd J = base::MatrixXd::Random(nq+3, nq);
+    qp.H = J.transpose()*J;
+    qp.g = 5*base::VectorXd::Random(nq);
+    qp.A.setRandom();
+    qp.b.setZero();
+    qp.lower_x.setConstant(-0.1);
+    qp.upper_x.setConstant(0.1);
+    qp.Wy.setOnes();
+    vector<HierarchicalQP> sequence;
+    for(uint n = 0; n < length; n++){
+        qp.g += 1e-2*base::VectorXd::Random(nq);
+        HierarchicalQP hqp;
+        hqp << qp;
+        hqp.Wq.setOnes(nq);
+        hqp.time = base::Time::fromMicroseconds(1000*n);
+        sequence.push_back(hqp);
+    }
+    return sequence;
+}
+
+BOOST_AUTO_TEST_CASE(qp_recorder){
+
+    vector<HierarchicalQP> sequence = randomSequence(10, 4, 20);
+    QuadraticProgram equality_only;
+    equality_only.resizeEqualityOnly(10, 3);
+    equality_only.A.setRandom();
+    equality_only.b.setRandom();
+    equality_only.Wy.setOnes();
+    sequence[5] << equality_only;
+
+    QPRecorder recorder("qp_sequence.bin");
+    for(const HierarchicalQP &hqp : sequence)
+        recorder.record(hqp);
+    BOOST_CHECK(recorder.getNoRecorded() == sequence.size());
+    recorder.close();
+
+    vector<HierarchicalQP> loaded = loadQPSequence("qp_sequence.bin");
+    BOOST_CHECK(loaded.size() == sequence.size());
+    for(size_t k = 0; k < loaded.size(); k++){
+        BOOST_CHECK(loaded[k].size() == sequence[k].size());
+        BOOST_CHECK(loaded[k].time == sequence[k].time);
+        BOOST_CHECK(loaded[k].Wq == sequence[k].Wq);
+        for(size_t i = 0; i < loaded[k].size(); i++){
+            const QuadraticProgram &a = loaded[k][i], &b = sequence[k][i];
+            BOOST_CHECK(a.nq == b.nq && a.neq == b.neq && a.nin == b.nin && a.bounded == b.bounded);
+            BOOST_CHECK(a.H == b.H && a.g == b.g && a.A == b.A && a.b == b.b && a.C == b.C);
+            BOOST_CHECK(a.lower_x == b.lower_x && a.upper_x == b.upper_x && a.lower_y == b.lower_y && a.upper_y == b.upper_y && a.Wy == b.Wy);
+        }
+    }
+    BOOST_CHECK(loaded[5][1].isEqualityOnly());
+
+    BOOST_CHECK_THROW(loadQPSequence("non_existing_file.bin"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(qp_solver_tuner){
+
+    // Make sure that the solver libraries are linked and registered
+    BoxQPSolver box_qp_solver;
+    QPOASESSolver qpoases_solver;
+
+    QPSolverTuner tuner;
+    tuner.addSequence(randomSequence(10, 4, 50));
+    tuner.addSequence(randomSequence(10, 4, 50));
+    tuner.setNoRepetitions(1);
+    tuner.addGrid("qpoases", {{"preset", {"default", "fast"}}, {"max_n_wsr", {"100", "1000"}}});
+    tuner.addGrid("box_qp", {});
+    tuner.addCandidate(QPSolverConfig("unknown_solver", ""));
+    QPSolverConfig invalid_parameter("box_qp", "");
+    invalid_parameter.parameters["unknown_parameter"] = "1";
+    tuner.addCandidate(invalid_parameter);
+    BOOST_CHECK(tuner.getCandidates().size() == 7);
+
+    BOOST_CHECK_THROW(tuner.getBest(), std::runtime_error);
+    const vector<QPSolverTuningResult>& results = tuner.run();
+    BOOST_CHECK(results.size() == 7);
+    for(uint i = 0; i < 5; i++){
+        BOOST_CHECK(results[i].valid);
+        BOOST_CHECK(results[i].n_solves == 100);
+        BOOST_CHECK(results[i].n_failures == 0);
+        BOOST_CHECK(results[i].max_error < 1e-6);
+        BOOST_CHECK(results[i].mean_time > 0 && results[i].p99_time > 0);
+    }
+    BOOST_CHECK(results[0].config.parameters.at("preset") == "default");
+    BOOST_CHECK(results[0].config.parameters.at("max_n_wsr") == "100");
+    BOOST_CHECK(!results[5].valid && results[5].n_failures == 100);
+    BOOST_CHECK(!results[6].valid && results[6].n_failures == 100);
+
+    // Best config can be saved and loaded
+    QPSolverConfig best = tuner.getBest().config;
+    best.save("best_solver_config.yml");
+    QPSolverConfig loaded;
+    loaded.load("best_solver_config.yml");
+    BOOST_CHECK(loaded.type == best.type);
+    BOOST_CHECK(loaded.parameters == best.parameters);
+    QPSolverPtr solver(QPSolverFactory::createInstance(loaded.type));
+    BOOST_CHECK_NO_THROW(solver->applyConfig(loaded));
+
+    // Latency constraint that cannot be met
+    tuner.setMaxP99Time(1e-6);
+    tuner.run();
+    BOOST_CHECK_THROW(tuner.getBest(), std::runtime_error);
+}
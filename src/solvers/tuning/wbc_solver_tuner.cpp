@@ -0,0 +1,108 @@
+#include "QPSolverTuner.hpp"
+#include "QPCorpus.hpp"
+#include "../../core/PluginLoader.hpp"
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+using namespace wbc;
+
+void usage(){
+    cout << "Usage: wbc_solver_tuner <output_config_file> <qp_sequence_1> [<qp_sequence_2> ...] [--max_error <e>] [--max_p99 <us>] [--repetitions <n>] [--reference <solver>]" << endl;
+    cout << "Replays the QP sequences recorded with the QPRecorder through all available solver backends over a grid of solver parameters and writes the" << endl;
+    cout << "fastest configuration that meets the accuracy (max. deviation from the reference solver) and p99 latency constraints to <output_config_file>." << endl;
+    cout << "The config file can be loaded with QPSolverConfig::load(). Default reference solver is qpoases with the 'reliable' preset." << endl;
+}
+
+int main(int argc, char** argv){
+
+    if(argc < 3){
+        usage();
+        return -1;
+    }
+
+    QPSolverTuner tuner;
+    string output_file = argv[1];
+    vector<string> sequence_files;
+    for(int i = 2; i < argc; i++){
+        string arg = argv[i];
+        if(arg == "--max_error" && i+1 < argc)
+            tuner.setMaxError(atof(argv[++i]));
+        else if(arg == "--max_p99" && i+1 < argc)
+            tuner.setMaxP99Time(atof(argv[++i]));
+        else if(arg == "--repetitions" && i+1 < argc)
+            tuner.setNoRepetitions(atoi(argv[++i]));
+        else if(arg == "--reference" && i+1 < argc)
+            tuner.setReference(QPSolverConfig(argv[++i], ""));
+        else if(arg.find("--") == 0){
+            usage();
+            return -1;
+        }
+        else
+            sequence_files.push_back(arg);
+    }
+    if(sequence_files.empty()){
+        usage();
+        return -1;
+    }
+
+    uint n_qps = 0;
+    for(const string &file : sequence_files){
+        vector<HierarchicalQP> sequence = loadQPSequence(file);
+        n_qps += sequence.size();
+        tuner.addSequence(sequence);
+    }
+    cout << "Loaded " << n_qps << " QPs from " << sequence_files.size() << " sequence(s)" << endl;
+
+    // Parameter grid for each backend. Backends that are not installed are skipped.
+    typedef map<string, vector<string> > Grid;
+    vector<pair<string,Grid> > backends = {
+        {"qpoases",    {{"preset", {"default", "reliable", "fast"}}}},
+        {"box_qp",     {}},
+        {"eiquadprog", {}},
+        {"osqp",       {{"rho", {"0.01", "0.1", "1"}}, {"eps_abs", {"1e-5", "1e-7"}}, {"eps_rel", {"1e-5", "1e-7"}}, {"polish", {"0", "1"}}}},
+        {"proxqp",     {{"eps_abs", {"1e-5", "1e-7", "1e-9"}}, {"max_iter", {"100", "1000", "10000"}}}},
+        {"qpswift",    {{"sigma", {"50", "100"}}, {"max_iter", {"100", "1000"}}}}
+    };
+    for(const auto &backend : backends){
+        if(QPSolverFactory::getQPSolverMap()->count(backend.first) == 0){
+            try{
+                PluginLoader::loadPlugin("libwbc-solvers-" + backend.first + ".so");
+            }
+            catch(std::exception &e){
+                cout << "Solver " << backend.first << " is not available, skipping" << endl;
+                continue;
+            }
+        }
+        tuner.addGrid(backend.first, backend.second);
+    }
+    if(tuner.getCandidates().empty()){
+        cerr << "No solver backend available" << endl;
+        return -1;
+    }
+    cout << "Evaluating " << tuner.getCandidates().size() << " configurations" << endl;
+
+    for(const QPSolverTuningResult &result : tuner.run()){
+        string params;
+        for(const auto &p : result.config.parameters)
+            params += p.first + "=" + p.second + " ";
+        cout << setw(12) << left << result.config.type << setw(56) << params
+             << " mean: " << setw(10) << result.mean_time << " p99: " << setw(10) << result.p99_time
+             << " max. error: " << setw(12) << result.max_error << " failures: " << result.n_failures << "/" << result.n_solves
+             << (result.valid ? "" : " (invalid)") << endl;
+    }
+
+    const QPSolverTuningResult *best = 0;
+    try{
+        best = &tuner.getBest();
+    }
+    catch(std::exception &e){
+        cerr << "No configuration meets the accuracy and latency constraints" << endl;
+        return -1;
+    }
+    best->config.save(output_file);
+    cout << "Best configuration: " << best->config.type << ", mean solve time: " << best->mean_time << " (mu s), p99: " << best->p99_time
+         << " (mu s). Written to " << output_file << endl;
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "UnconstrainedFirstSolver.hpp"
+#include "../../core/QuadraticProgram.hpp"
+#include <stdexcept>
+
+namespace wbc{
+
+UnconstrainedFirstSolver::UnconstrainedFirstSolver(QPSolverPtr backend, const double tolerance) :
+    backend(backend),
+    shortcut_taken(false),
+    n_solves(0),
+    n_shortcuts(0){
+    if(!backend)
+        throw std::invalid_argument("UnconstrainedFirstSolver: Backend solver must not be null");
+    setTolerance(tolerance);
+}
+
+UnconstrainedFirstSolver::~UnconstrainedFirstSolver(){
+}
+
+void UnconstrainedFirstSolver::setTolerance(const double tol){
+    if(tol < 0)
+        throw std::invalid_argument("UnconstrainedFirstSolver: Tolerance has to be >= 0");
+    tolerance = tol;
+}
+
+void UnconstrainedFirstSolver::reset(){
+    QPSolver::reset();
+    backend->reset();
+}
+
+bool UnconstrainedFirstSolver::solveEqualityConstrained(const wbc::QuadraticProgram &qp, base::VectorXd &x){
+
+    llt.compute(qp.H);
+    if(llt.info() != Eigen::Success)
+        return false;
+
+    // Unconstrained minimum: x0 = -H^-1 * g
+    x0 = -qp.g;
+    llt.solveInPlace(x0);
+
+    if(qp.neq > 0){
+        // KKT conditions: H*x + g + A^T*lambda = 0, A*x = b. Eliminating x gives
+        // (A*H^-1*A^T) * lambda = A*x0 - b, x = x0 - H^-1*A^T*lambda.
+        // LDLT is used for the Schur complement, since A may contain zero rows
+        Hinv_At = qp.A.transpose();
+        llt.solveInPlace(Hinv_At);
+        schur.noalias() = qp.A * Hinv_At;
+        schur_ldlt.compute(schur);
+        lambda.noalias() = qp.A * x0;
+        lambda -= qp.b;
+        lambda = schur_ldlt.solve(lambda);
+        x.noalias() = x0 - Hinv_At * lambda;
+
+        // Equalities might be inconsistent
+        if(((qp.A * x - qp.b).array().abs() > tolerance).any())
+            return false;
+    }
+    else
+        x = x0;
+
+    return isFeasible(qp, x, tolerance);
+}
+
+void UnconstrainedFirstSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output){
+
+    n_solves++;
+    shortcut_taken = false;
+
+    if(hierarchical_qp.size() == 1){
+        const wbc::QuadraticProgram &qp = hierarchical_qp[0];
+        solver_output.resize(qp.nq);
+        if(solveEqualityConstrained(qp, solver_output)){
+            shortcut_taken = true;
+            n_shortcuts++;
+            return;
+        }
+    }
+
+    backend->solve(hierarchical_qp, solver_output);
+}
+
+}
@@ -0,0 +1,86 @@
+#ifndef WBC_SOLVERS_UNCONSTRAINED_FIRST_SOLVER_HPP
+#define WBC_SOLVERS_UNCONSTRAINED_FIRST_SOLVER_HPP
+
+#include "../../core/QPSolver.hpp"
+#include <Eigen/Cholesky>
+
+namespace wbc{
+
+class HierarchicalQP;
+class QuadraticProgram;
+
+/**
+ * @brief Solver front-end that tries to avoid calling a full QP solver. It first ignores all inequality constraints and bounds and solves the equality constrained problem
+ *  \f[
+ *        \begin{array}{ccc}
+ *        min(\mathbf{x}) & \frac{1}{2} \mathbf{x}^T\mathbf{H}\mathbf{x}+\mathbf{x}^T\mathbf{g}& \\
+ *             & & \\
+ *        s.t. & \mathbf{Ax} = \mathbf{b}& \\
+ *        \end{array}
+ *  \f]
+ * directly from its KKT conditions, using a Cholesky decomposition of H and the Schur complement \f$\mathbf{AH}^{-1}\mathbf{A}^T\f$. If the solution fulfills all inequality constraints
+ * and bounds (within the given tolerance), it is also the solution of the full QP and is returned. Otherwise the full QP is passed to the backend solver.
+ * This pays off if the inequalities are rarely active, e.g., joint limits in free-space motion. H has to be positive definite.
+ *
+ * Since the front-end requires a backend solver, it is not registered in the QPSolverFactory, e.g. use
+ * \code
+ *     QPSolverPtr solver = std::make_shared<UnconstrainedFirstSolver>(std::make_shared<QPOASESSolver>());
+ * \endcode
+ */
+class UnconstrainedFirstSolver : public QPSolver{
+public:
+    /**
+     * @param backend Solver that is used if the solution of the equality constrained problem violates any inequality constraint or bound
+     * @param tolerance Allowed violation of inequality constraints and bounds
+     */
+    UnconstrainedFirstSolver(QPSolverPtr backend, const double tolerance = 1e-9);
+    virtual ~UnconstrainedFirstSolver();
+
+    /**
+     * @brief solve Solve the given quadratic program
+     * @param hierarchical_qp Description of the hierarchical quadratic program to solve. Hierarchical QPs with more than one priority are directly passed to the backend.
+     * @param solver_output solution of the quadratic program
+     */
+    virtual void solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output);
+
+    /** Enforce reconfiguration of the backend at the next call to solve()*/
+    virtual void reset();
+
+    /** Return the backend solver*/
+    QPSolverPtr getBackend(){return backend;}
+
+    /** Set the allowed violation of inequality constraints and bounds*/
+    void setTolerance(const double tol);
+
+    /** Get the allowed violation of inequality constraints and bounds*/
+    double getTolerance(){return tolerance;}
+
+    /** True if the last call to solve() returned the solution of the equality constrained problem, i.e., the backend has not been called*/
+    bool shortcutTaken(){return shortcut_taken;}
+
+    /** Number of calls to solve() since construction or last call to resetCounters()*/
+    uint getNoSolves(){return n_solves;}
+
+    /** Number of calls to solve() that did not require the backend since construction or last call to resetCounters()*/
+    uint getNoShortcuts(){return n_shortcuts;}
+
+    /** Set all counters to zero*/
+    void resetCounters(){n_solves = n_shortcuts = 0;}
+
+protected:
+    /** Solve the equality constrained QP. Return false if the solution does not fulfill the inequality constraints and bounds*/
+    bool solveEqualityConstrained(const wbc::QuadraticProgram &qp, base::VectorXd &x);
+
+    QPSolverPtr backend;
+    double tolerance;
+    bool shortcut_taken;
+    uint n_solves, n_shortcuts;
+
+    Eigen::LLT<Eigen::MatrixXd> llt;
+    Eigen::LDLT<Eigen::MatrixXd> schur_ldlt;
+    Eigen::MatrixXd Hinv_At, schur;
+    Eigen::VectorXd x0, lambda;
+};
+
+}
+#endif
@@ -0,0 +1,51 @@
+#include "UnconstrainedSolver.hpp"
+#include "../../core/QuadraticProgram.hpp"
+#include <stdexcept>
+
+namespace wbc{
+
+QPSolverRegistry<UnconstrainedSolver> UnconstrainedSolver::reg("unconstrained");
+
+UnconstrainedSolver::UnconstrainedSolver() :
+    used_ldlt(false){
+}
+
+UnconstrainedSolver::~UnconstrainedSolver(){
+}
+
+void UnconstrainedSolver::solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output){
+
+    if(hierarchical_qp.size() != 1)
+        throw std::runtime_error("UnconstrainedSolver::solve: Constraints vector size must be 1 for the current implementation");
+
+    const wbc::QuadraticProgram &qp = hierarchical_qp[0];
+    if(!qp.isUnconstrained())
+        throw std::runtime_error("UnconstrainedSolver::solve: The given QP has active constraints, use a constrained QP solver instead");
+
+    if(!configured){
+        llt = Eigen::LLT<Eigen::MatrixXd>(qp.nq);
+        ldlt = Eigen::LDLT<Eigen::MatrixXd>(qp.nq);
+        configured = true;
+    }
+    else if(llt.rows() != qp.nq)
+        throw std::runtime_error("QP problem changed dynamically. Not supported at the moment.");
+
+    solver_output.resize(qp.nq);
+    used_ldlt = false;
+    llt.compute(qp.H);
+    if(llt.info() == Eigen::Success){
+        solver_output = -qp.g;
+        llt.solveInPlace(solver_output);
+        return;
+    }
+
+    // H is not positive definite, e.g. because of a task with zero weight
+    used_ldlt = true;
+    ldlt.compute(qp.H);
+    if(ldlt.info() != Eigen::Success)
+        throw std::runtime_error("UnconstrainedSolver::solve: Failed to decompose the Hessian matrix");
+    solver_output = -qp.g;
+    ldlt.solveInPlace(solver_output);
+}
+
+}
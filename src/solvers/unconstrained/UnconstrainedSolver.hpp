@@ -0,0 +1,47 @@
+#ifndef WBC_SOLVERS_UNCONSTRAINED_SOLVER_HPP
+#define WBC_SOLVERS_UNCONSTRAINED_SOLVER_HPP
+
+#include "../../core/QPSolver.hpp"
+#include <Eigen/Cholesky>
+
+namespace wbc{
+
+class HierarchicalQP;
+
+/**
+ * @brief Direct solver for quadratic programs without (active) constraints. It solves problems of shape
+ *  \f[
+ *        \begin{array}{ccc}
+ *        min(\mathbf{x}) & \frac{1}{2} \mathbf{x}^T\mathbf{H}\mathbf{x}+\mathbf{x}^T\mathbf{g}& \\
+ *        \end{array}
+ *  \f]
+ * by solving \f$\mathbf{Hx} = -\mathbf{g}\f$ with a Cholesky decomposition (LLT) of H. If H is only positive semi-definite, an LDLT decomposition is used instead.
+ * Equality constraints with zero rows and inequality constraints/bounds beyond +-1e10 (see QuadraticProgram::isUnconstrained()) are ignored, all other constraints are rejected.
+ * The decompositions are allocated once for the problem size, so that no memory is allocated during solve().
+ */
+class UnconstrainedSolver : public QPSolver{
+private:
+    static QPSolverRegistry<UnconstrainedSolver> reg;
+
+public:
+    UnconstrainedSolver();
+    virtual ~UnconstrainedSolver();
+
+    /**
+     * @brief solve Solve the given quadratic program
+     * @param hierarchical_qp Description of the hierarchical quadratic program to solve. Only one priority level is supported.
+     * @param solver_output solution of the quadratic program
+     */
+    virtual void solve(const wbc::HierarchicalQP &hierarchical_qp, base::VectorXd &solver_output);
+
+    /** Return true if the last problem could not be solved with LLT and LDLT was used instead*/
+    bool usedLDLT(){return used_ldlt;}
+
+protected:
+    Eigen::LLT<Eigen::MatrixXd> llt;
+    Eigen::LDLT<Eigen::MatrixXd> ldlt;
+    bool used_ldlt;
+};
+
+}
+#endif
@@ -0,0 +1,111 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "solvers/unconstrained/UnconstrainedSolver.hpp"
+#include "solvers/unconstrained/UnconstrainedFirstSolver.hpp"
+#include "solvers/qpoases/QPOasesSolver.hpp"
+#include "core/QuadraticProgram.hpp"
+
+using namespace wbc;
+using namespace std;
+
+BOOST_AUTO_TEST_CASE(solver_unconstrained)
+{
+    /**
+     * Solve an unconstrained QP with inert constraints and compare with the closed form solution
+     */
+
+    const uint NO_JOINTS = 6;
+
+    wbc::QuadraticProgram qp;
+    qp.resize(NO_JOINTS, NO_JOINTS, 0, true);
+    base::MatrixXd J = base::MatrixXd::Random(NO_JOINTS, NO_JOINTS);
+    qp.H = J.transpose()*J + base::MatrixXd::Identity(NO_JOINTS, NO_JOINTS);
+    qp.g.setRandom();
+    qp.A.setZero();
+    qp.b.setZero();
+    qp.lower_x.setConstant(-1e10);
+    qp.upper_x.setConstant(1e10);
+    qp.check();
+
+    BOOST_CHECK(qp.isUnconstrained());
+
+    wbc::HierarchicalQP hqp;
+    hqp << qp;
+
+    UnconstrainedSolver solver;
+    base::VectorXd solver_output;
+    BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+    BOOST_CHECK(solver.usedLDLT() == false);
+
+    base::VectorXd x = -qp.H.inverse()*qp.g;
+    for(uint i = 0; i < NO_JOINTS; i++)
+        BOOST_CHECK(fabs(solver_output(i) - x(i)) < 1e-9);
+
+    // Positive semi-definite Hessian: Fall back to LDLT
+    hqp[0].H.setZero();
+    hqp[0].H.topLeftCorner(3,3).setIdentity();
+    hqp[0].g.setZero();
+    hqp[0].g.head(3).setOnes();
+    BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+    BOOST_CHECK(solver.usedLDLT() == true);
+    for(uint i = 0; i < 3; i++)
+        BOOST_CHECK(fabs(solver_output(i) + 1) < 1e-9);
+
+    // Active constraints are not supported
+    hqp[0].upper_x.setConstant(1);
+    BOOST_CHECK_THROW(solver.solve(hqp, solver_output), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(solver_unconstrained_first)
+{
+    /**
+     * Solve an equality constrained QP with bounds. If the bounds are not active, the front-end should return the solution without calling the backend.
+     * Otherwise, the result of the backend should be returned
+     */
+
+    const uint NO_JOINTS = 6;
+    const uint NO_EQ_CONSTRAINTS = 2;
+
+    wbc::QuadraticProgram qp;
+    qp.resize(NO_JOINTS, NO_EQ_CONSTRAINTS, 0, true);
+    base::MatrixXd J = base::MatrixXd::Random(NO_JOINTS, NO_JOINTS);
+    qp.H = J.transpose()*J + base::MatrixXd::Identity(NO_JOINTS, NO_JOINTS);
+    qp.g.setRandom();
+    qp.A.setRandom();
+    qp.b.setRandom();
+    qp.lower_x.setConstant(-1e3);
+    qp.upper_x.setConstant(1e3);
+
+    wbc::HierarchicalQP hqp;
+    hqp << qp;
+
+    std::shared_ptr<QPOASESSolver> backend = std::make_shared<QPOASESSolver>();
+    qpOASES::Options options = backend->getOptions();
+    options.printLevel = qpOASES::PL_NONE;
+    backend->setOptions(options);
+    UnconstrainedFirstSolver solver(backend);
+
+    // Inactive bounds: Shortcut
+    base::VectorXd solver_output, backend_output;
+    BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+    BOOST_CHECK(solver.shortcutTaken() == true);
+    BOOST_CHECK_NO_THROW(backend->solve(hqp, backend_output));
+    for(uint i = 0; i < NO_JOINTS; i++)
+        BOOST_CHECK(fabs(solver_output(i) - backend_output(i)) < 1e-6);
+    base::VectorXd eq = qp.A*solver_output - qp.b;
+    for(uint i = 0; i < NO_EQ_CONSTRAINTS; i++)
+        BOOST_CHECK(fabs(eq(i)) < 1e-9);
+
+    // Active bounds: Call backend
+    double max = solver_output.cwiseAbs().maxCoeff();
+    hqp[0].lower_x.setConstant(-0.5*max);
+    hqp[0].upper_x.setConstant(0.5*max);
+    BOOST_CHECK_NO_THROW(solver.solve(hqp, solver_output));
+    BOOST_CHECK(solver.shortcutTaken() == false);
+    for(uint i = 0; i < NO_JOINTS; i++)
+        BOOST_CHECK(fabs(solver_output(i)) <= 0.5*max + 1e-9);
+
+    BOOST_CHECK(solver.getNoSolves() == 2);
+    BOOST_CHECK(solver.getNoShortcuts() == 1);
+}
@@ -20,7 +20,7 @@ CartesianAccelerationTask::CartesianAccelerationTask(TaskConfig config, uint n_r
     : CartesianTask(config, n_robot_joints){
 }
 
-void CartesianAccelerationTask::update(RobotModelPtr robot_model){
+void CartesianAccelerationTask::update(const RobotModelPtr& robot_model){
     // Task Jacobian
     A = robot_model->spaceJacobian(config.root, config.tip);
 
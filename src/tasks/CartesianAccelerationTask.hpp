@@ -21,7 +21,7 @@ public:
      * @brief Compute the cartesian task matrix A
      * @param robot_model Pointer to the robot model from which get the state and compute the cartesian task matrix A
      */
-    virtual void update(RobotModelPtr robot_model) override;
+    virtual void update(const RobotModelPtr& robot_model) override;
 
     /**
      * @brief Update the Cartesian reference input for this task.
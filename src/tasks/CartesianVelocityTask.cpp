@@ -8,7 +8,7 @@ CartesianVelocityTask::CartesianVelocityTask(TaskConfig config, uint n_robot_joi
     : CartesianTask(config, n_robot_joints){
 }
 
-void CartesianVelocityTask::update(RobotModelPtr robot_model){
+void CartesianVelocityTask::update(const RobotModelPtr& robot_model){
     
     // Task Jacobian
     A = robot_model->spaceJacobian(config.root, config.tip);
@@ -8,7 +8,7 @@ CoMAccelerationTask::CoMAccelerationTask(TaskConfig config, uint n_robot_joints)
     : CartesianTask(config, n_robot_joints){
 }
 
-void CoMAccelerationTask::update(RobotModelPtr robot_model){
+void CoMAccelerationTask::update(const RobotModelPtr& robot_model){
     A = robot_model->comJacobian();
     // Desired task space acceleration: y_r = y_d - Jdot*qdot
     y_ref = y_ref - robot_model->spatialAccelerationBias(robot_model->worldFrame(), robot_model->baseFrame()).linear;
@@ -13,7 +13,7 @@ public:
     CoMAccelerationTask(TaskConfig config, uint n_robot_joints);
     virtual ~CoMAccelerationTask() = default;
 
-    virtual void update(RobotModelPtr robot_model) override;
+    virtual void update(const RobotModelPtr& robot_model) override;
 
     /**
      * @brief Update the CoM reference input for this task.
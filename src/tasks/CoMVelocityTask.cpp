@@ -8,7 +8,7 @@ CoMVelocityTask::CoMVelocityTask(TaskConfig config, uint n_robot_joints)
     : CartesianTask(config, n_robot_joints){
 }
 
-void CoMVelocityTask::update(RobotModelPtr robot_model){
+void CoMVelocityTask::update(const RobotModelPtr& robot_model){
     A = robot_model->comJacobian();
     // CoM tasks are always in world/base frame, no need to transform.
     y_ref_root = y_ref;
@@ -8,7 +8,7 @@ JointVelocityTask::JointVelocityTask(TaskConfig config, uint n_robot_joints)
 
 }
 
-void JointVelocityTask::update(RobotModelPtr robot_model){
+void JointVelocityTask::update(const RobotModelPtr& robot_model){
 
     // Joint space tasks: task matrix has only ones and Zeros. The joint order in the tasks might be different than in the robot model.
     // Thus, for joint space tasks, the joint indices have to be mapped correctly.
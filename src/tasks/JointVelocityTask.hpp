@@ -16,7 +16,7 @@ public:
      * @brief Compute the joint task matrix A
      * @param robot_model Pointer to the robot model from which get the state and compute the joint task matrix A
      */
-    virtual void update(RobotModelPtr robot_model) override;
+    virtual void update(const RobotModelPtr& robot_model) override;
 
     /**
      * @brief Update the Joint reference input for this task.
@@ -2,13 +2,14 @@
 
 namespace wbc {
 
-int svd_eigen_decomposition(const base::MatrixXd& A,
-                            base::MatrixXd& U,
-                            base::VectorXd& S,
-                            base::MatrixXd& V,
-                            base::VectorXd& tmp,
+template<typename Scalar>
+int svd_eigen_decomposition(const Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic>& A,
+                            Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic>& U,
+                            Eigen::Matrix<Scalar,Eigen::Dynamic,1>& S,
+                            Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic>& V,
+                            Eigen::Matrix<Scalar,Eigen::Dynamic,1>& tmp,
                             int maxiter,
-                            double epsilon){
+                            Scalar epsilon){
         //get the rows/columns of the matrix
         const int rows = A.rows();
         const int cols = A.cols();
@@ -19,7 +20,7 @@ int svd_eigen_decomposition(const base::MatrixXd& A,
         int i(-1),its(-1),j(-1),jj(-1),k(-1),nm=0;
         int ppi(0);
         bool flag,maxarg1,maxarg2;
-        double anorm(0),c(0),f(0),h(0),s(0),scale(0),x(0),y(0),z(0),g(0);
+        Scalar anorm(0),c(0),f(0),h(0),s(0),scale(0),x(0),y(0),z(0),g(0);
 
         /* Householder reduction to bidiagonal form. */
         for (i=0;i<cols;i++) {
@@ -28,8 +29,8 @@ int svd_eigen_decomposition(const base::MatrixXd& A,
             g=s=scale=0.0;
             if (i<rows) {
                 // compute the sum of the i-th column, starting from the i-th row
-                for (k=i;k<rows;k++) scale += fabs(U(k,i));
-                if (fabs(scale)>epsilon) {
+                for (k=i;k<rows;k++) scale += std::abs(U(k,i));
+                if (std::abs(scale)>epsilon) {
                     // multiply the i-th column by 1.0/scale, start from the i-th element
                     // sum of squares of column i, start from the i-th element
                     for (k=i;k<rows;k++) {
@@ -38,7 +39,7 @@ int svd_eigen_decomposition(const base::MatrixXd& A,
                     }
                     f=U(i,i);  // f is the diag elem
                     if (!(s>=0)) return -3;
-                    g = -SIGN(sqrt(s),f);
+                    g = -SIGN(std::sqrt(s),f);
                     h=f*g-s;
                     U(i,i)=f-g;
                     for (j=ppi;j<cols;j++) {
@@ -57,15 +58,15 @@ int svd_eigen_decomposition(const base::MatrixXd& A,
             g=s=scale=0.0;
             if ((i <rows) && (i+1 != cols)) {
                 // sum of row i, start from columns i+1
-                for (k=ppi;k<cols;k++) scale += fabs(U(i,k));
-                if (fabs(scale)>epsilon) {
+                for (k=ppi;k<cols;k++) scale += std::abs(U(i,k));
+                if (std::abs(scale)>epsilon) {
                     for (k=ppi;k<cols;k++) {
                         U(i,k) /= scale;
                         s += U(i,k)*U(i,k);
                     }
                     f=U(i,ppi);
                     if (!(s>=0)) return -5;
-                    g = -SIGN(sqrt(s),f);
+                    g = -SIGN(std::sqrt(s),f);
                     h=f*g-s;
                     U(i,ppi)=f-g;
                     if (!(h!=0)) return -6;
@@ -78,13 +79,13 @@ int svd_eigen_decomposition(const base::MatrixXd& A,
                 }
             }
             maxarg1=anorm;
-            maxarg2=(fabs(S(i))+fabs(tmp(i)));
+            maxarg2=(std::abs(S(i))+std::abs(tmp(i)));
             anorm = maxarg1 > maxarg2 ?	maxarg1 : maxarg2;
         }
         /* Accumulation of right-hand transformations. */
         for (i=cols-1;i>=0;i--) {
             if (i<cols-1) {
-                if (fabs(g)>epsilon) {
+                if (std::abs(g)>epsilon) {
                     if (!(U(i,ppi)!=0)) return -7;
                     for (j=ppi;j<cols;j++) V(j,i)=(U(i,j)/U(i,ppi))/g;
                     for (j=ppi;j<cols;j++) {
@@ -103,7 +104,7 @@ int svd_eigen_decomposition(const base::MatrixXd& A,
             ppi=i+1;
             g=S(i);
             for (j=ppi;j<cols;j++) U(i,j)=0.0;
-            if (fabs(g)>epsilon) {
+            if (std::abs(g)>epsilon) {
                 g=1.0/g;
                 for (j=ppi;j<cols;j++) {
                     for (s=0.0,k=ppi;k<rows;k++) s += U(k,i)*U(k,j);
@@ -124,11 +125,11 @@ int svd_eigen_decomposition(const base::MatrixXd& A,
                 flag=true;
                 for (ppi=k;ppi>=0;ppi--) {  /* Test for splitting. */
                     nm=ppi-1;             /* Note that tmp[1] is always zero. */
-                    if ((fabs(tmp(ppi))+anorm) == anorm) {
+                    if ((std::abs(tmp(ppi))+anorm) == anorm) {
                         flag=false;
                         break;
                     }
-                    if ((fabs(S(nm)+anorm) == anorm)) break;
+                    if ((std::abs(S(nm)+anorm) == anorm)) break;
                 }
                 if (flag) {
                     c=0.0;           /* Cancellation of tmp[l], if l>1: */
@@ -136,7 +137,7 @@ int svd_eigen_decomposition(const base::MatrixXd& A,
                     for (i=ppi;i<=k;i++) {
                         f=s*tmp(i);
                         tmp(i)=c*tmp(i);
-                        if ((fabs(f)+anorm) == anorm) break;
+                        if ((std::abs(f)+anorm) == anorm) break;
                         g=S(i);
                         h=PYTHAG(f,g);
                         S(i)=h;
@@ -170,7 +171,7 @@ int svd_eigen_decomposition(const base::MatrixXd& A,
                 if (!(h!=0&&y!=0)) return -10;
                 f=((y-z)*(y+z)+(g-h)*(g+h))/(2.0*h*y);
 
-                g=PYTHAG(f,1.0);
+                g=PYTHAG(f,Scalar(1));
                 if (!(x!=0)) return -11;
                 if (!((f+SIGN(g,f))!=0)) return -12;
                 f=((x-z)*(x+z)+h*((y/(f+SIGN(g,f)))-h))/x;
@@ -200,7 +201,7 @@ int svd_eigen_decomposition(const base::MatrixXd& A,
                     }
                     z=PYTHAG(f,h);
                     S(j)=z;
-                    if (fabs(z)>epsilon) {
+                    if (std::abs(z)>epsilon) {
                         z=1.0/z;
                         c=f*z;
                         s=h*z;
@@ -223,10 +224,10 @@ int svd_eigen_decomposition(const base::MatrixXd& A,
         //Sort eigen values:
         for (i=0; i<cols; i++){
 
-            double S_max = S(i);
+            Scalar S_max = S(i);
             int i_max = i;
             for (j=i+1; j<cols; j++){
-                double Sj = S(j);
+                Scalar Sj = S(j);
                 if (Sj > S_max){
                     S_max = Sj;
                     i_max = j;
@@ -234,7 +235,7 @@ int svd_eigen_decomposition(const base::MatrixXd& A,
             }
             if (i_max != i){
                 /* swap eigenvalues */
-                double tmp = S(i);
+                Scalar tmp = S(i);
                 S(i)=S(i_max);
                 S(i_max)=tmp;
 
@@ -250,4 +251,7 @@ int svd_eigen_decomposition(const base::MatrixXd& A,
             return (0);
 }
 
+template int svd_eigen_decomposition<double>(const Eigen::MatrixXd& A, Eigen::MatrixXd& U, Eigen::VectorXd& S, Eigen::MatrixXd& V, Eigen::VectorXd& tmp, int maxiter, double epsilon);
+template int svd_eigen_decomposition<float>(const Eigen::MatrixXf& A, Eigen::MatrixXf& U, Eigen::VectorXf& S, Eigen::MatrixXf& V, Eigen::VectorXf& tmp, int maxiter, float epsilon);
+
 } // namespace wbc
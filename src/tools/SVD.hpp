@@ -26,37 +26,42 @@
 #define SVD_DECOMPOSITION_HPP
 
 #include <base/Eigen.hpp>
+#include <limits>
 
 namespace wbc{
 
-inline double PYTHAG(double a,double b) {
-    double at,bt,ct;
-    at = fabs(a);
-    bt = fabs(b);
+template<typename Scalar>
+inline Scalar PYTHAG(Scalar a,Scalar b) {
+    Scalar at,bt,ct;
+    at = std::abs(a);
+    bt = std::abs(b);
     if (at > bt ) {
         ct=bt/at;
-        return at*sqrt(1.0+ct*ct);
+        return at*std::sqrt(Scalar(1)+ct*ct);
     } else {
         if (bt==0)
-            return 0.0;
+            return Scalar(0);
         else {
             ct=at/bt;
-            return bt*sqrt(1.0+ct*ct);
+            return bt*std::sqrt(Scalar(1)+ct*ct);
         }
     }
 }
 
-inline double SIGN(double a,double b) {
-    return ((b) >= 0.0 ? fabs(a) : -fabs(a));
+template<typename Scalar>
+inline Scalar SIGN(Scalar a,Scalar b) {
+    return ((b) >= 0.0 ? std::abs(a) : -std::abs(a));
 }
 
-int svd_eigen_decomposition(const base::MatrixXd& A,
-                            base::MatrixXd& U,
-                            base::VectorXd& S,
-                            base::MatrixXd& V,
-                            base::VectorXd& tmp,
+/** SVD of the given matrix A. Explicitly instantiated for double and float (see SVD.cpp)*/
+template<typename Scalar>
+int svd_eigen_decomposition(const Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic>& A,
+                            Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic>& U,
+                            Eigen::Matrix<Scalar,Eigen::Dynamic,1>& S,
+                            Eigen::Matrix<Scalar,Eigen::Dynamic,Eigen::Dynamic>& V,
+                            Eigen::Matrix<Scalar,Eigen::Dynamic,1>& tmp,
                             int maxiter=150,
-                            double epsilon=1e-300);
+                            Scalar epsilon=std::numeric_limits<Scalar>::min());
 
 }
 
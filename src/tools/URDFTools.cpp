@@ -2,6 +2,8 @@
 #include <base/JointLimits.hpp>
 #include <base-logging/Logging.hpp>
 #include <stack>
+#include <cmath>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <tinyxml2.h>
@@ -249,4 +251,59 @@ bool URDFTools::applyJointBlacklist(urdf::ModelInterfaceSharedPtr& robot_urdf, c
     return true;
 }
 
+bool URDFTools::applyJointLocks(urdf::ModelInterfaceSharedPtr& robot_urdf, const std::vector<std::string> &names, const std::vector<double> &positions){
+
+    if(names.size() != positions.size()){
+        LOG_ERROR_S << "Size of names and size of positions of the locked joints do not match" << std::endl;
+        return false;
+    }
+    for(size_t i = 0; i < names.size(); i++){
+        if(robot_urdf->joints_.count(names[i]) == 0){
+            LOG_ERROR_S << "Locked joints contain joint " << names[i] << " but this name is not in robot model " << std::endl;
+            return false;
+        }
+        urdf::JointSharedPtr joint = robot_urdf->joints_[names[i]];
+        urdf::Pose &origin = joint->parent_to_joint_origin_transform;
+        const double q = positions[i];
+        if(joint->type == urdf::Joint::REVOLUTE || joint->type == urdf::Joint::CONTINUOUS){
+            urdf::Rotation rot;
+            rot.setFromQuaternion(joint->axis.x*sin(q/2), joint->axis.y*sin(q/2), joint->axis.z*sin(q/2), cos(q/2));
+            origin.rotation = origin.rotation * rot;
+        }
+        else if(joint->type == urdf::Joint::PRISMATIC)
+            origin.position = origin.position + origin.rotation * urdf::Vector3(joint->axis.x*q, joint->axis.y*q, joint->axis.z*q);
+        else if(joint->type != urdf::Joint::FIXED){
+            LOG_ERROR_S << "Joint " << names[i] << " cannot be locked. Only revolute, continuous and prismatic joints can be locked" << std::endl;
+            return false;
+        }
+        joint->type = urdf::Joint::FIXED;
+    }
+    return true;
+}
+
+std::vector<std::string> URDFTools::jointNamesOnChain(const urdf::ModelInterfaceSharedPtr& robot_urdf, const std::string &root, const std::string &tip){
+
+    // Collect the joints between each of the links and the root of the tree. The chain consists of all joints that are on exactly one of the two paths
+    std::vector<std::string> paths[2];
+    const std::string links[2] = {root, tip};
+    for(int i = 0; i < 2; i++){
+        urdf::LinkConstSharedPtr link = robot_urdf->getLink(links[i]);
+        if(!link)
+            throw std::invalid_argument("URDFTools::jointNamesOnChain: Link " + links[i] + " is not in robot model");
+        for(; link->parent_joint; link = link->getParent()){
+            if(link->parent_joint->type != urdf::Joint::FIXED)
+                paths[i].push_back(link->parent_joint->name);
+        }
+    }
+
+    std::vector<std::string> joint_names;
+    for(int i = 0; i < 2; i++){
+        for(const std::string& name : paths[i]){
+            if(std::find(paths[1-i].begin(), paths[1-i].end(), name) == paths[1-i].end())
+                joint_names.push_back(name);
+        }
+    }
+    return joint_names;
+}
+
 }
@@ -42,6 +42,13 @@ public:
 
     /** Set all blacklisted joints in robot model to fixed*/
     static bool applyJointBlacklist(urdf::ModelInterfaceSharedPtr& robot_urdf, const std::vector<std::string> &blacklist);
+
+    /** Set all given joints in robot model to fixed and lock them at the given position (rad or m) by moving the joint motion into the joint origin.
+     *  Only revolute, continuous and prismatic joints can be locked*/
+    static bool applyJointLocks(urdf::ModelInterfaceSharedPtr& robot_urdf, const std::vector<std::string> &names, const std::vector<double> &positions);
+
+    /** Return all non-fixed joints on the kinematic chain between the two given links. The links do not have to be on the same branch of the tree*/
+    static std::vector<std::string> jointNamesOnChain(const urdf::ModelInterfaceSharedPtr& robot_urdf, const std::string &root, const std::string &tip);
 };
 
 }
@@ -0,0 +1,109 @@
+#include <robot_models/pinocchio/RobotModelPinocchio.hpp>
+#include <core/RobotModelConfig.hpp>
+#include <scenes/velocity_qp/VelocitySceneQP.hpp>
+#include <solvers/qpoases/QPOasesSolver.hpp>
+#include <solvers/batch/BatchADMMSolver.hpp>
+#include <chrono>
+
+using namespace std;
+using namespace wbc;
+
+/**
+ * Monte-Carlo style benchmark: Set up n_instances VelocitySceneQP problems of the kuka iiwa with random joint positions and random Cartesian velocity references and solve them
+ *   - sequentially with qpOASES (cold start, i.e., solver reset for each instance, and hot start from the previous instance)
+ *   - as a batch with the interleaved BatchADMMSolver
+ * The throughput (solved QPs per second) and the max. deviation of the batch solutions from the qpOASES solutions are printed.
+ */
+int main(int argc, char** argv){
+
+    int n_instances = 1000;
+    if(argc > 1)
+        n_instances = atoi(argv[1]);
+    double dt = 1e-3;
+
+    RobotModelConfig config;
+    config.file_or_string = "../../../models/kuka/urdf/kuka_iiwa.urdf";
+    RobotModelPtr robot_model = make_shared<RobotModelPinocchio>();
+    if(!robot_model->configure(config))
+        return -1;
+
+    TaskConfig cart_task;
+    cart_task.name       = "cart_pos_ctrl";
+    cart_task.type       = cart;
+    cart_task.priority   = 0;
+    cart_task.root       = "kuka_lbr_l_link_0";
+    cart_task.tip        = "kuka_lbr_l_tcp";
+    cart_task.ref_frame  = "kuka_lbr_l_link_0";
+    cart_task.activation = 1;
+    cart_task.weights    = vector<double>(6,1);
+
+    QPSolverPtr solver = std::make_shared<QPOASESSolver>();
+    qpOASES::Options options;
+    options.setToDefault();
+    options.printLevel = qpOASES::PL_NONE;
+    std::dynamic_pointer_cast<QPOASESSolver>(solver)->setOptions(options);
+    std::dynamic_pointer_cast<QPOASESSolver>(solver)->setMaxNoWSR(1000);
+
+    VelocitySceneQP scene(robot_model, solver, dt);
+    if(!scene.configure({cart_task}))
+        return -1;
+
+    // Generate the QPs
+    uint nj = robot_model->noOfJoints();
+    base::samples::Joints joint_state;
+    joint_state.resize(nj);
+    joint_state.names = robot_model->jointNames();
+    base::samples::RigidBodyStateSE3 ref;
+    ref.twist.setZero();
+    vector<HierarchicalQP> hqps(n_instances);
+    for(int k = 0; k < n_instances; k++){
+        for(uint i = 0; i < nj; i++){
+            joint_state[i].position = base::VectorXd::Random(1)[0];
+            joint_state[i].speed = joint_state[i].acceleration = 0;
+        }
+        joint_state.time = base::Time::now();
+        robot_model->update(joint_state);
+        ref.twist.linear = 0.5*base::Vector3d::Random();
+        ref.twist.angular = 0.5*base::Vector3d::Random();
+        scene.setReference(cart_task.name, ref);
+        hqps[k] = scene.update();
+    }
+
+    vector<base::VectorXd> reference_outputs(n_instances), batch_outputs;
+    QPOASESSolver sequential_solver;
+    sequential_solver.setOptions(options);
+    sequential_solver.setMaxNoWSR(1000);
+
+    // Sequential, cold start
+    auto s = std::chrono::high_resolution_clock::now();
+    for(int k = 0; k < n_instances; k++){
+        sequential_solver.reset();
+        sequential_solver.solve(hqps[k], reference_outputs[k]);
+    }
+    double time_cold = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - s).count();
+
+    // Sequential, hot start from the previous instance
+    s = std::chrono::high_resolution_clock::now();
+    for(int k = 0; k < n_instances; k++)
+        sequential_solver.solve(hqps[k], reference_outputs[k]);
+    double time_hot = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - s).count();
+
+    // Batch
+    BatchADMMSolver batch_solver;
+    s = std::chrono::high_resolution_clock::now();
+    batch_solver.solveBatch(hqps, batch_outputs);
+    double time_batch = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - s).count();
+
+    double max_diff = 0;
+    for(int k = 0; k < n_instances; k++)
+        max_diff = std::max(max_diff, (batch_outputs[k] - reference_outputs[k]).cwiseAbs().maxCoeff());
+
+    cout<<"Throughput for "<<n_instances<<" VelocitySceneQP instances (QPs/s)"<<endl;
+    cout<<"qpOASES sequential, cold start: "<<n_instances/time_cold<<endl;
+    cout<<"qpOASES sequential, hot start:  "<<n_instances/time_hot<<endl;
+    cout<<"BatchADMMSolver (block size "<<batch_solver.getBlockSize()<<"): "<<n_instances/time_batch<<endl;
+    cout<<"Converged instances: "<<batch_solver.getNoConverged()<<", max. iterations: "<<batch_solver.getNoIterations()<<endl;
+    cout<<"Max. deviation from qpOASES solution: "<<max_diff<<endl;
+
+    return 0;
+}
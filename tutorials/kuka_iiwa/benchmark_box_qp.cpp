@@ -0,0 +1,96 @@
+#include <robot_models/pinocchio/RobotModelPinocchio.hpp>
+#include <core/RobotModelConfig.hpp>
+#include <scenes/velocity_qp/VelocitySceneQP.hpp>
+#include <solvers/qpoases/QPOasesSolver.hpp>
+#include <solvers/box_qp/BoxQPSolver.hpp>
+#ifdef USE_OSQP
+#include <solvers/osqp/OsqpSolver.hpp>
+#endif
+#include <chrono>
+
+using namespace std;
+using namespace wbc;
+
+/**
+ * Run n_samples control cycles of the VelocitySceneQP with the given solver and return the average solve time in microseconds. The Cartesian reference
+ * follows a sinusoidal trajectory, so that some of the joint velocity bounds become active.
+ */
+double benchmark(RobotModelPtr robot_model, QPSolverPtr solver, const TaskConfig& cart_task, int n_samples, base::VectorXd& last_output){
+
+    double dt = 1e-3;
+    VelocitySceneQP scene(robot_model, solver, dt);
+    if(!scene.configure({cart_task}))
+        throw std::runtime_error("Failed to configure scene");
+
+    base::samples::Joints joint_state;
+    uint nj = robot_model->noOfJoints();
+    joint_state.resize(nj);
+    joint_state.names = robot_model->jointNames();
+    base::samples::RigidBodyStateSE3 ref;
+    ref.twist.setZero();
+
+    double total_time = 0;
+    for(int n = 0; n < n_samples; n++){
+        for(uint i = 0; i < nj; i++){
+            joint_state[i].position = 0.1 + 0.5*sin(1e-3*n);
+            joint_state[i].speed = joint_state[i].acceleration = 0;
+        }
+        joint_state.time = base::Time::now();
+        robot_model->update(joint_state);
+        ref.twist.linear = base::Vector3d(2.0*sin(1e-2*n), 2.0*cos(1e-2*n), 0);
+        scene.setReference(cart_task.name, ref);
+        const HierarchicalQP& hqp = scene.update();
+
+        auto s = std::chrono::high_resolution_clock::now();
+        solver->solve(hqp, last_output);
+        auto e = std::chrono::high_resolution_clock::now();
+        total_time += std::chrono::duration_cast<std::chrono::nanoseconds>(e-s).count()*1e-3;
+    }
+    return total_time / n_samples;
+}
+
+/**
+ * Benchmark the dedicated equality and bound constrained solver (BoxQPSolver) against qpOASES (and OSQP, if built with SOLVER_OSQP) on the VelocitySceneQP of the kuka iiwa.
+ * The average solve time per control cycle is printed.
+ */
+int main(int argc, char** argv){
+
+    int n_samples = 10000;
+    if(argc > 1)
+        n_samples = atoi(argv[1]);
+
+    RobotModelConfig config;
+    config.file_or_string = "../../../models/kuka/urdf/kuka_iiwa.urdf";
+    RobotModelPtr robot_model = make_shared<RobotModelPinocchio>();
+    if(!robot_model->configure(config))
+        return -1;
+
+    TaskConfig cart_task;
+    cart_task.name       = "cart_pos_ctrl";
+    cart_task.type       = cart;
+    cart_task.priority   = 0;
+    cart_task.root       = "kuka_lbr_l_link_0";
+    cart_task.tip        = "kuka_lbr_l_tcp";
+    cart_task.ref_frame  = "kuka_lbr_l_link_0";
+    cart_task.activation = 1;
+    cart_task.weights    = vector<double>(6,1);
+
+    QPSolverPtr qpoases_solver = std::make_shared<QPOASESSolver>();
+    qpOASES::Options options;
+    options.setToDefault();
+    options.printLevel = qpOASES::PL_NONE;
+    std::dynamic_pointer_cast<QPOASESSolver>(qpoases_solver)->setOptions(options);
+    std::dynamic_pointer_cast<QPOASESSolver>(qpoases_solver)->setMaxNoWSR(1000);
+
+    base::VectorXd output_qpoases, output_box_qp;
+    cout<<"Average solve time over "<<n_samples<<" samples"<<endl;
+    cout<<"qpOASES:     "<<benchmark(robot_model, qpoases_solver, cart_task, n_samples, output_qpoases)<<" (mu s)"<<endl;
+    cout<<"BoxQPSolver: "<<benchmark(robot_model, std::make_shared<BoxQPSolver>(), cart_task, n_samples, output_box_qp)<<" (mu s)"<<endl;
+#ifdef USE_OSQP
+    base::VectorXd output_osqp;
+    cout<<"OSQP:        "<<benchmark(robot_model, std::make_shared<OsqpSolver>(), cart_task, n_samples, output_osqp)<<" (mu s)"<<endl;
+#endif
+    cout<<"Deviation of the last solution from qpOASES: "<<(output_box_qp - output_qpoases).norm()<<endl;
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <robot_models/pinocchio/RobotModelPinocchio.hpp>
+#include <core/RobotModelConfig.hpp>
+#include <chrono>
+#include <functional>
+
+using namespace std;
+using namespace wbc;
+
+/** Call fn n_samples times and return the average time per call in microseconds*/
+double benchmark(std::function<void()> fn, int n_samples){
+    auto s = std::chrono::high_resolution_clock::now();
+    for(int n = 0; n < n_samples; n++)
+        fn();
+    auto e = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(e-s).count()*1e-3 / n_samples;
+}
+
+/** Forward dynamics qdd = M^-1 * (tau - h) at the current state of the robot model*/
+base::VectorXd forwardDynamics(RobotModelPtr robot_model, const base::VectorXd &tau){
+    return robot_model->jointSpaceInertiaMatrix().ldlt().solve(tau - robot_model->biasForces());
+}
+
+void printResult(const string &name, double time_analytical, double time_fd, double max_err){
+    cout<<name<<endl;
+    cout<<"  Analytical:         "<<time_analytical<<" (mu s)"<<endl;
+    cout<<"  Finite differences: "<<time_fd<<" (mu s)"<<endl;
+    cout<<"  Speed-up:           "<<time_fd/time_analytical<<endl;
+    cout<<"  Max. abs. deviation "<<max_err<<endl;
+}
+
+/**
+ * Benchmark the analytical dynamics derivatives of the robot model (see RobotModel::inverseDynamicsDerivatives(), RobotModel::forwardDynamicsDerivatives() and
+ * RobotModel::spatialAccelerationBiasDerivative()) against forward finite differences on the kuka iiwa 7 dof arm. Finite differences require one robot model update
+ * per joint and perturbed quantity (q and qd), so their cost grows linearly with the number of joints. Both variants include the robot model update at the nominal
+ * state. For each derivative, the average computation time, the speed-up and the max. deviation between both approaches are printed.
+ */
+int main(int argc, char** argv){
+
+    int n_samples = 1000;
+    if(argc > 1)
+        n_samples = atoi(argv[1]);
+    const double eps = 1e-6;
+
+    RobotModelConfig config;
+    config.file_or_string = "../../../models/kuka/urdf/kuka_iiwa.urdf";
+    RobotModelPtr robot_model = make_shared<RobotModelPinocchio>();
+    if(!robot_model->configure(config))
+        return -1;
+    const string root_frame = robot_model->worldFrame();
+    const string tip_frame = "kuka_lbr_l_tcp";
+    const uint nj = robot_model->noOfJoints();
+
+    base::samples::Joints joint_state;
+    joint_state.resize(nj);
+    joint_state.names = robot_model->jointNames();
+    for(uint i = 0; i < nj; i++){
+        joint_state[i].position = 0.1*(i+1);
+        joint_state[i].speed = 0.1;
+        joint_state[i].acceleration = 0; // Inverse dynamics equals the bias forces for zero acceleration
+    }
+    joint_state.time = base::Time::now();
+    robot_model->update(joint_state);
+    base::VectorXd tau = robot_model->biasForces() + base::VectorXd::Constant(nj, 1.0);
+
+    cout<<"Average computation time over "<<n_samples<<" samples"<<endl;
+
+    // Inverse dynamics
+    base::MatrixXd dtau_dq, dtau_dqd, dtau_dq_fd(nj,nj), dtau_dqd_fd(nj,nj);
+    double time_analytical = benchmark([&](){
+        robot_model->update(joint_state);
+        robot_model->inverseDynamicsDerivatives(dtau_dq, dtau_dqd);
+    }, n_samples);
+    double time_fd = benchmark([&](){
+        robot_model->update(joint_state);
+        base::VectorXd h = robot_model->biasForces();
+        for(uint i = 0; i < nj; i++){
+            base::samples::Joints js = joint_state;
+            js[i].position += eps;
+            robot_model->update(js);
+            dtau_dq_fd.col(i) = (robot_model->biasForces() - h) / eps;
+            js = joint_state;
+            js[i].speed += eps;
+            robot_model->update(js);
+            dtau_dqd_fd.col(i) = (robot_model->biasForces() - h) / eps;
+        }
+    }, n_samples);
+    printResult("Inverse dynamics (dtau/dq, dtau/dqd)", time_analytical, time_fd,
+                max((dtau_dq - dtau_dq_fd).cwiseAbs().maxCoeff(), (dtau_dqd - dtau_dqd_fd).cwiseAbs().maxCoeff()));
+
+    // Forward dynamics
+    base::MatrixXd dqdd_dq, dqdd_dqd, dqdd_dtau, dqdd_dq_fd(nj,nj), dqdd_dqd_fd(nj,nj);
+    time_analytical = benchmark([&](){
+        robot_model->update(joint_state);
+        robot_model->forwardDynamicsDerivatives(tau, dqdd_dq, dqdd_dqd, dqdd_dtau);
+    }, n_samples);
+    time_fd = benchmark([&](){
+        robot_model->update(joint_state);
+        base::VectorXd qdd = forwardDynamics(robot_model, tau);
+        for(uint i = 0; i < nj; i++){
+            base::samples::Joints js = joint_state;
+            js[i].position += eps;
+            robot_model->update(js);
+            dqdd_dq_fd.col(i) = (forwardDynamics(robot_model, tau) - qdd) / eps;
+            js = joint_state;
+            js[i].speed += eps;
+            robot_model->update(js);
+            dqdd_dqd_fd.col(i) = (forwardDynamics(robot_model, tau) - qdd) / eps;
+        }
+    }, n_samples);
+    printResult("Forward dynamics (dqdd/dq, dqdd/dqd)", time_analytical, time_fd,
+                max((dqdd_dq - dqdd_dq_fd).cwiseAbs().maxCoeff(), (dqdd_dqd - dqdd_dqd_fd).cwiseAbs().maxCoeff()));
+
+    // Spatial acceleration bias
+    base::MatrixXd dacc_dq, dacc_dq_fd(6,nj);
+    time_analytical = benchmark([&](){
+        robot_model->update(joint_state);
+        dacc_dq = robot_model->spatialAccelerationBiasDerivative(root_frame, tip_frame);
+    }, n_samples);
+    time_fd = benchmark([&](){
+        robot_model->update(joint_state);
+        base::Acceleration acc = robot_model->spatialAccelerationBias(root_frame, tip_frame);
+        for(uint i = 0; i < nj; i++){
+            base::samples::Joints js = joint_state;
+            js[i].position += eps;
+            robot_model->update(js);
+            base::Acceleration acc_eps = robot_model->spatialAccelerationBias(root_frame, tip_frame);
+            dacc_dq_fd.col(i).segment(0,3) = (acc_eps.linear - acc.linear) / eps;
+            dacc_dq_fd.col(i).segment(3,3) = (acc_eps.angular - acc.angular) / eps;
+        }
+    }, n_samples);
+    printResult("Spatial acceleration bias (d(Jdot*qdot)/dq)", time_analytical, time_fd, (dacc_dq - dacc_dq_fd).cwiseAbs().maxCoeff());
+
+    return 0;
+}
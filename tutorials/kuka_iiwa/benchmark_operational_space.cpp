@@ -0,0 +1,101 @@
+#include <robot_models/pinocchio/RobotModelPinocchio.hpp>
+#include <core/RobotModelConfig.hpp>
+#include <scenes/acceleration_tsid/AccelerationSceneTSID.hpp>
+#include <scenes/operational_space/OperationalSpaceScene.hpp>
+#include <solvers/qpoases/QPOasesSolver.hpp>
+#include <chrono>
+
+using namespace std;
+using namespace wbc;
+
+/**
+ * Run n_samples control cycles (model update, scene update and solve) and return the average cycle time in microseconds.
+ * The task references are changed in every cycle, so that the solver cannot reuse the previous solution.
+ */
+double benchmark(RobotModelPtr robot_model, Scene& scene, const vector<TaskConfig>& tasks, int n_samples){
+
+    base::samples::Joints joint_state;
+    uint nj = robot_model->noOfJoints();
+    joint_state.resize(nj);
+    joint_state.names = robot_model->jointNames();
+    base::samples::RigidBodyStateSE3 ref;
+    ref.twist.setZero();
+    ref.acceleration.setZero();
+    base::samples::Joints jnt_ref;
+    jnt_ref.resize(nj);
+    jnt_ref.names = robot_model->jointNames();
+
+    double total_time = 0;
+    for(int n = 0; n < n_samples; n++){
+        for(uint i = 0; i < nj; i++){
+            joint_state[i].position = 0.1 + 1e-4*n;
+            joint_state[i].speed = 0.1;
+            joint_state[i].acceleration = 0;
+            jnt_ref[i].acceleration = -0.1*joint_state[i].position;
+        }
+        joint_state.time = base::Time::now();
+        ref.acceleration.linear = base::Vector3d(0.1, 1e-4*n, 0);
+
+        auto s = std::chrono::high_resolution_clock::now();
+        robot_model->update(joint_state);
+        scene.setReference(tasks[0].name, ref);
+        if(tasks.size() > 1)
+            scene.setReference(tasks[1].name, jnt_ref);
+        const HierarchicalQP& hqp = scene.update();
+        scene.solve(hqp);
+        auto e = std::chrono::high_resolution_clock::now();
+        total_time += std::chrono::duration_cast<std::chrono::nanoseconds>(e-s).count()*1e-3;
+    }
+    return total_time / n_samples;
+}
+
+/**
+ * Benchmark the QP-free OperationalSpaceScene against the AccelerationSceneTSID (solved with qpOASES) on the kuka iiwa 7 dof arm with a
+ * Cartesian acceleration task. Since the TSID scene supports only a single priority, a joint space posture task is added on the same priority with low weight there
+ * and on a lower priority in the OperationalSpaceScene. For each scene the average time of a full control cycle (robot model update, scene update and solve) is printed.
+ */
+int main(int argc, char** argv){
+
+    int n_samples = 10000;
+    if(argc > 1)
+        n_samples = atoi(argv[1]);
+    double dt = 1e-3;
+
+    RobotModelConfig config;
+    config.file_or_string = "../../../models/kuka/urdf/kuka_iiwa.urdf";
+    RobotModelPtr robot_model = make_shared<RobotModelPinocchio>();
+    if(!robot_model->configure(config))
+        return -1;
+
+    TaskConfig cart_task("cart_pos_ctrl", 0, "kuka_lbr_l_link_0", "kuka_lbr_l_tcp", "kuka_lbr_l_link_0", 1);
+    TaskConfig jnt_task("jnt_posture", 1, robot_model->jointNames(), vector<double>(robot_model->noOfJoints(),1), 1);
+    TaskConfig jnt_task_tsid = jnt_task;
+    jnt_task_tsid.priority = 0;
+    jnt_task_tsid.weights = vector<double>(robot_model->noOfJoints(),1e-3);
+
+    QPSolverPtr solver = std::make_shared<QPOASESSolver>();
+    qpOASES::Options options;
+    options.setToDefault();
+    options.printLevel = qpOASES::PL_NONE;
+    std::dynamic_pointer_cast<QPOASESSolver>(solver)->setOptions(options);
+    std::dynamic_pointer_cast<QPOASESSolver>(solver)->setMaxNoWSR(100);
+
+    AccelerationSceneTSID tsid_scene(robot_model, solver, dt);
+    OperationalSpaceScene osc_scene(robot_model, nullptr, dt);
+
+    cout<<"Average cycle time over "<<n_samples<<" samples"<<endl;
+
+    if(!tsid_scene.configure({cart_task}) || !osc_scene.configure({cart_task}))
+        return -1;
+    cout<<"Cartesian task"<<endl;
+    cout<<"AccelerationSceneTSID: "<<benchmark(robot_model, tsid_scene, {cart_task}, n_samples)<<" (mu s)"<<endl;
+    cout<<"OperationalSpaceScene: "<<benchmark(robot_model, osc_scene, {cart_task}, n_samples)<<" (mu s)"<<endl;
+
+    if(!tsid_scene.configure({cart_task, jnt_task_tsid}) || !osc_scene.configure({cart_task, jnt_task}))
+        return -1;
+    cout<<"Cartesian task + joint space posture task"<<endl;
+    cout<<"AccelerationSceneTSID: "<<benchmark(robot_model, tsid_scene, {cart_task, jnt_task_tsid}, n_samples)<<" (mu s)"<<endl;
+    cout<<"OperationalSpaceScene: "<<benchmark(robot_model, osc_scene, {cart_task, jnt_task}, n_samples)<<" (mu s)"<<endl;
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <robot_models/pinocchio/RobotModelPinocchio.hpp>
+#include <core/RobotModelConfig.hpp>
+#include <scenes/velocity_qp/VelocitySceneQP.hpp>
+#include <solvers/qpoases/QPOasesSolver.hpp>
+#include <dataset/DatasetGenerator.hpp>
+
+using namespace std;
+using namespace wbc;
+
+/**
+ * Create a VelocitySceneQP for Cartesian velocity control of the kuka iiwa. Each call creates its own robot model and solver, as required by the DatasetGenerator
+ */
+ScenePtr createScene(){
+    RobotModelConfig config;
+    config.file_or_string = "../../../models/kuka/urdf/kuka_iiwa.urdf";
+    RobotModelPtr robot_model = make_shared<RobotModelPinocchio>();
+    if(!robot_model->configure(config))
+        throw std::runtime_error("Failed to configure robot model");
+
+    QPSolverPtr solver = std::make_shared<QPOASESSolver>();
+    qpOASES::Options options;
+    options.setToDefault();
+    options.printLevel = qpOASES::PL_NONE;
+    std::dynamic_pointer_cast<QPOASESSolver>(solver)->setOptions(options);
+    std::dynamic_pointer_cast<QPOASESSolver>(solver)->setMaxNoWSR(1000);
+
+    TaskConfig cart_task;
+    cart_task.name       = "cart_pos_ctrl";
+    cart_task.type       = cart;
+    cart_task.priority   = 0;
+    cart_task.root       = "kuka_lbr_l_link_0";
+    cart_task.tip        = "kuka_lbr_l_tcp";
+    cart_task.ref_frame  = "kuka_lbr_l_link_0";
+    cart_task.activation = 1;
+    cart_task.weights    = vector<double>(6,1);
+
+    ScenePtr scene = make_shared<VelocitySceneQP>(robot_model, solver, 1e-3);
+    if(!scene->configure({cart_task}))
+        throw std::runtime_error("Failed to configure scene");
+    return scene;
+}
+
+/**
+ * Headless dataset generation, e.g., for training a policy that imitates the WBC: Solve the VelocitySceneQP of the kuka iiwa for uniformly sampled joint states and Cartesian
+ * velocity references in parallel and write state, reference, QP dimensions and solution into .npy shards with a manifest (see DatasetGenerator).
+ * Usage: generate_dataset [<n_samples> [<output_directory> [<n_threads>]]]
+ */
+int main(int argc, char** argv){
+
+    uint n_samples = 100000;
+    string directory = "kuka_iiwa_dataset";
+    if(argc > 1)
+        n_samples = atoi(argv[1]);
+    if(argc > 2)
+        directory = argv[2];
+
+    DatasetGenerator generator(createScene, make_shared<UniformDatasetSampler>(0.5, 1.0));
+    if(argc > 3)
+        generator.setNoThreads(atoi(argv[3]));
+
+    uint n_rows = generator.generate(n_samples, directory);
+    cout<<"Wrote "<<n_rows<<" samples to "<<directory<<" ("<<generator.getNoFailures()<<" failed)"<<endl;
+    cout<<"Threads: "<<generator.getNoThreads()<<", throughput: "<<generator.getSamplesPerSecond()<<" samples/s"<<endl;
+
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include <solvers/qpoases/QPOasesSolver.hpp>
+#include <solvers/box_qp/BoxQPSolver.hpp>
+#include <solvers/tuning/QPCorpus.hpp>
+#include <robot_models/pinocchio/RobotModelPinocchio.hpp>
+#include <core/RobotModelConfig.hpp>
+#include <scenes/velocity_qp/VelocitySceneQP.hpp>
+#include <chrono>
+#include <iomanip>
+#include <map>
+
+using namespace wbc;
+using namespace std;
+using namespace qpOASES;
+
+/**
+ * Lookup table keyed on the gait phase: Predicts the solution of the QP at the same phase of the previous gait cycle. The phase is given by the number of
+ * solved QPs modulo the number of samples per gait cycle.
+ */
+class GaitPhasePredictor : public WarmStartPredictor{
+public:
+    GaitPhasePredictor(const uint samples_per_cycle) : samples_per_cycle(samples_per_cycle), n_solved(0){}
+    virtual bool predict(const HierarchicalQP &hierarchical_qp, WarmStart &warm_start){
+        auto it = table.find(n_solved % samples_per_cycle);
+        if(it == table.end())
+            return false;
+        warm_start = it->second;
+        return true;
+    }
+    virtual void update(const HierarchicalQP &hierarchical_qp, const WarmStart &solution){
+        table[n_solved % samples_per_cycle] = solution;
+        n_solved++;
+    }
+    virtual void reset(){
+        table.clear();
+        n_solved = 0;
+    }
+protected:
+    uint samples_per_cycle, n_solved;
+    map<uint,WarmStart> table;
+};
+
+/**
+ * Record a locomotion-like sequence of VelocitySceneQP problems on the RH5 legs (floating base, both feet in contact): The root link follows a periodic
+ * lateral sway and vertical bobbing motion, as during walking.
+ */
+vector<HierarchicalQP> recordLocomotion(const string &filename, const uint samples_per_cycle, const uint n_cycles){
+
+    double dt = 0.001;
+    RobotModelPtr robot_model = std::make_shared<RobotModelPinocchio>();
+    base::samples::RigidBodyStateSE3 floating_base_state;
+    floating_base_state.pose.position = base::Vector3d(-0.0, 0.0, 0.87);
+    floating_base_state.pose.orientation = base::Orientation(1,0,0,0);
+    floating_base_state.twist.setZero();
+    floating_base_state.acceleration.setZero();
+    floating_base_state.time = base::Time::now();
+    RobotModelConfig config;
+    config.file_or_string = "../../../models/rh5/urdf/rh5_legs.urdf";
+    config.floating_base = true;
+    config.contact_points.names = {"LLAnkle_FT", "LRAnkle_FT"};
+    config.contact_points.elements = {wbc::ActiveContact(1,0.6),wbc::ActiveContact(1,0.6)};
+    if(!robot_model->configure(config))
+        throw std::runtime_error("Failed to configure robot model");
+
+    TaskConfig cart_task;
+    cart_task.name = "com_position";
+    cart_task.type = cart;
+    cart_task.priority = 0;
+    cart_task.root = "world";
+    cart_task.tip = "RH5_Root_Link";
+    cart_task.ref_frame = "world";
+    cart_task.activation = 1;
+    cart_task.weights = vector<double>(6,1);
+    VelocitySceneQP scene(robot_model, std::make_shared<QPOASESSolver>(), dt);
+    if(!scene.configure({cart_task}))
+        throw std::runtime_error("Failed to configure scene");
+
+    uint nj = robot_model->noOfActuatedJoints();
+    base::VectorXd q(nj);
+    q << 0,0,-0.35,0.64,0,-0.27, 0,0,-0.35,0.64,0,-0.27;
+    base::samples::Joints joint_state;
+    joint_state.names = robot_model->actuatedJointNames();
+    joint_state.resize(nj);
+    for(size_t i = 0; i < nj; i++){
+        joint_state[i].position = q[i];
+        joint_state[i].speed = joint_state[i].acceleration = 0;
+    }
+
+    QPRecorder recorder(filename);
+    vector<HierarchicalQP> sequence;
+    base::samples::RigidBodyStateSE3 ref;
+    ref.twist.setZero();
+    for(uint k = 0; k < samples_per_cycle*n_cycles; k++){
+        joint_state.time = base::Time::now();
+        robot_model->update(joint_state, floating_base_state);
+
+        double phase = 2*M_PI*(k % samples_per_cycle)/samples_per_cycle;
+        ref.twist.linear = base::Vector3d(0, 0.3*cos(phase), 0.1*cos(2*phase));
+        scene.setReference(cart_task.name, ref);
+        HierarchicalQP hqp = scene.update();
+        recorder.record(hqp);
+        sequence.push_back(hqp);
+
+        base::commands::Joints solver_output = scene.solve(hqp);
+        for(size_t i = 0; i < joint_state.size(); i++){
+            joint_state[i].position += solver_output[i].speed * dt;
+            joint_state[i].speed = solver_output[i].speed;
+        }
+    }
+    return sequence;
+}
+
+/**
+ * Replay the sequence with the given solver and predictor, print the average number of iterations and solve time and the max. deviation from the reference solutions
+ */
+void replay(const string &name, QPSolverPtr solver, WarmStartPredictorPtr predictor, const vector<HierarchicalQP> &sequence,
+            vector<base::VectorXd> &reference_solutions){
+
+    solver->setWarmStartPredictor(predictor);
+    double total_iterations = 0, total_time = 0, max_diff = 0;
+    base::VectorXd solver_output;
+    for(size_t k = 0; k < sequence.size(); k++){
+        auto s = std::chrono::high_resolution_clock::now();
+        solver->solve(sequence[k], solver_output);
+        auto e = std::chrono::high_resolution_clock::now();
+        total_time += std::chrono::duration_cast<std::chrono::nanoseconds>(e-s).count()*1e-3;
+
+        if(std::dynamic_pointer_cast<QPOASESSolver>(solver))
+            total_iterations += std::dynamic_pointer_cast<QPOASESSolver>(solver)->getNoWSR();
+        else
+            total_iterations += std::dynamic_pointer_cast<BoxQPSolver>(solver)->getNoIterations();
+
+        if(reference_solutions.size() < sequence.size())
+            reference_solutions.push_back(solver_output);
+        else
+            max_diff = std::max(max_diff, (solver_output - reference_solutions[k]).cwiseAbs().maxCoeff());
+    }
+    cout << setw(40) << left << name << " iterations: " << setw(10) << total_iterations/sequence.size()
+         << " solve time: " << setw(10) << total_time/sequence.size() << " (mu s) max. deviation: " << max_diff << endl;
+}
+
+/**
+ * Benchmark of warm start predictors (see QPSolver::setWarmStartPredictor()) on recorded locomotion data. The QP sequence is either loaded from the given files
+ * (recorded with the QPRecorder) or recorded from a periodic sway motion of the RH5 legs. The average number of iterations (working set recalculations for
+ * qpOASES, active set changes for the BoxQPSolver) is compared for
+ *   - the default warm start of the solver (previous solution)
+ *   - the ExtrapolationPredictor (linear extrapolation of the last two solutions)
+ *   - a lookup table keyed on the gait phase (solution of the previous gait cycle)
+ * Usage: benchmark_warm_start [<samples_per_cycle> [<qp_sequence_1> <qp_sequence_2> ...]]
+ */
+int main(int argc, char** argv){
+
+    uint samples_per_cycle = 1000;
+    if(argc > 1)
+        samples_per_cycle = atoi(argv[1]);
+
+    vector<HierarchicalQP> sequence;
+    if(argc > 2){
+        for(int i = 2; i < argc; i++){
+            vector<HierarchicalQP> s = loadQPSequence(argv[i]);
+            sequence.insert(sequence.end(), s.begin(), s.end());
+        }
+    }
+    else
+        sequence = recordLocomotion("rh5_locomotion_qps.bin", samples_per_cycle, 5);
+    cout << "Replaying " << sequence.size() << " QPs, " << samples_per_cycle << " samples per gait cycle" << endl;
+
+    vector<base::VectorXd> reference_solutions;
+    auto qpoases = [](){
+        QPSolverPtr solver = std::make_shared<QPOASESSolver>();
+        Options options = std::dynamic_pointer_cast<QPOASESSolver>(solver)->getOptions();
+        options.enableRegularisation = BT_TRUE;
+        options.enableFarBounds = BT_FALSE;
+        options.printLevel = PL_NONE;
+        std::dynamic_pointer_cast<QPOASESSolver>(solver)->setOptions(options);
+        std::dynamic_pointer_cast<QPOASESSolver>(solver)->setMaxNoWSR(1000);
+        return solver;
+    };
+    replay("qpOASES, previous solution",   qpoases(), nullptr, sequence, reference_solutions);
+    replay("qpOASES, extrapolation",       qpoases(), std::make_shared<ExtrapolationPredictor>(), sequence, reference_solutions);
+    replay("qpOASES, gait phase table",    qpoases(), std::make_shared<GaitPhasePredictor>(samples_per_cycle), sequence, reference_solutions);
+    replay("BoxQPSolver, previous solution", std::make_shared<BoxQPSolver>(), nullptr, sequence, reference_solutions);
+    replay("BoxQPSolver, extrapolation",     std::make_shared<BoxQPSolver>(), std::make_shared<ExtrapolationPredictor>(), sequence, reference_solutions);
+    replay("BoxQPSolver, gait phase table",  std::make_shared<BoxQPSolver>(), std::make_shared<GaitPhasePredictor>(samples_per_cycle), sequence, reference_solutions);
+
+    return 0;
+}
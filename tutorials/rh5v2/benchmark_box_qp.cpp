@@ -0,0 +1,90 @@
+#include <robot_models/pinocchio/RobotModelPinocchio.hpp>
+#include <scenes/velocity_qp/VelocitySceneQP.hpp>
+#include <solvers/qpoases/QPOasesSolver.hpp>
+#include <solvers/box_qp/BoxQPSolver.hpp>
+#ifdef USE_OSQP
+#include <solvers/osqp/OsqpSolver.hpp>
+#endif
+#include <chrono>
+
+using namespace std;
+using namespace wbc;
+
+/**
+ * Run n_samples control cycles of the dual arm VelocitySceneQP with the given solver and return the average solve time in microseconds. Both end effectors
+ * follow a sinusoidal velocity reference.
+ */
+double benchmark(RobotModelPtr robot_model, QPSolverPtr solver, const vector<TaskConfig>& wbc_config, int n_samples, base::VectorXd& last_output){
+
+    double dt = 0.01;
+    VelocitySceneQP scene(robot_model, solver, dt);
+    if(!scene.configure(wbc_config))
+        throw std::runtime_error("Failed to configure scene");
+
+    base::samples::Joints joint_state;
+    joint_state.names = robot_model->jointNames();
+    uint nj = joint_state.names.size();
+    joint_state.elements.resize(nj);
+    base::samples::RigidBodyStateSE3 ref;
+    ref.twist.setZero();
+
+    double total_time = 0;
+    for(int n = 0; n < n_samples; n++){
+        for(uint i = 0; i < nj; i++){
+            joint_state[i].position = 0.1 + 0.3*sin(1e-3*n);
+            joint_state[i].speed = joint_state[i].acceleration = 0;
+        }
+        joint_state.time = base::Time::now();
+        robot_model->update(joint_state);
+        for(const TaskConfig& cfg : wbc_config){
+            ref.twist.linear = base::Vector3d(0, 0.5*sin(1e-2*n), 0.5*cos(1e-2*n));
+            scene.setReference(cfg.name, ref);
+        }
+        const HierarchicalQP& hqp = scene.update();
+
+        auto s = std::chrono::high_resolution_clock::now();
+        solver->solve(hqp, last_output);
+        auto e = std::chrono::high_resolution_clock::now();
+        total_time += std::chrono::duration_cast<std::chrono::nanoseconds>(e-s).count()*1e-3;
+    }
+    return total_time / n_samples;
+}
+
+/**
+ * Benchmark the dedicated equality and bound constrained solver (BoxQPSolver) against qpOASES (and OSQP, if built with SOLVER_OSQP) on the dual arm VelocitySceneQP
+ * of the RH5v2 humanoid. The average solve time per control cycle is printed.
+ */
+int main(int argc, char** argv){
+
+    int n_samples = 10000;
+    if(argc > 1)
+        n_samples = atoi(argv[1]);
+
+    RobotModelPtr robot_model = make_shared<RobotModelPinocchio>();
+    RobotModelConfig config("../../../models/rh5v2/urdf/rh5v2.urdf");
+    config.submechanism_file = "../../../models/rh5v2/hyrodyn/rh5v2.yml";
+    if(!robot_model->configure(config))
+        return -1;
+
+    vector<TaskConfig> wbc_config;
+    wbc_config.push_back(TaskConfig("cart_ctrl_left",  0, "RH5v2_Root_Link", "ALWristFT_Link", "RH5v2_Root_Link", 1.0));
+    wbc_config.push_back(TaskConfig("cart_ctrl_right",  0, "RH5v2_Root_Link", "ARWristFT_Link", "RH5v2_Root_Link", 1.0));
+
+    QPSolverPtr qpoases_solver = make_shared<QPOASESSolver>();
+    dynamic_pointer_cast<QPOASESSolver>(qpoases_solver)->setMaxNoWSR(1000);
+    qpOASES::Options options = dynamic_pointer_cast<QPOASESSolver>(qpoases_solver)->getOptions();
+    options.printLevel = qpOASES::PL_NONE;
+    dynamic_pointer_cast<QPOASESSolver>(qpoases_solver)->setOptions(options);
+
+    base::VectorXd output_qpoases, output_box_qp;
+    cout<<"Average solve time over "<<n_samples<<" samples"<<endl;
+    cout<<"qpOASES:     "<<benchmark(robot_model, qpoases_solver, wbc_config, n_samples, output_qpoases)<<" (mu s)"<<endl;
+    cout<<"BoxQPSolver: "<<benchmark(robot_model, make_shared<BoxQPSolver>(), wbc_config, n_samples, output_box_qp)<<" (mu s)"<<endl;
+#ifdef USE_OSQP
+    base::VectorXd output_osqp;
+    cout<<"OSQP:        "<<benchmark(robot_model, make_shared<OsqpSolver>(), wbc_config, n_samples, output_osqp)<<" (mu s)"<<endl;
+#endif
+    cout<<"Deviation of the last solution from qpOASES: "<<(output_box_qp - output_qpoases).norm()<<endl;
+
+    return 0;
+}